@@ -0,0 +1,107 @@
+/**
+ * Benchmark for connection reuse in the curl HTTP client.
+ *
+ * Issues the same GET repeatedly, first the way CurlHttpClient used to
+ * (a fresh easy handle per request, so a new TCP connection and TLS
+ * handshake every time), then through CurlHttpClient with its pooled
+ * handles and shared connection cache, and reports per-request latency.
+ *
+ * Usage:
+ *   http_client_benchmark <url> [requests] [--insecure]
+ *
+ * Point it at a local HTTPS stand-in rather than a real API, e.g.
+ *   openssl req -x509 -newkey rsa:2048 -nodes -subj /CN=localhost \
+ *       -keyout key.pem -out cert.pem
+ *   nghttpx -f'127.0.0.1,8443' -b'127.0.0.1,8080' key.pem cert.pem
+ * with any HTTP server on port 8080 behind it, then run
+ *   http_client_benchmark https://127.0.0.1:8443/ 200 --insecure
+ */
+
+#include "http/http_client_curl.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+size_t discardBody(void*, size_t size, size_t nmemb, void*) {
+    return size * nmemb;
+}
+
+/**
+ * One request on a throwaway handle, as CurlHttpClient::perform used to.
+ */
+long performUncached(const std::string& url, bool verifySsl) {
+    CURL* curl = curl_easy_init();
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discardBody);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, verifySsl ? 1L : 0L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
+    curl_easy_perform(curl);
+    long status = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    curl_easy_cleanup(curl);
+    return status;
+}
+
+template <typename Fn>
+std::vector<double> timeRequests(int count, Fn&& fn) {
+    std::vector<double> millis;
+    millis.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        millis.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return millis;
+}
+
+void report(const char* label, std::vector<double> millis) {
+    std::sort(millis.begin(), millis.end());
+    double total = 0;
+    for (double ms : millis) total += ms;
+    std::printf("%-22s mean %7.2f ms  median %7.2f ms  p95 %7.2f ms  min %7.2f ms\n",
+                label, total / millis.size(), millis[millis.size() / 2],
+                millis[millis.size() * 95 / 100], millis.front());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <url> [requests] [--insecure]\n", argv[0]);
+        return 1;
+    }
+
+    std::string url = argv[1];
+    int count = 100;
+    bool verifySsl = true;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--insecure") == 0) {
+            verifySsl = false;
+        } else {
+            count = std::max(1, std::atoi(argv[i]));
+        }
+    }
+
+    Http::CurlHttpClient client;
+    Http::HttpRequest request;
+    request.url = url;
+    request.verifySsl = verifySsl;
+
+    // Both runs hit the server once first so neither pays for its warm-up
+    if (performUncached(url, verifySsl) == 0 || !client.perform(request).isOk()) {
+        std::fprintf(stderr, "Request to %s failed\n", url.c_str());
+        return 1;
+    }
+
+    std::printf("%d requests to %s\n", count, url.c_str());
+    report("handle per request:", timeRequests(count, [&] { performUncached(url, verifySsl); }));
+    report("CurlHttpClient:", timeRequests(count, [&] { client.perform(request); }));
+    return 0;
+}
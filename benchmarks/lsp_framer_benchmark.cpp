@@ -0,0 +1,176 @@
+/**
+ * Micro-benchmark for LSP Content-Length framing.
+ *
+ * Feeds a large stream of LSP traffic through LspMessageFramer and through the
+ * previous substr-based framer, in pipe-sized chunks, and reports throughput.
+ *
+ * Usage:
+ *   lsp_framer_benchmark [capture-file] [chunk-size]
+ *
+ * The capture file should contain raw server output (headers + bodies), e.g.
+ * recorded with `clangd ... | tee clangd.capture`. Without one, clangd-like
+ * traffic (diagnostic floods, document symbols, small responses) is synthesized.
+ */
+
+#include "lsp/lsp_framer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+
+namespace {
+
+/**
+ * The framer LspClient used before LspMessageFramer, kept for comparison.
+ */
+class SubstrFramer {
+public:
+    template <typename Handler>
+    void feed(const char* data, size_t size, Handler&& onMessage) {
+        m_inputBuffer.append(data, size);
+        while (true) {
+            size_t header_end = m_inputBuffer.find("\r\n\r\n");
+            if (header_end == std::string::npos) break;
+
+            size_t content_length = 0;
+            size_t cl_pos = m_inputBuffer.find("Content-Length:");
+            if (cl_pos != std::string::npos && cl_pos < header_end) {
+                size_t num_start = cl_pos + 15;
+                while (num_start < header_end && isspace(m_inputBuffer[num_start])) num_start++;
+                content_length = std::stoul(m_inputBuffer.substr(num_start));
+            }
+
+            size_t message_start = header_end + 4;
+            if (m_inputBuffer.size() < message_start + content_length) break;
+
+            std::string content = m_inputBuffer.substr(message_start, content_length);
+            m_inputBuffer = m_inputBuffer.substr(message_start + content_length);
+
+            onMessage(content);
+        }
+    }
+
+private:
+    std::string m_inputBuffer;
+};
+
+std::string frame(const std::string& body) {
+    return "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+/**
+ * Synthesize roughly targetBytes of clangd-like server output.
+ */
+std::string synthesizeTraffic(size_t targetBytes) {
+    std::mt19937 rng(42);
+    std::string stream;
+    stream.reserve(targetBytes + 64 * 1024);
+    int id = 1;
+
+    while (stream.size() < targetBytes) {
+        int kind = rng() % 10;
+        std::string body;
+
+        if (kind < 6) {
+            // publishDiagnostics with a burst of entries
+            int count = 1 + rng() % 40;
+            body = R"({"jsonrpc":"2.0","method":"textDocument/publishDiagnostics","params":{"uri":"file:///src/module_)"
+                 + std::to_string(rng() % 1000) + R"(.cpp","diagnostics":[)";
+            for (int i = 0; i < count; ++i) {
+                if (i) body += ",";
+                int line = rng() % 5000;
+                body += R"({"range":{"start":{"line":)" + std::to_string(line) + R"(,"character":4},"end":{"line":)"
+                      + std::to_string(line) + R"(,"character":17}},"severity":2,"code":"-Wunused-variable",)"
+                      R"("source":"clang","message":"unused variable 'tmp)" + std::to_string(i) + R"('"})";
+            }
+            body += "]}}";
+        } else if (kind < 9) {
+            // documentSymbol response
+            int count = 5 + rng() % 200;
+            body = R"({"jsonrpc":"2.0","id":)" + std::to_string(id++) + R"(,"result":[)";
+            for (int i = 0; i < count; ++i) {
+                if (i) body += ",";
+                body += R"({"name":"symbol_)" + std::to_string(i) + R"(","kind":12,"range":{"start":{"line":)"
+                      + std::to_string(i * 3) + R"(,"character":0},"end":{"line":)" + std::to_string(i * 3 + 2)
+                      + R"(,"character":1}},"selectionRange":{"start":{"line":)" + std::to_string(i * 3)
+                      + R"(,"character":5},"end":{"line":)" + std::to_string(i * 3) + R"(,"character":14}}})";
+            }
+            body += "]}";
+        } else {
+            // $/progress and other small notifications
+            body = R"({"jsonrpc":"2.0","method":"$/progress","params":{"token":"backgroundIndexProgress","value":{"kind":"report","percentage":)"
+                 + std::to_string(rng() % 100) + "}}}";
+        }
+
+        stream += frame(body);
+    }
+    return stream;
+}
+
+template <typename Fn>
+double timeSeconds(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string traffic;
+    if (argc > 1) {
+        std::ifstream in(argv[1], std::ios::binary);
+        if (!in) {
+            std::fprintf(stderr, "Could not open capture file: %s\n", argv[1]);
+            return 1;
+        }
+        traffic.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    } else {
+        traffic = synthesizeTraffic(64 * 1024 * 1024);
+    }
+
+    size_t chunkSize = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 65536;
+    if (chunkSize == 0) chunkSize = 65536;
+
+    double megabytes = traffic.size() / (1024.0 * 1024.0);
+    std::printf("Traffic: %.1f MB, chunk size: %zu bytes\n", megabytes, chunkSize);
+
+    size_t framedMessages = 0;
+    size_t framedBytes = 0;
+    double framedTime = timeSeconds([&] {
+        LspMessageFramer framer;
+        for (size_t pos = 0; pos < traffic.size(); pos += chunkSize) {
+            size_t n = std::min(chunkSize, traffic.size() - pos);
+            framer.append(traffic.data() + pos, n);
+            framedMessages += framer.drain([&](std::string_view body) { framedBytes += body.size(); });
+        }
+    });
+
+    size_t legacyMessages = 0;
+    size_t legacyBytes = 0;
+    double legacyTime = timeSeconds([&] {
+        SubstrFramer framer;
+        for (size_t pos = 0; pos < traffic.size(); pos += chunkSize) {
+            size_t n = std::min(chunkSize, traffic.size() - pos);
+            framer.feed(traffic.data() + pos, n, [&](const std::string& body) {
+                ++legacyMessages;
+                legacyBytes += body.size();
+            });
+        }
+    });
+
+    std::printf("LspMessageFramer: %zu messages, %8.3f s, %9.1f MB/s\n",
+                framedMessages, framedTime, megabytes / framedTime);
+    std::printf("substr framer:    %zu messages, %8.3f s, %9.1f MB/s\n",
+                legacyMessages, legacyTime, megabytes / legacyTime);
+
+    if (framedMessages != legacyMessages || framedBytes != legacyBytes) {
+        std::fprintf(stderr, "Mismatch between framers!\n");
+        return 1;
+    }
+    return 0;
+}
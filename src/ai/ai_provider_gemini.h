@@ -152,6 +152,14 @@ public:
         return baseUrl + "/models/" + config.model + ":generateContent?key=" + config.apiKey;
     }
     
+    /**
+     * Build the request URL for streamed generation (server-sent events).
+     */
+    static std::string buildStreamRequestUrl(const AIConfig& config) {
+        std::string baseUrl = config.baseUrl.empty() ? getDefaultBaseUrl() : config.baseUrl;
+        return baseUrl + "/models/" + config.model + ":streamGenerateContent?alt=sse&key=" + config.apiKey;
+    }
+    
     /**
      * Build request headers.
      */
@@ -269,14 +277,14 @@ public:
             return result;
         }
         
-        // Extract content
+        // Extract content; a turn may request several independent function calls
         for (const auto& part : candidate.content.parts) {
             if (part.functionCall.has_value()) {
-                result.hasFunctionCall = true;
+                result.functionCalls.push_back({
+                    part.functionCall->name,
+                    glz::write_json(part.functionCall->args).value_or("{}")});
                 result.success = true;
-                result.functionName = part.functionCall->name;
-                result.functionArgs = glz::write_json(part.functionCall->args).value_or("{}");
-                return result;
+                continue;
             }
             
             if (part.text.has_value()) {
@@ -285,6 +293,13 @@ public:
             }
         }
         
+        if (!result.functionCalls.empty()) {
+            result.hasFunctionCall = true;
+            result.functionName = result.functionCalls.front().name;
+            result.functionArgs = result.functionCalls.front().args;
+            return result;
+        }
+        
         if (!result.success) {
             result.error = "No text or function call found in response";
             return result;
@@ -356,6 +371,121 @@ public:
     }
 };
 
+/**
+ * Assembles a :streamGenerateContent?alt=sse response from its events.
+ * 
+ * Every SSE event carries a complete GenerateContentResponse holding the
+ * next slice of the answer. Text parts are forwarded to the callback as they
+ * arrive and accumulated; function calls and token counts are collected, so
+ * finish() returns the same AIResponse a non-streamed request would. The
+ * SSE framing itself is done by Http::HttpClient::streamEvents().
+ */
+class GeminiStreamParser {
+public:
+    explicit GeminiStreamParser(StreamCallback onText) : m_onText(std::move(onText)) {}
+    
+    /**
+     * Handle the data of the next event.
+     * @return false to stop the stream (API error, or the callback declined).
+     */
+    bool handleEvent(const std::string& json) {
+        m_sawEvent = true;
+        dispatchEvent(json);
+        return !m_stopped;
+    }
+    
+    /**
+     * Complete parsing once the transfer ended.
+     * @param body The response body when no event arrived (e.g. an HTTP error)
+     */
+    AIResponse finish(long httpCode, const std::string& body) {
+        if (!m_sawEvent) {
+            return GeminiProvider::parseResponse(body, httpCode);
+        }
+        
+        AIResponse result;
+        result.httpCode = httpCode;
+        result.promptTokens = m_promptTokens;
+        result.completionTokens = m_completionTokens;
+        
+        if (!m_error.empty()) {
+            result.error = m_error;
+            return result;
+        }
+        
+        result.text = m_text;
+        if (!m_calls.empty()) {
+            result.hasFunctionCall = true;
+            result.functionName = m_calls.front().name;
+            result.functionArgs = m_calls.front().args;
+            result.functionCalls = m_calls;
+        }
+        result.success = !m_text.empty() || !m_calls.empty();
+        if (!result.success) {
+            result.error = "No text or function call found in response";
+        }
+        return result;
+    }
+    
+    bool stopped() const { return m_stopped; }
+    
+private:
+    StreamCallback m_onText;
+    std::string m_text;
+    std::vector<FunctionCallRequest> m_calls;
+    std::string m_error;
+    int m_promptTokens = 0;
+    int m_completionTokens = 0;
+    bool m_sawEvent = false;
+    bool m_stopped = false;
+    
+    void dispatchEvent(const std::string& json) {
+        GeminiApi::Response chunk;
+        auto ec = glz::read<glz::opts{.error_on_unknown_keys = false}>(chunk, json);
+        if (ec) {
+            m_error = "Failed to parse streamed response: " + glz::format_error(ec, json);
+            wxLogError("AI: %s", m_error);
+            m_stopped = true;
+            return;
+        }
+        
+        if (chunk.error.has_value()) {
+            m_error = chunk.error->message.empty() ? "API returned an error" : chunk.error->message;
+            m_stopped = true;
+            return;
+        }
+        
+        if (chunk.usageMetadata.has_value()) {
+            m_promptTokens = chunk.usageMetadata->promptTokenCount;
+            m_completionTokens = chunk.usageMetadata->candidatesTokenCount;
+        }
+        
+        if (chunk.candidates.empty()) return;
+        const auto& candidate = chunk.candidates[0];
+        
+        if (candidate.finishReason.has_value() && candidate.finishReason.value() == "SAFETY") {
+            m_error = "Response blocked by safety filter. "
+                      "Try setting ai.safetyThreshold to BLOCK_ONLY_HIGH or BLOCK_NONE in config.";
+            m_stopped = true;
+            return;
+        }
+        
+        for (const auto& part : candidate.content.parts) {
+            if (part.functionCall.has_value()) {
+                m_calls.push_back({
+                    part.functionCall->name,
+                    glz::write_json(part.functionCall->args).value_or("{}")});
+            } else if (part.text.has_value() && !part.text->empty()) {
+                m_text += part.text.value();
+                if (m_onText && !m_onText(part.text.value())) {
+                    m_stopped = true;
+                    return;
+                }
+            }
+        }
+    }
+};
+
 } // namespace AI
 
 #endif // AI_PROVIDER_GEMINI_H
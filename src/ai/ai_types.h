@@ -48,6 +48,22 @@ struct ChatMessage {
     }
 };
 
+/**
+ * A function (tool) call requested by the model.
+ */
+struct FunctionCallRequest {
+    std::string name;
+    std::string args;           // JSON string of arguments
+};
+
+/**
+ * The result of one executed function call, sent back to the model.
+ */
+struct FunctionCallResult {
+    std::string name;
+    std::string result;         // JSON string
+};
+
 /**
  * Result of an AI API call.
  */
@@ -61,8 +77,9 @@ struct AIResponse {
     
     // Function calling support
     bool hasFunctionCall = false;
-    std::string functionName;
+    std::string functionName;   // First requested call
     std::string functionArgs;   // JSON string of arguments
+    std::vector<FunctionCallRequest> functionCalls;    // All calls requested in this turn
     
     bool isOk() const { return success && error.empty(); }
     bool needsFunctionCall() const { return success && hasFunctionCall; }
@@ -4,7 +4,7 @@
 #include "ai_types.h"
 #include "ai_provider_gemini.h"
 #include "ai_provider_cortex.h"
-#include "../http/http_client.h"
+#include "../http/async_http.h"
 #include "../config/config.h"
 #include "../mcp/mcp.h"
 #include <wx/log.h>
@@ -298,9 +298,10 @@ public:
      * The message and response are added to the conversation history.
      * 
      * @param message The user's message
+     * @param onText If set, the reply is streamed and its text passed here as it arrives
      * @return GeminiResponse with the model's reply
      */
-    GeminiResponse SendMessage(const std::string& message) {
+    GeminiResponse SendMessage(const std::string& message, const StreamCallback& onText = nullptr) {
         // Add user message to history
         {
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -314,7 +315,7 @@ public:
             messages = m_conversationHistory;
         }
         
-        GeminiResponse response = GenerateFromMessages(messages);
+        GeminiResponse response = GenerateFromMessages(messages, onText);
         
         // Add model response to history if successful
         if (response.isOk()) {
@@ -322,11 +323,7 @@ public:
             if (response.hasFunctionCall) {
                 // For function calls, add a message indicating the model requested a tool
                 // This is important for conversation continuity when ContinueWithToolResult is called
-                std::string funcCallMsg = "[Calling tool: " + response.functionName + "]";
-                if (!response.functionArgs.empty()) {
-                    funcCallMsg += "\nArguments: " + response.functionArgs;
-                }
-                m_conversationHistory.emplace_back(MessageRole::Model, funcCallMsg);
+                m_conversationHistory.emplace_back(MessageRole::Model, FormatFunctionCalls(response));
             } else {
                 m_conversationHistory.emplace_back(MessageRole::Model, response.text);
             }
@@ -354,12 +351,29 @@ public:
      */
     GeminiResponse ContinueWithToolResult(const std::string& functionName, 
                                           const std::string& result) {
+        return ContinueWithToolResults({{functionName, result}});
+    }
+    
+    /**
+     * Continue a conversation with the results of all function calls the
+     * model requested in its last turn, sent back in a single round.
+     * 
+     * @param results One entry per call, in the order they were requested
+     * @param onText If set, the reply is streamed and its text passed here as it arrives
+     * @return GeminiResponse with the model's continued reply
+     */
+    GeminiResponse ContinueWithToolResults(const std::vector<FunctionCallResult>& results,
+                                           const StreamCallback& onText = nullptr) {
         // Build the function response message
         // In the conversation history, we need to add:
         // 1. The model's function call (as a model message)
         // 2. The function response (as a special format)
         
-        std::string toolResponseContent = "[Tool Result for " + functionName + "]\n" + result;
+        std::string toolResponseContent;
+        for (const auto& result : results) {
+            if (!toolResponseContent.empty()) toolResponseContent += "\n\n";
+            toolResponseContent += "[Tool Result for " + result.name + "]\n" + result.result;
+        }
         
         {
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -375,16 +389,28 @@ public:
         }
         
         // For the continuation, we might not need tools again
-        GeminiResponse response = GenerateFromMessages(messages);
+        GeminiResponse response = GenerateFromMessages(messages, onText);
         
-        if (response.isOk() && !response.hasFunctionCall) {
+        if (response.isOk()) {
             std::lock_guard<std::mutex> lock(m_mutex);
-            m_conversationHistory.emplace_back(MessageRole::Model, response.text);
+            // Record follow-up calls too, so the next round's results have their request
+            m_conversationHistory.emplace_back(MessageRole::Model,
+                response.hasFunctionCall ? FormatFunctionCalls(response) : response.text);
         }
         
         return response;
     }
     
+    /**
+     * Cancel the requests in flight (e.g. when the chat closes). The
+     * interrupted call returns with an error; later calls run normally.
+     */
+    void CancelPendingRequests() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancel.cancel();
+        m_cancel = Http::CancellationToken();
+    }
+    
     // ========== Available Models ==========
     
     /**
@@ -489,6 +515,7 @@ private:
     mutable std::mutex m_mutex;
     GeminiConfig m_config;
     std::vector<ChatMessage> m_conversationHistory;
+    Http::CancellationToken m_cancel;   // Shared by the requests in flight
     
     /**
      * Parse Gemini models list response - delegates to GeminiProvider.
@@ -641,6 +668,21 @@ private:
         return CortexProvider::parseResponse(responseBody, httpCode);
     }
     
+    /**
+     * History entry for the function calls requested in a response.
+     */
+    static std::string FormatFunctionCalls(const GeminiResponse& response) {
+        std::string message;
+        for (const auto& call : response.functionCalls) {
+            if (!message.empty()) message += "\n";
+            message += "[Calling tool: " + call.name + "]";
+            if (!call.args.empty()) {
+                message += "\nArguments: " + call.args;
+            }
+        }
+        return message;
+    }
+    
     /**
      * Parse the response JSON from the Gemini API.
      * Delegates to GeminiProvider which uses Glaze for proper JSON parsing.
@@ -651,15 +693,21 @@ private:
     
     /**
      * Generate a response from a list of messages.
+     * With onText set, Gemini responses are streamed (:streamGenerateContent)
+     * and their text is passed to it as it arrives; other providers deliver
+     * the whole text in one call once done.
      */
-    GeminiResponse GenerateFromMessages(const std::vector<ChatMessage>& messages) {
+    GeminiResponse GenerateFromMessages(const std::vector<ChatMessage>& messages,
+                                        const StreamCallback& onText = nullptr) {
         GeminiResponse result;
         
         // Get config snapshot
         GeminiConfig config;
+        Http::CancellationToken cancel;
         {
             std::lock_guard<std::mutex> lock(m_mutex);
             config = m_config;
+            cancel = m_cancel;
         }
         
         wxLogDebug("AI: GenerateFromMessages() with %zu messages, provider=%s, model=%s",
@@ -679,8 +727,9 @@ private:
             return result;
         }
         
-        // Get HTTP client
-        Http::HttpClient& httpClient = Http::getHttpClient();
+        // Run on the shared async engine, so chat traffic shares connections
+        // with the other widgets' requests and can be cancelled
+        Http::HttpClient& httpClient = Http::AsyncClient::Instance();
         if (!httpClient.isAvailable()) {
             result.error = "HTTP client not available";
             wxLogError("AI: HTTP client not available (backend: %s)", httpClient.backendName());
@@ -694,6 +743,7 @@ private:
         request.method = "POST";
         request.headers["Content-Type"] = "application/json";
         request.timeoutSeconds = 60; // AI requests can take a while
+        request.cancel = cancel;
         
         if (config.provider == AIProvider::Cortex) {
             // Cortex/OpenAI-compatible API
@@ -704,7 +754,8 @@ private:
         } else {
             // Google Gemini API
             std::string baseUrl = config.getEffectiveBaseUrl();
-            request.url = baseUrl + "/models/" + config.model + ":generateContent?key=" + config.apiKey;
+            request.url = onText ? GeminiProvider::buildStreamRequestUrl(config)
+                                 : GeminiProvider::buildRequestUrl(config);
             
             wxLogDebug("AI: Building Gemini request body (enableMCP=%s, systemInstruction=%zu chars)",
                        config.enableMCP ? "yes" : "no",
@@ -712,12 +763,26 @@ private:
             
             request.body = BuildRequestBodyWithTools(messages, config.enableMCP);
             
-            wxLogDebug("AI: Gemini request to %s/models/%s:generateContent", baseUrl, config.model);
+            wxLogDebug("AI: Gemini request to %s/models/%s%s", baseUrl, config.model,
+                       onText ? ":streamGenerateContent" : ":generateContent");
         }
         
         wxLogDebug("AI: Request body size: %zu bytes", request.body.size());
         
-        Http::HttpResponse httpResponse = httpClient.perform(request);
+        std::optional<GeminiStreamParser> streamParser;
+        Http::HttpResponse httpResponse;
+        if (onText && config.provider != AIProvider::Cortex) {
+            streamParser.emplace(onText);
+            httpResponse = httpClient.streamEvents(request, [&streamParser](const Http::SseEvent& event) {
+                return streamParser->handleEvent(event.data);
+            });
+            // The parser stops the transfer itself on API errors or when onText declines
+            if (streamParser->stopped()) {
+                httpResponse.error.clear();
+            }
+        } else {
+            httpResponse = httpClient.perform(request);
+        }
         
         wxLogDebug("AI: HTTP response - status=%ld, body=%zu bytes, error=%s",
                    httpResponse.statusCode, httpResponse.body.size(),
@@ -738,8 +803,13 @@ private:
         
         // Parse response based on provider
         GeminiResponse parsedResult;
-        if (config.provider == AIProvider::Cortex) {
+        if (streamParser) {
+            parsedResult = streamParser->finish(httpResponse.statusCode, httpResponse.body);
+        } else if (config.provider == AIProvider::Cortex) {
             parsedResult = ParseCortexResponse(httpResponse.body, httpResponse.statusCode);
+            if (onText && parsedResult.success && !parsedResult.text.empty()) {
+                onText(parsedResult.text);
+            }
         } else {
             parsedResult = ParseResponse(httpResponse.body, httpResponse.statusCode);
         }
@@ -754,7 +824,9 @@ private:
             wxLogDebug("AI: Response parsed successfully - tokens: prompt=%d, completion=%d",
                        parsedResult.promptTokens, parsedResult.completionTokens);
             if (parsedResult.hasFunctionCall) {
-                wxLogDebug("AI: Function call requested: %s", parsedResult.functionName);
+                for (const auto& call : parsedResult.functionCalls) {
+                    wxLogDebug("AI: Function call requested: %s", call.name);
+                }
             }
         }
         
@@ -23,6 +23,11 @@ void Config::InitializeDefaults() {
     // Terminal defaults
     m_values["terminal.fontSize"] = 12;
     m_values["terminal.fontFamily"] = wxString("Menlo");
+    m_values["terminal.scrollback"] = 10000;                  // Output lines kept; older ones are dropped
+    
+    // Filesystem watching defaults
+    m_values["watcher.enabled"] = true;                      // Follow external changes in the open folder
+    m_values["watcher.pollInterval"] = 5;                    // Seconds between scans of remote hosts without inotifywait
     
     // SSH Remote Development defaults
     // When enabled, terminal, file operations, and code indexing will go through SSH
@@ -35,9 +40,18 @@ void Config::InitializeDefaults() {
     m_values["ssh.extraOptions"] = wxString("");           // Additional SSH options (e.g., -o StrictHostKeyChecking=no)
     m_values["ssh.forwardAgent"] = false;                    // Enable SSH agent forwarding
     m_values["ssh.connectionTimeout"] = 30;                  // Connection timeout in seconds
+    m_values["ssh.multiplex"] = true;                        // Reuse one ControlMaster connection for file operations
     m_values["ssh.clangdCommand"] = wxString("");          // Remote clangd command (auto-detects nix if empty)
                                                             // Examples: "clangd", "nix develop -c clangd"
     
+    // Code index defaults
+    m_values["lsp.indexConcurrency"] = 32;                   // documentSymbol requests kept in flight while indexing (1-64)
+    m_values["lsp.indexTimeout"] = 10;                       // Seconds to wait for a file's symbols before skipping it
+    m_values["lsp.symbolCache"] = true;                      // Keep indexed symbols on disk and only re-index changed files
+    m_values["ai.workspaceIndex"] = true;                    // Index local workspace files for the AI's fs_grep / fs_search_files
+    m_values["ai.toolConcurrency"] = 4;                      // Tool calls from one model turn run in parallel (1 = one at a time)
+    m_values["ai.stream"] = true;                            // Show Gemini replies as they are generated
+    
     // UI defaults
     m_values["ui.sidebarWidth"] = 250;
     m_values["ui.terminalHeight"] = 200;
@@ -0,0 +1,327 @@
+#include "change_watcher.h"
+#include "remote_session.h"
+#include <algorithm>
+#include <chrono>
+
+namespace FS {
+
+// --- Coalescing ---
+
+void ChangeCoalescer::add(const FileChange& change) {
+    using Kind = FileChange::Kind;
+
+    auto it = m_byPath.find(change.path);
+    if (it == m_byPath.end()) {
+        m_byPath.emplace(change.path, m_entries.size());
+        m_entries.push_back({change, false});
+        ++m_live;
+        return;
+    }
+
+    Entry& entry = m_entries[it->second];
+    if (entry.dropped) {
+        entry.change = change;
+        entry.dropped = false;
+        ++m_live;
+        return;
+    }
+
+    Kind previous = entry.change.kind;
+    if (change.isDirectory) {
+        entry.change.isDirectory = true;
+    }
+    switch (change.kind) {
+    case Kind::Created:
+    case Kind::Modified:
+        // Created stays created; anything after a deletion means it is back
+        if (previous == Kind::Deleted) {
+            entry.change.kind = Kind::Modified;
+        }
+        break;
+    case Kind::Deleted:
+        if (previous == Kind::Created) {
+            entry.dropped = true;   // Came and went within the burst
+            --m_live;
+        } else {
+            entry.change.kind = Kind::Deleted;
+        }
+        break;
+    }
+}
+
+std::vector<FileChange> ChangeCoalescer::take() {
+    std::vector<FileChange> changes;
+    changes.reserve(m_live);
+    for (auto& entry : m_entries) {
+        if (!entry.dropped) {
+            changes.push_back(std::move(entry.change));
+        }
+    }
+    m_entries.clear();
+    m_byPath.clear();
+    m_live = 0;
+    return changes;
+}
+
+// --- Remote watching ---
+
+namespace {
+
+/**
+ * Escape a name for use in a POSIX extended regular expression.
+ */
+std::string regexEscape(const std::string& name) {
+    std::string escaped;
+    for (char c : name) {
+        if (std::string_view(".[]{}()\\*+?^$|").find(c) != std::string_view::npos) {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+RemoteWatcher::RemoteWatcher(const Filesystem& fs, const std::string& root,
+                             std::vector<std::string> skipDirectories, int pollSeconds,
+                             ChangesCallback onChanges)
+    : m_fs(fs)
+    , m_root(root)
+    , m_skipDirectories(std::move(skipDirectories))
+    , m_pollSeconds(std::max(1, pollSeconds))
+    , m_onChanges(std::move(onChanges)) {
+    while (m_root.size() > 1 && m_root.back() == '/') {
+        m_root.pop_back();
+    }
+    m_thread = std::thread([this] { run(); });
+}
+
+RemoteWatcher::~RemoteWatcher() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+std::string RemoteWatcher::WatchCommand(const std::string& root, const std::vector<std::string>& skipDirectories) {
+    // Hidden entries and skipped directories, anywhere below the root
+    std::string exclude = "/\\.";
+    if (!skipDirectories.empty()) {
+        exclude += "|/(";
+        for (size_t i = 0; i < skipDirectories.size(); ++i) {
+            if (i > 0) exclude += "|";
+            exclude += regexEscape(skipDirectories[i]);
+        }
+        exclude += ")(/|$)";
+    }
+
+    // The heartbeat both shows the watcher is alive and, once the channel
+    // is gone, fails with SIGPIPE so the script ends and takes inotifywait
+    // down with it
+    std::string script =
+        "command -v inotifywait >/dev/null 2>&1 || exit 127\n"
+        "inotifywait -m -r -q -e create,delete,close_write,moved_from,moved_to"
+        " --format '%e|%w%f' --exclude " + RemoteSession::shellQuote(exclude) +
+        " " + RemoteSession::shellQuote(root) + " &\n"
+        "w=$!\n"
+        "trap 'kill $w 2>/dev/null' EXIT\n"
+        "trap 'exit 1' HUP PIPE TERM\n"
+        "while kill -0 $w 2>/dev/null; do echo; sleep " + std::to_string(kHeartbeatSeconds) + "; done\n"
+        "wait $w\n";
+    return "sh -c " + RemoteSession::shellQuote(script);
+}
+
+bool RemoteWatcher::ParseEvent(std::string_view line, FileChange& change) {
+    size_t bar = line.find('|');
+    if (bar == std::string_view::npos || bar + 1 >= line.size()) {
+        return false;
+    }
+
+    bool known = false;
+    change = FileChange();
+    std::string_view events = line.substr(0, bar);
+    while (!events.empty()) {
+        size_t comma = events.find(',');
+        std::string_view event = events.substr(0, comma);
+        if (event == "CREATE" || event == "MOVED_TO") {
+            change.kind = FileChange::Kind::Created;
+            known = true;
+        } else if (event == "DELETE" || event == "MOVED_FROM") {
+            change.kind = FileChange::Kind::Deleted;
+            known = true;
+        } else if (event == "CLOSE_WRITE" || event == "MODIFY") {
+            change.kind = FileChange::Kind::Modified;
+            known = true;
+        } else if (event == "ISDIR") {
+            change.isDirectory = true;
+        }
+        events = (comma == std::string_view::npos) ? std::string_view() : events.substr(comma + 1);
+    }
+
+    change.path = std::string(line.substr(bar + 1));
+    return known;
+}
+
+bool RemoteWatcher::IsIgnored(std::string_view root, std::string_view path,
+                              const std::vector<std::string>& skipDirectories) {
+    if (root.empty() || path.size() <= root.size() || path.compare(0, root.size(), root) != 0 ||
+        (root.back() != '/' && path[root.size()] != '/')) {
+        return true;    // Not below the root
+    }
+    std::string_view rest = path.substr(root.size());
+    while (!rest.empty()) {
+        size_t slash = rest.find('/');
+        std::string_view part = rest.substr(0, slash);
+        if (!part.empty() && IsIgnoredName(part, skipDirectories)) {
+            return true;
+        }
+        rest = (slash == std::string_view::npos) ? std::string_view() : rest.substr(slash + 1);
+    }
+    return false;
+}
+
+bool RemoteWatcher::IsIgnoredName(std::string_view name, const std::vector<std::string>& skipDirectories) {
+    return (!name.empty() && name[0] == '.') ||
+           std::find(skipDirectories.begin(), skipDirectories.end(), name) != skipDirectories.end();
+}
+
+std::vector<FileChange> RemoteWatcher::Diff(const Snapshot& before, const Snapshot& after) {
+    std::vector<FileChange> changes;
+    for (const auto& [path, stamp] : after) {
+        auto it = before.find(path);
+        if (it == before.end()) {
+            changes.push_back({FileChange::Kind::Created, path, stamp.isDirectory});
+        } else if (!(it->second == stamp) && !stamp.isDirectory) {
+            // A directory's mtime moves with its entries, which are reported themselves
+            changes.push_back({FileChange::Kind::Modified, path, false});
+        }
+    }
+    for (const auto& [path, stamp] : before) {
+        if (!after.count(path)) {
+            changes.push_back({FileChange::Kind::Deleted, path, stamp.isDirectory});
+        }
+    }
+    std::sort(changes.begin(), changes.end(), [](const FileChange& a, const FileChange& b) {
+        return a.path < b.path;
+    });
+    return changes;
+}
+
+void RemoteWatcher::run() {
+    if (!m_fs.session()) {
+        return;
+    }
+
+    while (!stopping()) {
+        int rc = stream();
+        if (rc < 0) {
+            return;     // Stopped
+        }
+        // 255 is ssh's own failure (connection lost): watch again once it is
+        // back. Anything else means inotifywait is missing or gave up.
+        if (rc != 0 && rc != 255) {
+            wxLogMessage("RemoteWatcher: inotifywait unavailable on the host (exit %d), polling %s every %ds",
+                         rc, wxString::FromUTF8(m_root), m_pollSeconds);
+            poll();
+            return;
+        }
+        if (!sleepFor(kRetrySeconds)) {
+            return;
+        }
+    }
+}
+
+int RemoteWatcher::stream() {
+    std::string pending;
+    int rc = m_fs.session()->runStreaming(WatchCommand(m_root, m_skipDirectories),
+        [&](const char* data, size_t size) {
+            if (stopping()) {
+                return false;
+            }
+            pending.append(data, size);
+
+            std::vector<FileChange> changes;
+            size_t start = 0;
+            for (size_t newline; (newline = pending.find('\n', start)) != std::string::npos; start = newline + 1) {
+                FileChange change;
+                std::string_view line(pending.data() + start, newline - start);
+                if (!ParseEvent(line, change) || IsIgnored(m_root, change.path, m_skipDirectories)) {
+                    continue;
+                }
+                bool newDirectory = change.isDirectory && change.kind == FileChange::Kind::Created;
+                std::string path = change.path;
+                changes.push_back(std::move(change));
+                if (newDirectory) {
+                    addDirectoryContents(path, changes);
+                }
+            }
+            pending.erase(0, start);
+
+            if (!changes.empty()) {
+                m_onChanges(std::move(changes));
+            }
+            return true;
+        });
+    return stopping() ? -1 : rc;
+}
+
+void RemoteWatcher::poll() {
+    m_polling = true;
+
+    Snapshot previous;
+    bool haveBaseline = takeSnapshot(previous);
+    while (sleepFor(m_pollSeconds)) {
+        Snapshot current;
+        if (!takeSnapshot(current)) {
+            continue;   // Host unreachable or stopped; try again next round
+        }
+        if (haveBaseline) {
+            auto changes = Diff(previous, current);
+            if (!changes.empty()) {
+                m_onChanges(std::move(changes));
+            }
+        }
+        previous = std::move(current);
+        haveBaseline = true;
+    }
+}
+
+bool RemoteWatcher::takeSnapshot(Snapshot& snapshot) const {
+    WalkOptions options;
+    options.skipDirectories = m_skipDirectories;
+
+    bool ok = m_fs.walk(wxString::FromUTF8(m_root), options, [&](const FileEntry& entry) {
+        snapshot[std::string(entry.fullPath.ToUTF8().data())] =
+            Stamp{static_cast<int64_t>(entry.modTime), entry.size, entry.isDirectory};
+        return !stopping();
+    });
+    return ok && !stopping();
+}
+
+void RemoteWatcher::addDirectoryContents(const std::string& dir, std::vector<FileChange>& changes) const {
+    WalkOptions options;
+    options.skipDirectories = m_skipDirectories;
+
+    m_fs.walk(wxString::FromUTF8(dir), options, [&](const FileEntry& entry) {
+        changes.push_back({FileChange::Kind::Created, std::string(entry.fullPath.ToUTF8().data()),
+                           entry.isDirectory});
+        return true;
+    });
+}
+
+bool RemoteWatcher::sleepFor(int seconds) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return !m_wake.wait_for(lock, std::chrono::seconds(seconds), [this] { return m_stopping; });
+}
+
+bool RemoteWatcher::stopping() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stopping;
+}
+
+} // namespace FS
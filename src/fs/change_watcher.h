@@ -0,0 +1,172 @@
+#ifndef CHANGE_WATCHER_H
+#define CHANGE_WATCHER_H
+
+#include "fs.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace FS {
+
+/**
+ * A change to one path below a watched directory.
+ */
+struct FileChange {
+    enum class Kind { Created, Modified, Deleted };
+
+    Kind kind = Kind::Modified;
+    std::string path;           // UTF-8, absolute
+    bool isDirectory = false;   // Not always known for deletions
+};
+
+/**
+ * Folds a burst of raw change events into at most one change per path.
+ *
+ * A path created and then modified is reported as created; created and
+ * then deleted is not reported at all; deleted and then created again (an
+ * atomic save) is reported as modified. Changes come out in the order
+ * their paths were first seen.
+ */
+class ChangeCoalescer {
+public:
+    void add(const FileChange& change);
+
+    bool empty() const { return m_live == 0; }
+    size_t size() const { return m_live; }
+
+    /**
+     * Hand out the pending changes and start over.
+     */
+    std::vector<FileChange> take();
+
+private:
+    struct Entry {
+        FileChange change;
+        bool dropped = false;
+    };
+
+    std::vector<Entry> m_entries;
+    std::unordered_map<std::string, size_t> m_byPath;
+    size_t m_live = 0;
+};
+
+/**
+ * Watches a directory tree on the remote host over the shared RemoteSession.
+ *
+ * Runs `inotifywait -m -r` on the host and streams its events back over one
+ * channel. A heartbeat line every kHeartbeatSeconds lets the watcher notice
+ * when it is asked to stop and ends the remote process once the channel is
+ * closed. Hosts without inotifywait (or where it cannot watch the tree, e.g.
+ * out of inotify watches) are polled instead: the tree is walked every
+ * poll interval and compared with the previous walk.
+ *
+ * Hidden directories and the configured skipped directories are not
+ * reported. A directory that appears is walked once so files created in it
+ * before the host started watching it are not missed.
+ *
+ * Changes are handed to the callback on the watcher's own thread.
+ */
+class RemoteWatcher {
+public:
+    static constexpr int kHeartbeatSeconds = 1;
+    static constexpr int kRetrySeconds = 5;
+
+    using ChangesCallback = std::function<void(std::vector<FileChange> changes)>;
+
+    /**
+     * Start watching root.
+     * @param pollSeconds Interval of the polling fallback.
+     */
+    RemoteWatcher(const Filesystem& fs, const std::string& root, std::vector<std::string> skipDirectories,
+                  int pollSeconds, ChangesCallback onChanges);
+    ~RemoteWatcher();
+
+    RemoteWatcher(const RemoteWatcher&) = delete;
+    RemoteWatcher& operator=(const RemoteWatcher&) = delete;
+
+    bool isPolling() const { return m_polling.load(); }
+
+    /**
+     * Remote command streaming "<events>|<path>" lines and heartbeat blank lines.
+     * Exits with 127 if inotifywait is not installed.
+     */
+    static std::string WatchCommand(const std::string& root, const std::vector<std::string>& skipDirectories);
+
+    /**
+     * Parse one line of WatchCommand() output.
+     * @return false for heartbeats and events that are not changes.
+     */
+    static bool ParseEvent(std::string_view line, FileChange& change);
+
+    /**
+     * True unless path lies below root with no hidden or skipped component.
+     */
+    static bool IsIgnored(std::string_view root, std::string_view path,
+                          const std::vector<std::string>& skipDirectories);
+
+    /**
+     * True for a path component IsIgnored() rejects: hidden or skipped.
+     */
+    static bool IsIgnoredName(std::string_view name, const std::vector<std::string>& skipDirectories);
+
+    /**
+     * What a walk saw of one path, for the polling fallback.
+     */
+    struct Stamp {
+        int64_t modTime = 0;
+        int64_t size = -1;
+        bool isDirectory = false;
+
+        bool operator==(const Stamp& other) const {
+            return modTime == other.modTime && size == other.size && isDirectory == other.isDirectory;
+        }
+    };
+    using Snapshot = std::unordered_map<std::string, Stamp>;
+
+    /**
+     * Changes between two walks of the same tree, sorted by path.
+     */
+    static std::vector<FileChange> Diff(const Snapshot& before, const Snapshot& after);
+
+private:
+    Filesystem m_fs;
+    std::string m_root;
+    std::vector<std::string> m_skipDirectories;
+    int m_pollSeconds;
+    ChangesCallback m_onChanges;
+
+    std::atomic<bool> m_polling{false};
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopping = false;
+    std::thread m_thread;
+
+    void run();
+
+    /**
+     * Stream events until stopped or the stream ends.
+     * @return The stream's exit status; -1 if stopped.
+     */
+    int stream();
+    void poll();
+    bool takeSnapshot(Snapshot& snapshot) const;
+    void addDirectoryContents(const std::string& dir, std::vector<FileChange>& changes) const;
+
+    /**
+     * Sleep for the given time unless stopped first.
+     * @return false if stopped.
+     */
+    bool sleepFor(int seconds);
+    bool stopping() const;
+};
+
+} // namespace FS
+
+#endif // CHANGE_WATCHER_H
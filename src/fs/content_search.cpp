@@ -0,0 +1,319 @@
+#include "content_search.h"
+#include "file_view.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace FS {
+
+namespace {
+
+unsigned char foldAscii(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+}
+
+size_t workerCount(const ContentSearchOptions& options) {
+    size_t threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    return std::clamp<size_t>(threads, 1, 16);
+}
+
+bool isSkipped(const ContentSearchOptions& options, const std::string& name) {
+    return options.skipName && options.skipName(name);
+}
+
+} // namespace
+
+// --- LiteralMatcher ---
+
+LiteralMatcher::LiteralMatcher(std::string_view needle, bool caseSensitive)
+    : m_needle(needle), m_caseSensitive(caseSensitive) {
+    if (!m_caseSensitive) {
+        for (char& c : m_needle) {
+            c = static_cast<char>(foldAscii(static_cast<unsigned char>(c)));
+        }
+    }
+    if (!m_needle.empty()) {
+        m_first = static_cast<unsigned char>(m_needle[0]);
+        m_firstAlt = m_first;
+        if (!m_caseSensitive && m_first >= 'a' && m_first <= 'z') {
+            m_firstAlt = static_cast<unsigned char>(m_first - 'a' + 'A');
+        }
+    }
+}
+
+bool LiteralMatcher::matchesAt(const char* p) const {
+    size_t n = m_needle.size();
+    if (m_caseSensitive) {
+        return std::memcmp(p + 1, m_needle.data() + 1, n - 1) == 0;
+    }
+    for (size_t i = 1; i < n; ++i) {
+        if (foldAscii(static_cast<unsigned char>(p[i])) != static_cast<unsigned char>(m_needle[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const char* LiteralMatcher::find(const char* begin, const char* end) const {
+    size_t n = m_needle.size();
+    if (n == 0) return begin;
+    if (static_cast<size_t>(end - begin) < n) return nullptr;
+
+    // Last position a match can start at
+    const char* last = end - n;
+    auto scan = [last](const char* from, unsigned char c) -> const char* {
+        if (from > last) return nullptr;
+        return static_cast<const char*>(std::memchr(from, c, static_cast<size_t>(last - from) + 1));
+    };
+
+    if (m_first == m_firstAlt) {
+        for (const char* p = scan(begin, m_first); p; p = scan(p + 1, m_first)) {
+            if (matchesAt(p)) return p;
+        }
+        return nullptr;
+    }
+
+    // Follow both case variants of the first byte, always verifying the nearer one
+    const char* nextLower = scan(begin, m_first);
+    const char* nextUpper = scan(begin, m_firstAlt);
+    while (nextLower || nextUpper) {
+        bool useLower = !nextUpper || (nextLower && nextLower < nextUpper);
+        const char* p = useLower ? nextLower : nextUpper;
+        if (matchesAt(p)) return p;
+        if (useLower) {
+            nextLower = scan(p + 1, m_first);
+        } else {
+            nextUpper = scan(p + 1, m_firstAlt);
+        }
+    }
+    return nullptr;
+}
+
+// --- ContentSearch ---
+
+std::vector<std::string> ContentSearch::CollectFiles(const std::string& rootPath, const ContentSearchOptions& options) {
+    size_t threads = workerCount(options);
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::filesystem::path> pending{std::filesystem::path(rootPath)};
+    size_t busy = 0;
+    std::vector<std::string> files;
+
+    auto worker = [&]() {
+        std::vector<std::string> localFiles;
+        std::vector<std::filesystem::path> localDirs;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&] { return !pending.empty() || busy == 0; });
+            if (pending.empty()) {
+                return;  // Queue drained and nobody can add more
+            }
+            std::filesystem::path dir = std::move(pending.front());
+            pending.pop_front();
+            ++busy;
+            lock.unlock();
+
+            std::error_code ec;
+            std::filesystem::directory_iterator it(dir, std::filesystem::directory_options::skip_permission_denied, ec);
+            for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+                std::string name = it->path().filename().string();
+                if (isSkipped(options, name)) continue;
+
+                // Don't follow directory symlinks; they can form cycles
+                std::error_code statEc;
+                auto status = it->symlink_status(statEc);
+                if (statEc) continue;
+                if (std::filesystem::is_directory(status)) {
+                    localDirs.push_back(it->path());
+                } else if (std::filesystem::is_regular_file(it->status(statEc)) &&
+                           ContentSearch::WildcardMatch(options.filePattern, name)) {
+                    localFiles.push_back(it->path().string());
+                }
+            }
+
+            lock.lock();
+            files.insert(files.end(), std::make_move_iterator(localFiles.begin()),
+                         std::make_move_iterator(localFiles.end()));
+            for (auto& sub : localDirs) {
+                pending.push_back(std::move(sub));
+            }
+            localFiles.clear();
+            localDirs.clear();
+            --busy;
+            wake.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : workers) {
+        t.join();
+    }
+
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+ContentSearchResult ContentSearch::Run(const std::string& rootPath, const ContentSearchOptions& options) {
+    if (options.maxResults == 0) return {};
+    return Search(CollectFiles(rootPath, options), options);
+}
+
+ContentSearchResult ContentSearch::Search(const std::vector<std::string>& files, const ContentSearchOptions& options) {
+    ContentSearchResult result;
+    if (options.maxResults == 0) return result;
+
+    // One match past the limit tells a truncated result from one that is
+    // exactly maxResults long
+    const size_t wanted = options.maxResults < std::numeric_limits<size_t>::max() ? options.maxResults + 1
+                                                                                   : options.maxResults;
+    size_t threads = workerCount(options);
+    LiteralMatcher matcher(options.query, options.caseSensitive);
+
+    struct FileSlot {
+        std::vector<ContentMatch> matches;
+        bool done = false;
+    };
+    std::vector<FileSlot> slots(files.size());
+
+    // Files at or beyond `limit` can't contribute: everything before them
+    // already produced enough matches
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> limit{files.size()};
+    std::mutex frontierMutex;
+    size_t frontier = 0;
+    size_t frontierMatches = 0;
+
+    auto worker = [&]() {
+        std::vector<char> buffer;
+        while (true) {
+            size_t i = next.fetch_add(1);
+            if (i >= limit.load(std::memory_order_relaxed)) return;
+
+            FileView view(files[i], options.maxFileSize, buffer);
+            if (view.data() && !LooksBinary(view.data(), std::min(view.size(), kBinaryProbeSize))) {
+                SearchBuffer(view.data(), view.size(), matcher, files[i], wanted, slots[i].matches);
+            }
+
+            std::lock_guard<std::mutex> lock(frontierMutex);
+            slots[i].done = true;
+            while (frontier < slots.size() && slots[frontier].done && frontierMatches < wanted) {
+                frontierMatches += slots[frontier].matches.size();
+                ++frontier;
+            }
+            if (frontierMatches >= wanted) {
+                limit.store(frontier, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < std::min(threads, files.size()); ++t) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : workers) {
+        t.join();
+    }
+
+    for (size_t i = 0; i < slots.size() && result.matches.size() < wanted; ++i) {
+        if (!slots[i].done) break;
+        ++result.filesSearched;
+        for (auto& match : slots[i].matches) {
+            if (result.matches.size() >= wanted) break;
+            result.matches.push_back(std::move(match));
+        }
+    }
+    result.truncated = result.matches.size() > options.maxResults;
+    if (result.truncated) {
+        result.matches.resize(options.maxResults);
+    }
+    return result;
+}
+
+void ContentSearch::SearchBuffer(const char* data, size_t size, const LiteralMatcher& matcher,
+                                 const std::string& path, size_t maxMatches,
+                                 std::vector<ContentMatch>& out) {
+    const char* end = data + size;
+    const char* cursor = data;      // Newlines before here are counted
+    const char* lineStart = data;
+    int line = 1;
+    size_t found = 0;
+
+    while (found < maxMatches && cursor < end) {
+        const char* hit = matcher.find(cursor, end);
+        if (!hit || hit >= end) break;
+
+        while (const char* nl = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(hit - cursor)))) {
+            ++line;
+            lineStart = nl + 1;
+            cursor = nl + 1;
+        }
+
+        const char* lineEnd = static_cast<const char*>(std::memchr(hit, '\n', static_cast<size_t>(end - hit)));
+        if (!lineEnd) lineEnd = end;
+        const char* contentEnd = (lineEnd > lineStart && lineEnd[-1] == '\r') ? lineEnd - 1 : lineEnd;
+
+        ContentMatch match;
+        match.path = path;
+        match.line = line;
+        size_t offset = static_cast<size_t>(hit - lineStart);
+        match.column = static_cast<int>(offset + 1);
+
+        match.content = TrimLine(std::string_view(lineStart, static_cast<size_t>(contentEnd - lineStart)), offset);
+        out.push_back(std::move(match));
+        ++found;
+
+        // One match per line: continue on the next line
+        if (lineEnd == end) break;
+        ++line;
+        lineStart = lineEnd + 1;
+        cursor = lineEnd + 1;
+    }
+}
+
+std::string ContentSearch::TrimLine(std::string_view line, size_t offset) {
+    if (line.size() <= 200) {
+        return std::string(line);
+    }
+    size_t start = offset > 50 ? offset - 50 : 0;
+    return "..." + std::string(line.substr(start, 150)) + "...";
+}
+
+bool ContentSearch::LooksBinary(const char* data, size_t size) {
+    return std::memchr(data, '\0', size) != nullptr;
+}
+
+bool ContentSearch::WildcardMatch(std::string_view pattern, std::string_view name) {
+    // Iterative glob match with backtracking to the last '*'
+    size_t p = 0, n = 0;
+    size_t starP = std::string_view::npos, starN = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++p;
+            ++n;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            starP = p++;
+            starN = n;
+        } else if (starP != std::string_view::npos) {
+            p = starP + 1;
+            n = ++starN;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+
+} // namespace FS
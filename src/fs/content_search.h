@@ -0,0 +1,135 @@
+#ifndef CONTENT_SEARCH_H
+#define CONTENT_SEARCH_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FS {
+
+/**
+ * Literal substring matcher over raw bytes.
+ *
+ * Case-sensitive search is memchr on the first byte followed by memcmp. For
+ * case-insensitive search the needle is folded once and the haystack is
+ * scanned in place: the lower and upper case variants of the first byte are
+ * located with memchr and candidates are verified with an ASCII-folding
+ * compare, so no lowercased copy of the text is ever made.
+ */
+class LiteralMatcher {
+public:
+    LiteralMatcher(std::string_view needle, bool caseSensitive);
+
+    /**
+     * Find the first occurrence in [begin, end).
+     * @return Pointer to the match, or nullptr.
+     */
+    const char* find(const char* begin, const char* end) const;
+
+    size_t size() const { return m_needle.size(); }
+
+private:
+    std::string m_needle;   // Lowercased when case-insensitive
+    bool m_caseSensitive;
+    unsigned char m_first = 0;
+    unsigned char m_firstAlt = 0;   // Other case of the first byte, same as m_first if none
+
+    bool matchesAt(const char* p) const;
+};
+
+/**
+ * One matching line.
+ */
+struct ContentMatch {
+    std::string path;       // Full path of the file
+    int line = 0;           // 1-based
+    int column = 0;         // 1-based byte column of the match
+    std::string content;    // The line, trimmed around the match when long
+};
+
+/**
+ * Options for a content search.
+ */
+struct ContentSearchOptions {
+    std::string query;
+    bool caseSensitive = false;
+    std::string filePattern = "*";      // Wildcard (* and ?) applied to file names
+    size_t maxResults = 50;
+    size_t threads = 0;                 // Worker count, 0 for hardware concurrency
+    size_t maxFileSize = 16 * 1024 * 1024;  // Larger files are skipped
+
+    /**
+     * Entry names (files and directories) for which this returns true are
+     * not searched or descended into. Called from worker threads.
+     */
+    std::function<bool(const std::string& name)> skipName;
+};
+
+/**
+ * Result of a content search. Matches are in a stable order: files sorted by
+ * path, lines in file order, so results don't depend on thread scheduling.
+ */
+struct ContentSearchResult {
+    std::vector<ContentMatch> matches;
+    bool truncated = false;     // Stopped at maxResults
+    size_t filesSearched = 0;
+};
+
+/**
+ * Parallel grep engine behind fs_grep.
+ *
+ * The directory tree is walked by a pool of workers sharing a directory
+ * queue. The collected files are sorted and then scanned by the same number
+ * of workers, each file memory mapped (or read into a reused buffer when
+ * small) and searched with LiteralMatcher. Files with a NUL byte in their
+ * first block are treated as binary and skipped. Per-file results are merged
+ * in file order, and workers stop picking up files once the files before
+ * them already produced maxResults matches.
+ */
+class ContentSearch {
+public:
+    static ContentSearchResult Run(const std::string& rootPath, const ContentSearchOptions& options);
+
+    /**
+     * Search an already known list of files (e.g. index candidates), which
+     * must be sorted by path for results to come back in path order.
+     */
+    static ContentSearchResult Search(const std::vector<std::string>& files, const ContentSearchOptions& options);
+
+    /**
+     * Walk the tree in parallel and return the regular files whose names
+     * match options.filePattern, sorted by path.
+     */
+    static std::vector<std::string> CollectFiles(const std::string& rootPath, const ContentSearchOptions& options);
+
+    /**
+     * Search one in-memory buffer, appending up to maxMatches matches.
+     */
+    static void SearchBuffer(const char* data, size_t size, const LiteralMatcher& matcher,
+                             const std::string& path, size_t maxMatches,
+                             std::vector<ContentMatch>& out);
+
+    /**
+     * Line text for a match at byte `offset`; lines over 200 bytes are cut
+     * to 150 bytes around the match.
+     */
+    static std::string TrimLine(std::string_view line, size_t offset);
+
+    /**
+     * True if the block looks binary (contains a NUL byte).
+     */
+    static bool LooksBinary(const char* data, size_t size);
+
+    /**
+     * Match a file name against a wildcard pattern with * and ?.
+     */
+    static bool WildcardMatch(std::string_view pattern, std::string_view name);
+
+    static constexpr size_t kBinaryProbeSize = 8192;
+};
+
+} // namespace FS
+
+#endif // CONTENT_SEARCH_H
@@ -0,0 +1,119 @@
+#include "directory_lister.h"
+#include <algorithm>
+
+namespace FS {
+
+// --- Lifetime ---
+
+DirectoryLister::DirectoryLister() {
+    m_thread = std::thread([this] { run(); });
+}
+
+DirectoryLister::~DirectoryLister() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+DirectoryLister& DirectoryLister::Instance() {
+    static DirectoryLister instance;
+    return instance;
+}
+
+// --- Submission ---
+
+void DirectoryLister::list(const Filesystem& fs, const wxString& path, ProgressCallback onProgress,
+                           DoneCallback onDone, TransferToken cancel, bool includeHidden) {
+    Job job;
+    job.fs = fs;
+    job.path = std::string(path.ToUTF8().data());
+    job.includeHidden = includeHidden;
+    job.onProgress = std::move(onProgress);
+    job.onDone = std::move(onDone);
+    job.cancel = std::move(cancel);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(job));
+    }
+    m_wake.notify_one();
+}
+
+void DirectoryLister::Sort(std::vector<FileEntry>& entries) {
+    // Plain code point order, as wxTreeCtrl::OnCompareItems compares labels
+    std::sort(entries.begin(), entries.end(), [](const FileEntry& a, const FileEntry& b) {
+        return a.name.compare(b.name) < 0;
+    });
+}
+
+// --- Worker ---
+
+void DirectoryLister::run() {
+    for (;;) {
+        Job job;
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return;     // Stopping and drained
+            }
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+            stopping = m_stopping;
+        }
+
+        ListResult result;
+        if (stopping || job.cancel.isCancelled()) {
+            result.cancelled = true;
+            result.error = "Cancelled";
+        } else {
+            result = listDirectory(job);
+        }
+
+        if (job.onDone) {
+            job.onDone(result);
+        }
+    }
+}
+
+ListResult DirectoryLister::listDirectory(Job& job) {
+    ListResult result;
+    wxString path = wxString::FromUTF8(job.path);
+
+    WalkOptions options;
+    options.maxDepth = 1;
+    options.includeHidden = job.includeHidden;
+
+    bool ok = job.fs.walk(path, options, [&](const FileEntry& entry) {
+        if (job.cancel.isCancelled()) {
+            return false;
+        }
+        result.entries.push_back(entry);
+        if (job.onProgress && result.entries.size() % kProgressInterval == 0) {
+            job.onProgress(result.entries.size());
+        }
+        return true;
+    });
+
+    if (job.cancel.isCancelled()) {
+        result = ListResult();
+        result.cancelled = true;
+        result.error = "Cancelled";
+        return result;
+    }
+    if (!ok) {
+        result.error = "Could not list directory: " + path;
+        return result;
+    }
+
+    Sort(result.entries);
+    result.success = true;
+    return result;
+}
+
+} // namespace FS
@@ -0,0 +1,94 @@
+#ifndef DIRECTORY_LISTER_H
+#define DIRECTORY_LISTER_H
+
+#include "fs.h"
+#include "file_io.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace FS {
+
+/**
+ * Outcome of a directory listing.
+ */
+struct ListResult {
+    bool success = false;
+    bool cancelled = false;
+    wxString error;
+    std::vector<FileEntry> entries;     // Sorted by name
+};
+
+/**
+ * Background listing of a single directory level, local or remote.
+ *
+ * Listings go through Filesystem::walk, so a remote directory arrives as one
+ * streamed command over the shared RemoteSession with type, size and mtime
+ * per entry. The entries are sorted on the worker thread in the order
+ * wxTreeCtrl::SortChildren would use, so the UI only has to insert them.
+ *
+ * Listings run one at a time on their own worker thread, separate from
+ * FS::FileIO so expanding a directory never waits behind a large save. A
+ * listing whose token trips stops at the next entry.
+ *
+ * Callbacks run on the worker thread and must not block; UI code uses
+ * FS::TransferScope, which marshals them to the wx main thread.
+ */
+class DirectoryLister {
+public:
+    static constexpr size_t kProgressInterval = 1000;
+
+    using ProgressCallback = std::function<void(size_t entriesSoFar)>;
+    using DoneCallback = std::function<void(const ListResult& result)>;
+
+    DirectoryLister();
+    ~DirectoryLister();
+
+    DirectoryLister(const DirectoryLister&) = delete;
+    DirectoryLister& operator=(const DirectoryLister&) = delete;
+
+    /**
+     * Get the shared service.
+     */
+    static DirectoryLister& Instance();
+
+    /**
+     * Queue a listing of the directory's immediate children.
+     * @param onProgress Called every kProgressInterval entries; may be empty.
+     */
+    void list(const Filesystem& fs, const wxString& path, ProgressCallback onProgress,
+              DoneCallback onDone, TransferToken cancel = TransferToken(),
+              bool includeHidden = false);
+
+    /**
+     * Sort entries the way the file trees show them.
+     */
+    static void Sort(std::vector<FileEntry>& entries);
+
+private:
+    struct Job {
+        Filesystem fs;
+        std::string path;       // UTF-8
+        bool includeHidden = false;
+        ProgressCallback onProgress;
+        DoneCallback onDone;
+        TransferToken cancel;
+    };
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<Job> m_queue;
+    bool m_stopping = false;
+    std::thread m_thread;
+
+    void run();
+    static ListResult listDirectory(Job& job);
+};
+
+} // namespace FS
+
+#endif // DIRECTORY_LISTER_H
@@ -0,0 +1,335 @@
+#include "file_io.h"
+#include "remote_session.h"
+#include <wx/file.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace FS {
+
+namespace {
+
+/**
+ * Collects read data into chunks of FileIO::kChunkSize before handing them on.
+ */
+class ChunkSink {
+public:
+    ChunkSink(const FileIO::DataCallback& onData, TransferProgress& progress)
+        : m_onData(onData), m_progress(progress) {}
+
+    void add(const char* data, size_t size) {
+        m_progress.bytesDone += size;
+        m_pending.append(data, size);
+        if (m_pending.size() >= FileIO::kChunkSize) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (m_pending.empty()) return;
+        if (m_onData) {
+            m_onData(std::move(m_pending), m_progress);
+        }
+        m_pending = std::string();
+        m_pending.reserve(FileIO::kChunkSize);
+    }
+
+private:
+    const FileIO::DataCallback& m_onData;
+    TransferProgress& m_progress;
+    std::string m_pending;
+};
+
+} // namespace
+
+// --- Lifetime ---
+
+FileIO::FileIO() {
+    m_thread = std::thread([this] { run(); });
+}
+
+FileIO::~FileIO() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+FileIO& FileIO::Instance() {
+    static FileIO instance;
+    return instance;
+}
+
+// --- Submission ---
+
+void FileIO::read(const Filesystem& fs, const wxString& path, DataCallback onData,
+                  DoneCallback onDone, TransferToken cancel) {
+    Job job;
+    job.fs = fs;
+    job.path = std::string(path.ToUTF8().data());
+    job.onData = std::move(onData);
+    job.onDone = std::move(onDone);
+    job.cancel = std::move(cancel);
+    submit(std::move(job));
+}
+
+void FileIO::write(const Filesystem& fs, const wxString& path, std::string data,
+                   ProgressCallback onProgress, DoneCallback onDone, TransferToken cancel,
+                   std::shared_ptr<const DeltaSignature> base) {
+    Job job;
+    job.isWrite = true;
+    job.fs = fs;
+    job.path = std::string(path.ToUTF8().data());
+    job.data = std::move(data);
+    job.base = std::move(base);
+    job.onProgress = std::move(onProgress);
+    job.onDone = std::move(onDone);
+    job.cancel = std::move(cancel);
+    submit(std::move(job));
+}
+
+void FileIO::submit(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(job));
+    }
+    m_wake.notify_one();
+}
+
+// --- Worker ---
+
+void FileIO::run() {
+    for (;;) {
+        Job job;
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return;     // Stopping and drained
+            }
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+            stopping = m_stopping;
+        }
+
+        TransferResult result;
+        if (job.cancel.isCancelled() || (!job.isWrite && stopping)) {
+            result = cancelledResult();
+        } else if (job.isWrite) {
+            result = job.fs.isRemote() ? writeRemote(job) : writeLocal(job);
+        } else {
+            result = job.fs.isRemote() ? readRemote(job) : readLocal(job);
+        }
+
+        if (job.onDone) {
+            job.onDone(result);
+        }
+    }
+}
+
+TransferResult FileIO::cancelledResult() {
+    TransferResult result;
+    result.cancelled = true;
+    result.error = "Cancelled";
+    return result;
+}
+
+TransferResult FileIO::readLocal(Job& job) {
+    TransferResult result;
+    wxString path = wxString::FromUTF8(job.path);
+
+    wxFile file(path);
+    if (!file.IsOpened()) {
+        result.error = "Could not open file: " + path;
+        return result;
+    }
+
+    TransferProgress progress;
+    wxFileOffset length = file.Length();
+    progress.bytesTotal = (length == wxInvalidOffset) ? -1 : static_cast<int64_t>(length);
+
+    ChunkSink sink(job.onData, progress);
+    std::vector<char> buffer(64 * 1024);
+    for (;;) {
+        if (job.cancel.isCancelled()) {
+            return cancelledResult();
+        }
+        ssize_t n = file.Read(buffer.data(), buffer.size());
+        if (n == wxInvalidOffset) {
+            result.error = "Could not read file: " + path;
+            return result;
+        }
+        if (n == 0) {
+            break;
+        }
+        sink.add(buffer.data(), static_cast<size_t>(n));
+    }
+    sink.flush();
+
+    result.success = true;
+    result.bytes = progress.bytesDone;
+    return result;
+}
+
+TransferResult FileIO::readRemote(Job& job) {
+    TransferResult result;
+    auto session = job.fs.session();
+    if (!session || !job.fs.sshConfig().isValid()) {
+        result.error = "SSH not configured";
+        return result;
+    }
+
+    // The size comes first, on a line of its own, so progress has a total
+    std::string quoted = RemoteSession::shellQuote(job.path);
+    std::string command = "wc -c < " + quoted + " && exec cat " + quoted;
+
+    TransferProgress progress;
+    ChunkSink sink(job.onData, progress);
+    std::string header;
+    bool inHeader = true;
+    std::unique_ptr<DeltaSignature> signature;
+
+    int rc = session->runStreaming(command, [&](const char* data, size_t size) {
+        if (job.cancel.isCancelled()) {
+            return false;
+        }
+        if (inHeader) {
+            const char* newline = static_cast<const char*>(memchr(data, '\n', size));
+            if (!newline) {
+                header.append(data, size);
+                return true;
+            }
+            header.append(data, newline - data);
+            progress.bytesTotal = std::strtoll(header.c_str(), nullptr, 10);
+            signature = std::make_unique<DeltaSignature>(progress.bytesTotal);
+            inHeader = false;
+            size -= (newline + 1 - data);
+            data = newline + 1;
+        }
+        if (size > 0) {
+            signature->update(data, size);
+            sink.add(data, size);
+        }
+        return true;
+    });
+
+    if (job.cancel.isCancelled()) {
+        return cancelledResult();
+    }
+    if (rc == 255 || rc < 0) {
+        result.error = "Could not connect to remote host";
+        return result;
+    }
+    if (rc != 0) {
+        result.error = wxString::Format("Could not read remote file: %s (exit code: %d)",
+                                        wxString::FromUTF8(job.path), rc);
+        return result;
+    }
+    sink.flush();
+
+    if (signature) {
+        signature->finish();
+        result.signature = std::move(signature);
+    }
+    result.success = true;
+    result.bytes = progress.bytesDone;
+    return result;
+}
+
+TransferResult FileIO::writeLocal(Job& job) {
+    TransferResult result;
+    wxString path = wxString::FromUTF8(job.path);
+
+    wxFile file(path, wxFile::write);
+    if (!file.IsOpened()) {
+        result.error = "Could not open file for writing: " + path;
+        return result;
+    }
+
+    TransferProgress progress;
+    progress.bytesTotal = static_cast<int64_t>(job.data.size());
+    while (progress.bytesDone < job.data.size()) {
+        size_t chunk = std::min(kChunkSize, job.data.size() - static_cast<size_t>(progress.bytesDone));
+        if (file.Write(job.data.data() + progress.bytesDone, chunk) != chunk) {
+            result.error = "Error writing to file: " + path;
+            return result;
+        }
+        progress.bytesDone += chunk;
+        if (job.onProgress) {
+            job.onProgress(progress);
+        }
+    }
+
+    result.success = true;
+    result.bytes = progress.bytesDone;
+    return result;
+}
+
+TransferResult FileIO::writeRemote(Job& job) {
+    TransferResult result;
+    auto session = job.fs.session();
+    if (!session || !job.fs.sshConfig().isValid()) {
+        result.error = "SSH not configured";
+        return result;
+    }
+
+    result.usedDelta = writeRemoteDelta(job, *session);
+    if (!result.usedDelta) {
+        TransferProgress progress;
+        progress.bytesTotal = static_cast<int64_t>(job.data.size());
+        int rc = session->runWithInput(RemoteWrite::FullCommand(job.path, job.data), job.data,
+            [&](size_t written) {
+                progress.bytesDone = written;
+                if (job.onProgress) {
+                    job.onProgress(progress);
+                }
+            });
+        if (rc != 0) {
+            result.error = "Could not write remote file: " + wxString::FromUTF8(job.path);
+            return result;
+        }
+    }
+
+    result.signature = std::make_shared<const DeltaSignature>(DeltaSignature::Of(job.data));
+    result.success = true;
+    result.bytes = job.data.size();
+    return result;
+}
+
+bool FileIO::writeRemoteDelta(Job& job, RemoteSession& session) {
+    // Each copied range costs two processes on the host; past a few hundred
+    // ranges, or when most of the file changed, a full upload is cheaper
+    constexpr size_t kMaxOps = 256;
+
+    if (!job.base || job.data.size() < kMinDeltaSize) {
+        return false;
+    }
+    Delta delta = Delta::Compute(*job.base, job.data);
+    if (delta.ops.size() > kMaxOps || delta.literals.size() > job.data.size() / 2) {
+        return false;
+    }
+
+    TransferProgress progress;
+    progress.bytesTotal = static_cast<int64_t>(delta.literals.size());
+    int rc = session.runWithInput(RemoteWrite::PatchCommand(job.path, *job.base, delta, job.data),
+        delta.literals,
+        [&](size_t written) {
+            progress.bytesDone = written;
+            if (job.onProgress) {
+                job.onProgress(progress);
+            }
+        });
+    if (rc == RemoteWrite::kBaseMismatch) {
+        wxLogDebug("FileIO: %s changed on the host since it was read, uploading it whole",
+                   wxString::FromUTF8(job.path));
+    }
+    return rc == 0;
+}
+
+} // namespace FS
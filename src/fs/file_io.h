@@ -0,0 +1,148 @@
+#ifndef FILE_IO_H
+#define FILE_IO_H
+
+#include "fs.h"
+#include "remote_delta.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace FS {
+
+/**
+ * Cancellation flag for a file transfer.
+ * Copies share state, so keep one and hand a copy to FileIO.
+ */
+class TransferToken {
+public:
+    TransferToken() : m_cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() const { m_cancelled->store(true); }
+    bool isCancelled() const { return m_cancelled->load(); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+/**
+ * How far a transfer has got.
+ */
+struct TransferProgress {
+    uint64_t bytesDone = 0;
+    int64_t bytesTotal = -1;    // -1 if unknown
+};
+
+/**
+ * Outcome of a file transfer.
+ */
+struct TransferResult {
+    bool success = false;
+    bool cancelled = false;
+    wxString error;
+    uint64_t bytes = 0;         // Bytes read or written
+    
+    // Remote transfers only: signature of the file as it now is on the
+    // host, to pass as the base of the next write
+    std::shared_ptr<const DeltaSignature> signature;
+    bool usedDelta = false;     // The write sent only the changes
+};
+
+/**
+ * Background file transfers for local and remote filesystems.
+ *
+ * Reads hand the file's raw bytes (binary safe, no encoding conversion) to
+ * the caller in chunks of up to kChunkSize as they arrive, so a large file
+ * is never held twice and the caller can show it while it loads. Remote
+ * reads stream `cat` over the filesystem's shared RemoteSession.
+ *
+ * Remote writes replace the file atomically (see FS::RemoteWrite). Given
+ * the signature of what the remote file held before, which remote reads
+ * and writes return, a write of a file of at least kMinDeltaSize sends only
+ * the bytes that changed and has the host rebuild the file from its old
+ * copy; if the remote file changed meanwhile it falls back to a full upload.
+ *
+ * Transfers run one at a time on a single worker thread, in submission
+ * order, so two saves of the same file always land in order. A read whose
+ * token trips stops between chunks. A write is only cancellable while it is
+ * queued; once started it runs to the end, so a cancelled save can never
+ * leave a truncated file behind. For the same reason, queued writes still
+ * run when the service shuts down while queued reads are dropped.
+ *
+ * Callbacks run on the worker thread and must not block; UI code uses
+ * FS::TransferScope, which marshals them to the wx main thread.
+ */
+class FileIO {
+public:
+    static constexpr size_t kChunkSize = 256 * 1024;
+    static constexpr size_t kMinDeltaSize = 64 * 1024;
+
+    using DataCallback = std::function<void(std::string chunk, const TransferProgress& progress)>;
+    using ProgressCallback = std::function<void(const TransferProgress& progress)>;
+    using DoneCallback = std::function<void(const TransferResult& result)>;
+
+    FileIO();
+    ~FileIO();
+
+    FileIO(const FileIO&) = delete;
+    FileIO& operator=(const FileIO&) = delete;
+
+    /**
+     * Get the shared service.
+     */
+    static FileIO& Instance();
+
+    /**
+     * Queue a read of the whole file.
+     * @param onData Receives the content chunk by chunk, in order.
+     */
+    void read(const Filesystem& fs, const wxString& path, DataCallback onData,
+              DoneCallback onDone, TransferToken cancel = TransferToken());
+
+    /**
+     * Queue a write replacing the file's content with data.
+     * @param base Signature of the remote file's current content, if known.
+     */
+    void write(const Filesystem& fs, const wxString& path, std::string data,
+               ProgressCallback onProgress, DoneCallback onDone,
+               TransferToken cancel = TransferToken(),
+               std::shared_ptr<const DeltaSignature> base = nullptr);
+
+private:
+    struct Job {
+        bool isWrite = false;
+        Filesystem fs;
+        std::string path;       // UTF-8
+        std::string data;       // Content to write
+        std::shared_ptr<const DeltaSignature> base;
+        DataCallback onData;
+        ProgressCallback onProgress;
+        DoneCallback onDone;
+        TransferToken cancel;
+    };
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<Job> m_queue;
+    bool m_stopping = false;
+    std::thread m_thread;
+
+    void submit(Job job);
+    void run();
+
+    static TransferResult readLocal(Job& job);
+    static TransferResult readRemote(Job& job);
+    static TransferResult writeLocal(Job& job);
+    static TransferResult writeRemote(Job& job);
+    static bool writeRemoteDelta(Job& job, RemoteSession& session);
+    static TransferResult cancelledResult();
+};
+
+} // namespace FS
+
+#endif // FILE_IO_H
@@ -0,0 +1,95 @@
+#ifndef FILE_VIEW_H
+#define FILE_VIEW_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace FS {
+
+/**
+ * Read-only view of a file's bytes. Large files are memory mapped; small
+ * ones are read into a per-thread buffer, which is cheaper than a mapping.
+ */
+class FileView {
+public:
+    static constexpr size_t kMapThreshold = 64 * 1024;
+
+    FileView(const std::string& path, size_t maxSize, std::vector<char>& buffer) {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return;
+        std::streamoff size = file.tellg();
+        if (size <= 0 || static_cast<size_t>(size) > maxSize) return;
+        buffer.resize(static_cast<size_t>(size));
+        file.seekg(0);
+        if (!file.read(buffer.data(), size)) return;
+        m_data = buffer.data();
+        m_size = buffer.size();
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+            static_cast<size_t>(st.st_size) > maxSize) {
+            ::close(fd);
+            return;
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+
+        if (size >= kMapThreshold) {
+            void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                ::madvise(mapped, size, MADV_SEQUENTIAL);
+                m_mapped = mapped;
+                m_data = static_cast<const char*>(mapped);
+                m_size = size;
+            }
+        } else {
+            buffer.resize(size);
+            size_t total = 0;
+            while (total < size) {
+                ssize_t n = ::read(fd, buffer.data() + total, size - total);
+                if (n <= 0) break;
+                total += static_cast<size_t>(n);
+            }
+            m_data = buffer.data();
+            m_size = total;
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~FileView() {
+#ifndef _WIN32
+        if (m_mapped) {
+            ::munmap(m_mapped, m_size);
+        }
+#endif
+    }
+
+    FileView(const FileView&) = delete;
+    FileView& operator=(const FileView&) = delete;
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    void* m_mapped = nullptr;
+};
+
+} // namespace FS
+
+#endif // FILE_VIEW_H
@@ -1,12 +1,114 @@
 #include "fs.h"
+#include "remote_session.h"
+#include "line_reader.h"
+#include "remote_delta.h"
 #include <wx/filename.h>
 #include <wx/dir.h>
 #include <wx/file.h>
 #include <wx/textfile.h>
-#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 namespace FS {
 
+// --- Walk stream parsing ---
+
+bool WalkStreamParser::feed(const char* data, size_t size) {
+    if (m_stopped) return false;
+    
+    size_t start = 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] != '\0') continue;
+        
+        bool keepGoing;
+        if (m_pending.empty()) {
+            keepGoing = parseRecord(data + start, i - start);
+        } else {
+            // Record straddles two chunks
+            m_pending.append(data + start, i - start);
+            keepGoing = parseRecord(m_pending.data(), m_pending.size());
+            m_pending.clear();
+        }
+        start = i + 1;
+        
+        if (!keepGoing) {
+            m_stopped = true;
+            return false;
+        }
+    }
+    
+    m_pending.append(data + start, size - start);
+    return true;
+}
+
+bool WalkStreamParser::parseRecord(const char* record, size_t size) {
+    // <type>\t<size>\t<mtime>\t<path>; the path itself may contain tabs
+    const char* end = record + size;
+    const char* fields[3];
+    const char* cursor = record;
+    for (int f = 0; f < 3; ++f) {
+        fields[f] = cursor;
+        const char* tab = static_cast<const char*>(memchr(cursor, '\t', end - cursor));
+        if (!tab) return true;  // Malformed record (e.g. stray output), skip it
+        cursor = tab + 1;
+    }
+    if (cursor >= end) return true;
+    
+    std::string path(cursor, end);
+    while (path.size() > 1 && path.back() == '/') {
+        path.pop_back();
+    }
+    size_t slash = path.rfind('/');
+    std::string name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+    
+    FileEntry entry;
+    entry.name = wxString::FromUTF8(name.data(), name.size());
+    entry.fullPath = wxString::FromUTF8(path.data(), path.size());
+    entry.isDirectory = (fields[0][0] == 'd');
+    entry.size = entry.isDirectory ? -1 : std::strtoll(fields[1], nullptr, 10);
+    entry.modTime = static_cast<time_t>(std::strtoll(fields[2], nullptr, 10));
+    
+    ++m_entryCount;
+    return m_onEntry(entry);
+}
+
+namespace {
+
+/**
+ * Build the remote find command for a subtree walk.
+ * @param portable Use only POSIX find/printf (for hosts without GNU find -printf).
+ *                 Size and mtime are then reported as unknown.
+ */
+std::string buildWalkCommand(const std::string& root, const WalkOptions& options, bool portable) {
+    std::string cmd = "find " + RemoteSession::shellQuote(root) + " -mindepth 1";
+    if (options.maxDepth >= 0) {
+        cmd += " -maxdepth " + std::to_string(options.maxDepth);
+    }
+    
+    if (!options.includeHidden) {
+        cmd += " \\( -name '.*' -prune \\) -o";
+    }
+    if (!options.skipDirectories.empty()) {
+        cmd += " \\( -type d \\(";
+        for (size_t i = 0; i < options.skipDirectories.size(); ++i) {
+            if (i > 0) cmd += " -o";
+            cmd += " -name " + RemoteSession::shellQuote(options.skipDirectories[i]);
+        }
+        cmd += " \\) -prune \\) -o";
+    }
+    
+    if (portable) {
+        cmd += " \\( -type d -exec printf 'd\\t-1\\t0\\t%s\\0' {} + \\)"
+               " -o -exec printf 'f\\t-1\\t0\\t%s\\0' {} +";
+    } else {
+        cmd += " -printf '%y\\t%s\\t%T@\\t%p\\0'";
+    }
+    return cmd;
+}
+
+} // namespace
+
 // --- Factory methods ---
 
 Filesystem Filesystem::Local(const wxString& rootPath) {
@@ -14,8 +116,22 @@ Filesystem Filesystem::Local(const wxString& rootPath) {
 }
 
 Filesystem Filesystem::Remote(const SshConfig& sshConfig, const wxString& remotePath) {
-    wxString expandedPath = wxString(sshConfig.expandRemotePath(remotePath.ToStdString()));
-    return Filesystem(true, expandedPath, sshConfig);
+    auto session = RemoteSession::Acquire(sshConfig);
+    
+    // Expand ~ over the shared session so the handshake is paid only once
+    wxString expandedPath = remotePath;
+    if (remotePath.StartsWith("~") && sshConfig.isValid()) {
+        auto result = session->run("eval echo " + remotePath.ToStdString());
+        std::string expanded = result.output;
+        while (!expanded.empty() && (expanded.back() == '\n' || expanded.back() == '\r')) {
+            expanded.pop_back();
+        }
+        if (result.ok() && !expanded.empty()) {
+            expandedPath = wxString::FromUTF8(expanded);
+        }
+    }
+    
+    return Filesystem(true, expandedPath, sshConfig, std::move(session));
 }
 
 Filesystem Filesystem::FromConfig() {
@@ -37,13 +153,19 @@ Filesystem::Filesystem()
 {
 }
 
-Filesystem::Filesystem(bool isRemote, const wxString& rootPath, const SshConfig& sshConfig)
+Filesystem::Filesystem(bool isRemote, const wxString& rootPath, const SshConfig& sshConfig,
+                       std::shared_ptr<RemoteSession> session)
     : m_isRemote(isRemote)
     , m_rootPath(rootPath)
     , m_sshConfig(sshConfig)
+    , m_session(std::move(session))
 {
 }
 
+std::string Filesystem::sshPrefix() const {
+    return m_session ? m_session->sshPrefix() : m_sshConfig.buildSshPrefix();
+}
+
 // --- Directory operations ---
 
 std::vector<FileEntry> Filesystem::listDirectory(const wxString& path, bool includeHidden) const {
@@ -97,70 +219,115 @@ std::vector<FileEntry> Filesystem::listDirectoryLocal(const wxString& path, bool
 std::vector<FileEntry> Filesystem::listDirectoryRemote(const wxString& path, bool includeHidden) const {
     std::vector<FileEntry> entries;
     
-    if (!m_sshConfig.isValid()) {
+    if (!m_session || !m_sshConfig.isValid()) {
         return entries;
     }
     
-    std::string sshPrefix = m_sshConfig.buildSshPrefix();
-    std::string cmd = sshPrefix + " \"ls -la '" + path.ToStdString() + "' 2>/dev/null\" 2>&1";
+    WalkOptions options;
+    options.maxDepth = 1;
+    options.includeHidden = includeHidden;
     
-    FILE* pipe = popen(cmd.c_str(), "r");
-    if (!pipe) {
-        return entries;
-    }
+    walkRemote(path, options, [&entries](const FileEntry& entry) {
+        entries.push_back(entry);
+        return true;
+    });
     
-    std::string output;
-    char buffer[4096];
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        output += buffer;
+    return entries;
+}
+
+bool Filesystem::walk(const wxString& path, const WalkOptions& options, const WalkCallback& onEntry) const {
+    if (m_isRemote) {
+        return walkRemote(path, options, onEntry);
     }
-    pclose(pipe);
-    
-    std::istringstream stream(output);
-    std::string line;
-    
-    while (std::getline(stream, line)) {
-        // Skip total line and empty lines
-        if (line.empty() || line.find("total") == 0) continue;
-        
-        // Parse ls -la output
-        std::istringstream lineStream(line);
-        std::string permissions, links, owner, group, sizeStr, month, day, timeStr, name;
-        lineStream >> permissions >> links >> owner >> group >> sizeStr >> month >> day >> timeStr;
-        std::getline(lineStream, name);
-        
-        // Trim leading whitespace from name
-        size_t start = name.find_first_not_of(" \t");
-        if (start != std::string::npos) {
-            name = name.substr(start);
+    bool stopped = false;
+    return walkLocal(path, options, onEntry, 1, stopped);
+}
+
+bool Filesystem::walkLocal(const wxString& path, const WalkOptions& options, const WalkCallback& onEntry,
+                           int depth, bool& stopped) const {
+    std::vector<wxString> subdirs;
+    {
+        wxDir dir(path);
+        if (!dir.IsOpened()) {
+            return false;
         }
         
-        // Skip . and ..
-        if (name.empty() || name == "." || name == "..") continue;
-        
-        // Skip hidden files unless requested
-        if (!includeHidden && !name.empty() && name[0] == '.') continue;
-        
-        wxString fullPath = path;
-        if (!fullPath.EndsWith("/")) fullPath += "/";
-        fullPath += wxString(name);
+        wxString filename;
+        bool cont = dir.GetFirst(&filename);
         
-        FileEntry entry;
-        entry.name = wxString(name);
-        entry.fullPath = fullPath;
-        entry.isDirectory = !permissions.empty() && permissions[0] == 'd';
-        
-        // Parse size
-        try {
-            entry.size = std::stoll(sizeStr);
-        } catch (...) {
-            entry.size = -1;
+        while (cont && !stopped) {
+            if (!options.includeHidden && filename.StartsWith(".")) {
+                cont = dir.GetNext(&filename);
+                continue;
+            }
+            
+            wxString fullPath = path;
+            if (!fullPath.EndsWith("/") && !fullPath.EndsWith("\\")) {
+                fullPath += wxFileName::GetPathSeparator();
+            }
+            fullPath += filename;
+            
+            FileEntry entry(filename, fullPath, wxDir::Exists(fullPath));
+            entry.modTime = wxFileModificationTime(fullPath);
+            if (!entry.isDirectory) {
+                wxULongLong size = wxFileName::GetSize(fullPath);
+                entry.size = (size == wxInvalidSize) ? -1 : static_cast<int64_t>(size.GetValue());
+            }
+            
+            if (!onEntry(entry)) {
+                stopped = true;
+                break;
+            }
+            
+            if (entry.isDirectory) {
+                std::string name = filename.ToStdString();
+                bool skip = std::find(options.skipDirectories.begin(), options.skipDirectories.end(), name)
+                            != options.skipDirectories.end();
+                if (!skip) {
+                    subdirs.push_back(fullPath);
+                }
+            }
+            cont = dir.GetNext(&filename);
         }
-        
-        entries.push_back(entry);
     }
     
-    return entries;
+    // Descend once this level's wxDir is closed, so a deep tree holds only
+    // one directory handle open at a time
+    if (options.maxDepth < 0 || depth < options.maxDepth) {
+        for (const auto& subdir : subdirs) {
+            if (stopped) break;
+            walkLocal(subdir, options, onEntry, depth + 1, stopped);
+        }
+    }
+    
+    return true;
+}
+
+bool Filesystem::walkRemote(const wxString& path, const WalkOptions& options, const WalkCallback& onEntry) const {
+    if (!m_session || !m_sshConfig.isValid()) {
+        return false;
+    }
+    
+    std::string root = path.ToStdString();
+    
+    WalkStreamParser parser(onEntry);
+    int rc = m_session->runStreaming(buildWalkCommand(root, options, false),
+        [&parser](const char* data, size_t size) { return parser.feed(data, size); });
+    
+    if (parser.stopped()) {
+        return true;
+    }
+    
+    // GNU find exits non-zero for unreadable subdirectories while still
+    // producing output. Only an empty, failed run means -printf is missing.
+    if (rc != 0 && parser.entryCount() == 0) {
+        WalkStreamParser fallback(onEntry);
+        rc = m_session->runStreaming(buildWalkCommand(root, options, true),
+            [&fallback](const char* data, size_t size) { return fallback.feed(data, size); });
+        return rc == 0 || fallback.entryCount() > 0;
+    }
+    
+    return true;
 }
 
 bool Filesystem::isDirectory(const wxString& path) const {
@@ -176,14 +343,11 @@ bool Filesystem::isDirectoryLocal(const wxString& path) const {
 }
 
 bool Filesystem::isDirectoryRemote(const wxString& path) const {
-    if (!m_sshConfig.isValid()) {
+    if (!m_session || !m_sshConfig.isValid()) {
         return false;
     }
     
-    std::string sshPrefix = m_sshConfig.buildSshPrefix();
-    std::string cmd = sshPrefix + " \"test -d \\\"" + path.ToStdString() + "\\\"\" 2>&1";
-    int result = system(cmd.c_str());
-    return result == 0;
+    return m_session->status("test -d " + RemoteSession::shellQuote(path.ToStdString())) == 0;
 }
 
 bool Filesystem::exists(const wxString& path) const {
@@ -199,14 +363,11 @@ bool Filesystem::existsLocal(const wxString& path) const {
 }
 
 bool Filesystem::existsRemote(const wxString& path) const {
-    if (!m_sshConfig.isValid()) {
+    if (!m_session || !m_sshConfig.isValid()) {
         return false;
     }
     
-    std::string sshPrefix = m_sshConfig.buildSshPrefix();
-    std::string cmd = sshPrefix + " \"test -e \\\"" + path.ToStdString() + "\\\"\" 2>&1";
-    int result = system(cmd.c_str());
-    return result == 0;
+    return m_session->status("test -e " + RemoteSession::shellQuote(path.ToStdString())) == 0;
 }
 
 // --- File reading ---
@@ -234,61 +395,54 @@ ReadResult Filesystem::readFileLocal(const wxString& path) const {
 }
 
 ReadResult Filesystem::readFileRemote(const wxString& path) const {
-    if (!m_sshConfig.isValid()) {
+    if (!m_session || !m_sshConfig.isValid()) {
         return ReadResult::Error("SSH not configured");
     }
     
-    std::string sshPrefix = m_sshConfig.buildSshPrefix();
-    std::string cmd = sshPrefix + " \"cat \\\"" + path.ToStdString() + "\\\"\" 2>&1";
-    
-    FILE* pipe = popen(cmd.c_str(), "r");
-    if (!pipe) {
+    auto result = m_session->run("cat " + RemoteSession::shellQuote(path.ToStdString()));
+    if (result.exitCode == 255 || result.exitCode < 0) {
         return ReadResult::Error("Could not connect to remote host");
     }
-    
-    std::string content;
-    char buffer[4096];
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        content += buffer;
+    if (!result.ok()) {
+        return ReadResult::Error(wxString::Format("Could not read remote file: %s (exit code: %d)", path, result.exitCode));
     }
     
-    int status = pclose(pipe);
-    if (status != 0) {
-        return ReadResult::Error(wxString::Format("Could not read remote file: %s (exit code: %d)", path, status));
+    // Prefer UTF-8, fall back to the current locale for legacy encodings
+    wxString content = wxString::FromUTF8(result.output.data(), result.output.size());
+    if (content.IsEmpty() && !result.output.empty()) {
+        content = wxString(result.output);
     }
-    
-    return ReadResult::Success(wxString(content));
+    return ReadResult::Success(content);
 }
 
 ReadResult Filesystem::readFileLines(const wxString& path, int startLine, int endLine) const {
-    // Read the full file first
-    auto result = readFile(path);
-    if (!result.success) {
-        return result;
-    }
-    
-    // Split into lines and extract the requested range
-    wxArrayString lines = wxSplit(result.content, '\n');
-    
-    int totalLines = static_cast<int>(lines.GetCount());
-    
-    // Validate and adjust line numbers (1-indexed)
-    if (startLine < 1) startLine = 1;
-    if (endLine < 0 || endLine > totalLines) endLine = totalLines;
-    if (startLine > totalLines) {
-        return ReadResult::Success(wxEmptyString);
-    }
-    
-    // Extract the requested lines
-    wxString extracted;
-    for (int i = startLine - 1; i < endLine; ++i) {
-        if (i > startLine - 1) {
-            extracted += "\n";
+    std::string content;
+    if (m_isRemote) {
+        if (!m_session || !m_sshConfig.isValid()) {
+            return ReadResult::Error("SSH not configured");
+        }
+        auto result = m_session->run(LineReader::RemoteCommand(path.ToStdString(), startLine, endLine));
+        if (result.exitCode == 255 || result.exitCode < 0) {
+            return ReadResult::Error("Could not connect to remote host");
+        }
+        if (!result.ok()) {
+            return ReadResult::Error(wxString::Format("Could not read remote file: %s (exit code: %d)", path, result.exitCode));
+        }
+        content = LineReader::FromRemoteOutput(std::move(result.output), startLine).content;
+    } else {
+        auto range = LineReader::Instance().read(std::string(path.ToUTF8().data()), startLine, endLine);
+        if (!range.ok) {
+            return ReadResult::Error(wxString::FromUTF8(range.error));
         }
-        extracted += lines[i];
+        content = std::move(range.content);
     }
     
-    return ReadResult::Success(extracted);
+    // Prefer UTF-8, fall back to the current locale for legacy encodings
+    wxString text = wxString::FromUTF8(content.data(), content.size());
+    if (text.IsEmpty() && !content.empty()) {
+        text = wxString(content);
+    }
+    return ReadResult::Success(text);
 }
 
 // --- File writing ---
@@ -315,26 +469,16 @@ WriteResult Filesystem::writeFileLocal(const wxString& path, const wxString& con
 }
 
 WriteResult Filesystem::writeFileRemote(const wxString& path, const wxString& content) const {
-    if (!m_sshConfig.isValid()) {
+    if (!m_session || !m_sshConfig.isValid()) {
         return WriteResult::Error("SSH not configured");
     }
     
-    // Write content to a temp file, then scp it to remote
-    wxString tempPath = wxFileName::CreateTempFileName("bytemuse_");
-    {
-        wxFile tempFile(tempPath, wxFile::write);
-        if (!tempFile.IsOpened() || !tempFile.Write(content)) {
-            wxRemoveFile(tempPath);
-            return WriteResult::Error("Could not create temp file for remote write");
-        }
-    }
-    
-    std::string scpCmd = m_sshConfig.buildScpPrefix();
-    scpCmd += " \"" + tempPath.ToStdString() + "\" " + m_sshConfig.getHostSpec() + ":\"" + path.ToStdString() + "\"";
-    
-    int result = system(scpCmd.c_str());
-    wxRemoveFile(tempPath);
+    // Stream the content over the shared session into a temp file that
+    // replaces the target only once it has fully arrived
+    auto utf8 = content.utf8_str();
+    std::string data(utf8.data(), utf8.length());
     
+    int result = m_session->runWithInput(RemoteWrite::FullCommand(path.ToStdString(), data), data);
     if (result != 0) {
         return WriteResult::Error("Could not write remote file: " + path);
     }
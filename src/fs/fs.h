@@ -6,6 +6,7 @@
 #include <vector>
 #include <optional>
 #include <functional>
+#include <memory>
 #include "../config/config.h"
 
 #ifdef _WIN32
@@ -62,6 +63,50 @@ struct WriteResult {
     }
 };
 
+/**
+ * Options controlling a recursive directory walk.
+ */
+struct WalkOptions {
+    int maxDepth = -1;                          // Levels below the root to visit, -1 for unlimited
+    bool includeHidden = false;                 // Visit entries starting with '.'
+    std::vector<std::string> skipDirectories;   // Directory names that are not descended into
+};
+
+/**
+ * Callback invoked for every entry visited by a walk.
+ * Return false to stop the walk early.
+ */
+using WalkCallback = std::function<bool(const FileEntry& entry)>;
+
+/**
+ * Incremental parser for the remote walk stream.
+ *
+ * The remote side emits one NUL-terminated record per entry in the form
+ * "<type>\t<size>\t<mtime>\t<path>", where type is find's %y letter. Data can
+ * be fed in arbitrary chunks; complete records are reported as they arrive.
+ */
+class WalkStreamParser {
+public:
+    explicit WalkStreamParser(WalkCallback onEntry) : m_onEntry(std::move(onEntry)) {}
+    
+    /**
+     * Feed the next chunk of the stream.
+     * @return false once the callback asked to stop.
+     */
+    bool feed(const char* data, size_t size);
+    
+    size_t entryCount() const { return m_entryCount; }
+    bool stopped() const { return m_stopped; }
+
+private:
+    WalkCallback m_onEntry;
+    std::string m_pending;
+    size_t m_entryCount = 0;
+    bool m_stopped = false;
+    
+    bool parseRecord(const char* record, size_t size);
+};
+
 /**
  * SSH configuration for remote filesystem access.
  */
@@ -73,13 +118,21 @@ struct SshConfig {
     std::string identityFile;
     std::string extraOptions;
     int connectionTimeout = 30;
+    bool multiplex = true;      // Share one ControlMaster connection across commands
     
     /**
      * Build SSH command prefix for remote operations.
      */
     std::string buildSshPrefix() const {
         if (!enabled || host.empty()) return "";
-        
+        return buildSshOptions() + " " + getHostSpec();
+    }
+    
+    /**
+     * Build the ssh invocation with all options but without the destination,
+     * so callers can append further options (e.g. -O check) before the host.
+     */
+    std::string buildSshOptions() const {
         std::string cmd = "ssh";
         
         if (!extraOptions.empty()) {
@@ -97,12 +150,6 @@ struct SshConfig {
         cmd += " -o ConnectTimeout=" + std::to_string(connectionTimeout);
         cmd += " -o BatchMode=yes";
         
-        if (!user.empty()) {
-            cmd += " " + user + "@" + host;
-        } else {
-            cmd += " " + host;
-        }
-        
         return cmd;
     }
     
@@ -194,16 +241,20 @@ struct SshConfig {
         ssh.identityFile = config.GetString("ssh.identityFile", "").ToStdString();
         ssh.extraOptions = config.GetString("ssh.extraOptions", "").ToStdString();
         ssh.connectionTimeout = config.GetInt("ssh.connectionTimeout", 30);
+        ssh.multiplex = config.GetBool("ssh.multiplex", true);
         return ssh;
     }
 };
 
+class RemoteSession;
 
 /**
  * Unified filesystem interface for local and remote file operations.
  * 
  * This class provides a consistent API for working with files whether they
  * are on the local machine or on a remote server accessed via SSH.
+ * Remote instances (and their copies) share a persistent RemoteSession so
+ * individual operations do not pay for a new SSH handshake each time.
  */
 class Filesystem {
 public:
@@ -239,7 +290,12 @@ public:
     bool isRemote() const { return m_isRemote; }
     const wxString& rootPath() const { return m_rootPath; }
     const SshConfig& sshConfig() const { return m_sshConfig; }
-    std::string sshPrefix() const { return m_sshConfig.buildSshPrefix(); }
+    std::string sshPrefix() const;
+    
+    /**
+     * Shared SSH session used for remote operations (null for local filesystems).
+     */
+    std::shared_ptr<RemoteSession> session() const { return m_session; }
     
     // --- Directory operations ---
     
@@ -251,6 +307,20 @@ public:
      */
     std::vector<FileEntry> listDirectory(const wxString& path, bool includeHidden = false) const;
     
+    /**
+     * Recursively visit every entry below a directory.
+     * 
+     * Remote walks run as a single streamed command over the shared session
+     * (one round trip for the whole subtree) and report type, size and
+     * modification time for each entry.
+     * 
+     * @param path Root of the walk; the root itself is not reported.
+     * @param options Depth limit, hidden-file handling and pruned directories.
+     * @param onEntry Called for each entry; return false to stop.
+     * @return false if the walk could not be performed at all.
+     */
+    bool walk(const wxString& path, const WalkOptions& options, const WalkCallback& onEntry) const;
+    
     /**
      * Check if a path is a directory.
      */
@@ -270,6 +340,8 @@ public:
     
     /**
      * Read a specific range of lines from a file.
+     * Only the requested lines are read (see FS::LineReader); remote reads
+     * run sed on the host and transfer just the range.
      * @param path Path to the file.
      * @param startLine First line to read (1-indexed).
      * @param endLine Last line to read (1-indexed, inclusive). -1 for end of file.
@@ -314,15 +386,21 @@ private:
     bool m_isRemote;
     wxString m_rootPath;
     SshConfig m_sshConfig;
+    std::shared_ptr<RemoteSession> m_session;
     
     // Private constructor - use factory methods
-    Filesystem(bool isRemote, const wxString& rootPath, const SshConfig& sshConfig);
+    Filesystem(bool isRemote, const wxString& rootPath, const SshConfig& sshConfig,
+               std::shared_ptr<RemoteSession> session = nullptr);
     
     // --- Internal helpers ---
     
     std::vector<FileEntry> listDirectoryLocal(const wxString& path, bool includeHidden) const;
     std::vector<FileEntry> listDirectoryRemote(const wxString& path, bool includeHidden) const;
     
+    bool walkLocal(const wxString& path, const WalkOptions& options, const WalkCallback& onEntry,
+                   int depth, bool& stopped) const;
+    bool walkRemote(const wxString& path, const WalkOptions& options, const WalkCallback& onEntry) const;
+    
     ReadResult readFileLocal(const wxString& path) const;
     ReadResult readFileRemote(const wxString& path) const;
     
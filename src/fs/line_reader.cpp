@@ -0,0 +1,216 @@
+#include "line_reader.h"
+#include "file_view.h"
+#include "remote_session.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+
+namespace FS {
+
+namespace {
+
+const char* nextNewline(const char* p, const char* end) {
+    return static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+}
+
+int64_t countLines(const char* data, size_t size) {
+    int64_t lines = 0;
+    const char* p = data;
+    const char* end = data + size;
+    while (p < end) {
+        const char* nl = nextNewline(p, end);
+        ++lines;
+        if (!nl) break;
+        p = nl + 1;
+    }
+    return lines;
+}
+
+} // namespace
+
+// --- Index ---
+
+LineIndex LineIndex::Build(const char* data, size_t size) {
+    LineIndex index;
+    index.checkpoints.push_back(0);
+
+    const char* p = data;
+    const char* end = data + size;
+    while (p < end) {
+        const char* nl = nextNewline(p, end);
+        ++index.totalLines;
+        if (!nl) break;
+        p = nl + 1;
+        if (index.totalLines % kStride == 0 && p < end) {
+            index.checkpoints.push_back(static_cast<uint64_t>(p - data));
+        }
+    }
+    return index;
+}
+
+// --- Extraction ---
+
+LineRange LineReader::Extract(const char* data, size_t size, int startLine, int endLine,
+                              const LineIndex* index) {
+    LineRange range;
+    range.ok = true;
+    range.startLine = std::max(startLine, 1);
+    range.endLine = range.startLine - 1;
+
+    const char* p = data;
+    const char* end = data + size;
+    int64_t line = 1;
+
+    // Jump to the nearest checkpoint at or before the first line
+    if (index && !index->checkpoints.empty()) {
+        size_t checkpoint = std::min(static_cast<size_t>((range.startLine - 1) / LineIndex::kStride),
+                                     index->checkpoints.size() - 1);
+        if (index->checkpoints[checkpoint] <= size) {
+            p = data + index->checkpoints[checkpoint];
+            line = static_cast<int64_t>(checkpoint) * LineIndex::kStride + 1;
+        }
+    }
+
+    while (line < range.startLine && p < end) {
+        const char* nl = nextNewline(p, end);
+        p = nl ? nl + 1 : end;
+        ++line;
+    }
+
+    // The requested lines are one contiguous slice of the file
+    const char* begin = p;
+    const char* last = p;
+    int count = 0;
+    while (p < end && (endLine < 0 || line <= endLine)) {
+        const char* nl = nextNewline(p, end);
+        last = nl ? nl : end;
+        p = nl ? nl + 1 : end;
+        ++line;
+        ++count;
+    }
+    if (count > 0) {
+        range.content.assign(begin, last);
+        range.endLine = range.startLine + count - 1;
+    }
+
+    if (index) {
+        range.totalLines = index->totalLines;
+    } else {
+        range.totalLines = (line - 1) + countLines(p, static_cast<size_t>(end - p));
+    }
+    return range;
+}
+
+// --- Remote ---
+
+std::string LineReader::RemoteCommand(const std::string& path, int startLine, int endLine) {
+    std::string start = std::to_string(std::max(startLine, 1));
+    std::string script = (endLine < 0)
+        ? start + ",$p"
+        : start + "," + std::to_string(endLine) + "p;" + std::to_string(endLine) + "q";
+    return "sed -n '" + script + "' " + RemoteSession::shellQuote(path);
+}
+
+LineRange LineReader::FromRemoteOutput(std::string output, int startLine) {
+    LineRange range;
+    range.ok = true;
+    range.startLine = std::max(startLine, 1);
+    int64_t count = countLines(output.data(), output.size());
+    range.endLine = range.startLine + static_cast<int>(count) - 1;
+    if (!output.empty() && output.back() == '\n') {
+        output.pop_back();
+    }
+    range.content = std::move(output);
+    return range;
+}
+
+// --- Local files ---
+
+LineReader::LineReader(size_t maxCachedFiles) : m_maxCachedFiles(std::max<size_t>(maxCachedFiles, 1)) {}
+
+LineReader& LineReader::Instance() {
+    static LineReader instance;
+    return instance;
+}
+
+LineRange LineReader::read(const std::string& path, int startLine, int endLine) {
+    LineRange range;
+
+    std::error_code ec;
+    std::filesystem::path fsPath(path);
+    if (!std::filesystem::is_regular_file(fsPath, ec)) {
+        range.error = "Could not open file: " + path;
+        return range;
+    }
+    auto size = static_cast<int64_t>(std::filesystem::file_size(fsPath, ec));
+    if (ec) {
+        range.error = "Could not open file: " + path;
+        return range;
+    }
+    int64_t modTime = std::filesystem::last_write_time(fsPath, ec).time_since_epoch().count();
+
+    std::vector<char> buffer;
+    FileView view(path, std::numeric_limits<size_t>::max(), buffer);
+    if (!view.data()) {
+        if (size > 0) {
+            range.error = "Could not read file: " + path;
+            return range;
+        }
+        return Extract("", 0, startLine, endLine, nullptr);
+    }
+
+    std::shared_ptr<const LineIndex> index;
+    if (view.size() >= kIndexThreshold) {
+        index = cachedIndex(path, size, modTime);
+        if (!index) {
+            index = std::make_shared<const LineIndex>(LineIndex::Build(view.data(), view.size()));
+            store(path, size, modTime, index);
+        }
+    }
+    return Extract(view.data(), view.size(), startLine, endLine, index.get());
+}
+
+void LineReader::invalidate(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(path);
+    if (it != m_entries.end()) {
+        m_lru.erase(it->second);
+        m_entries.erase(it);
+    }
+}
+
+std::shared_ptr<const LineIndex> LineReader::cachedIndex(const std::string& path, int64_t size, int64_t modTime) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(path);
+    if (it == m_entries.end()) {
+        return nullptr;
+    }
+    if (it->second->size != size || it->second->modTime != modTime) {
+        // File changed since it was indexed
+        m_lru.erase(it->second);
+        m_entries.erase(it);
+        return nullptr;
+    }
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->index;
+}
+
+void LineReader::store(const std::string& path, int64_t size, int64_t modTime,
+                       std::shared_ptr<const LineIndex> index) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(path);
+    if (it != m_entries.end()) {
+        m_lru.erase(it->second);
+        m_entries.erase(it);
+    }
+    m_lru.push_front({path, size, modTime, std::move(index)});
+    m_entries[path] = m_lru.begin();
+
+    while (m_lru.size() > m_maxCachedFiles) {
+        m_entries.erase(m_lru.back().path);
+        m_lru.pop_back();
+    }
+}
+
+} // namespace FS
@@ -0,0 +1,115 @@
+#ifndef LINE_READER_H
+#define LINE_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace FS {
+
+/**
+ * A range of lines read from a file.
+ *
+ * Lines are separated by '\n'; a trailing newline does not start another
+ * line, and '\r' is kept as part of the line.
+ */
+struct LineRange {
+    bool ok = false;
+    std::string error;
+    std::string content;        // The lines joined with '\n', no trailing newline
+    int startLine = 0;          // First line returned (1-based)
+    int endLine = 0;            // Last line returned, startLine - 1 if none
+    int64_t totalLines = -1;    // Lines in the file, -1 if not known
+};
+
+/**
+ * Sparse line-start index of one file: the byte offset of every
+ * kStride-th line, so any line is at most kStride lines from a known offset.
+ */
+struct LineIndex {
+    static constexpr int kStride = 1024;
+
+    std::vector<uint64_t> checkpoints;  // checkpoints[i] is where line i * kStride + 1 starts
+    int64_t totalLines = 0;
+
+    static LineIndex Build(const char* data, size_t size);
+};
+
+/**
+ * Reads line ranges without loading or splitting the whole file.
+ *
+ * The file is memory mapped and newlines are found with memchr (vectorized
+ * in the C library), copying out only the requested lines. Files of at
+ * least kIndexThreshold bytes get a LineIndex on their first read, which is
+ * kept in a small LRU cache keyed by path and validated against the file's
+ * size and modification time; later reads of any range then start scanning
+ * from the nearest checkpoint, so paging through a large file costs
+ * O(range) per page instead of O(offset).
+ *
+ * Safe to use from several threads.
+ */
+class LineReader {
+public:
+    static constexpr size_t kIndexThreshold = 1024 * 1024;
+
+    explicit LineReader(size_t maxCachedFiles = 32);
+
+    /**
+     * Get the shared reader.
+     */
+    static LineReader& Instance();
+
+    /**
+     * Read lines [startLine, endLine] (1-based, inclusive) of a local file.
+     * @param endLine -1 to read to the end of the file.
+     */
+    LineRange read(const std::string& path, int startLine, int endLine);
+
+    /**
+     * Drop the cached index of a file.
+     */
+    void invalidate(const std::string& path);
+
+    /**
+     * Extract lines from an in-memory buffer, starting from the index when
+     * one is given. totalLines is counted if the buffer has no index.
+     */
+    static LineRange Extract(const char* data, size_t size, int startLine, int endLine,
+                             const LineIndex* index);
+
+    /**
+     * Remote command printing lines [startLine, endLine] of a file. sed
+     * quits after the last line, so the remote side never reads further.
+     */
+    static std::string RemoteCommand(const std::string& path, int startLine, int endLine);
+
+    /**
+     * Turn RemoteCommand output into a range (totalLines stays unknown).
+     */
+    static LineRange FromRemoteOutput(std::string output, int startLine);
+
+private:
+    struct CacheEntry {
+        std::string path;
+        int64_t size = 0;
+        int64_t modTime = 0;
+        std::shared_ptr<const LineIndex> index;
+    };
+
+    size_t m_maxCachedFiles;
+    std::mutex m_mutex;
+    std::list<CacheEntry> m_lru;    // Most recently used first
+    std::unordered_map<std::string, std::list<CacheEntry>::iterator> m_entries;
+
+    std::shared_ptr<const LineIndex> cachedIndex(const std::string& path, int64_t size, int64_t modTime);
+    void store(const std::string& path, int64_t size, int64_t modTime, std::shared_ptr<const LineIndex> index);
+};
+
+} // namespace FS
+
+#endif // LINE_READER_H
@@ -0,0 +1,298 @@
+#include "remote_delta.h"
+#include "remote_session.h"
+#include <algorithm>
+#include <cmath>
+
+namespace FS {
+
+namespace {
+
+constexpr size_t kMinBlockSize = 1024;
+constexpr size_t kMaxBlockSize = 64 * 1024;
+constexpr size_t kDefaultBlockSize = 4096;
+
+const uint32_t* crcTable() {
+    static uint32_t table[256];
+    static bool initialized = [] {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i << 24;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x80000000u) ? (crc << 1) ^ 0x04C11DB7u : (crc << 1);
+            }
+            table[i] = crc;
+        }
+        return true;
+    }();
+    (void)initialized;
+    return table;
+}
+
+uint32_t crcByte(uint32_t crc, unsigned char byte) {
+    return (crc << 8) ^ crcTable()[((crc >> 24) ^ byte) & 0xFF];
+}
+
+} // namespace
+
+// --- cksum ---
+
+void PosixChecksum::update(const char* data, size_t size) {
+    uint32_t crc = m_crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = crcByte(crc, static_cast<unsigned char>(data[i]));
+    }
+    m_crc = crc;
+    m_size += size;
+}
+
+std::string PosixChecksum::finish() const {
+    // The length goes in last, least significant byte first, without padding
+    uint32_t crc = m_crc;
+    for (uint64_t length = m_size; length != 0; length >>= 8) {
+        crc = crcByte(crc, static_cast<unsigned char>(length & 0xFF));
+    }
+    return std::to_string(~crc) + " " + std::to_string(m_size);
+}
+
+std::string PosixChecksum::Of(std::string_view data) {
+    PosixChecksum checksum;
+    checksum.update(data.data(), data.size());
+    return checksum.finish();
+}
+
+// --- Signature ---
+
+DeltaSignature::DeltaSignature(int64_t sizeHint) {
+    if (sizeHint < 0) {
+        m_blockSize = kDefaultBlockSize;
+    } else {
+        // About sqrt(size) like rsync: the signature and the literal overhead
+        // per changed spot grow at the same rate
+        auto root = static_cast<size_t>(std::sqrt(static_cast<double>(sizeHint)));
+        m_blockSize = std::clamp(root, kMinBlockSize, kMaxBlockSize);
+    }
+}
+
+uint32_t DeltaSignature::WeakChecksum(const char* data, size_t size) {
+    uint32_t a = 0;
+    uint32_t b = 0;
+    for (size_t i = 0; i < size; ++i) {
+        a += static_cast<unsigned char>(data[i]);
+        b += static_cast<uint32_t>(size - i) * static_cast<unsigned char>(data[i]);
+    }
+    return (a & 0xFFFF) | (b << 16);
+}
+
+uint64_t DeltaSignature::StrongHash(const char* data, size_t size) {
+    // FNV-1a; only ever compared after the weak checksums already agree,
+    // and the whole result is verified with cksum on the remote side
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void DeltaSignature::update(const char* data, size_t size) {
+    m_crc.update(data, size);
+    m_size += size;
+
+    if (!m_pending.empty()) {
+        size_t take = std::min(size, m_blockSize - m_pending.size());
+        m_pending.append(data, take);
+        data += take;
+        size -= take;
+        if (m_pending.size() < m_blockSize) {
+            return;
+        }
+        addBlock(m_pending.data(), m_pending.size());
+        m_pending.clear();
+    }
+    while (size >= m_blockSize) {
+        addBlock(data, m_blockSize);
+        data += m_blockSize;
+        size -= m_blockSize;
+    }
+    m_pending.assign(data, size);
+}
+
+void DeltaSignature::finish() {
+    // A short last block only ever matches at the end of the new content
+    if (!m_pending.empty()) {
+        m_blocks.push_back({WeakChecksum(m_pending.data(), m_pending.size()),
+                            StrongHash(m_pending.data(), m_pending.size())});
+        m_pending.clear();
+    }
+    m_checksum = m_crc.finish();
+}
+
+void DeltaSignature::addBlock(const char* data, size_t size) {
+    Block block{WeakChecksum(data, size), StrongHash(data, size)};
+    m_byWeak[block.weak].push_back(static_cast<uint32_t>(m_blocks.size()));
+    m_blocks.push_back(block);
+}
+
+const std::vector<uint32_t>* DeltaSignature::find(uint32_t weak) const {
+    auto it = m_byWeak.find(weak);
+    return it == m_byWeak.end() ? nullptr : &it->second;
+}
+
+DeltaSignature DeltaSignature::Of(std::string_view data) {
+    DeltaSignature signature(static_cast<int64_t>(data.size()));
+    signature.update(data.data(), data.size());
+    signature.finish();
+    return signature;
+}
+
+// --- Delta ---
+
+Delta Delta::Compute(const DeltaSignature& base, std::string_view target) {
+    Delta delta;
+    const size_t bs = base.blockSize();
+    const char* data = target.data();
+    const size_t size = target.size();
+
+    auto addLiteral = [&](size_t from, size_t to) {
+        if (from >= to) return;
+        delta.ops.push_back({false, delta.literals.size(), to - from});
+        delta.literals.append(data + from, to - from);
+    };
+    auto addCopy = [&](uint64_t offset, uint64_t length) {
+        if (!delta.ops.empty() && delta.ops.back().copy &&
+            delta.ops.back().offset + delta.ops.back().length == offset) {
+            delta.ops.back().length += length;
+        } else {
+            delta.ops.push_back({true, offset, length});
+        }
+    };
+
+    size_t literalStart = 0;
+    size_t pos = 0;
+    size_t fullBlocks = static_cast<size_t>(base.size() / bs);
+
+    if (fullBlocks > 0 && size >= bs) {
+        uint32_t a = 0;
+        uint32_t b = 0;
+        auto reset = [&](size_t at) {
+            uint32_t weak = DeltaSignature::WeakChecksum(data + at, bs);
+            a = weak & 0xFFFF;
+            b = weak >> 16;
+        };
+        reset(0);
+
+        while (pos + bs <= size) {
+            uint32_t weak = (a & 0xFFFF) | (b << 16);
+            bool matched = false;
+            if (const auto* candidates = base.find(weak)) {
+                uint64_t strong = DeltaSignature::StrongHash(data + pos, bs);
+                for (uint32_t index : *candidates) {
+                    if (index < fullBlocks && base.blocks()[index].strong == strong) {
+                        addLiteral(literalStart, pos);
+                        addCopy(static_cast<uint64_t>(index) * bs, bs);
+                        pos += bs;
+                        literalStart = pos;
+                        matched = true;
+                        break;
+                    }
+                }
+            }
+            if (matched) {
+                if (pos + bs <= size) {
+                    reset(pos);
+                }
+                continue;
+            }
+            if (pos + bs >= size) {
+                break;
+            }
+            // Roll the window one byte forward
+            auto out = static_cast<unsigned char>(data[pos]);
+            auto in = static_cast<unsigned char>(data[pos + bs]);
+            a = a - out + in;
+            b = b - static_cast<uint32_t>(bs) * out + (a & 0xFFFF);
+            ++pos;
+        }
+    }
+
+    // The old file's short last block can still match the end of the new one
+    size_t tail = static_cast<size_t>(base.size() % bs);
+    if (tail > 0 && size - literalStart >= tail &&
+        DeltaSignature::StrongHash(data + size - tail, tail) == base.blocks().back().strong) {
+        addLiteral(literalStart, size - tail);
+        addCopy(base.size() - tail, tail);
+    } else {
+        addLiteral(literalStart, size);
+    }
+    return delta;
+}
+
+// --- Remote scripts ---
+
+namespace {
+
+/**
+ * Script lines shared by both writes: set up the temp file, and after the
+ * content is in place check it and rename it over the target.
+ */
+std::string scriptHead(const std::string& path) {
+    return "f=" + RemoteSession::shellQuote(path) + "\n"
+           // Write through a symlink instead of replacing it; plain readlink
+           // where -f is missing (older BSDs) resolves one level
+           "if [ -L \"$f\" ]; then\n"
+           "  l=$(readlink -f \"$f\" 2>/dev/null) || {\n"
+           "    l=$(readlink \"$f\") || exit 1\n"
+           "    case $l in /*) ;; *) l=$(dirname \"$f\")/$l ;; esac\n"
+           "  }\n"
+           "  f=$l\n"
+           "fi\n"
+           "t=$(mktemp \"$f.XXXXXX\") || exit 1\n"
+           "trap 'rm -f \"$t\" \"$t.patch\"' EXIT\n";
+}
+
+std::string scriptTail(std::string_view target) {
+    return "[ \"$(cksum < \"$t\")\" = '" + PosixChecksum::Of(target) + "' ] || exit 1\n"
+           // Keep the target's permissions; mktemp creates files as 0600
+           "if [ -e \"$f\" ]; then\n"
+           "  m=$(stat -L -c %a \"$f\" 2>/dev/null || stat -L -f %Lp \"$f\" 2>/dev/null)\n"
+           "else\n"
+           "  m=$(printf '%o' $((0666 & ~0$(umask))))\n"
+           "fi\n"
+           "[ -z \"$m\" ] || chmod \"$m\" \"$t\"\n"
+           "mv -f \"$t\" \"$f\"\n";
+}
+
+std::string wrap(const std::string& script) {
+    // The login shell may not be POSIX (fish, csh)
+    return "sh -c " + RemoteSession::shellQuote(script);
+}
+
+} // namespace
+
+std::string RemoteWrite::FullCommand(const std::string& path, std::string_view content) {
+    return wrap(scriptHead(path) + "cat > \"$t\" || exit 1\n" + scriptTail(content));
+}
+
+std::string RemoteWrite::PatchCommand(const std::string& path, const DeltaSignature& base,
+                                      const Delta& delta, std::string_view target) {
+    std::string script = scriptHead(path);
+    script += "cat > \"$t.patch\" || exit 1\n";
+    script += "[ \"$(cksum < \"$f\")\" = '" + base.checksum() + "' ] || exit " +
+              std::to_string(kBaseMismatch) + "\n";
+
+    script += "{\n";
+    for (const auto& op : delta.ops) {
+        const char* source = op.copy ? "\"$f\"" : "\"$t.patch\"";
+        if (op.offset == 0) {
+            script += "head -c " + std::to_string(op.length) + " " + source + "\n";
+        } else {
+            script += "tail -c +" + std::to_string(op.offset + 1) + " " + source +
+                      " | head -c " + std::to_string(op.length) + "\n";
+        }
+    }
+    script += "} > \"$t\" || exit 1\n";
+
+    script += scriptTail(target);
+    return wrap(script);
+}
+
+} // namespace FS
@@ -0,0 +1,131 @@
+#ifndef REMOTE_DELTA_H
+#define REMOTE_DELTA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace FS {
+
+/**
+ * POSIX cksum (CRC-32 over the data and its length), formatted the way
+ * `cksum < file` prints it: "<crc> <size>".
+ */
+class PosixChecksum {
+public:
+    void update(const char* data, size_t size);
+    std::string finish() const;
+
+    static std::string Of(std::string_view data);
+
+private:
+    uint32_t m_crc = 0;
+    uint64_t m_size = 0;
+};
+
+/**
+ * rsync-style signature of a file's content: a weak rolling checksum and a
+ * strong hash per fixed-size block, plus the whole-file cksum. It is all
+ * that is needed to compute a delta against the file later, without
+ * keeping a copy of it (about 12 bytes per block).
+ *
+ * Built incrementally from chunks as the content streams by.
+ */
+class DeltaSignature {
+public:
+    struct Block {
+        uint32_t weak;
+        uint64_t strong;
+    };
+
+    /**
+     * @param sizeHint Expected total size, used to pick the block size; -1 if unknown.
+     */
+    explicit DeltaSignature(int64_t sizeHint = -1);
+
+    void update(const char* data, size_t size);
+
+    /**
+     * Call once after the last update().
+     */
+    void finish();
+
+    size_t blockSize() const { return m_blockSize; }
+    uint64_t size() const { return m_size; }
+    const std::string& checksum() const { return m_checksum; }
+    const std::vector<Block>& blocks() const { return m_blocks; }
+
+    /**
+     * Indexes of the blocks with the given weak checksum.
+     */
+    const std::vector<uint32_t>* find(uint32_t weak) const;
+
+    static DeltaSignature Of(std::string_view data);
+
+    static uint32_t WeakChecksum(const char* data, size_t size);
+    static uint64_t StrongHash(const char* data, size_t size);
+
+private:
+    size_t m_blockSize;
+    uint64_t m_size = 0;
+    std::string m_pending;      // Bytes of the current partial block
+    std::string m_checksum;
+    PosixChecksum m_crc;
+    std::vector<Block> m_blocks;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_byWeak;
+
+    void addBlock(const char* data, size_t size);
+};
+
+/**
+ * Instructions for turning the signed (old) content into new content:
+ * copies of ranges of the old file interleaved with literal bytes.
+ */
+struct Delta {
+    struct Op {
+        bool copy;          // Copy from the old file, else take from literals
+        uint64_t offset;    // Into the old file, or into literals
+        uint64_t length;
+    };
+
+    std::vector<Op> ops;
+    std::string literals;
+
+    /**
+     * Match new content against a signature of the old content.
+     */
+    static Delta Compute(const DeltaSignature& base, std::string_view target);
+};
+
+/**
+ * Shell scripts that replace a remote file atomically.
+ *
+ * Both write to a temporary file next to the target, check its cksum, give
+ * it the target's permissions and rename it over the target, so a dropped
+ * connection never leaves a truncated file. Both read their stdin first.
+ */
+class RemoteWrite {
+public:
+    /** Exit status of a patch whose base no longer matches the remote file. */
+    static constexpr int kBaseMismatch = 3;
+
+    /**
+     * Replace the file with the content fed on stdin.
+     */
+    static std::string FullCommand(const std::string& path, std::string_view content);
+
+    /**
+     * Rebuild the file from its current content and the delta's literals,
+     * which are fed on stdin. Exits with kBaseMismatch, leaving the file
+     * alone, if the remote file is not the one the delta was computed for.
+     */
+    static std::string PatchCommand(const std::string& path, const DeltaSignature& base,
+                                    const Delta& delta, std::string_view target);
+};
+
+} // namespace FS
+
+#endif // REMOTE_DELTA_H
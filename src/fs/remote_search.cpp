@@ -0,0 +1,131 @@
+#include "remote_search.h"
+#include "remote_session.h"
+#include <cctype>
+#include <cstring>
+
+namespace FS {
+
+// --- RemoteGrep ---
+
+std::string RemoteGrep::BuildCommand(const std::string& root, const ContentSearchOptions& options) {
+    const std::string quotedRoot = RemoteSession::shellQuote(root);
+    const std::string quotedQuery = RemoteSession::shellQuote(options.query);
+    const std::string quotedPattern = RemoteSession::shellQuote(options.filePattern.empty() ? "*" : options.filePattern);
+    const std::string maxCount = std::to_string(options.maxResults > 0 ? options.maxResults : 1);
+
+    // ripgrep skips dot entries by itself; --no-ignore keeps results in line
+    // with local searches, which don't read .gitignore
+    std::string rg = "rg --null --line-number --no-heading --color never --no-messages --no-ignore"
+                     " --fixed-strings " + std::string(options.caseSensitive ? "--case-sensitive" : "--ignore-case") +
+                     " --max-count " + maxCount + " --glob '!node_modules'";
+    if (!options.filePattern.empty() && options.filePattern != "*") {
+        rg += " --glob " + quotedPattern;
+    }
+    rg += " -e " + quotedQuery + " -- " + quotedRoot;
+
+    std::string gnuGrep = "grep -rnIZ -F" + std::string(options.caseSensitive ? "" : " -i") +
+                          " -m " + maxCount +
+                          // --include must come first: grep includes unmatched files unless the first filter is --include
+                          " --include=" + quotedPattern +
+                          " --exclude='.*' --exclude-dir='.*' --exclude-dir=node_modules" +
+                          " -e " + quotedQuery + " -- " + quotedRoot + " 2>/dev/null";
+
+    // /dev/null makes grep print the file name even for a single file
+    std::string portable = "find " + quotedRoot +
+                           " \\( -name '.*' ! -path " + quotedRoot + " -o -name node_modules \\) -prune"
+                           " -o -type f -name " + quotedPattern +
+                           " -exec grep -n -F" + std::string(options.caseSensitive ? "" : " -i") +
+                           " -e " + quotedQuery + " /dev/null {} + 2>/dev/null";
+
+    return "if command -v rg >/dev/null 2>&1; then " + rg +
+           "; elif grep --version 2>/dev/null | grep -q GNU; then " + gnuGrep +
+           "; else " + portable + "; fi";
+}
+
+// --- RemoteGrepParser ---
+
+RemoteGrepParser::RemoteGrepParser(const ContentSearchOptions& options, MatchCallback onMatch)
+    : m_matcher(options.query, options.caseSensitive), m_onMatch(std::move(onMatch)) {}
+
+bool RemoteGrepParser::feed(const char* data, size_t size) {
+    if (m_stopped) return false;
+
+    const char* end = data + size;
+    const char* cursor = data;
+    while (const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)))) {
+        bool keepGoing;
+        if (m_pending.empty()) {
+            keepGoing = parseLine(std::string_view(cursor, static_cast<size_t>(newline - cursor)));
+        } else {
+            m_pending.append(cursor, newline);
+            keepGoing = parseLine(m_pending);
+            m_pending.clear();
+        }
+        cursor = newline + 1;
+        if (!keepGoing) {
+            m_stopped = true;
+            return false;
+        }
+    }
+    m_pending.append(cursor, end);
+    return true;
+}
+
+bool RemoteGrepParser::finish() {
+    if (m_stopped || m_pending.empty()) return !m_stopped;
+    bool keepGoing = parseLine(m_pending);
+    m_pending.clear();
+    m_stopped = !keepGoing;
+    return keepGoing;
+}
+
+bool RemoteGrepParser::parseLine(std::string_view line) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+
+    std::string_view path;
+    std::string_view rest;
+    size_t nul = line.find('\0');
+    if (nul != std::string_view::npos) {
+        path = line.substr(0, nul);
+        rest = line.substr(nul + 1);
+    } else {
+        // "<path>:<line>:<text>": split at the first colon followed by digits and a colon
+        size_t colon = line.find(':');
+        while (colon != std::string_view::npos) {
+            size_t digits = colon + 1;
+            while (digits < line.size() && std::isdigit(static_cast<unsigned char>(line[digits]))) ++digits;
+            if (digits > colon + 1 && digits < line.size() && line[digits] == ':') break;
+            colon = line.find(':', colon + 1);
+        }
+        if (colon == std::string_view::npos) return true;
+        path = line.substr(0, colon);
+        rest = line.substr(colon + 1);
+    }
+
+    size_t digits = 0;
+    int lineNumber = 0;
+    while (digits < rest.size() && std::isdigit(static_cast<unsigned char>(rest[digits]))) {
+        lineNumber = lineNumber * 10 + (rest[digits] - '0');
+        ++digits;
+    }
+    if (digits == 0 || digits >= rest.size() || rest[digits] != ':' || path.empty()) {
+        return true;
+    }
+    std::string_view text = rest.substr(digits + 1);
+
+    const char* hit = m_matcher.find(text.data(), text.data() + text.size());
+    size_t offset = hit ? static_cast<size_t>(hit - text.data()) : 0;
+
+    ContentMatch match;
+    match.path = std::string(path);
+    match.line = lineNumber;
+    match.column = static_cast<int>(offset + 1);
+    match.content = ContentSearch::TrimLine(text, offset);
+
+    ++m_matchCount;
+    return m_onMatch(std::move(match));
+}
+
+} // namespace FS
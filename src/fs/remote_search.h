@@ -0,0 +1,70 @@
+#ifndef REMOTE_SEARCH_H
+#define REMOTE_SEARCH_H
+
+#include "content_search.h"
+#include <functional>
+#include <string>
+
+namespace FS {
+
+/**
+ * Content search executed on the remote host.
+ *
+ * The whole query is sent as one shell command that uses ripgrep when the
+ * host has it, GNU grep -r otherwise, and find + POSIX grep as a last
+ * resort. Its output is streamed back over the shared SSH session and
+ * parsed incrementally by RemoteGrepParser, so the caller can stop reading
+ * (and close the channel) as soon as it has enough matches.
+ */
+class RemoteGrep {
+public:
+    /**
+     * Build the remote command for a search under `root`. Uses query,
+     * caseSensitive, filePattern and maxResults (as a per-file cap) from
+     * the options. Dot entries and node_modules are skipped.
+     */
+    static std::string BuildCommand(const std::string& root, const ContentSearchOptions& options);
+};
+
+/**
+ * Incremental parser for RemoteGrep output.
+ *
+ * Each output line is one match: "<path>\0<line>:<text>" from rg --null and
+ * grep -Z, or "<path>:<line>:<text>" from the portable fallback (split at the
+ * first ":<digits>:"). Lines that match neither form, such as POSIX grep's
+ * "Binary file ... matches", are ignored. The column is found by searching
+ * the text locally.
+ */
+class RemoteGrepParser {
+public:
+    using MatchCallback = std::function<bool(ContentMatch&& match)>;
+
+    RemoteGrepParser(const ContentSearchOptions& options, MatchCallback onMatch);
+
+    /**
+     * Feed the next chunk of output.
+     * @return false once the callback asked to stop.
+     */
+    bool feed(const char* data, size_t size);
+
+    /**
+     * Parse a final line that had no trailing newline.
+     */
+    bool finish();
+
+    size_t matchCount() const { return m_matchCount; }
+    bool stopped() const { return m_stopped; }
+
+private:
+    LiteralMatcher m_matcher;
+    MatchCallback m_onMatch;
+    std::string m_pending;
+    size_t m_matchCount = 0;
+    bool m_stopped = false;
+
+    bool parseLine(std::string_view line);
+};
+
+} // namespace FS
+
+#endif // REMOTE_SEARCH_H
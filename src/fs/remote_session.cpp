@@ -0,0 +1,314 @@
+#include "remote_session.h"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#include <signal.h>
+#endif
+
+namespace FS {
+
+namespace {
+
+#ifdef _WIN32
+constexpr const char* kPipeRead = "rb";
+constexpr const char* kPipeWrite = "wb";
+constexpr const char* kDiscardOutput = " >NUL 2>&1";
+constexpr const char* kNoInput = " <NUL";
+constexpr const char* kDiscardErrors = " 2>NUL";
+#else
+constexpr const char* kPipeRead = "r";
+constexpr const char* kPipeWrite = "w";
+constexpr const char* kDiscardOutput = " >/dev/null 2>&1";
+constexpr const char* kNoInput = " </dev/null";
+constexpr const char* kDiscardErrors = " 2>/dev/null";
+#endif
+
+/**
+ * Convert a pclose()/system() status into a plain exit code.
+ */
+int toExitCode(int status) {
+#ifdef _WIN32
+    return status;
+#else
+    if (status == -1) return -1;
+    if (WIFEXITED(status)) return WEXITSTATUS(status);
+    return 255;
+#endif
+}
+
+std::mutex& sessionsMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+/**
+ * A registered session. The registry holds a strong reference so the master
+ * survives brief gaps between users (a one-off Filesystem, an MCP tool call).
+ */
+struct SessionEntry {
+    std::shared_ptr<RemoteSession> session;
+    std::chrono::steady_clock::time_point idleSince;   // Last seen without other users
+    bool idle = false;
+};
+
+std::map<std::string, SessionEntry>& sessions() {
+    static std::map<std::string, SessionEntry> map;
+    return map;
+}
+
+} // namespace
+
+// --- Lifetime ---
+
+std::shared_ptr<RemoteSession> RemoteSession::Acquire(const SshConfig& config) {
+    std::string key = config.buildSshPrefix() + (config.multiplex ? "|mux" : "");
+
+    // Expired sessions close their master (a blocking ssh -O exit) once the
+    // registry lock is released
+    std::vector<std::shared_ptr<RemoteSession>> expired;
+    std::shared_ptr<RemoteSession> session;
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex());
+        auto& map = sessions();
+        auto now = std::chrono::steady_clock::now();
+
+        for (auto it = map.begin(); it != map.end();) {
+            SessionEntry& entry = it->second;
+            if (it->first == key || entry.session.use_count() > 1) {
+                entry.idle = false;
+            } else if (!entry.idle) {
+                entry.idle = true;
+                entry.idleSince = now;
+            } else if (now - entry.idleSince >= kIdleTimeout) {
+                expired.push_back(std::move(entry.session));
+                it = map.erase(it);
+                continue;
+            }
+            ++it;
+        }
+
+        SessionEntry& entry = map[key];
+        if (!entry.session) {
+            entry.session.reset(new RemoteSession(config));
+        }
+        session = entry.session;
+    }
+    return session;
+}
+
+RemoteSession::RemoteSession(const SshConfig& config)
+    : m_config(config)
+#ifdef _WIN32
+    , m_multiplexed(false)
+#else
+    , m_multiplexed(config.multiplex)
+#endif
+{
+#ifndef _WIN32
+    // Unix socket paths are limited to ~104 bytes, so stay out of $TMPDIR
+    // (long on macOS). %C is ssh's hash of the connection parameters.
+    m_controlPath = "/tmp/bytemuse-" + std::to_string(getpid()) + "-%C";
+#endif
+}
+
+RemoteSession::~RemoteSession() {
+    closeMaster();
+}
+
+// --- Command building ---
+
+std::string RemoteSession::controlOptions() const {
+    if (!m_multiplexed) return "";
+    // ControlMaster=no: join the master if it is up, otherwise fall back to
+    // a direct connection rather than turning this command into a master.
+    return " -o ControlMaster=no -o ControlPath=" + shellQuote(m_controlPath);
+}
+
+std::string RemoteSession::sshPrefix() const {
+    if (!m_config.isValid()) return "";
+    return m_config.buildSshOptions() + controlOptions() + " " + m_config.getHostSpec();
+}
+
+std::string RemoteSession::scpPrefix() const {
+    if (!m_config.isValid()) return "";
+    return m_config.buildScpPrefix() + controlOptions();
+}
+
+std::string RemoteSession::buildCommand(const std::string& remoteCommand) const {
+    return sshPrefix() + " " + shellQuote(remoteCommand);
+}
+
+std::string RemoteSession::shellQuote(const std::string& value) {
+    std::string quoted = "'";
+    for (char c : value) {
+        if (c == '\'') {
+            quoted += "'\\''";
+        } else {
+            quoted += c;
+        }
+    }
+    quoted += "'";
+    return quoted;
+}
+
+// --- Master connection ---
+
+void RemoteSession::ensureMaster() const {
+    if (!m_multiplexed || !m_config.isValid()) return;
+
+    std::lock_guard<std::mutex> lock(m_masterMutex);
+    if (m_masterRunning) return;
+
+    std::string base = m_config.buildSshOptions() + " -o ControlPath=" + shellQuote(m_controlPath);
+    std::string host = " " + m_config.getHostSpec();
+
+    // Another session object (or a previous run of this one) may have left a
+    // master behind on the same socket
+    if (toExitCode(system((base + " -O check" + host + kDiscardOutput).c_str())) == 0) {
+        m_masterRunning = true;
+        return;
+    }
+
+    // -f returns once authentication succeeded, leaving the master in the background
+    std::string startCmd = base + " -o ControlMaster=yes -o ControlPersist=yes -N -f" + host +
+                           kNoInput + kDiscardOutput;
+    int rc = toExitCode(system(startCmd.c_str()));
+    m_masterRunning = (rc == 0);
+
+    if (!m_masterRunning) {
+        wxLogDebug("RemoteSession: could not start control master for %s (exit %d), "
+                   "falling back to per-command connections", m_config.getHostSpec().c_str(), rc);
+    }
+}
+
+void RemoteSession::noteResult(int exitCode) const {
+    // 255 is what ssh itself returns for connection failures
+    if (m_multiplexed && exitCode == 255) {
+        std::lock_guard<std::mutex> lock(m_masterMutex);
+        m_masterRunning = false;
+    }
+}
+
+void RemoteSession::closeMaster() {
+    if (!m_multiplexed) return;
+
+    std::lock_guard<std::mutex> lock(m_masterMutex);
+    if (!m_masterRunning) return;
+
+    std::string cmd = m_config.buildSshOptions() + " -o ControlPath=" + shellQuote(m_controlPath) +
+                      " -O exit " + m_config.getHostSpec() + kDiscardOutput;
+    system(cmd.c_str());
+    m_masterRunning = false;
+}
+
+// --- Command execution ---
+
+RemoteCommandResult RemoteSession::run(const std::string& remoteCommand) const {
+    RemoteCommandResult result;
+    result.exitCode = runStreaming(remoteCommand, [&result](const char* data, size_t size) {
+        result.output.append(data, size);
+        return true;
+    });
+    return result;
+}
+
+int RemoteSession::runStreaming(const std::string& remoteCommand,
+                                const std::function<bool(const char* data, size_t size)>& onData) const {
+    if (!m_config.isValid()) return -1;
+
+    ensureMaster();
+
+    std::string cmd = buildCommand(remoteCommand) + kDiscardErrors;
+    FILE* pipe = popen(cmd.c_str(), kPipeRead);
+    if (!pipe) return -1;
+
+    char buffer[65536];
+    for (;;) {
+#ifdef _WIN32
+        size_t n = fread(buffer, 1, sizeof(buffer), pipe);
+#else
+        // read() rather than fread() so chunks are delivered as soon as they
+        // arrive instead of waiting for a full buffer
+        ssize_t n = read(fileno(pipe), buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+#endif
+        if (n <= 0 || !onData(buffer, static_cast<size_t>(n))) {
+            break;
+        }
+    }
+
+    int exitCode = toExitCode(pclose(pipe));
+    noteResult(exitCode);
+    return exitCode;
+}
+
+int RemoteSession::status(const std::string& remoteCommand) const {
+    if (!m_config.isValid()) return -1;
+
+    ensureMaster();
+
+    std::string cmd = buildCommand(remoteCommand) + kNoInput + kDiscardOutput;
+    int exitCode = toExitCode(system(cmd.c_str()));
+    noteResult(exitCode);
+    return exitCode;
+}
+
+int RemoteSession::runWithInput(const std::string& remoteCommand, const std::string& input,
+                                const std::function<void(size_t written)>& onProgress) const {
+    if (!m_config.isValid()) return -1;
+
+    ensureMaster();
+
+    std::string cmd = buildCommand(remoteCommand) + kDiscardOutput;
+    FILE* pipe = popen(cmd.c_str(), kPipeWrite);
+    if (!pipe) return -1;
+
+#ifndef _WIN32
+    // If ssh exits early the write raises SIGPIPE, which would kill the app.
+    // Block it for this thread and swallow any pending instance afterwards.
+    sigset_t pipeMask, oldMask;
+    sigemptyset(&pipeMask);
+    sigaddset(&pipeMask, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeMask, &oldMask);
+#endif
+
+    constexpr size_t kChunkSize = 64 * 1024;
+    size_t written = 0;
+    while (written < input.size()) {
+        size_t chunk = std::min(kChunkSize, input.size() - written);
+        size_t n = fwrite(input.data() + written, 1, chunk, pipe);
+        written += n;
+        if (n != chunk) {
+            break;
+        }
+        if (onProgress) {
+            onProgress(written);
+        }
+    }
+    int exitCode = toExitCode(pclose(pipe));
+
+#ifndef _WIN32
+    sigset_t pending;
+    sigpending(&pending);
+    if (sigismember(&pending, SIGPIPE)) {
+        int sig;
+        sigwait(&pipeMask, &sig);
+    }
+    pthread_sigmask(SIG_SETMASK, &oldMask, nullptr);
+#endif
+    noteResult(exitCode);
+
+    if (written != input.size() && exitCode == 0) {
+        return -1;
+    }
+    return exitCode;
+}
+
+} // namespace FS
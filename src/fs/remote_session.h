@@ -0,0 +1,132 @@
+#ifndef REMOTE_SESSION_H
+#define REMOTE_SESSION_H
+
+#include "fs.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace FS {
+
+/**
+ * Result of running a command on the remote host.
+ */
+struct RemoteCommandResult {
+    int exitCode = -1;      // Remote exit status, 255 for ssh/connection errors
+    std::string output;     // Raw stdout bytes (binary safe)
+
+    bool ok() const { return exitCode == 0; }
+};
+
+/**
+ * Long-lived SSH session shared by all remote filesystem operations.
+ *
+ * Instead of paying a full TCP connect + key exchange for every stat, list
+ * or read, the session keeps an OpenSSH ControlMaster connection open in the
+ * background and every command is multiplexed over it as a new channel.
+ *
+ * Sessions are shared per SSH endpoint: every Filesystem (and every copy of
+ * one) pointing at the same host shares one master connection. The registry
+ * keeps a session alive after its last user lets go, so short-lived users
+ * don't each pay for a new handshake; it is closed once it has gone unused
+ * for kIdleTimeout (noticed on a later Acquire) or at shutdown.
+ *
+ * On platforms without ControlMaster support (Windows OpenSSH) the session
+ * degrades to one ssh process per command, matching the previous behaviour.
+ */
+class RemoteSession {
+public:
+    static constexpr std::chrono::minutes kIdleTimeout{10};
+
+    /**
+     * Get the shared session for the given SSH configuration, creating it if needed.
+     */
+    static std::shared_ptr<RemoteSession> Acquire(const SshConfig& config);
+
+    ~RemoteSession();
+
+    RemoteSession(const RemoteSession&) = delete;
+    RemoteSession& operator=(const RemoteSession&) = delete;
+
+    const SshConfig& config() const { return m_config; }
+    bool isMultiplexed() const { return m_multiplexed; }
+
+    /**
+     * SSH command prefix routed through the shared control connection.
+     * Append a (quoted) remote command to run it on the host.
+     */
+    std::string sshPrefix() const;
+
+    /**
+     * SCP command prefix routed through the shared control connection.
+     */
+    std::string scpPrefix() const;
+
+    /**
+     * Run a command on the remote host and capture its stdout.
+     * The command is interpreted by the remote login shell.
+     */
+    RemoteCommandResult run(const std::string& remoteCommand) const;
+
+    /**
+     * Run a command on the remote host and hand its stdout to the callback
+     * chunk by chunk as it arrives. Returning false from the callback stops
+     * reading and closes the channel early.
+     * @return The remote exit status.
+     */
+    int runStreaming(const std::string& remoteCommand,
+                     const std::function<bool(const char* data, size_t size)>& onData) const;
+
+    /**
+     * Run a command on the remote host and return its exit status only.
+     */
+    int status(const std::string& remoteCommand) const;
+
+    /**
+     * Run a command on the remote host, feeding the given bytes to its stdin.
+     * @param onProgress Called with the bytes written so far after each chunk.
+     * @return The remote exit status.
+     */
+    int runWithInput(const std::string& remoteCommand, const std::string& input,
+                     const std::function<void(size_t written)>& onProgress = nullptr) const;
+
+    /**
+     * Quote a string as a single POSIX shell word.
+     */
+    static std::string shellQuote(const std::string& value);
+
+private:
+    explicit RemoteSession(const SshConfig& config);
+
+    SshConfig m_config;
+    std::string m_controlPath;
+    bool m_multiplexed;
+
+    mutable std::mutex m_masterMutex;
+    mutable bool m_masterRunning = false;
+
+    /**
+     * Make sure the background master connection is up, starting it if needed.
+     */
+    void ensureMaster() const;
+
+    /**
+     * Forget the master after a connection-level failure so the next call
+     * re-establishes it.
+     */
+    void noteResult(int exitCode) const;
+
+    /**
+     * Ask the master connection to exit.
+     */
+    void closeMaster();
+
+    std::string controlOptions() const;
+    std::string buildCommand(const std::string& remoteCommand) const;
+};
+
+} // namespace FS
+
+#endif // REMOTE_SESSION_H
@@ -0,0 +1,155 @@
+#ifndef TRANSFER_SCOPE_H
+#define TRANSFER_SCOPE_H
+
+#include "file_io.h"
+#include "directory_lister.h"
+#include <wx/app.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace FS {
+
+/**
+ * Ties background file transfers and directory listings to a UI object.
+ *
+ * Transfers go through FS::FileIO, listings through FS::DirectoryLister,
+ * and their callbacks run on the wx main
+ * thread, in the order the worker produced them. Destroying the scope (or
+ * calling cancelAll()) cancels every transfer still in flight and
+ * guarantees none of their callbacks runs afterwards, so a widget can
+ * capture `this` without outliving checks. Use from the main thread only.
+ */
+class TransferScope {
+public:
+    TransferScope() : m_state(std::make_shared<State>()) {}
+    ~TransferScope() { cancelAll(); }
+
+    TransferScope(const TransferScope&) = delete;
+    TransferScope& operator=(const TransferScope&) = delete;
+
+    /**
+     * Start a read; cancel the returned token to stop it.
+     */
+    TransferToken read(const Filesystem& fs, const wxString& path,
+                       FileIO::DataCallback onData, FileIO::DoneCallback onDone) {
+        TransferToken token;
+        uint64_t id = track(token);
+        std::weak_ptr<State> weakState = m_state;
+
+        FileIO::Instance().read(fs, path,
+            [weakState, id, onData = std::move(onData)](std::string chunk, const TransferProgress& progress) {
+                if (!onData) return;
+                post(weakState, id, [onData, chunk = std::move(chunk), progress]() mutable {
+                    onData(std::move(chunk), progress);
+                });
+            },
+            finisher(id, std::move(onDone)), token);
+        return token;
+    }
+
+    /**
+     * Start a write; cancel the returned token to drop it while still queued.
+     * @param base Signature of the remote file's current content, if known.
+     */
+    TransferToken write(const Filesystem& fs, const wxString& path, std::string data,
+                        FileIO::ProgressCallback onProgress, FileIO::DoneCallback onDone,
+                        std::shared_ptr<const DeltaSignature> base = nullptr) {
+        TransferToken token;
+        uint64_t id = track(token);
+        std::weak_ptr<State> weakState = m_state;
+
+        FileIO::ProgressCallback progress;
+        if (onProgress) {
+            progress = [weakState, id, onProgress = std::move(onProgress)](const TransferProgress& p) {
+                post(weakState, id, [onProgress, p]() { onProgress(p); });
+            };
+        }
+        FileIO::Instance().write(fs, path, std::move(data), std::move(progress),
+                                 finisher(id, std::move(onDone)), token, std::move(base));
+        return token;
+    }
+
+    /**
+     * Start listing a directory; cancel the returned token to stop it.
+     */
+    TransferToken list(const Filesystem& fs, const wxString& path,
+                       DirectoryLister::ProgressCallback onProgress,
+                       DirectoryLister::DoneCallback onDone) {
+        TransferToken token;
+        uint64_t id = track(token);
+        std::weak_ptr<State> weakState = m_state;
+
+        DirectoryLister::ProgressCallback progress;
+        if (onProgress) {
+            progress = [weakState, id, onProgress = std::move(onProgress)](size_t count) {
+                post(weakState, id, [onProgress, count]() { onProgress(count); });
+            };
+        }
+        DirectoryLister::Instance().list(fs, path, std::move(progress),
+                                         finisher(id, std::move(onDone)), token);
+        return token;
+    }
+
+    /**
+     * Cancel all transfers in flight and drop their callbacks.
+     */
+    void cancelAll() {
+        for (auto& [id, token] : m_state->inFlight) {
+            token.cancel();
+        }
+        m_state->inFlight.clear();
+    }
+
+    bool hasPending() const { return !m_state->inFlight.empty(); }
+
+private:
+    struct State {
+        uint64_t nextId = 0;
+        std::unordered_map<uint64_t, TransferToken> inFlight;
+    };
+    std::shared_ptr<State> m_state;
+
+    uint64_t track(const TransferToken& token) {
+        uint64_t id = ++m_state->nextId;
+        m_state->inFlight.emplace(id, token);
+        return id;
+    }
+
+    /**
+     * Run fn on the main thread if the transfer is still wanted by then.
+     */
+    template <typename Fn>
+    static void post(const std::weak_ptr<State>& weakState, uint64_t id, Fn fn) {
+        // wxTheApp is null during shutdown
+        if (!wxTheApp) return;
+        wxTheApp->CallAfter([weakState, id, fn = std::move(fn)]() mutable {
+            auto state = weakState.lock();
+            if (state && state->inFlight.count(id)) {
+                fn();
+            }
+        });
+    }
+
+    template <typename Result>
+    std::function<void(const Result&)> finisher(uint64_t id, std::function<void(const Result&)> onDone) {
+        std::weak_ptr<State> weakState = m_state;
+        return [weakState, id, onDone = std::move(onDone)](const Result& result) {
+            if (!wxTheApp) return;
+            wxTheApp->CallAfter([weakState, id, onDone, result]() {
+                auto state = weakState.lock();
+                if (!state || state->inFlight.erase(id) == 0) {
+                    return;     // Scope gone or transfer cancelled
+                }
+                if (onDone) {
+                    onDone(result);
+                }
+            });
+        };
+    }
+};
+
+} // namespace FS
+
+#endif // TRANSFER_SCOPE_H
@@ -0,0 +1,282 @@
+#include "watch_service.h"
+#include "../config/config.h"
+#include <wx/filename.h>
+#include <algorithm>
+
+namespace FS {
+
+namespace {
+
+const int kLocalEvents = wxFSW_EVENT_CREATE | wxFSW_EVENT_DELETE | wxFSW_EVENT_RENAME | wxFSW_EVENT_MODIFY;
+
+std::string toPath(const wxString& path) {
+    std::string utf8 = path.ToUTF8().data();
+    while (utf8.size() > 1 && utf8.back() == '/') {
+        utf8.pop_back();
+    }
+    return utf8;
+}
+
+} // namespace
+
+WatchService& WatchService::Instance() {
+    static WatchService instance;
+    return instance;
+}
+
+WatchService::WatchService() {
+    Bind(wxEVT_FSWATCHER, &WatchService::OnLocalChange, this);
+    Bind(wxEVT_TIMER, &WatchService::OnTimer, this);
+    m_walker = std::thread([this] { RunWalks(); });
+}
+
+WatchService::~WatchService() {
+    Reset();
+    {
+        std::lock_guard<std::mutex> lock(m_walkMutex);
+        m_walkStopping = true;
+    }
+    m_walkWake.notify_all();
+    if (m_walker.joinable()) {
+        m_walker.join();
+    }
+}
+
+const std::vector<std::string>& WatchService::SkippedDirectories() {
+    // Build output and dependencies: churn nobody browses or indexes
+    static const std::vector<std::string> skipped = {
+        "node_modules", "build", "target", "__pycache__", "venv", "dist"
+    };
+    return skipped;
+}
+
+bool WatchService::IsSkippedName(std::string_view name) {
+    return RemoteWatcher::IsIgnoredName(name, SkippedDirectories());
+}
+
+void WatchService::Watch(const Filesystem& fs) {
+    Reset();
+    if (!Config::Instance().GetBool("watcher.enabled", true)) {
+        NotifyRoot();
+        return;
+    }
+
+    m_fs = fs;
+    m_root = toPath(fs.rootPath());
+    m_watching = true;
+    m_timer = std::make_unique<wxTimer>(this);
+
+    uint64_t generation = m_generation;
+    if (fs.isRemote()) {
+        int pollSeconds = Config::Instance().GetInt("watcher.pollInterval", 5);
+        m_remoteWatcher = std::make_unique<RemoteWatcher>(fs, m_root, SkippedDirectories(), pollSeconds,
+            [this, generation](std::vector<FileChange> changes) {
+                CallAfter([this, generation, changes = std::move(changes)]() {
+                    if (generation != m_generation) return;
+                    for (const auto& change : changes) {
+                        Add(change);
+                    }
+                });
+            });
+    } else {
+        // wxFileSystemWatcher needs a running event loop
+        CallAfter([this, generation]() {
+            if (generation == m_generation) {
+                StartLocal();
+            }
+        });
+    }
+    NotifyRoot();
+}
+
+void WatchService::Stop() {
+    Reset();
+    NotifyRoot();
+}
+
+void WatchService::Reset() {
+    ++m_generation;
+    m_watching = false;
+    m_root.clear();
+    m_remoteWatcher.reset();
+    m_localWatcher.reset();
+    m_timer.reset();
+    m_pending.take();
+}
+
+int WatchService::AddListener(Listener listener) {
+    int id = m_nextListenerId++;
+    m_listeners.push_back({id, std::move(listener), nullptr});
+    return id;
+}
+
+int WatchService::AddRootListener(RootListener listener) {
+    int id = m_nextListenerId++;
+    m_listeners.push_back({id, nullptr, std::move(listener)});
+    return id;
+}
+
+void WatchService::RemoveListener(int id) {
+    m_listeners.erase(std::remove_if(m_listeners.begin(), m_listeners.end(),
+                                     [id](const Entry& entry) { return entry.id == id; }),
+                      m_listeners.end());
+}
+
+// --- Local watching ---
+
+void WatchService::StartLocal() {
+    m_localWatcher = std::make_unique<wxFileSystemWatcher>();
+    m_localWatcher->SetOwner(this);
+    AddLocalWatches(m_fs.rootPath(), false);
+}
+
+void WatchService::AddLocalWatches(const wxString& dir, bool report) {
+    if (!m_localWatcher->Add(wxFileName::DirName(dir), kLocalEvents)) {
+        wxLogMessage("WatchService: Could not watch %s; external changes there will not show", dir);
+        return;
+    }
+
+    Walk walk;
+    walk.fs = m_fs;
+    walk.dir = dir.ToUTF8().data();
+    walk.report = report;
+    walk.generation = m_generation;
+    {
+        std::lock_guard<std::mutex> lock(m_walkMutex);
+        m_walks.push_back(std::move(walk));
+    }
+    m_walkWake.notify_one();
+}
+
+void WatchService::AddLocalBatch(uint64_t generation, bool report, const std::vector<FileEntry>& entries) {
+    if (generation != m_generation || !m_localWatcher) return;
+
+    for (const auto& entry : entries) {
+        if (entry.isDirectory) {
+            m_localWatcher->Add(wxFileName::DirName(entry.fullPath), kLocalEvents);
+        }
+        if (report) {
+            Add({FileChange::Kind::Created, toPath(entry.fullPath), entry.isDirectory});
+        }
+    }
+}
+
+void WatchService::RunWalks() {
+    for (;;) {
+        Walk walk;
+        {
+            std::unique_lock<std::mutex> lock(m_walkMutex);
+            m_walkWake.wait(lock, [this] { return m_walkStopping || !m_walks.empty(); });
+            if (m_walkStopping) {
+                return;
+            }
+            walk = std::move(m_walks.front());
+            m_walks.pop_front();
+        }
+
+        std::vector<FileEntry> batch;
+        auto flush = [&]() {
+            CallAfter([this, generation = walk.generation, report = walk.report, batch = std::move(batch)]() {
+                AddLocalBatch(generation, report, batch);
+            });
+            batch.clear();
+        };
+
+        WalkOptions options;
+        options.skipDirectories = SkippedDirectories();
+        walk.fs.walk(wxString::FromUTF8(walk.dir), options, [&](const FileEntry& entry) {
+            if (walk.generation != m_generation) {
+                return false;   // Watching something else now
+            }
+            if (entry.isDirectory || walk.report) {
+                batch.push_back(entry);
+                if (batch.size() >= kWatchBatch) {
+                    flush();
+                }
+            }
+            return true;
+        });
+        if (!batch.empty() && walk.generation == m_generation) {
+            flush();
+        }
+    }
+}
+
+void WatchService::AddLocalCreated(const wxString& path) {
+    FileChange change{FileChange::Kind::Created, toPath(path), wxDirExists(path)};
+    if (RemoteWatcher::IsIgnored(m_root, change.path, SkippedDirectories())) return;
+
+    Add(change);
+    if (change.isDirectory) {
+        // Files may have landed in it before its watch was added
+        AddLocalWatches(path, true);
+    }
+}
+
+void WatchService::OnLocalChange(wxFileSystemWatcherEvent& event) {
+    if (!m_localWatcher) return;
+
+    int type = event.GetChangeType();
+    if (type == wxFSW_EVENT_WARNING || type == wxFSW_EVENT_ERROR) {
+        wxLogMessage("WatchService: %s", event.GetErrorDescription());
+        return;
+    }
+
+    wxString path = event.GetPath().GetFullPath();
+    switch (type) {
+    case wxFSW_EVENT_CREATE:
+        AddLocalCreated(path);
+        break;
+    case wxFSW_EVENT_DELETE:
+        Add({FileChange::Kind::Deleted, toPath(path), false});
+        break;
+    case wxFSW_EVENT_RENAME:
+        Add({FileChange::Kind::Deleted, toPath(path), false});
+        AddLocalCreated(event.GetNewPath().GetFullPath());
+        break;
+    case wxFSW_EVENT_MODIFY:
+        // Directories report a modification whenever an entry changes
+        if (!wxDirExists(path)) {
+            Add({FileChange::Kind::Modified, toPath(path), false});
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// --- Delivery ---
+
+void WatchService::Add(const FileChange& change) {
+    if (!m_timer || RemoteWatcher::IsIgnored(m_root, change.path, SkippedDirectories())) {
+        return;
+    }
+    m_pending.add(change);
+    if (!m_timer->IsRunning()) {
+        m_timer->StartOnce(kCoalesceMs);
+    }
+}
+
+void WatchService::OnTimer(wxTimerEvent& event) {
+    std::vector<FileChange> changes = m_pending.take();
+    if (changes.empty()) return;
+
+    // Listeners may add or remove listeners
+    std::vector<Entry> listeners = m_listeners;
+    for (const auto& entry : listeners) {
+        if (entry.listener) {
+            entry.listener(changes);
+        }
+    }
+}
+
+void WatchService::NotifyRoot() {
+    std::vector<Entry> listeners = m_listeners;
+    for (const auto& entry : listeners) {
+        if (entry.rootListener) {
+            entry.rootListener(m_root);
+        }
+    }
+}
+
+} // namespace FS
@@ -0,0 +1,150 @@
+#ifndef WATCH_SERVICE_H
+#define WATCH_SERVICE_H
+
+#include "fs.h"
+#include "change_watcher.h"
+#include <wx/event.h>
+#include <wx/timer.h>
+#include <wx/fswatcher.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace FS {
+
+/**
+ * Publishes changes made outside the editor to the open folder.
+ *
+ * Local folders are watched with wxFileSystemWatcher (inotify on Linux),
+ * one watch per directory so build output and dependency trees are never
+ * watched. The directories are found on a worker thread and their watches
+ * added in batches of kWatchBatch, so opening a large folder or unpacking
+ * an archive into it doesn't stall the UI. Remote folders use an FS::RemoteWatcher over the shared
+ * RemoteSession, which falls back to polling on hosts without inotifywait.
+ *
+ * Raw events are coalesced for kCoalesceMs after the first one of a burst,
+ * so a git checkout touching thousands of files reaches listeners as a
+ * single batch with one change per path. Listeners run on the wx main
+ * thread and should update incrementally instead of rescanning.
+ *
+ * Use from the main thread only. Watching is off when watcher.enabled is
+ * false.
+ */
+class WatchService : public wxEvtHandler {
+public:
+    static constexpr int kCoalesceMs = 300;
+    static constexpr size_t kWatchBatch = 256;
+
+    using Listener = std::function<void(const std::vector<FileChange>& changes)>;
+    using RootListener = std::function<void(const std::string& root)>;
+
+    static WatchService& Instance();
+
+    /**
+     * Watch the filesystem's root folder, replacing any previous watch.
+     */
+    void Watch(const Filesystem& fs);
+
+    /**
+     * Stop watching and drop pending changes.
+     */
+    void Stop();
+
+    bool IsWatching() const { return m_watching; }
+
+    /**
+     * The watched folder (UTF-8, no trailing slash), empty when not watching.
+     */
+    const std::string& RootPath() const { return m_root; }
+
+    /**
+     * Register a listener for batches of changes.
+     * @return ID for RemoveListener().
+     */
+    int AddListener(Listener listener);
+
+    /**
+     * Register a listener for the watched folder, called after every Watch()
+     * and Stop() with RootPath(). Changes made before the call may never be
+     * reported, so state kept current by the change listeners is stale.
+     * @return ID for RemoveListener().
+     */
+    int AddRootListener(RootListener listener);
+    void RemoveListener(int id);
+
+    /**
+     * Directories that are never watched or reported.
+     */
+    static const std::vector<std::string>& SkippedDirectories();
+
+    /**
+     * Entry names whose changes are never reported: hidden entries and
+     * SkippedDirectories(). Anything kept current from the reported changes
+     * must leave out exactly these.
+     */
+    static bool IsSkippedName(std::string_view name);
+
+private:
+    WatchService();
+    ~WatchService() override;
+
+    struct Entry {
+        int id;
+        Listener listener;
+        RootListener rootListener;
+    };
+
+    struct Walk {
+        Filesystem fs;
+        std::string dir;            // UTF-8
+        bool report = false;
+        uint64_t generation = 0;
+    };
+
+    Filesystem m_fs;
+    std::string m_root;             // UTF-8, without a trailing slash
+    bool m_watching = false;
+    std::atomic<uint64_t> m_generation{0};  // Drops events and walks from an earlier Watch()
+    std::unique_ptr<wxFileSystemWatcher> m_localWatcher;
+    std::unique_ptr<RemoteWatcher> m_remoteWatcher;
+    std::unique_ptr<wxTimer> m_timer;
+    ChangeCoalescer m_pending;
+    std::vector<Entry> m_listeners;
+    int m_nextListenerId = 1;
+
+    // Walks of local directories, run in order on m_walker
+    std::mutex m_walkMutex;
+    std::condition_variable m_walkWake;
+    std::deque<Walk> m_walks;
+    bool m_walkStopping = false;
+    std::thread m_walker;
+
+    void Reset();
+    void NotifyRoot();
+    void StartLocal();
+
+    /**
+     * Watch dir, and the directories below it once the walker has found them.
+     * @param report Also report everything below dir as created.
+     */
+    void AddLocalWatches(const wxString& dir, bool report);
+    void AddLocalBatch(uint64_t generation, bool report, const std::vector<FileEntry>& entries);
+    void RunWalks();
+    void AddLocalCreated(const wxString& path);
+    void Add(const FileChange& change);
+
+    void OnLocalChange(wxFileSystemWatcherEvent& event);
+    void OnTimer(wxTimerEvent& event);
+};
+
+} // namespace FS
+
+#endif // WATCH_SERVICE_H
@@ -0,0 +1,469 @@
+#include "workspace_index.h"
+#include "content_search.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace FS {
+
+namespace {
+
+constexpr size_t kTrigramSpace = size_t(1) << 24;
+
+unsigned char foldAscii(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+}
+
+bool isSeparator(char c) {
+    return c == '/' || c == '\\';
+}
+
+} // namespace
+
+WorkspaceIndex::WorkspaceIndex(std::string rootPath, WorkspaceIndexOptions options)
+    : m_rootPath(std::move(rootPath)), m_options(std::move(options)) {
+    while (m_rootPath.size() > 1 && isSeparator(m_rootPath.back())) {
+        m_rootPath.pop_back();
+    }
+}
+
+WorkspaceIndex::~WorkspaceIndex() {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_stopping = true;
+    }
+    m_queueCond.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void WorkspaceIndex::start() {
+    if (m_started.exchange(true)) return;
+    m_thread = std::thread([this] { run(); });
+}
+
+bool WorkspaceIndex::waitUntilReady(std::chrono::milliseconds timeout) const {
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    return m_queueCond.wait_for(lock, timeout, [this] { return m_ready.load(); });
+}
+
+bool WorkspaceIndex::waitUntilIdle(std::chrono::milliseconds timeout) const {
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    return m_queueCond.wait_for(lock, timeout, [this] {
+        return m_ready.load() && m_pendingChanges.empty() && !m_applying;
+    });
+}
+
+void WorkspaceIndex::notifyChanged(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_pendingChanges.insert(path);
+    }
+    m_queueCond.notify_all();
+}
+
+// --- Background thread ---
+
+void WorkspaceIndex::run() {
+    build();
+
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    m_ready = true;
+    m_queueCond.notify_all();
+
+    while (!m_stopping) {
+        m_queueCond.wait(lock, [this] { return m_stopping || !m_pendingChanges.empty(); });
+        if (m_stopping) break;
+
+        // Let a burst of notifications (checkout, build output) settle first
+        m_queueCond.wait_for(lock, m_options.changeDelay, [this] { return m_stopping.load(); });
+        if (m_stopping) break;
+
+        std::vector<std::string> paths(m_pendingChanges.begin(), m_pendingChanges.end());
+        m_pendingChanges.clear();
+        m_applying = true;
+        lock.unlock();
+
+        applyChanges(std::move(paths));
+
+        lock.lock();
+        m_applying = false;
+        m_queueCond.notify_all();
+    }
+}
+
+void WorkspaceIndex::build() {
+    ContentSearchOptions walkOptions;
+    walkOptions.skipName = m_options.skipName;
+    walkOptions.threads = m_options.threads;
+    std::vector<std::string> files = ContentSearch::CollectFiles(m_rootPath, walkOptions);
+
+    std::vector<std::optional<Scan>> scans(files.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        std::vector<uint64_t> seen(kTrigramSpace / 64, 0);
+        for (size_t i = next.fetch_add(1); i < files.size() && !m_stopping; i = next.fetch_add(1)) {
+            scans[i] = scanFile(files[i], seen);
+        }
+    };
+
+    size_t threads = m_options.threads ? m_options.threads : std::thread::hardware_concurrency();
+    threads = std::clamp<size_t>(threads, 1, 16);
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < std::min(threads, files.size()); ++t) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : workers) {
+        t.join();
+    }
+
+    // Insert in path order so postings stay sorted by id
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    for (auto& scan : scans) {
+        if (scan) {
+            addEntry(std::move(*scan));
+        }
+    }
+    for (auto& [key, postings] : m_postings) {
+        postings.shrinkToFit();
+    }
+}
+
+void WorkspaceIndex::applyChanges(std::vector<std::string> paths) {
+    std::vector<uint64_t> seen(kTrigramSpace / 64, 0);
+
+    for (std::string& path : paths) {
+        while (path.size() > 1 && isSeparator(path.back())) {
+            path.pop_back();
+        }
+        if (!isUnder(path, m_rootPath) || path == m_rootPath || isSkippedPath(path)) {
+            continue;
+        }
+
+        std::error_code ec;
+        auto status = std::filesystem::symlink_status(path, ec);
+
+        if (!ec && std::filesystem::is_directory(status)) {
+            // Rescan the directory: re-read files whose stamp changed, drop vanished ones
+            ContentSearchOptions walkOptions;
+            walkOptions.skipName = m_options.skipName;
+            walkOptions.threads = 1;
+            std::vector<std::string> files = ContentSearch::CollectFiles(path, walkOptions);
+
+            std::vector<Scan> changed;
+            for (const auto& file : files) {
+                std::error_code statEc;
+                auto size = static_cast<int64_t>(std::filesystem::file_size(file, statEc));
+                auto modTime = std::filesystem::last_write_time(file, statEc).time_since_epoch().count();
+                {
+                    std::shared_lock<std::shared_mutex> lock(m_mutex);
+                    auto it = m_idByPath.find(file);
+                    if (it != m_idByPath.end() && m_entries[it->second].size == size &&
+                        m_entries[it->second].modTime == modTime) {
+                        continue;
+                    }
+                }
+                if (auto scan = scanFile(file, seen)) {
+                    changed.push_back(std::move(*scan));
+                }
+            }
+
+            std::unordered_set<std::string> present(files.begin(), files.end());
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            std::vector<uint32_t> vanished;
+            for (const auto& [filePath, id] : m_idByPath) {
+                if (isUnder(filePath, path) && !present.count(filePath)) {
+                    vanished.push_back(id);
+                }
+            }
+            for (uint32_t id : vanished) {
+                removeEntry(id);
+            }
+            for (auto& scan : changed) {
+                auto it = m_idByPath.find(scan.entry.path);
+                if (it != m_idByPath.end()) {
+                    removeEntry(it->second);
+                }
+                addEntry(std::move(scan));
+            }
+        } else if (!ec && std::filesystem::is_regular_file(std::filesystem::status(path, ec))) {
+            auto scan = scanFile(path, seen);
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            auto it = m_idByPath.find(path);
+            if (it != m_idByPath.end()) {
+                const Entry& existing = m_entries[it->second];
+                if (scan && existing.size == scan->entry.size && existing.modTime == scan->entry.modTime) {
+                    continue;
+                }
+                removeEntry(it->second);
+            }
+            if (scan) {
+                addEntry(std::move(*scan));
+            }
+        } else {
+            // Gone (or not something we index): drop it and anything below it
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            std::vector<uint32_t> removed;
+            for (const auto& [filePath, id] : m_idByPath) {
+                if (filePath == path || isUnder(filePath, path)) {
+                    removed.push_back(id);
+                }
+            }
+            for (uint32_t id : removed) {
+                removeEntry(id);
+            }
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    if (m_deadCount > 1024 && m_deadCount > m_idByPath.size() / 2) {
+        compact();
+    }
+}
+
+std::optional<WorkspaceIndex::Scan> WorkspaceIndex::scanFile(const std::string& path, std::vector<uint64_t>& seen) const {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) return std::nullopt;
+    auto modTime = std::filesystem::last_write_time(path, ec);
+    if (ec) return std::nullopt;
+
+    Scan scan;
+    scan.entry.path = path;
+    size_t slash = path.find_last_of("/\\");
+    scan.entry.nameOffset = slash == std::string::npos ? 0 : slash + 1;
+    scan.entry.size = static_cast<int64_t>(size);
+    scan.entry.modTime = static_cast<int64_t>(modTime.time_since_epoch().count());
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return std::nullopt;
+
+    bool indexContent = size <= m_options.maxIndexedFileSize;
+    std::string content(indexContent ? size : std::min<size_t>(size, ContentSearch::kBinaryProbeSize), '\0');
+    file.read(content.data(), static_cast<std::streamsize>(content.size()));
+    content.resize(static_cast<size_t>(file.gcount()));
+
+    scan.entry.text = !ContentSearch::LooksBinary(content.data(), std::min(content.size(), ContentSearch::kBinaryProbeSize));
+    if (!scan.entry.text || !indexContent) {
+        return scan;
+    }
+
+    // Distinct case-folded trigrams, deduplicated with a bitmap over the whole key space
+    for (size_t i = 0; i + 3 <= content.size(); ++i) {
+        auto a = foldAscii(static_cast<unsigned char>(content[i]));
+        auto b = foldAscii(static_cast<unsigned char>(content[i + 1]));
+        auto c = foldAscii(static_cast<unsigned char>(content[i + 2]));
+        if (a == '\n' || b == '\n' || c == '\n') continue;
+
+        uint32_t key = trigramKey(a, b, c);
+        uint64_t bit = uint64_t(1) << (key % 64);
+        if (!(seen[key / 64] & bit)) {
+            seen[key / 64] |= bit;
+            scan.trigrams.push_back(key);
+        }
+    }
+    for (uint32_t key : scan.trigrams) {
+        seen[key / 64] = 0;
+    }
+    scan.entry.indexed = true;
+    return scan;
+}
+
+bool WorkspaceIndex::isSkippedPath(const std::string& path) const {
+    if (!m_options.skipName) return false;
+
+    size_t pos = m_rootPath.size();
+    while (pos < path.size()) {
+        while (pos < path.size() && isSeparator(path[pos])) ++pos;
+        size_t end = pos;
+        while (end < path.size() && !isSeparator(path[end])) ++end;
+        if (end > pos && m_options.skipName(path.substr(pos, end - pos))) {
+            return true;
+        }
+        pos = end;
+    }
+    return false;
+}
+
+bool WorkspaceIndex::covers(const std::string& directory) const {
+    return (directory == m_rootPath || isUnder(directory, m_rootPath)) && !isSkippedPath(directory);
+}
+
+bool WorkspaceIndex::isUnder(const std::string& path, const std::string& directory) const {
+    if (path.size() <= directory.size() || path.compare(0, directory.size(), directory) != 0) {
+        return false;
+    }
+    return isSeparator(path[directory.size()]) || (!directory.empty() && isSeparator(directory.back()));
+}
+
+// --- Writers ---
+
+void WorkspaceIndex::addEntry(Scan&& scan) {
+    uint32_t id = static_cast<uint32_t>(m_entries.size());
+    m_idByPath[scan.entry.path] = id;
+    for (uint32_t key : scan.trigrams) {
+        m_postings[key].add(id);
+    }
+    if (scan.entry.text && !scan.entry.indexed) {
+        m_unindexed.push_back(id);
+    }
+    m_entries.push_back(std::move(scan.entry));
+}
+
+void WorkspaceIndex::removeEntry(uint32_t id) {
+    Entry& entry = m_entries[id];
+    if (!entry.alive) return;
+    m_idByPath.erase(entry.path);
+    entry.alive = false;
+    entry.path.clear();
+    entry.path.shrink_to_fit();
+    m_deadCount++;
+}
+
+void WorkspaceIndex::compact() {
+    auto isDead = [this](uint32_t id) { return !m_entries[id].alive; };
+    m_unindexed.erase(std::remove_if(m_unindexed.begin(), m_unindexed.end(), isDead), m_unindexed.end());
+    for (auto it = m_postings.begin(); it != m_postings.end();) {
+        PostingList live;
+        it->second.forEach([&](uint32_t id) {
+            if (!isDead(id)) live.add(id);
+            return true;
+        });
+        live.shrinkToFit();
+        it->second = std::move(live);
+        it = it->second.empty() ? m_postings.erase(it) : std::next(it);
+    }
+    m_deadCount = 0;
+}
+
+// --- Queries ---
+
+std::optional<std::vector<WorkspaceIndex::FileInfo>> WorkspaceIndex::findFiles(
+    const std::string& directory, const std::string& pattern, bool recursive, size_t maxResults) const {
+    if (!m_ready) return std::nullopt;
+
+    std::string dir = directory;
+    while (dir.size() > 1 && isSeparator(dir.back())) dir.pop_back();
+    if (!covers(dir)) return std::nullopt;
+
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    std::vector<const Entry*> found;
+    for (const auto& [path, id] : m_idByPath) {
+        const Entry& entry = m_entries[id];
+        if (!isUnder(path, dir)) continue;
+        bool direct = entry.nameOffset == dir.size() + 1 ||
+                      (isSeparator(dir.back()) && entry.nameOffset == dir.size());
+        if (!recursive && !direct) continue;
+        if (ContentSearch::WildcardMatch(pattern, std::string_view(path).substr(entry.nameOffset))) {
+            found.push_back(&entry);
+        }
+    }
+
+    auto byPath = [](const Entry* a, const Entry* b) { return a->path < b->path; };
+    if (found.size() > maxResults) {
+        std::partial_sort(found.begin(), found.begin() + maxResults, found.end(), byPath);
+        found.resize(maxResults);
+    } else {
+        std::sort(found.begin(), found.end(), byPath);
+    }
+
+    std::vector<FileInfo> results;
+    results.reserve(found.size());
+    for (const Entry* entry : found) {
+        results.push_back({entry->path, entry->size, entry->modTime});
+    }
+    return results;
+}
+
+std::optional<std::vector<std::string>> WorkspaceIndex::candidateFiles(
+    const std::string& directory, std::string_view query, const std::string& filePattern) const {
+    if (!m_ready) return std::nullopt;
+
+    std::string dir = directory;
+    while (dir.size() > 1 && isSeparator(dir.back())) dir.pop_back();
+    if (!covers(dir)) return std::nullopt;
+
+    std::vector<uint32_t> keys;
+    for (size_t i = 0; i + 3 <= query.size(); ++i) {
+        auto a = foldAscii(static_cast<unsigned char>(query[i]));
+        auto b = foldAscii(static_cast<unsigned char>(query[i + 1]));
+        auto c = foldAscii(static_cast<unsigned char>(query[i + 2]));
+        if (a == '\n' || b == '\n' || c == '\n') continue;
+        keys.push_back(trigramKey(a, b, c));
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+    auto accept = [&](const Entry& entry) {
+        return entry.alive && entry.text && (entry.path == dir || isUnder(entry.path, dir)) &&
+               ContentSearch::WildcardMatch(filePattern, std::string_view(entry.path).substr(entry.nameOffset));
+    };
+
+    std::vector<std::string> results;
+    if (keys.empty()) {
+        // Query too short to prune: every text file is a candidate
+        for (const auto& [path, id] : m_idByPath) {
+            if (accept(m_entries[id])) results.push_back(path);
+        }
+    } else {
+        std::vector<const PostingList*> lists;
+        bool anyMissing = false;
+        for (uint32_t key : keys) {
+            auto it = m_postings.find(key);
+            if (it == m_postings.end()) {
+                anyMissing = true;
+                break;
+            }
+            lists.push_back(&it->second);
+        }
+
+        if (!anyMissing) {
+            // Intersect starting from the rarest trigram
+            std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+            std::vector<uint32_t> ids;
+            ids.reserve(lists.front()->size());
+            lists.front()->forEach([&](uint32_t id) {
+                ids.push_back(id);
+                return true;
+            });
+            for (size_t i = 1; i < lists.size() && !ids.empty(); ++i) {
+                // Merge against the next list, keeping ids found in both
+                size_t pos = 0;
+                size_t kept = 0;
+                lists[i]->forEach([&](uint32_t id) {
+                    while (pos < ids.size() && ids[pos] < id) ++pos;
+                    if (pos == ids.size()) return false;
+                    if (ids[pos] == id) ids[kept++] = ids[pos++];
+                    return true;
+                });
+                ids.resize(kept);
+            }
+            for (uint32_t id : ids) {
+                if (accept(m_entries[id])) results.push_back(m_entries[id].path);
+            }
+        }
+
+        // Files too large for the postings can't be ruled out
+        for (uint32_t id : m_unindexed) {
+            if (accept(m_entries[id])) results.push_back(m_entries[id].path);
+        }
+    }
+
+    std::sort(results.begin(), results.end());
+    return results;
+}
+
+size_t WorkspaceIndex::fileCount() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_idByPath.size();
+}
+
+uint32_t WorkspaceIndex::trigramKey(unsigned char a, unsigned char b, unsigned char c) {
+    return (static_cast<uint32_t>(a) << 16) | (static_cast<uint32_t>(b) << 8) | static_cast<uint32_t>(c);
+}
+
+} // namespace FS
@@ -0,0 +1,231 @@
+#ifndef WORKSPACE_INDEX_H
+#define WORKSPACE_INDEX_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace FS {
+
+/**
+ * Options for a workspace index.
+ */
+struct WorkspaceIndexOptions {
+    /**
+     * Entry names (files and directories) that are left out of the index.
+     * Called from the index thread.
+     */
+    std::function<bool(const std::string& name)> skipName;
+
+    size_t maxIndexedFileSize = 1024 * 1024;    // Larger text files are listed but always searched
+    size_t threads = 0;                         // Build workers, 0 for hardware concurrency
+    std::chrono::milliseconds changeDelay{100}; // Change notifications are coalesced for this long
+};
+
+/**
+ * Ascending file ids of one trigram, delta and varint encoded.
+ *
+ * Ids are handed out in path order, so neighbouring ids in a list are
+ * close and most gaps fit in one byte: a posting costs about a quarter of
+ * a plain uint32_t vector entry.
+ */
+class PostingList {
+public:
+    /**
+     * Append an id greater than every id already in the list.
+     */
+    void add(uint32_t id) {
+        uint32_t delta = m_count == 0 ? id : id - m_last;
+        while (delta >= 0x80) {
+            m_bytes.push_back(static_cast<uint8_t>(delta | 0x80));
+            delta >>= 7;
+        }
+        m_bytes.push_back(static_cast<uint8_t>(delta));
+        m_last = id;
+        ++m_count;
+    }
+
+    /**
+     * Call fn(id) for every id in ascending order until it returns false.
+     */
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        uint32_t id = 0;
+        size_t pos = 0;
+        for (size_t i = 0; i < m_count; ++i) {
+            uint32_t delta = 0;
+            for (int shift = 0;; shift += 7) {
+                uint8_t byte = m_bytes[pos++];
+                delta |= static_cast<uint32_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) break;
+            }
+            id = (i == 0) ? delta : id + delta;
+            if (!fn(id)) return;
+        }
+    }
+
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    size_t byteSize() const { return m_bytes.size(); }
+    void shrinkToFit() { m_bytes.shrink_to_fit(); }
+
+private:
+    std::vector<uint8_t> m_bytes;
+    uint32_t m_last = 0;
+    uint32_t m_count = 0;
+};
+
+/**
+ * Long-lived index of a local workspace for repeated searches.
+ *
+ * Holds the file list (with size and modification time) and a trigram
+ * posting list (see PostingList) over the case-folded contents of every
+ * text file, typically around one byte per distinct trigram per file. Content
+ * queries intersect the postings of the query's trigrams to get a small
+ * candidate set that is then verified by ContentSearch, so a search only
+ * reads the files that can match.
+ *
+ * The index is built on its own background thread, which also applies
+ * change notifications: notifyChanged() queues a path, and after a short
+ * coalescing delay the thread re-stats it and re-indexes, adds or removes
+ * the affected files. Replaced or removed files leave tombstones in the
+ * postings that are filtered at query time and compacted away once they
+ * outnumber the live files.
+ *
+ * Queries may come from any thread; they return nullopt until the first
+ * build has finished, or for a directory the index doesn't cover, so
+ * callers can fall back to a direct scan. The index only stays current if
+ * every change to a path it doesn't skip is notified: skipName must leave
+ * out at least what the change source never reports.
+ */
+class WorkspaceIndex {
+public:
+    struct FileInfo {
+        std::string path;       // Full path
+        int64_t size = 0;
+        int64_t modTime = 0;    // Filesystem clock ticks, only meaningful for comparison
+    };
+
+    explicit WorkspaceIndex(std::string rootPath, WorkspaceIndexOptions options = {});
+    ~WorkspaceIndex();
+
+    WorkspaceIndex(const WorkspaceIndex&) = delete;
+    WorkspaceIndex& operator=(const WorkspaceIndex&) = delete;
+
+    const std::string& rootPath() const { return m_rootPath; }
+
+    /**
+     * Start the background build. Does nothing if already started.
+     */
+    void start();
+
+    bool isReady() const { return m_ready.load(); }
+
+    /**
+     * Block until the first build is done (mainly for tests).
+     * @return false on timeout.
+     */
+    bool waitUntilReady(std::chrono::milliseconds timeout) const;
+
+    /**
+     * Block until all queued change notifications are applied (mainly for tests).
+     */
+    bool waitUntilIdle(std::chrono::milliseconds timeout) const;
+
+    /**
+     * Queue a changed, created or deleted path (file or directory) for
+     * re-indexing. Cheap; safe to call from the UI thread.
+     */
+    void notifyChanged(const std::string& path);
+
+    /**
+     * Files under `directory` whose names match the wildcard pattern, in
+     * path order. Only direct children unless `recursive`.
+     */
+    std::optional<std::vector<FileInfo>> findFiles(const std::string& directory, const std::string& pattern,
+                                                   bool recursive, size_t maxResults) const;
+
+    /**
+     * Text files under `directory` matching `filePattern` that may contain
+     * `query` (case-insensitively), sorted by path.
+     */
+    std::optional<std::vector<std::string>> candidateFiles(const std::string& directory, std::string_view query,
+                                                           const std::string& filePattern) const;
+
+    size_t fileCount() const;
+
+private:
+    struct Entry {
+        std::string path;
+        size_t nameOffset = 0;  // Start of the file name within path
+        int64_t size = 0;
+        int64_t modTime = 0;
+        bool alive = true;
+        bool text = false;      // Not binary
+        bool indexed = false;   // Trigrams are in the postings (else always a candidate)
+    };
+
+    /**
+     * A file's freshly scanned state, computed without holding the lock.
+     */
+    struct Scan {
+        Entry entry;
+        std::vector<uint32_t> trigrams;
+    };
+
+    std::string m_rootPath;
+    WorkspaceIndexOptions m_options;
+
+    mutable std::shared_mutex m_mutex;
+    std::vector<Entry> m_entries;
+    std::unordered_map<std::string, uint32_t> m_idByPath;     // Live entries only
+    std::unordered_map<uint32_t, PostingList> m_postings;     // Trigram -> ids
+    std::vector<uint32_t> m_unindexed;      // Text files without postings (too large)
+    size_t m_deadCount = 0;
+
+    std::thread m_thread;
+    std::atomic<bool> m_started{false};
+    std::atomic<bool> m_ready{false};
+    std::atomic<bool> m_stopping{false};
+
+    mutable std::mutex m_queueMutex;
+    mutable std::condition_variable m_queueCond;
+    std::unordered_set<std::string> m_pendingChanges;
+    bool m_applying = false;
+
+    void run();
+    void build();
+    void applyChanges(std::vector<std::string> paths);
+
+    std::optional<Scan> scanFile(const std::string& path, std::vector<uint64_t>& seen) const;
+    bool isSkippedPath(const std::string& path) const;
+    bool isUnder(const std::string& path, const std::string& directory) const;
+
+    /**
+     * Whether the index holds everything below directory: it lies inside
+     * the root and no component of it is skipped.
+     */
+    bool covers(const std::string& directory) const;
+
+    // Writers, called with m_mutex held exclusively
+    void addEntry(Scan&& scan);
+    void removeEntry(uint32_t id);
+    void compact();
+
+    static uint32_t trigramKey(unsigned char a, unsigned char b, unsigned char c);
+};
+
+} // namespace FS
+
+#endif // WORKSPACE_INDEX_H
@@ -250,6 +250,14 @@ public:
     Result<std::vector<Issue>> ListItems(int maxResults = 50, const std::string& statusFilter = "") {
         if (!IsConfigured()) return Result<std::vector<Issue>>::Error("GitHub Projects client not configured");
 
+        return ParseListItemsResponse(Perform(BuildListItemsRequest(maxResults)), statusFilter);
+    }
+
+    /**
+     * Build the request behind ListItems(), for callers that run it themselves
+     * (e.g. through Http::AsyncClient). Pair with ParseListItemsResponse().
+     */
+    Http::HttpRequest BuildListItemsRequest(int maxResults = 50) const {
         std::string ownerField = (m_config.ownerType == "user") ? "user" : "organization";
 
         // GraphQL query to fetch project items with field values
@@ -271,7 +279,15 @@ content{
 }
 }}}})";
 
-        auto result = GraphQL(query);
+        return BuildGraphQLRequest(query);
+    }
+
+    /**
+     * Turn the response to a BuildListItemsRequest() request into issues.
+     */
+    Result<std::vector<Issue>> ParseListItemsResponse(const Http::HttpResponse& response,
+                                                      const std::string& statusFilter = "") {
+        auto result = InterpretGraphQL(response);
         if (!result.success) return Result<std::vector<Issue>>::Error(result.error, result.httpCode);
 
         return ParseItemsResponse(result.data, statusFilter);
@@ -290,17 +306,22 @@ content{
         auto userResult = GetAuthenticatedUser();
         if (!userResult.success) return Result<std::vector<Issue>>::Error(userResult.error);
 
+        return Result<std::vector<Issue>>::Success(
+            FilterAssignedTo(std::move(result.data), userResult.data, maxResults));
+    }
+
+    /**
+     * Keep the first maxResults items assigned to login.
+     */
+    static std::vector<Issue> FilterAssignedTo(std::vector<Issue> items, const std::string& login, int maxResults) {
         std::vector<Issue> filtered;
-        for (auto& item : result.data) {
-            if (item.assignee == userResult.data || item.assignee.empty()) {
-                // Include assigned-to-me and unassigned (drafts without assignee)
-            }
-            if (item.assignee == userResult.data) {
+        for (auto& item : items) {
+            if (item.assignee == login) {
                 filtered.push_back(std::move(item));
                 if (static_cast<int>(filtered.size()) >= maxResults) break;
             }
         }
-        return Result<std::vector<Issue>>::Success(std::move(filtered));
+        return filtered;
     }
 
     /**
@@ -601,7 +622,21 @@ projectId:")" + projResult.data.id + R"(",itemId:")" + itemId +
      * Get the authenticated user's login.
      */
     Result<std::string> GetAuthenticatedUser() {
-        auto result = RestGet("/user");
+        return ParseAuthenticatedUserResponse(Perform(BuildAuthenticatedUserRequest()));
+    }
+
+    /**
+     * Build the request behind GetAuthenticatedUser().
+     */
+    Http::HttpRequest BuildAuthenticatedUserRequest() const {
+        return BuildRestRequest("/user", "GET");
+    }
+
+    /**
+     * Extract the login from the response to BuildAuthenticatedUserRequest().
+     */
+    Result<std::string> ParseAuthenticatedUserResponse(const Http::HttpResponse& response) {
+        auto result = InterpretRest(response);
         if (!result.success) return Result<std::string>::Error(result.error);
 
         struct UserResp { std::string login; };
@@ -664,14 +699,10 @@ private:
      * Execute a GraphQL query/mutation against the GitHub API.
      */
     RequestResult GraphQL(const std::string& queryOrMutation) {
-        RequestResult result;
-
-        Http::HttpClient& client = Http::getHttpClient();
-        if (!client.isAvailable()) {
-            result.error = "HTTP client not available";
-            return result;
-        }
+        return InterpretGraphQL(Perform(BuildGraphQLRequest(queryOrMutation)));
+    }
 
+    Http::HttpRequest BuildGraphQLRequest(const std::string& queryOrMutation) const {
         Http::HttpRequest req;
         req.url = "https://api.github.com/graphql";
         req.method = "POST";
@@ -683,18 +714,12 @@ private:
 
         // Wrap in {"query": "..."} envelope
         req.body = R"({"query":")" + EscapeJson(queryOrMutation) + R"("})";
+        return req;
+    }
 
-        Http::HttpResponse httpResult = client.perform(req);
-        result.httpCode = httpResult.statusCode;
-        result.data = httpResult.body;
-
-        if (!httpResult.error.empty()) {
-            result.error = httpResult.error;
-            return result;
-        }
-
-        if (httpResult.statusCode >= 400) {
-            result.error = GetHttpErrorMessage(httpResult.statusCode, httpResult.body);
+    RequestResult InterpretGraphQL(const Http::HttpResponse& httpResult) const {
+        RequestResult result = InterpretRest(httpResult);
+        if (!result.success) {
             return result;
         }
 
@@ -708,12 +733,12 @@ private:
                 result.error = errResp.errors[0].message;
                 // Still mark success=false if only errors (no data)
                 if (httpResult.body.find("\"data\":null") != std::string::npos) {
+                    result.success = false;
                     return result;
                 }
             }
         }
 
-        result.success = true;
         return result;
     }
 
@@ -721,24 +746,38 @@ private:
      * REST API GET request.
      */
     RequestResult RestGet(const std::string& endpoint) {
-        RequestResult result;
+        return InterpretRest(Perform(BuildRestRequest(endpoint, "GET")));
+    }
 
-        Http::HttpClient& client = Http::getHttpClient();
-        if (!client.isAvailable()) {
-            result.error = "HTTP client not available";
-            return result;
-        }
+    /**
+     * REST API POST request.
+     */
+    RequestResult RestPost(const std::string& endpoint, const std::string& body) {
+        return InterpretRest(Perform(BuildRestRequest(endpoint, "POST", body)));
+    }
 
+    Http::HttpRequest BuildRestRequest(const std::string& endpoint, const std::string& method,
+                                       const std::string& body = "") const {
         Http::HttpRequest req;
         req.url = "https://api.github.com" + endpoint;
-        req.method = "GET";
+        req.method = method;
+        if (!body.empty()) {
+            req.headers["Content-Type"] = "application/json";
+            req.body = body;
+        }
         req.headers["Accept"] = "application/vnd.github+json";
         req.headers["Authorization"] = "Bearer " + m_config.token;
         req.headers["X-GitHub-Api-Version"] = "2022-11-28";
         req.headers["User-Agent"] = "ByteMuseHQ";
         req.timeoutSeconds = m_config.timeoutSeconds;
+        return req;
+    }
 
-        Http::HttpResponse httpResult = client.perform(req);
+    /**
+     * Check transport errors and HTTP status; the body goes to result.data.
+     */
+    RequestResult InterpretRest(const Http::HttpResponse& httpResult) const {
+        RequestResult result;
         result.httpCode = httpResult.statusCode;
         result.data = httpResult.body;
 
@@ -757,44 +796,16 @@ private:
     }
 
     /**
-     * REST API POST request.
+     * Run a request on the shared blocking client.
      */
-    RequestResult RestPost(const std::string& endpoint, const std::string& body) {
-        RequestResult result;
-
+    static Http::HttpResponse Perform(const Http::HttpRequest& req) {
         Http::HttpClient& client = Http::getHttpClient();
         if (!client.isAvailable()) {
-            result.error = "HTTP client not available";
-            return result;
-        }
-
-        Http::HttpRequest req;
-        req.url = "https://api.github.com" + endpoint;
-        req.method = "POST";
-        req.headers["Content-Type"] = "application/json";
-        req.headers["Accept"] = "application/vnd.github+json";
-        req.headers["Authorization"] = "Bearer " + m_config.token;
-        req.headers["X-GitHub-Api-Version"] = "2022-11-28";
-        req.headers["User-Agent"] = "ByteMuseHQ";
-        req.timeoutSeconds = m_config.timeoutSeconds;
-        req.body = body;
-
-        Http::HttpResponse httpResult = client.perform(req);
-        result.httpCode = httpResult.statusCode;
-        result.data = httpResult.body;
-
-        if (!httpResult.error.empty()) {
-            result.error = httpResult.error;
-            return result;
+            Http::HttpResponse response;
+            response.error = "HTTP client not available";
+            return response;
         }
-
-        if (httpResult.statusCode >= 400) {
-            result.error = GetHttpErrorMessage(httpResult.statusCode, httpResult.body);
-            return result;
-        }
-
-        result.success = true;
-        return result;
+        return client.perform(req);
     }
 
     /**
@@ -1043,7 +1054,7 @@ private:
         return EscapeJson(s);
     }
 
-    std::string GetHttpErrorMessage(long httpCode, const std::string& response) {
+    std::string GetHttpErrorMessage(long httpCode, const std::string& response) const {
         switch (httpCode) {
             case 401: return "Authentication failed (401). Check your GitHub token.";
             case 403: return "Access forbidden (403). Token may lack required scopes (project, repo).";
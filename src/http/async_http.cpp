@@ -0,0 +1,356 @@
+#include "async_http.h"
+
+#ifndef _WIN32
+#include "http_client_curl.h"
+#include <unordered_map>
+#endif
+
+#include <algorithm>
+#include <chrono>
+
+namespace Http {
+
+namespace {
+
+// How often queued and running requests are checked for cancellation
+constexpr auto kPollInterval = std::chrono::milliseconds(100);
+
+#ifdef _WIN32
+constexpr size_t kMaxWorkers = 4;
+#endif
+
+} // namespace
+
+#ifndef _WIN32
+
+/**
+ * curl_multi state, only touched by the event-loop thread (except wakeup).
+ */
+struct AsyncClient::Engine {
+    /** A running transfer; transfer refers to job.request. */
+    struct Active {
+        explicit Active(Job&& j) : job(std::move(j)), transfer(job.request) {}
+        Job job;
+        CurlHttpClient::Transfer transfer;
+    };
+
+    CURLM* multi = nullptr;
+    std::unordered_map<CURL*, std::unique_ptr<Active>> active;
+    std::vector<CURL*> idle;    // Reset handles kept for reuse
+
+    Engine() {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        multi = curl_multi_init();
+        if (multi) {
+            curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+            curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, 6L);
+        }
+    }
+
+    ~Engine() {
+        for (CURL* handle : idle) {
+            curl_easy_cleanup(handle);
+        }
+        if (multi) {
+            curl_multi_cleanup(multi);
+        }
+    }
+
+    void start(Job&& job) {
+        CURL* curl = nullptr;
+        if (!idle.empty()) {
+            curl = idle.back();
+            idle.pop_back();
+        } else {
+            curl = curl_easy_init();
+        }
+        if (!curl) {
+            HttpResponse response;
+            response.error = "Failed to initialize CURL";
+            complete(job, std::move(response));
+            return;
+        }
+
+        auto entry = std::make_unique<Active>(std::move(job));
+        CurlHttpClient::setupTransfer(curl, entry->transfer);
+        active.emplace(curl, std::move(entry));
+        curl_multi_add_handle(multi, curl);
+    }
+
+    /**
+     * Detach a transfer from the multi handle and complete its job.
+     */
+    void finish(CURL* curl, CURLcode result) {
+        auto it = active.find(curl);
+        if (it == active.end()) {
+            return;
+        }
+        std::unique_ptr<Active> entry = std::move(it->second);
+        active.erase(it);
+        curl_multi_remove_handle(multi, curl);
+
+        HttpResponse response = CurlHttpClient::finishTransfer(curl, entry->transfer, result);
+        curl_easy_reset(curl);
+        idle.push_back(curl);
+        complete(entry->job, std::move(response));
+    }
+
+    void collectFinished() {
+        int pending = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi, &pending)) {
+            if (message->msg == CURLMSG_DONE) {
+                finish(message->easy_handle, message->data.result);
+            }
+        }
+    }
+
+    /**
+     * Stop running transfers whose token tripped without waiting for
+     * curl's next progress callback.
+     */
+    void stopCancelled() {
+        std::vector<CURL*> stopped;
+        for (auto& [curl, entry] : active) {
+            if (entry->job.request.cancel.isCancelled()) {
+                entry->transfer.aborted = true;
+                stopped.push_back(curl);
+            }
+        }
+        for (CURL* curl : stopped) {
+            finish(curl, CURLE_ABORTED_BY_CALLBACK);
+        }
+    }
+
+    void cancelAll() {
+        for (auto& [curl, entry] : active) {
+            entry->job.request.cancel.cancel();
+        }
+        stopCancelled();
+    }
+};
+
+#else
+
+struct AsyncClient::Engine {};
+
+#endif
+
+// ---------------------------------------------------------------------------
+
+AsyncClient::AsyncClient(size_t maxActive)
+    : m_maxActive(std::max<size_t>(maxActive, 1)),
+      m_engine(std::make_unique<Engine>()) {
+#ifdef _WIN32
+    size_t workers = std::min(m_maxActive, kMaxWorkers);
+    for (size_t i = 0; i < workers; ++i) {
+        m_threads.emplace_back([this] { run(); });
+    }
+#else
+    m_threads.emplace_back([this] { run(); });
+#endif
+}
+
+AsyncClient::~AsyncClient() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+#ifndef _WIN32
+    if (m_engine->multi) {
+        curl_multi_wakeup(m_engine->multi);
+    }
+#endif
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+
+    // Whatever never started completes as cancelled, so no future is left hanging
+    for (auto& queue : m_queues) {
+        for (auto& job : queue) {
+            complete(job, cancelledResponse());
+        }
+        queue.clear();
+    }
+}
+
+AsyncClient& AsyncClient::Instance() {
+    static AsyncClient instance;
+    return instance;
+}
+
+void AsyncClient::submit(HttpRequest request, Callback onDone, Priority priority) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_stopping) {
+            m_queues[static_cast<int>(priority)].push_back({std::move(request), std::move(onDone)});
+            onDone = nullptr;
+        }
+    }
+    if (onDone) {
+        // Shutting down
+        onDone(cancelledResponse());
+        return;
+    }
+
+    m_wake.notify_one();
+#ifndef _WIN32
+    if (m_engine->multi) {
+        curl_multi_wakeup(m_engine->multi);
+    }
+#endif
+}
+
+std::future<HttpResponse> AsyncClient::submit(HttpRequest request, Priority priority) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    std::future<HttpResponse> future = promise->get_future();
+    submit(std::move(request), [promise](HttpResponse response) {
+        promise->set_value(std::move(response));
+    }, priority);
+    return future;
+}
+
+HttpResponse AsyncClient::perform(const HttpRequest& request) {
+    return submit(request, Priority::Normal).get();
+}
+
+bool AsyncClient::isAvailable() const {
+#ifdef _WIN32
+    return getHttpClient().isAvailable();
+#else
+    return m_engine->multi != nullptr;
+#endif
+}
+
+std::string AsyncClient::backendName() const {
+#ifdef _WIN32
+    return getHttpClient().backendName() + " (worker threads)";
+#else
+    return "CURL multi";
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
+bool AsyncClient::hasQueued() const {
+    for (const auto& queue : m_queues) {
+        if (!queue.empty()) return true;
+    }
+    return false;
+}
+
+bool AsyncClient::takeNext(Job& job) {
+    for (int priority = static_cast<int>(Priority::Interactive); priority >= 0; --priority) {
+        auto& queue = m_queues[priority];
+        if (!queue.empty()) {
+            job = std::move(queue.front());
+            queue.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void AsyncClient::takeCancelled(std::vector<Job>& cancelled) {
+    for (auto& queue : m_queues) {
+        for (auto it = queue.begin(); it != queue.end();) {
+            if (it->request.cancel.isCancelled()) {
+                cancelled.push_back(std::move(*it));
+                it = queue.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void AsyncClient::complete(Job& job, HttpResponse response) {
+    if (!job.onDone) {
+        return;
+    }
+    try {
+        job.onDone(std::move(response));
+    } catch (...) {
+        // A throwing callback must not take the engine down with it
+    }
+}
+
+HttpResponse AsyncClient::cancelledResponse() {
+    HttpResponse response;
+    response.cancelled = true;
+    response.error = "Request cancelled";
+    return response;
+}
+
+#ifndef _WIN32
+
+void AsyncClient::run() {
+    Engine& engine = *m_engine;
+    if (!engine.multi) {
+        return;
+    }
+
+    while (true) {
+        std::vector<Job> cancelled;
+        std::vector<Job> starting;
+        bool stopping = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            stopping = m_stopping;
+            takeCancelled(cancelled);
+            Job job;
+            while (!stopping && engine.active.size() + starting.size() < m_maxActive && takeNext(job)) {
+                starting.push_back(std::move(job));
+            }
+        }
+
+        for (auto& job : cancelled) {
+            complete(job, cancelledResponse());
+        }
+        if (stopping) {
+            break;
+        }
+        for (auto& job : starting) {
+            engine.start(std::move(job));
+        }
+
+        int running = 0;
+        curl_multi_perform(engine.multi, &running);
+        engine.collectFinished();
+        engine.stopCancelled();
+
+        curl_multi_poll(engine.multi, nullptr, 0, static_cast<int>(kPollInterval.count()), nullptr);
+    }
+
+    engine.cancelAll();
+}
+
+#else
+
+void AsyncClient::run() {
+    while (true) {
+        std::vector<Job> cancelled;
+        Job job;
+        bool haveJob = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait_for(lock, kPollInterval, [this] { return m_stopping || hasQueued(); });
+            if (m_stopping) {
+                break;
+            }
+            takeCancelled(cancelled);
+            haveJob = takeNext(job);
+        }
+
+        for (auto& cancelledJob : cancelled) {
+            complete(cancelledJob, cancelledResponse());
+        }
+        if (haveJob) {
+            complete(job, getHttpClient().perform(job.request));
+        }
+    }
+}
+
+#endif
+
+} // namespace Http
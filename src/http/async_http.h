@@ -0,0 +1,113 @@
+#ifndef ASYNC_HTTP_H
+#define ASYNC_HTTP_H
+
+#include "http_client.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Http {
+
+/**
+ * Scheduling priority of an asynchronous request.
+ */
+enum class Priority {
+    Background,     // Prefetches, periodic refreshes
+    Normal,
+    Interactive     // Something the user is waiting on
+};
+
+/**
+ * Asynchronous HTTP engine.
+ *
+ * Requests are queued and run by one event-loop thread driving curl_multi,
+ * so any number of concurrent API calls costs one thread and shares
+ * connections (HTTP/2 streams to the same host multiplex on one). At most
+ * maxActive transfers run at once; when more are waiting, the highest
+ * priority goes first, then submission order. A request whose
+ * HttpRequest::cancel token trips is dropped from the queue or stopped
+ * mid-transfer and completes with HttpResponse::cancelled set.
+ *
+ * Completion callbacks run on the engine thread and must not block; UI code
+ * uses Http::RequestScope, which marshals them to the wx main thread.
+ * Without curl (WinHTTP builds) a few worker threads run the queue through
+ * the blocking client instead.
+ *
+ * Being an HttpClient itself, perform() and the streaming helpers work too:
+ * they submit and wait, for code that already runs off the UI thread.
+ */
+class AsyncClient : public HttpClient {
+public:
+    using Callback = std::function<void(HttpResponse)>;
+
+    explicit AsyncClient(size_t maxActive = 16);
+    ~AsyncClient() override;
+
+    AsyncClient(const AsyncClient&) = delete;
+    AsyncClient& operator=(const AsyncClient&) = delete;
+
+    /**
+     * Get the shared engine.
+     */
+    static AsyncClient& Instance();
+
+    /**
+     * Queue a request; onDone receives the response on the engine thread.
+     */
+    void submit(HttpRequest request, Callback onDone, Priority priority = Priority::Normal);
+
+    /**
+     * Queue a request and get its response as a future.
+     */
+    std::future<HttpResponse> submit(HttpRequest request, Priority priority = Priority::Normal);
+
+    /**
+     * Submit and wait. Must not be called from a completion callback.
+     */
+    HttpResponse perform(const HttpRequest& request) override;
+
+    bool isAvailable() const override;
+    std::string backendName() const override;
+
+private:
+    struct Job {
+        HttpRequest request;
+        Callback onDone;
+    };
+    struct Engine;
+
+    size_t m_maxActive;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;     // Worker threads (no curl)
+    std::deque<Job> m_queues[3];        // Indexed by Priority
+    bool m_stopping = false;
+    std::unique_ptr<Engine> m_engine;
+    std::vector<std::thread> m_threads;
+
+    /**
+     * Whether any job is waiting to start. Called with m_mutex held.
+     */
+    bool hasQueued() const;
+
+    /**
+     * Pop the next job to start. Called with m_mutex held.
+     */
+    bool takeNext(Job& job);
+
+    /**
+     * Move queued jobs whose token tripped to cancelled. Called with m_mutex held.
+     */
+    void takeCancelled(std::vector<Job>& cancelled);
+
+    void run();
+    static void complete(Job& job, HttpResponse response);
+    static HttpResponse cancelledResponse();
+};
+
+} // namespace Http
+
+#endif // ASYNC_HTTP_H
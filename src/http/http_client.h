@@ -1,9 +1,12 @@
 #ifndef HTTP_CLIENT_H
 #define HTTP_CLIENT_H
 
+#include "sse_parser.h"
 #include <string>
 #include <map>
 #include <memory>
+#include <functional>
+#include <atomic>
 
 namespace Http {
 
@@ -15,12 +18,28 @@ struct HttpResponse {
     long statusCode = 0;        // HTTP status code (200, 404, etc.)
     std::string error;          // Error message if request failed
     bool success = false;       // True if request completed with 2xx status
+    bool cancelled = false;     // Stopped by the cancel token or the data callback
     
     bool isOk() const { return success && statusCode >= 200 && statusCode < 300; }
     bool isClientError() const { return statusCode >= 400 && statusCode < 500; }
     bool isServerError() const { return statusCode >= 500; }
 };
 
+/**
+ * Lets another thread stop a request mid-transfer.
+ * Copies share state, so keep one and put a copy in HttpRequest::cancel.
+ */
+class CancellationToken {
+public:
+    CancellationToken() : m_cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+    
+    void cancel() const { m_cancelled->store(true); }
+    bool isCancelled() const { return m_cancelled->load(); }
+    
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
 /**
  * HTTP request configuration.
  */
@@ -32,6 +51,18 @@ struct HttpRequest {
     long timeoutSeconds = 30;
     bool followRedirects = true;
     bool verifySsl = true;
+    
+    /**
+     * When set, body chunks are passed here as they arrive instead of being
+     * collected in HttpResponse::body. Return false to abort the transfer.
+     */
+    std::function<bool(const char* data, size_t size)> onData;
+    
+    /**
+     * Checked while connecting and between chunks; once cancelled the
+     * transfer stops and the response has cancelled set.
+     */
+    CancellationToken cancel;
 };
 
 /**
@@ -97,6 +128,41 @@ public:
         req.headers = headers;
         return perform(req);
     }
+    
+    /**
+     * Perform a request, passing body chunks to onChunk as they arrive
+     * rather than buffering them. Return false from onChunk to stop.
+     */
+    HttpResponse stream(HttpRequest request,
+                        std::function<bool(const char* data, size_t size)> onChunk) {
+        request.onData = std::move(onChunk);
+        return perform(request);
+    }
+    
+    /**
+     * Perform a request whose response is a text/event-stream, passing each
+     * event to onEvent as soon as it is complete. Return false to stop.
+     * A non-SSE body (typically an error response) ends up in
+     * HttpResponse::body as usual.
+     */
+    HttpResponse streamEvents(HttpRequest request, SseParser::EventCallback onEvent) {
+        if (request.headers.find("Accept") == request.headers.end()) {
+            request.headers["Accept"] = "text/event-stream";
+        }
+        SseParser parser(std::move(onEvent));
+        request.onData = [&parser](const char* data, size_t size) {
+            return parser.feed(data, size);
+        };
+        
+        HttpResponse response = perform(request);
+        if (!response.cancelled && response.error.empty()) {
+            parser.finish();
+        }
+        if (!parser.sawEvent()) {
+            response.body = parser.nonEventText();
+        }
+        return response;
+    }
 };
 
 /**
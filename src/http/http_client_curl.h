@@ -4,12 +4,22 @@
 #include "http_client.h"
 #include <wx/log.h>
 #include <curl/curl.h>
+#include <mutex>
+#include <vector>
 
 namespace Http {
 
 /**
  * HTTP client implementation using libcurl.
  * Used on macOS, Linux, and optionally on Windows.
+ * 
+ * Requests go to a handful of hosts (Gemini, Jira, GitHub) over and over, so
+ * nothing is thrown away between them: finished easy handles are reset and
+ * pooled, and all handles share one CURLSH holding the DNS cache, TLS
+ * sessions and open connections, so a request reuses an idle connection
+ * instead of handshaking again. Each perform() still runs one transfer on
+ * its own connection; only a multi handle (Http::AsyncClient) multiplexes
+ * concurrent HTTP/2 requests over one.
  */
 class CurlHttpClient : public HttpClient {
 public:
@@ -21,44 +31,99 @@ public:
         } else {
             wxLogDebug("HTTP: CURL client initialized (version: %s)", curl_version());
         }
+        
+        m_share = curl_share_init();
+        if (m_share) {
+            curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC, lockCallback);
+            curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, unlockCallback);
+            curl_share_setopt(m_share, CURLSHOPT_USERDATA, this);
+            curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+        } else {
+            wxLogError("HTTP: Failed to create CURL share handle; connections won't be reused");
+        }
     }
     
     ~CurlHttpClient() override {
+        for (CURL* handle : m_idleHandles) {
+            curl_easy_cleanup(handle);
+        }
+        if (m_share) {
+            curl_share_cleanup(m_share);
+        }
         // Note: We don't call curl_global_cleanup() here because
         // other parts of the application might still use CURL.
         // It should be called once at application shutdown.
     }
     
     HttpResponse perform(const HttpRequest& request) override {
-        HttpResponse response;
-        
         wxLogDebug("HTTP: CURL perform() - %s %s", request.method, request.url);
         
-        CURL* curl = curl_easy_init();
+        CURL* curl = acquireHandle();
         if (!curl) {
+            HttpResponse response;
             response.error = "Failed to initialize CURL";
             wxLogError("HTTP: %s", response.error);
             return response;
         }
         
+        Transfer transfer(request);
+        setupTransfer(curl, transfer);
+        
+        wxLogDebug("HTTP: Sending request (body size: %zu bytes)", request.body.size());
+        
+        // Perform the request
+        CURLcode res = curl_easy_perform(curl);
+        HttpResponse response = finishTransfer(curl, transfer, res);
+        releaseHandle(curl);
+        return response;
+    }
+    
+    /**
+     * State of one transfer on an easy handle: the response body (unless
+     * streamed to request.onData) and whether it was cancelled.
+     * The request must outlive the transfer.
+     */
+    struct Transfer {
+        explicit Transfer(const HttpRequest& request) : request(request) {}
+        ~Transfer() { curl_slist_free_all(headers); }
+        Transfer(const Transfer&) = delete;
+        Transfer& operator=(const Transfer&) = delete;
+        
+        const HttpRequest& request;
+        std::string body;
+        curl_slist* headers = nullptr;
+        bool aborted = false;
+    };
+    
+    /**
+     * Set all options for transfer.request on a clean easy handle.
+     * Shared with the curl_multi engine in async_http.cpp.
+     */
+    static void setupTransfer(CURL* curl, Transfer& transfer) {
+        const HttpRequest& request = transfer.request;
+        
         // Set up headers
-        struct curl_slist* headerList = nullptr;
         for (const auto& [key, value] : request.headers) {
             std::string header = key + ": " + value;
-            headerList = curl_slist_append(headerList, header.c_str());
+            transfer.headers = curl_slist_append(transfer.headers, header.c_str());
         }
         
-        // Response body collection
-        std::string responseBody;
-        
         // Configure CURL options
         curl_easy_setopt(curl, CURLOPT_URL, request.url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headerList);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer.headers);
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseBody);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer);
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progressCallback);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &transfer);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
         curl_easy_setopt(curl, CURLOPT_TIMEOUT, request.timeoutSeconds);
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, request.verifySsl ? 1L : 0L);
         curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, request.followRedirects ? 1L : 0L);
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
         
         // Set method and body
         if (request.method == "POST") {
@@ -77,18 +142,23 @@ public:
             curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.body.size()));
         }
         // GET is the default
-        
-        wxLogDebug("HTTP: Sending request (body size: %zu bytes)", request.body.size());
-        
-        // Perform the request
-        CURLcode res = curl_easy_perform(curl);
+    }
+    
+    /**
+     * Build the response once the transfer on curl ended with res.
+     */
+    static HttpResponse finishTransfer(CURL* curl, Transfer& transfer, CURLcode res) {
+        HttpResponse response;
         
         // Get HTTP status code
         curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.statusCode);
         
-        // Cleanup
-        curl_slist_free_all(headerList);
-        curl_easy_cleanup(curl);
+        if (transfer.aborted) {
+            response.cancelled = true;
+            response.error = "Request cancelled";
+            wxLogDebug("HTTP: %s - %s", response.error, transfer.request.url);
+            return response;
+        }
         
         if (res != CURLE_OK) {
             response.error = std::string("CURL error: ") + curl_easy_strerror(res);
@@ -96,7 +166,7 @@ public:
             return response;
         }
         
-        response.body = std::move(responseBody);
+        response.body = std::move(transfer.body);
         response.success = (response.statusCode >= 200 && response.statusCode < 300);
         
         wxLogDebug("HTTP: Request complete - status=%ld, success=%s, body=%zu bytes",
@@ -115,11 +185,87 @@ public:
     }
     
 private:
-    static size_t writeCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
+    static constexpr size_t kMaxIdleHandles = 8;
+    
+    CURLSH* m_share = nullptr;
+    std::mutex m_shareLocks[CURL_LOCK_DATA_LAST];
+    std::mutex m_poolMutex;
+    std::vector<CURL*> m_idleHandles;
+    
+    /**
+     * Take a pooled handle, or make a new one attached to the share.
+     */
+    CURL* acquireHandle() {
+        {
+            std::lock_guard<std::mutex> lock(m_poolMutex);
+            if (!m_idleHandles.empty()) {
+                CURL* handle = m_idleHandles.back();
+                m_idleHandles.pop_back();
+                return handle;
+            }
+        }
+        CURL* handle = curl_easy_init();
+        if (handle && m_share) {
+            curl_easy_setopt(handle, CURLOPT_SHARE, m_share);
+        }
+        return handle;
+    }
+    
+    /**
+     * Reset a finished handle and return it to the pool. Resetting clears
+     * the per-request options but keeps the handle's caches.
+     */
+    void releaseHandle(CURL* handle) {
+        curl_easy_reset(handle);
+        if (m_share) {
+            curl_easy_setopt(handle, CURLOPT_SHARE, m_share);
+        }
+        
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        if (m_idleHandles.size() < kMaxIdleHandles) {
+            m_idleHandles.push_back(handle);
+            return;
+        }
+        curl_easy_cleanup(handle);
+    }
+    
+    static void lockCallback(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+        static_cast<CurlHttpClient*>(userptr)->m_shareLocks[data].lock();
+    }
+    
+    static void unlockCallback(CURL*, curl_lock_data data, void* userptr) {
+        static_cast<CurlHttpClient*>(userptr)->m_shareLocks[data].unlock();
+    }
+    
+    static size_t writeCallback(void* contents, size_t size, size_t nmemb, Transfer* transfer) {
         size_t totalSize = size * nmemb;
-        userp->append(static_cast<char*>(contents), totalSize);
+        if (transfer->request.cancel.isCancelled()) {
+            transfer->aborted = true;
+            return 0;
+        }
+        if (transfer->request.onData) {
+            if (!transfer->request.onData(static_cast<const char*>(contents), totalSize)) {
+                transfer->aborted = true;
+                return 0;   // Makes curl stop with CURLE_WRITE_ERROR
+            }
+            return totalSize;
+        }
+        transfer->body.append(static_cast<char*>(contents), totalSize);
         return totalSize;
     }
+    
+    /**
+     * Called by curl about once a second even while no data flows, so a
+     * cancel also stops requests stuck connecting or waiting for headers.
+     */
+    static int progressCallback(void* clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+        auto* transfer = static_cast<Transfer*>(clientp);
+        if (transfer->request.cancel.isCancelled()) {
+            transfer->aborted = true;
+            return 1;   // Makes curl stop with CURLE_ABORTED_BY_CALLBACK
+        }
+        return 0;
+    }
 };
 
 } // namespace Http
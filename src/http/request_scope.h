@@ -0,0 +1,74 @@
+#ifndef REQUEST_SCOPE_H
+#define REQUEST_SCOPE_H
+
+#include "async_http.h"
+#include <wx/app.h>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace Http {
+
+/**
+ * Ties asynchronous requests to a UI object.
+ *
+ * Requests go through Http::AsyncClient and their callbacks run on the wx
+ * main thread. Destroying the scope (or calling cancelAll()) cancels every
+ * request still in flight and guarantees none of their callbacks runs
+ * afterwards, so a widget can capture `this` without outliving checks.
+ * Use from the main thread only.
+ */
+class RequestScope {
+public:
+    using Callback = std::function<void(HttpResponse)>;
+
+    RequestScope() : m_state(std::make_shared<State>()) {}
+    ~RequestScope() { cancelAll(); }
+
+    RequestScope(const RequestScope&) = delete;
+    RequestScope& operator=(const RequestScope&) = delete;
+
+    void submit(HttpRequest request, Callback onDone, Priority priority = Priority::Normal) {
+        uint64_t id = ++m_state->nextId;
+        m_state->inFlight.emplace(id, request.cancel);
+
+        std::weak_ptr<State> weakState = m_state;
+        auto deliver = [weakState, id, onDone = std::move(onDone)](const HttpResponse& response) {
+            auto state = weakState.lock();
+            if (!state || state->inFlight.erase(id) == 0) {
+                return;     // Scope gone or request cancelled
+            }
+            onDone(response);
+        };
+
+        AsyncClient::Instance().submit(std::move(request), [deliver](HttpResponse response) {
+            // wxTheApp is null during shutdown
+            if (wxTheApp) {
+                wxTheApp->CallAfter([deliver, response]() { deliver(response); });
+            }
+        }, priority);
+    }
+
+    /**
+     * Cancel all requests in flight and drop their callbacks.
+     */
+    void cancelAll() {
+        for (auto& [id, token] : m_state->inFlight) {
+            token.cancel();
+        }
+        m_state->inFlight.clear();
+    }
+
+    bool hasPending() const { return !m_state->inFlight.empty(); }
+
+private:
+    struct State {
+        uint64_t nextId = 0;
+        std::unordered_map<uint64_t, CancellationToken> inFlight;
+    };
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace Http
+
+#endif // REQUEST_SCOPE_H
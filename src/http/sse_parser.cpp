@@ -0,0 +1,104 @@
+#include "sse_parser.h"
+#include <string_view>
+
+namespace Http {
+
+SseParser::SseParser(EventCallback onEvent) : m_onEvent(std::move(onEvent)) {}
+
+bool SseParser::feed(const char* data, size_t size) {
+    const char* end = data + size;
+    while (data < end && !m_stopped) {
+        if (m_skipLf) {
+            m_skipLf = false;
+            if (*data == '\n') {
+                ++data;
+                continue;
+            }
+        }
+
+        const char* eol = data;
+        while (eol < end && *eol != '\n' && *eol != '\r') {
+            ++eol;
+        }
+        m_line.append(data, eol);
+        if (eol == end) {
+            break;
+        }
+
+        m_skipLf = (*eol == '\r');
+        data = eol + 1;
+        handleLine();
+        m_line.clear();
+    }
+    return !m_stopped;
+}
+
+bool SseParser::finish() {
+    if (m_stopped) {
+        return false;
+    }
+    if (!m_line.empty()) {
+        handleLine();
+        m_line.clear();
+    }
+    dispatch();
+    return !m_stopped;
+}
+
+// ---------------------------------------------------------------------------
+
+void SseParser::handleLine() {
+    std::string_view line(m_line);
+    if (line.empty()) {
+        dispatch();
+        return;
+    }
+    if (line.front() == ':') {
+        return;     // Comment / keep-alive
+    }
+
+    size_t colon = line.find(':');
+    std::string_view field = line.substr(0, colon);
+    std::string_view value;
+    if (colon != std::string_view::npos) {
+        value = line.substr(colon + 1);
+        if (!value.empty() && value.front() == ' ') {
+            value.remove_prefix(1);
+        }
+    }
+
+    if (field == "data") {
+        if (m_hasData) {
+            m_event.data += '\n';
+        }
+        m_event.data.append(value);
+        m_hasData = true;
+    } else if (field == "event") {
+        m_event.event.assign(value);
+    } else if (field == "id") {
+        m_lastId.assign(value);
+    } else if (field == "retry") {
+        // Reconnection is up to the caller
+    } else if (!m_sawEvent) {
+        // Not SSE at all, e.g. a JSON error body
+        m_nonEventText.append(line);
+        m_nonEventText += '\n';
+    }
+}
+
+void SseParser::dispatch() {
+    if (!m_hasData) {
+        m_event.event = "message";
+        return;
+    }
+
+    m_sawEvent = true;
+    m_event.id = m_lastId;
+    if (m_onEvent && !m_onEvent(m_event)) {
+        m_stopped = true;
+    }
+    m_event = SseEvent{};
+    m_hasData = false;
+}
+
+} // namespace Http
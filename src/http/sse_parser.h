@@ -0,0 +1,72 @@
+#ifndef SSE_PARSER_H
+#define SSE_PARSER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace Http {
+
+/**
+ * One server-sent event.
+ */
+struct SseEvent {
+    std::string event = "message";  // event: field, "message" if absent
+    std::string data;               // data: lines joined with '\n'
+    std::string id;                 // Last id: seen on the stream
+};
+
+/**
+ * Incremental text/event-stream parser.
+ *
+ * Body chunks are fed as they arrive, split at any byte, and every complete
+ * event is passed to the callback when its terminating blank line is seen.
+ * Lines ending in \n, \r\n or \r are accepted, comments (":...") and retry:
+ * are skipped, and events without data are not dispatched, as in the
+ * EventSource spec.
+ *
+ * Servers answer errors with a plain body (usually JSON) instead of a
+ * stream, so lines that are not SSE fields and arrive before the first
+ * event are kept in nonEventText() for the caller to parse.
+ */
+class SseParser {
+public:
+    /** Return false to stop parsing; feed() then reports false. */
+    using EventCallback = std::function<bool(const SseEvent&)>;
+
+    explicit SseParser(EventCallback onEvent);
+
+    /**
+     * Parse the next chunk of the body.
+     * @return false once the callback asked to stop.
+     */
+    bool feed(const char* data, size_t size);
+
+    /**
+     * Flush an event left unterminated at the end of the body.
+     * @return false if the callback asked to stop.
+     */
+    bool finish();
+
+    bool sawEvent() const { return m_sawEvent; }
+    bool stopped() const { return m_stopped; }
+    const std::string& nonEventText() const { return m_nonEventText; }
+
+private:
+    EventCallback m_onEvent;
+    std::string m_line;         // Current, incomplete line
+    SseEvent m_event;           // Event being assembled
+    bool m_hasData = false;
+    bool m_skipLf = false;      // Previous chunk ended in \r
+    std::string m_lastId;
+    std::string m_nonEventText;
+    bool m_sawEvent = false;
+    bool m_stopped = false;
+
+    void handleLine();
+    void dispatch();
+};
+
+} // namespace Http
+
+#endif // SSE_PARSER_H
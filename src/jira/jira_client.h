@@ -319,6 +319,19 @@ public:
             return Result<Api::SearchResponse>::Error("Jira client not configured");
         }
         
+        Http::HttpRequest req = BuildSearchRequest(jql, maxResults, fields);
+        return ParseSearchRaw(Perform(req));
+    }
+    
+    /**
+     * Build the HTTP request for a JQL search, for callers that run it
+     * themselves (e.g. through Http::AsyncClient). Pair with ParseSearchResponse().
+     */
+    Http::HttpRequest BuildSearchRequest(
+        const std::string& jql,
+        int maxResults = 50,
+        const std::vector<std::string>& fields = {}
+    ) const {
         // Build fields list
         std::string fieldsParam = "key,summary,description,status,priority,issuetype,assignee,reporter,updated";
         if (!fields.empty()) {
@@ -329,16 +342,9 @@ public:
             }
         }
         
-        std::string response;
-        long httpCode = 0;
-        std::string error;
-        
         if (m_config.apiVersion == "3") {
-            // API v3 uses POST with JSON body
-            std::string jsonBody = R"({"jql": ")" + EscapeJson(jql) + R"(", "fields": [")" + 
-                fieldsParam + R"("], "maxResults": )" + std::to_string(maxResults) + "}";
-            // Fix fields format - split by comma and quote each
-            jsonBody = "{\"jql\": \"" + EscapeJson(jql) + "\", \"fields\": [";
+            // API v3 uses POST with JSON body; split fields by comma and quote each
+            std::string jsonBody = "{\"jql\": \"" + EscapeJson(jql) + "\", \"fields\": [";
             bool first = true;
             size_t start = 0;
             while (start < fieldsParam.size()) {
@@ -351,43 +357,44 @@ public:
             }
             jsonBody += "], \"maxResults\": " + std::to_string(maxResults) + "}";
             
-            auto result = MakeRequest("/rest/api/3/search/jql", "POST", jsonBody);
-            response = result.response;
-            httpCode = result.httpCode;
-            error = result.error;
-        } else {
-            // API v2 uses GET with query params
-            std::string endpoint = "/rest/api/2/search?jql=" + UrlEncode(jql) +
-                "&fields=" + fieldsParam + "&maxResults=" + std::to_string(maxResults);
-            auto result = MakeRequest(endpoint, "GET");
-            response = result.response;
-            httpCode = result.httpCode;
-            error = result.error;
+            return BuildRequest("/rest/api/3/search/jql", "POST", jsonBody);
         }
         
-        if (!error.empty()) {
-            return Result<Api::SearchResponse>::Error(error, httpCode);
-        }
-        
-        if (httpCode >= 400) {
-            return Result<Api::SearchResponse>::Error(GetHttpErrorMessage(httpCode, response), httpCode);
+        // API v2 uses GET with query params
+        std::string endpoint = "/rest/api/2/search?jql=" + UrlEncode(jql) +
+            "&fields=" + fieldsParam + "&maxResults=" + std::to_string(maxResults);
+        return BuildRequest(endpoint, "GET");
+    }
+    
+    /**
+     * Turn the response to a BuildSearchRequest() request into issues.
+     */
+    Result<std::vector<Issue>> ParseSearchResponse(const Http::HttpResponse& response) const {
+        auto apiResult = ParseSearchRaw(ToRequestResult(response));
+        if (!apiResult.success) {
+            return Result<std::vector<Issue>>::Error(apiResult.error, apiResult.httpCode);
         }
         
-        Api::SearchResponse searchResp;
-        auto ec = glz::read<glz::opts{.error_on_unknown_keys = false}>(searchResp, response);
-        if (ec) {
-            return Result<Api::SearchResponse>::Error(
-                "Failed to parse response: " + glz::format_error(ec, response), 0);
+        std::vector<Issue> issues;
+        for (const auto& apiIssue : apiResult.data.issues) {
+            issues.push_back(Issue::FromApi(apiIssue, m_config.apiUrl));
         }
         
-        return Result<Api::SearchResponse>::Success(std::move(searchResp));
+        return Result<std::vector<Issue>>::Success(std::move(issues));
     }
     
     /**
      * Get issues assigned to the current user.
      */
     Result<std::vector<Issue>> GetMyIssues(int maxResults = 50) {
-        return SearchIssues("assignee=currentUser() ORDER BY updated DESC", maxResults);
+        return SearchIssues(kMyIssuesJql, maxResults);
+    }
+    
+    /**
+     * Build the request behind GetMyIssues(); parse with ParseSearchResponse().
+     */
+    Http::HttpRequest BuildMyIssuesRequest(int maxResults = 50) const {
+        return BuildSearchRequest(kMyIssuesJql, maxResults);
     }
     
     /**
@@ -640,20 +647,21 @@ private:
         std::string error;
     };
     
+    static constexpr const char* kMyIssuesJql = "assignee=currentUser() ORDER BY updated DESC";
+    
     /**
      * Make an HTTP request to the Jira API.
      */
     RequestResult MakeRequest(const std::string& endpoint, const std::string& method,
                               const std::string& body = "") {
-        RequestResult result;
-        
-        Http::HttpClient& client = Http::getHttpClient();
-        if (!client.isAvailable()) {
-            result.error = "HTTP client not available";
-            return result;
-        }
-        
-        // Build request
+        return Perform(BuildRequest(endpoint, method, body));
+    }
+    
+    /**
+     * Build an authenticated request to the Jira API.
+     */
+    Http::HttpRequest BuildRequest(const std::string& endpoint, const std::string& method,
+                                   const std::string& body = "") const {
         Http::HttpRequest req;
         req.url = m_config.apiUrl + endpoint;
         req.method = method;
@@ -665,9 +673,24 @@ private:
         if (!body.empty()) {
             req.body = body;
         }
-        
-        Http::HttpResponse httpResult = client.perform(req);
-        
+        return req;
+    }
+    
+    /**
+     * Run a request on the shared blocking client.
+     */
+    static RequestResult Perform(const Http::HttpRequest& req) {
+        Http::HttpClient& client = Http::getHttpClient();
+        if (!client.isAvailable()) {
+            RequestResult result;
+            result.error = "HTTP client not available";
+            return result;
+        }
+        return ToRequestResult(client.perform(req));
+    }
+    
+    static RequestResult ToRequestResult(const Http::HttpResponse& httpResult) {
+        RequestResult result;
         result.response = httpResult.body;
         result.httpCode = httpResult.statusCode;
         
@@ -678,10 +701,33 @@ private:
         return result;
     }
     
+    /**
+     * Parse a search response into the raw API structures.
+     */
+    Result<Api::SearchResponse> ParseSearchRaw(const RequestResult& result) const {
+        if (!result.error.empty()) {
+            return Result<Api::SearchResponse>::Error(result.error, result.httpCode);
+        }
+        
+        if (result.httpCode >= 400) {
+            return Result<Api::SearchResponse>::Error(
+                GetHttpErrorMessage(result.httpCode, result.response), result.httpCode);
+        }
+        
+        Api::SearchResponse searchResp;
+        auto ec = glz::read<glz::opts{.error_on_unknown_keys = false}>(searchResp, result.response);
+        if (ec) {
+            return Result<Api::SearchResponse>::Error(
+                "Failed to parse response: " + glz::format_error(ec, result.response), 0);
+        }
+        
+        return Result<Api::SearchResponse>::Success(std::move(searchResp));
+    }
+    
     /**
      * Get human-readable error message for HTTP status codes.
      */
-    std::string GetHttpErrorMessage(long httpCode, const std::string& response) {
+    std::string GetHttpErrorMessage(long httpCode, const std::string& response) const {
         switch (httpCode) {
             case 401:
                 return "Authentication failed (401). Please check your credentials.";
@@ -11,7 +11,11 @@
 #include <mutex>
 #include <atomic>
 #include <condition_variable>
+#include <cerrno>
+#include <charconv>
+#include <string_view>
 #include <glaze/glaze.hpp>
+#include "lsp_framer.h"
 
 // Platform-specific includes for process management
 #ifdef _WIN32
@@ -136,6 +140,63 @@ template<> struct glz::meta<LspCompletionItem> {
     );
 };
 
+// ----------------------------------------------------------------------------
+// Wire-level types used for two-phase decoding of incoming messages
+// ----------------------------------------------------------------------------
+
+/**
+ * Top-level JSON-RPC message. Only the routing fields are decoded; the
+ * payloads stay as raw views into the message buffer until the handler that
+ * owns them decodes them straight into their typed structs.
+ */
+struct LspMessageEnvelope {
+    glz::raw_json_view id;          // Number or string; empty for notifications
+    std::string method;             // Empty for responses
+    glz::raw_json_view result;
+    glz::raw_json_view params;
+    glz::raw_json_view error;
+};
+
+struct LspCompletionList {
+    std::vector<LspCompletionItem> items;
+};
+
+struct LspPublishDiagnosticsParams {
+    std::string uri;
+    std::vector<LspDiagnostic> diagnostics;
+};
+
+struct LspShowMessageParams {
+    int type = 0;
+    std::string message;
+};
+
+template<> struct glz::meta<LspMessageEnvelope> {
+    using T = LspMessageEnvelope;
+    static constexpr auto value = object(
+        "id", &T::id,
+        "method", &T::method,
+        "result", &T::result,
+        "params", &T::params,
+        "error", &T::error
+    );
+};
+
+template<> struct glz::meta<LspCompletionList> {
+    using T = LspCompletionList;
+    static constexpr auto value = object("items", &T::items);
+};
+
+template<> struct glz::meta<LspPublishDiagnosticsParams> {
+    using T = LspPublishDiagnosticsParams;
+    static constexpr auto value = object("uri", &T::uri, "diagnostics", &T::diagnostics);
+};
+
+template<> struct glz::meta<LspShowMessageParams> {
+    using T = LspShowMessageParams;
+    static constexpr auto value = object("type", &T::type, "message", &T::message);
+};
+
 // ============================================================================
 // Callbacks
 // ============================================================================
@@ -215,9 +276,30 @@ struct LspSshConfig {
 
 class ProcessHandle {
 public:
+    // Bits returned by waitForOutput()
+    enum ReadyFlags {
+        StdoutReady = 1,
+        StderrReady = 2,
+        WokenUp = 4
+    };
+    
     virtual ~ProcessHandle() = default;
     virtual bool isRunning() const = 0;
     virtual void terminate() = 0;
+    
+    /**
+     * Block until stdout or stderr has data (or EOF), wakeUp() is called,
+     * or the timeout expires (-1 waits indefinitely).
+     * @return A combination of ReadyFlags, 0 on timeout, -1 on error.
+     */
+    virtual int waitForOutput(int timeoutMs) = 0;
+    
+    /**
+     * Interrupt a pending waitForOutput() from another thread.
+     */
+    virtual void wakeUp() = 0;
+    
+    // Read available output. Returns bytes read, 0 on EOF, -1 on error.
     virtual int readStdout(char* buffer, size_t size) = 0;
     virtual int readStderr(char* buffer, size_t size) = 0;
     virtual bool writeStdin(const char* data, size_t size) = 0;
@@ -230,16 +312,28 @@ private:
     int m_stdin_fd;
     int m_stdout_fd;
     int m_stderr_fd;
+    int m_wakePipe[2] = {-1, -1};  // Self-pipe used to interrupt poll() on shutdown
     
 public:
     UnixProcessHandle(pid_t pid, int stdin_fd, int stdout_fd, int stderr_fd)
-        : m_pid(pid), m_stdin_fd(stdin_fd), m_stdout_fd(stdout_fd), m_stderr_fd(stderr_fd) {}
+        : m_pid(pid), m_stdin_fd(stdin_fd), m_stdout_fd(stdout_fd), m_stderr_fd(stderr_fd) {
+        if (pipe(m_wakePipe) == 0) {
+            for (int fd : m_wakePipe) {
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+                fcntl(fd, F_SETFD, FD_CLOEXEC);
+            }
+        } else {
+            m_wakePipe[0] = m_wakePipe[1] = -1;
+        }
+    }
     
     ~UnixProcessHandle() override {
         terminate();
         if (m_stdin_fd >= 0) close(m_stdin_fd);
         if (m_stdout_fd >= 0) close(m_stdout_fd);
         if (m_stderr_fd >= 0) close(m_stderr_fd);
+        if (m_wakePipe[0] >= 0) close(m_wakePipe[0]);
+        if (m_wakePipe[1] >= 0) close(m_wakePipe[1]);
     }
     
     bool isRunning() const override {
@@ -255,54 +349,90 @@ public:
         }
     }
     
-    int readStdout(char* buffer, size_t size) override {
-        if (m_stdout_fd < 0) return -1;
+    int waitForOutput(int timeoutMs) override {
+        // poll() ignores negative fds, so closed streams simply drop out
+        pollfd fds[3] = {
+            {m_stdout_fd, POLLIN, 0},
+            {m_stderr_fd, POLLIN, 0},
+            {m_wakePipe[0], POLLIN, 0}
+        };
         
-        // Non-blocking read
-        pollfd pfd = {m_stdout_fd, POLLIN, 0};
-        int ret = poll(&pfd, 1, 0);
-        if (ret <= 0) return 0;
+        int ret = poll(fds, 3, timeoutMs);
+        if (ret < 0) {
+            return errno == EINTR ? 0 : -1;
+        }
         
-        return read(m_stdout_fd, buffer, size);
+        int ready = 0;
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) ready |= StdoutReady;
+        if (fds[1].revents & (POLLIN | POLLHUP | POLLERR)) ready |= StderrReady;
+        if (fds[2].revents & POLLIN) {
+            char drain[64];
+            while (read(m_wakePipe[0], drain, sizeof(drain)) > 0) {}
+            ready |= WokenUp;
+        }
+        return ready;
+    }
+    
+    void wakeUp() override {
+        if (m_wakePipe[1] >= 0) {
+            char byte = 1;
+            (void)!write(m_wakePipe[1], &byte, 1);
+        }
+    }
+    
+    int readStdout(char* buffer, size_t size) override {
+        return readStream(m_stdout_fd, buffer, size);
     }
     
     int readStderr(char* buffer, size_t size) override {
-        if (m_stderr_fd < 0) return -1;
-        
-        pollfd pfd = {m_stderr_fd, POLLIN, 0};
-        int ret = poll(&pfd, 1, 0);
-        if (ret <= 0) return 0;
-        
-        return read(m_stderr_fd, buffer, size);
+        return readStream(m_stderr_fd, buffer, size);
     }
     
     bool writeStdin(const char* data, size_t size) override {
         if (m_stdin_fd < 0) return false;
         
         size_t total_written = 0;
-        int retries = 0;
-        const int max_retries = 100; // Max ~100ms of retries
         
         while (total_written < size) {
             ssize_t written = write(m_stdin_fd, data + total_written, size - total_written);
             if (written < 0) {
+                if (errno == EINTR) continue;
                 if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                    // Non-blocking write would block
-                    retries++;
-                    if (retries >= max_retries) {
-                        // Give up after max retries to prevent UI freeze
+                    // Pipe is full: wait until the server drains it instead of spinning.
+                    // Give up if it makes no progress for a while (server hung).
+                    pollfd pfd = {m_stdin_fd, POLLOUT, 0};
+                    int ret = poll(&pfd, 1, 5000);
+                    if (ret <= 0 && !(ret < 0 && errno == EINTR)) {
                         return false;
                     }
-                    usleep(1000); // 1ms
                     continue;
                 }
                 return false; // Real error
             }
             total_written += written;
-            retries = 0; // Reset retry counter on successful write
         }
         return true;
     }
+
+private:
+    /**
+     * Read from a stream whose fd was reported ready. Closes the fd on EOF
+     * so later polls no longer report it.
+     */
+    static int readStream(int& fd, char* buffer, size_t size) {
+        if (fd < 0) return 0;
+        
+        ssize_t n;
+        do {
+            n = read(fd, buffer, size);
+        } while (n < 0 && errno == EINTR);
+        
+        if (n <= 0) {
+            close(fd);
+            fd = -1;
+        }
+        return static_cast<int>(n);
+    }
 };
 #endif
 
@@ -319,16 +449,17 @@ private:
     std::atomic<bool> m_running{false};
     LspSshConfig m_sshConfig;
     
-    std::thread m_readerThread;
+    std::thread m_readerThread;  // Waits on both stdout and stderr
     std::thread m_writerThread;
-    std::thread m_stderrThread;  // Read stderr for errors and debug output
     std::mutex m_mutex;
     std::mutex m_writeMutex;
-    std::string m_inputBuffer;
+    LspMessageFramer m_framer;  // Guarded by m_mutex
     std::queue<std::string> m_writeQueue;
     std::condition_variable m_writeCondition;
     
-    std::map<int, std::function<void(const glz::generic&)>> m_pendingRequests;
+    // Response handlers keyed by request id. They receive the raw "result"
+    // JSON and decode it into whatever type the request expects.
+    std::map<int, std::function<void(std::string_view result)>> m_pendingRequests;
     DiagnosticsCallback m_diagnosticsCallback;
     LogCallback m_logCallback;
     
@@ -511,10 +642,9 @@ public:
 #endif
         
         m_running = true;
-        log("Starting reader, writer, and stderr threads");
+        log("Starting reader and writer threads");
         m_readerThread = std::thread(&LspClient::readerThreadFunc, this);
         m_writerThread = std::thread(&LspClient::writerThreadFunc, this);
-        m_stderrThread = std::thread(&LspClient::stderrThreadFunc, this);
         
         log("LSP client started successfully");
         return true;
@@ -529,7 +659,12 @@ public:
             sendRequest("shutdown", glz::generic{});
         }
         
-        m_running = false;
+        {
+            // Under the writer's mutex so the flip can't land between its
+            // predicate check and its wait
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            m_running = false;
+        }
         
         // Wake up writer thread
         m_writeCondition.notify_one();
@@ -538,14 +673,13 @@ public:
             m_writerThread.join();
         }
         
+        // Interrupt the reader's blocking poll
+        m_process->wakeUp();
+        
         if (m_readerThread.joinable()) {
             m_readerThread.join();
         }
         
-        if (m_stderrThread.joinable()) {
-            m_stderrThread.join();
-        }
-        
         m_process.reset();
         m_initialized = false;
         
@@ -570,7 +704,7 @@ public:
         int id = sendRequest("initialize", params);
         
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_pendingRequests[id] = [this, callback](const glz::generic& result) {
+        m_pendingRequests[id] = [this, callback](std::string_view) {
             log("Server initialized");
             sendNotification("initialized", glz::generic{});
             m_initialized = true;
@@ -625,11 +759,10 @@ public:
         int id = sendRequest("textDocument/documentSymbol", params);
         
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_pendingRequests[id] = [callback](const glz::generic& result) {
+        m_pendingRequests[id] = [callback](std::string_view result) {
             std::vector<LspDocumentSymbol> symbols;
-            if (result.is_array()) {
-                std::string json = glz::write_json(result).value_or("[]");
-                [[maybe_unused]] auto ec = glz::read<glz::opts{.error_on_unknown_keys = false}>(symbols, json);
+            if (jsonStartsWith(result, '[')) {
+                decodeJson(symbols, result);
             }
             if (callback) callback(symbols);
         };
@@ -646,11 +779,10 @@ public:
         int id = sendRequest("textDocument/definition", params);
         
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_pendingRequests[id] = [callback](const glz::generic& result) {
+        m_pendingRequests[id] = [callback](std::string_view result) {
             std::vector<LspLocation> locations;
-            if (result.is_array()) {
-                std::string json = glz::write_json(result).value_or("[]");
-                [[maybe_unused]] auto ec = glz::read<glz::opts{.error_on_unknown_keys = false}>(locations, json);
+            if (jsonStartsWith(result, '[')) {
+                decodeJson(locations, result);
             }
             if (callback) callback(locations);
         };
@@ -669,11 +801,10 @@ public:
         int id = sendRequest("textDocument/references", params);
         
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_pendingRequests[id] = [callback](const glz::generic& result) {
+        m_pendingRequests[id] = [callback](std::string_view result) {
             std::vector<LspLocation> locations;
-            if (result.is_array()) {
-                std::string json = glz::write_json(result).value_or("[]");
-                [[maybe_unused]] auto ec = glz::read<glz::opts{.error_on_unknown_keys = false}>(locations, json);
+            if (jsonStartsWith(result, '[')) {
+                decodeJson(locations, result);
             }
             if (callback) callback(locations);
         };
@@ -690,14 +821,15 @@ public:
         int id = sendRequest("textDocument/completion", params);
         
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_pendingRequests[id] = [callback](const glz::generic& result) {
+        m_pendingRequests[id] = [callback](std::string_view result) {
+            // Either CompletionItem[] or CompletionList { items }
             std::vector<LspCompletionItem> items;
-            if (result.is_object() && result.contains("items")) {
-                std::string json = glz::write_json(result["items"]).value_or("[]");
-                [[maybe_unused]] auto ec = glz::read<glz::opts{.error_on_unknown_keys = false}>(items, json);
-            } else if (result.is_array()) {
-                std::string json = glz::write_json(result).value_or("[]");
-                [[maybe_unused]] auto ec = glz::read<glz::opts{.error_on_unknown_keys = false}>(items, json);
+            if (jsonStartsWith(result, '{')) {
+                LspCompletionList list;
+                decodeJson(list, result);
+                items = std::move(list.items);
+            } else if (jsonStartsWith(result, '[')) {
+                decodeJson(items, result);
             }
             if (callback) callback(items);
         };
@@ -724,7 +856,11 @@ public:
         sendMessage(msg);
         
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_pendingRequests[id] = callback;
+        m_pendingRequests[id] = [callback](std::string_view result) {
+            glz::generic value;
+            decodeJson(value, result);
+            if (callback) callback(value);
+        };
     }
     
 private:
@@ -759,7 +895,7 @@ private:
     void writerThreadFunc() {
         while (m_running || !m_writeQueue.empty()) {
             std::unique_lock<std::mutex> lock(m_writeMutex);
-            m_writeCondition.wait_for(lock, std::chrono::milliseconds(100), [this] {
+            m_writeCondition.wait(lock, [this] {
                 return !m_writeQueue.empty() || !m_running;
             });
             
@@ -791,136 +927,165 @@ private:
     }
     
     void readerThreadFunc() {
-        char buffer[4096];
-        
-        while (m_running && m_process) {
-            int bytesRead = m_process->readStdout(buffer, sizeof(buffer) - 1);
-            
-            if (bytesRead > 0) {
-                buffer[bytesRead] = '\0';
-                
-                std::lock_guard<std::mutex> lock(m_mutex);
-                m_inputBuffer += buffer;
-                processInputBuffer();
-            } else if (bytesRead < 0) {
-                log("Error reading from LSP server");
+        char buffer[65536];
+        std::string stderrLines;
+        bool stdoutOpen = true;
+        bool stderrOpen = true;
+        
+        // Block until either stream has data (or stop() wakes us), so messages
+        // are dispatched as soon as they arrive and the thread sleeps while idle
+        while (m_running && m_process && (stdoutOpen || stderrOpen)) {
+            int ready = m_process->waitForOutput(-1);
+            if (ready < 0) {
+                log("Error waiting for LSP server output");
                 break;
             }
             
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-    }
-    
-    void stderrThreadFunc() {
-        char buffer[4096];
-        std::string lineBuffer;
-        
-        while (m_running && m_process) {
-            int bytesRead = m_process->readStderr(buffer, sizeof(buffer) - 1);
-            
-            if (bytesRead > 0) {
-                buffer[bytesRead] = '\0';
-                lineBuffer += buffer;
-                
-                // Process complete lines
-                size_t pos;
-                while ((pos = lineBuffer.find('\n')) != std::string::npos) {
-                    std::string line = lineBuffer.substr(0, pos);
-                    lineBuffer = lineBuffer.substr(pos + 1);
-                    
-                    // Remove trailing \r if present
-                    if (!line.empty() && line.back() == '\r') {
-                        line.pop_back();
-                    }
-                    
-                    if (!line.empty()) {
-                        log("[stderr] " + line);
+            if (ready & ProcessHandle::StdoutReady) {
+                int bytesRead = m_process->readStdout(buffer, sizeof(buffer));
+                if (bytesRead > 0) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_framer.append(buffer, bytesRead);
+                    processInputBuffer();
+                } else {
+                    if (bytesRead < 0) {
+                        log("Error reading from LSP server");
                     }
+                    stdoutOpen = false;
                 }
-            } else if (bytesRead < 0) {
-                // EOF or error - this is normal when process exits
-                break;
             }
             
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (ready & ProcessHandle::StderrReady) {
+                int bytesRead = m_process->readStderr(buffer, sizeof(buffer));
+                if (bytesRead > 0) {
+                    stderrLines.append(buffer, bytesRead);
+                    processStderrLines(stderrLines);
+                } else {
+                    // EOF or error - this is normal when process exits
+                    stderrOpen = false;
+                }
+            }
         }
         
         // Log any remaining content in buffer
-        if (!lineBuffer.empty()) {
-            log("[stderr] " + lineBuffer);
+        if (!stderrLines.empty()) {
+            log("[stderr] " + stderrLines);
         }
     }
     
-    void processInputBuffer() {
-        while (true) {
-            size_t header_end = m_inputBuffer.find("\r\n\r\n");
-            if (header_end == std::string::npos) break;
+    /**
+     * Log complete stderr lines and keep any partial trailing line.
+     */
+    void processStderrLines(std::string& lineBuffer) {
+        size_t start = 0;
+        size_t pos;
+        while ((pos = lineBuffer.find('\n', start)) != std::string::npos) {
+            std::string line = lineBuffer.substr(start, pos - start);
+            start = pos + 1;
             
-            size_t content_length = 0;
-            size_t cl_pos = m_inputBuffer.find("Content-Length:");
-            if (cl_pos != std::string::npos && cl_pos < header_end) {
-                size_t num_start = cl_pos + 15;
-                while (num_start < header_end && isspace(m_inputBuffer[num_start])) num_start++;
-                content_length = std::stoul(m_inputBuffer.substr(num_start));
+            // Remove trailing \r if present
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
             }
             
-            size_t message_start = header_end + 4;
-            if (m_inputBuffer.size() < message_start + content_length) break;
-            
-            std::string content = m_inputBuffer.substr(message_start, content_length);
-            m_inputBuffer = m_inputBuffer.substr(message_start + content_length);
-            
-            handleMessage(content);
+            if (!line.empty()) {
+                log("[stderr] " + line);
+            }
         }
+        lineBuffer.erase(0, start);
     }
     
-    void handleMessage(const std::string& content) {
-        glz::generic msg;
-        auto ec = glz::read_json(msg, content);
-        if (ec) {
-            log("Failed to parse LSP message: " + content);
+    void processInputBuffer() {
+        m_framer.drain([this](std::string_view content) {
+            handleMessage(content);
+        });
+    }
+    
+    /**
+     * Decode a JSON payload directly into a typed value.
+     * Payload views point into the framer's buffer, which is NUL-terminated
+     * after the enclosing message, so parsing in place is safe.
+     */
+    template <typename T>
+    static bool decodeJson(T& value, std::string_view json) {
+        if (json.empty()) return false;
+        auto ec = glz::read<glz::opts{.error_on_unknown_keys = false}>(value, json);
+        return !ec;
+    }
+    
+    /**
+     * Check the first non-whitespace character of a raw JSON value.
+     */
+    static bool jsonStartsWith(std::string_view json, char c) {
+        size_t pos = json.find_first_not_of(" \t\r\n");
+        return pos != std::string_view::npos && json[pos] == c;
+    }
+    
+    void handleMessage(std::string_view content) {
+        // Phase 1: routing fields only, payloads are skipped as raw views
+        LspMessageEnvelope msg;
+        if (!decodeJson(msg, content)) {
+            log("Failed to parse LSP message: " + std::string(content));
             return;
         }
         
-        if (msg.contains("id") && !msg["id"].is_null()) {
-            int id = static_cast<int>(msg["id"].get<double>());
+        std::string_view idJson = msg.id.str;
+        bool hasId = !idJson.empty() && idJson != "null";
+        
+        if (hasId && !msg.method.empty()) {
+            // Request from the server (e.g. window/workDoneProgress/create).
+            // We don't implement any, but must answer so the server doesn't wait.
+            glz::generic reply;
+            reply["jsonrpc"] = "2.0";
+            decodeJson(reply["id"], idJson);
+            reply["result"] = nullptr;
+            sendMessage(reply);
+            return;
+        }
+        
+        if (hasId) {
+            int id = 0;
+            auto parsed = std::from_chars(idJson.data(), idJson.data() + idJson.size(), id);
+            if (parsed.ec != std::errc()) {
+                log("Ignoring response with non-numeric id: " + std::string(idJson));
+                return;
+            }
+            
             auto it = m_pendingRequests.find(id);
             if (it != m_pendingRequests.end()) {
-                if (msg.contains("result")) {
-                    it->second(msg["result"]);
-                } else if (msg.contains("error")) {
-                    log("LSP error: " + glz::write_json(msg["error"]).value_or("unknown"));
+                // Phase 2: the handler decodes "result" into its own type
+                if (!msg.result.str.empty()) {
+                    it->second(msg.result.str);
+                } else if (!msg.error.str.empty()) {
+                    log("LSP error: " + std::string(msg.error.str));
                 }
                 m_pendingRequests.erase(it);
             }
-        } else if (msg.contains("method")) {
-            std::string method = msg["method"].get<std::string>();
+        } else if (!msg.method.empty()) {
+            const std::string& method = msg.method;
+            std::string_view params = msg.params.str;
+            
             if (method == "textDocument/publishDiagnostics") {
                 if (m_diagnosticsCallback) {
-                    handleDiagnostics(msg["params"]);
+                    handleDiagnostics(params);
                 }
                 // Always consume this notification even without callback
             } else if (method == "$/progress") {
                 // Background indexing progress notification
-                if (msg.contains("params")) {
-                    std::string progressJson = glz::write_json(msg["params"]).value_or("{}");
-                    log("Progress: " + progressJson);
+                if (!params.empty()) {
+                    log("Progress: " + std::string(params));
                 }
             } else if (method == "window/logMessage") {
                 // Log message from server
-                if (msg.contains("params") && msg["params"].is_object()) {
-                    auto& params = msg["params"];
-                    if (params.contains("message")) {
-                        log("Server: " + params["message"].get<std::string>());
-                    }
+                LspShowMessageParams message;
+                if (decodeJson(message, params) && !message.message.empty()) {
+                    log("Server: " + message.message);
                 }
             } else if (method == "window/showMessage") {
                 // Status message from server
-                if (msg.contains("params") && msg["params"].is_object()) {
-                    auto& params = msg["params"];
-                    if (params.contains("message")) {
-                        log("Status: " + params["message"].get<std::string>());
-                    }
+                LspShowMessageParams message;
+                if (decodeJson(message, params) && !message.message.empty()) {
+                    log("Status: " + message.message);
                 }
             } else if (method.find("$/") == 0) {
                 // Silently ignore other $ prefixed notifications (internal protocol extensions)
@@ -931,19 +1096,14 @@ private:
         }
     }
     
-    void handleDiagnostics(const glz::generic& params) {
-        if (!params.is_object()) return;
-        
-        std::string uri = params["uri"].get<std::string>();
-        std::vector<LspDiagnostic> diagnostics;
+    void handleDiagnostics(std::string_view params) {
+        if (!jsonStartsWith(params, '{')) return;
         
-        if (params.contains("diagnostics") && params["diagnostics"].is_array()) {
-            std::string json = glz::write_json(params["diagnostics"]).value_or("[]");
-            [[maybe_unused]] auto ec = glz::read<glz::opts{.error_on_unknown_keys = false}>(diagnostics, json);
-        }
+        LspPublishDiagnosticsParams decoded;
+        decodeJson(decoded, params);
         
         if (m_diagnosticsCallback) {
-            m_diagnosticsCallback(uri, diagnostics);
+            m_diagnosticsCallback(decoded.uri, decoded.diagnostics);
         }
     }
 };
@@ -0,0 +1,199 @@
+#ifndef LSP_FRAMER_H
+#define LSP_FRAMER_H
+
+#include <algorithm>
+#include <charconv>
+#include <string>
+#include <string_view>
+
+/**
+ * Content-Length framing for LSP / JSON-RPC streams.
+ *
+ * Bytes read from the server are appended to a single buffer and messages are
+ * parsed in place: headers are scanned with a read offset, and each complete
+ * body is handed to the caller as a std::string_view into the buffer, so no
+ * per-message copies are made. Consumed bytes are only discarded when the
+ * buffer is fully drained or the dead prefix dominates, which keeps large
+ * bursts (diagnostic floods, workspace symbols) linear.
+ *
+ * A header announcing more than kMaxBodyLength bytes is treated like one
+ * without a Content-Length and skipped, so a corrupt length can't make the
+ * buffer reservation throw on the reader thread.
+ *
+ * The view passed to the handler is NUL-terminated for the duration of the
+ * call, so parsers that expect C strings can consume it directly. It must not
+ * be retained after the handler returns.
+ */
+class LspMessageFramer {
+public:
+    static constexpr size_t kMaxBodyLength = 256 * 1024 * 1024;
+
+    /**
+     * Append raw bytes read from the server.
+     */
+    void append(const char* data, size_t size) {
+        m_buffer.append(data, size);
+    }
+
+    /**
+     * Dispatch every complete message currently buffered.
+     * @param onMessage Callable taking std::string_view (the JSON body).
+     * @return Number of messages dispatched.
+     */
+    template <typename Handler>
+    size_t drain(Handler&& onMessage) {
+        size_t dispatched = 0;
+
+        while (true) {
+            if (m_bodyStart == std::string::npos && !parseHeader()) {
+                break;
+            }
+            if (m_buffer.size() - m_bodyStart < m_bodyLength) {
+                break;  // Body not fully received yet
+            }
+
+            size_t bodyEnd = m_bodyStart + m_bodyLength;
+            m_readPos = bodyEnd;
+            std::string_view body(m_buffer.data() + m_bodyStart, m_bodyLength);
+            m_bodyStart = std::string::npos;
+            m_bodyLength = 0;
+
+            // Temporarily terminate the body in place (the byte after it
+            // belongs to the next message, or is the string's own NUL)
+            char saved = m_buffer[bodyEnd];
+            m_buffer[bodyEnd] = '\0';
+            onMessage(body);
+            m_buffer[bodyEnd] = saved;
+
+            ++dispatched;
+        }
+
+        compact();
+        return dispatched;
+    }
+
+    /**
+     * Bytes received but not yet dispatched.
+     */
+    size_t bufferedBytes() const {
+        return m_buffer.size() - m_readPos;
+    }
+
+    void clear() {
+        m_buffer.clear();
+        m_readPos = 0;
+        m_scanPos = 0;
+        m_bodyStart = std::string::npos;
+        m_bodyLength = 0;
+    }
+
+private:
+    std::string m_buffer;
+    size_t m_readPos = 0;                       // Start of the first unconsumed byte
+    size_t m_scanPos = 0;                       // Where to resume the header terminator search
+    size_t m_bodyStart = std::string::npos;     // Body offset once a header has been parsed
+    size_t m_bodyLength = 0;
+
+    // Only shift the buffer once this much has been consumed
+    static constexpr size_t kCompactThreshold = 64 * 1024;
+
+    /**
+     * Parse the next header block, if complete.
+     * @return true if m_bodyStart/m_bodyLength now describe a message body.
+     */
+    bool parseHeader() {
+        static constexpr std::string_view terminator = "\r\n\r\n";
+
+        std::string_view data(m_buffer);
+        size_t headerEnd;
+        size_t length = 0;
+
+        while (true) {
+            size_t searchFrom = std::max(m_readPos, m_scanPos);
+            headerEnd = data.find(terminator, searchFrom);
+            if (headerEnd == std::string_view::npos) {
+                // Resume just before the end next time, in case the terminator is split
+                m_scanPos = data.size() >= terminator.size() - 1 ? data.size() - (terminator.size() - 1) : 0;
+                return false;
+            }
+
+            length = 0;
+            bool haveLength = false;
+
+            size_t lineStart = m_readPos;
+            while (lineStart < headerEnd) {
+                size_t lineEnd = data.find("\r\n", lineStart);
+                if (lineEnd == std::string_view::npos || lineEnd > headerEnd) {
+                    lineEnd = headerEnd;
+                }
+
+                std::string_view line = data.substr(lineStart, lineEnd - lineStart);
+                size_t colon = line.find(':');
+                if (colon != std::string_view::npos && equalsIgnoreCase(line.substr(0, colon), "Content-Length")) {
+                    std::string_view value = line.substr(colon + 1);
+                    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+                        value.remove_prefix(1);
+                    }
+                    auto result = std::from_chars(value.data(), value.data() + value.size(), length);
+                    haveLength = (result.ec == std::errc() && length <= kMaxBodyLength);
+                }
+
+                lineStart = lineEnd + 2;
+            }
+
+            m_scanPos = 0;
+
+            if (haveLength) {
+                break;
+            }
+
+            // Not a valid LSP header (e.g. stray server output) - skip it
+            m_readPos = headerEnd + terminator.size();
+        }
+
+        m_bodyStart = headerEnd + terminator.size();
+        m_bodyLength = length;
+
+        // Grow once for large bodies instead of repeatedly while they stream in
+        if (m_buffer.capacity() < m_bodyStart + m_bodyLength) {
+            m_buffer.reserve(m_bodyStart + m_bodyLength);
+        }
+        return true;
+    }
+
+    /**
+     * Drop consumed bytes when it is cheap or worthwhile to do so.
+     */
+    void compact() {
+        if (m_readPos == 0) return;
+
+        if (m_readPos == m_buffer.size()) {
+            // Fully drained: reset without moving anything (keeps capacity)
+            m_buffer.clear();
+        } else if (m_readPos >= kCompactThreshold && m_readPos * 2 >= m_buffer.size()) {
+            m_buffer.erase(0, m_readPos);
+        } else {
+            return;
+        }
+
+        if (m_bodyStart != std::string::npos) {
+            m_bodyStart -= m_readPos;
+        }
+        m_scanPos = m_scanPos > m_readPos ? m_scanPos - m_readPos : 0;
+        m_readPos = 0;
+    }
+
+    static bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            char ca = a[i];
+            char cb = b[i];
+            if (ca >= 'A' && ca <= 'Z') ca = static_cast<char>(ca - 'A' + 'a');
+            if (cb >= 'A' && cb <= 'Z') cb = static_cast<char>(cb - 'A' + 'a');
+            if (ca != cb) return false;
+        }
+        return true;
+    }
+};
+
+#endif // LSP_FRAMER_H
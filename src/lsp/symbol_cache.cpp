@@ -0,0 +1,244 @@
+#include "symbol_cache.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+constexpr uint32_t kMagic = 0x43534D42;  // "BMSC"
+constexpr uint32_t kVersion = 1;
+
+// Guards against absurd counts from a corrupt file
+constexpr uint32_t kMaxChildDepth = 256;
+
+// --- Serialization helpers ---
+
+class Writer {
+public:
+    explicit Writer(std::string& out) : m_out(out) {}
+
+    template <typename T>
+    void pod(T value) {
+        m_out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void string(const std::string& value) {
+        pod<uint32_t>(static_cast<uint32_t>(value.size()));
+        m_out.append(value);
+    }
+
+    void range(const LspRange& r) {
+        pod<int32_t>(r.start.line);
+        pod<int32_t>(r.start.character);
+        pod<int32_t>(r.end.line);
+        pod<int32_t>(r.end.character);
+    }
+
+    void symbols(const std::vector<LspDocumentSymbol>& list) {
+        pod<uint32_t>(static_cast<uint32_t>(list.size()));
+        for (const auto& symbol : list) {
+            string(symbol.name);
+            string(symbol.detail);
+            pod<uint8_t>(static_cast<uint8_t>(symbol.kind));
+            range(symbol.range);
+            range(symbol.selectionRange);
+            symbols(symbol.children);
+        }
+    }
+
+private:
+    std::string& m_out;
+};
+
+class Reader {
+public:
+    Reader(const char* data, size_t size) : m_cursor(data), m_end(data + size) {}
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_cursor == m_end; }
+
+    template <typename T>
+    T pod() {
+        T value{};
+        if (!take(sizeof(T))) return value;
+        std::memcpy(&value, m_cursor - sizeof(T), sizeof(T));
+        return value;
+    }
+
+    std::string string() {
+        uint32_t size = pod<uint32_t>();
+        if (!take(size)) return {};
+        return std::string(m_cursor - size, size);
+    }
+
+    LspRange range() {
+        LspRange r;
+        r.start.line = pod<int32_t>();
+        r.start.character = pod<int32_t>();
+        r.end.line = pod<int32_t>();
+        r.end.character = pod<int32_t>();
+        return r;
+    }
+
+    void symbols(std::vector<LspDocumentSymbol>& out, uint32_t depth = 0) {
+        uint32_t count = pod<uint32_t>();
+        if (depth > kMaxChildDepth || count > remaining()) {
+            m_ok = false;
+            return;
+        }
+        out.resize(count);
+        for (auto& symbol : out) {
+            symbol.name = string();
+            symbol.detail = string();
+            symbol.kind = static_cast<LspSymbolKind>(pod<uint8_t>());
+            symbol.range = range();
+            symbol.selectionRange = range();
+            symbols(symbol.children, depth + 1);
+            if (!m_ok) return;
+        }
+    }
+
+private:
+    const char* m_cursor;
+    const char* m_end;
+    bool m_ok = true;
+
+    size_t remaining() const { return static_cast<size_t>(m_end - m_cursor); }
+
+    bool take(size_t size) {
+        if (!m_ok || size > remaining()) {
+            m_ok = false;
+            return false;
+        }
+        m_cursor += size;
+        return true;
+    }
+};
+
+} // namespace
+
+// --- Entries ---
+
+const std::vector<LspDocumentSymbol>* SymbolCache::find(const std::string& filePath,
+                                                        const FileStamp& stamp) const {
+    if (!stamp.isKnown()) {
+        return nullptr;  // Nothing to validate against
+    }
+    auto it = m_files.find(filePath);
+    if (it == m_files.end() || !(it->second.stamp == stamp)) {
+        return nullptr;
+    }
+    return &it->second.symbols;
+}
+
+void SymbolCache::store(const std::string& filePath, const FileStamp& stamp,
+                        std::vector<LspDocumentSymbol> symbols) {
+    m_files[filePath] = Entry{stamp, std::move(symbols)};
+    m_dirty = true;
+}
+
+void SymbolCache::retainOnly(const std::set<std::string>& filePaths) {
+    for (auto it = m_files.begin(); it != m_files.end();) {
+        if (filePaths.count(it->first)) {
+            ++it;
+        } else {
+            it = m_files.erase(it);
+            m_dirty = true;
+        }
+    }
+}
+
+void SymbolCache::clear() {
+    m_dirty = !m_files.empty();
+    m_files.clear();
+}
+
+// --- Persistence ---
+
+bool SymbolCache::load(const std::string& cacheFile) {
+    m_files.clear();
+    m_dirty = false;
+
+    std::ifstream in(cacheFile, std::ios::binary);
+    if (!in) return false;
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    Reader reader(data.data(), data.size());
+    if (reader.pod<uint32_t>() != kMagic || reader.pod<uint32_t>() != kVersion) {
+        return false;
+    }
+    if (reader.string() != m_workspaceKey) {
+        return false;
+    }
+
+    uint32_t fileCount = reader.pod<uint32_t>();
+    std::unordered_map<std::string, Entry> files;
+    files.reserve(fileCount);
+    for (uint32_t i = 0; i < fileCount && reader.ok(); ++i) {
+        std::string path = reader.string();
+        Entry entry;
+        entry.stamp.modTime = reader.pod<int64_t>();
+        entry.stamp.size = reader.pod<int64_t>();
+        reader.symbols(entry.symbols);
+        files.emplace(std::move(path), std::move(entry));
+    }
+
+    if (!reader.ok() || !reader.atEnd()) {
+        return false;  // Truncated or corrupt: start from scratch
+    }
+
+    m_files = std::move(files);
+    return !m_files.empty();
+}
+
+bool SymbolCache::save(const std::string& cacheFile) {
+    std::string data;
+    Writer writer(data);
+    writer.pod<uint32_t>(kMagic);
+    writer.pod<uint32_t>(kVersion);
+    writer.string(m_workspaceKey);
+    writer.pod<uint32_t>(static_cast<uint32_t>(m_files.size()));
+    for (const auto& [path, entry] : m_files) {
+        writer.string(path);
+        writer.pod<int64_t>(entry.stamp.modTime);
+        writer.pod<int64_t>(entry.stamp.size);
+        writer.symbols(entry.symbols);
+    }
+
+    // Write beside the target and rename, so a crash never leaves a torn cache
+    std::string tempFile = cacheFile + ".tmp";
+    {
+        std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out) {
+            out.close();
+            std::remove(tempFile.c_str());
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempFile, cacheFile, ec);
+    if (ec) {
+        std::remove(tempFile.c_str());
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+std::string SymbolCache::FileNameFor(const std::string& workspaceKey) {
+    // FNV-1a: stable across runs and platforms, unlike std::hash
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : workspaceKey) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    char name[32];
+    std::snprintf(name, sizeof(name), "symbols-%016llx.bin", static_cast<unsigned long long>(hash));
+    return name;
+}
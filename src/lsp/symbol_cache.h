@@ -0,0 +1,93 @@
+#ifndef SYMBOL_CACHE_H
+#define SYMBOL_CACHE_H
+
+#include "lsp_client.h"
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Persistent cache of document symbols for one workspace.
+ *
+ * Maps each indexed file to the symbols the language server reported for it,
+ * together with the file's modification time and size at the time. On the
+ * next launch, files whose stamp is unchanged are served from the cache and
+ * only new or modified files are sent to the server again.
+ *
+ * The on-disk form is a compact binary file (native byte order, versioned)
+ * that records the workspace key it belongs to, so a cache is never applied
+ * to the wrong workspace even if two keys hash to the same file name.
+ */
+class SymbolCache {
+public:
+    /**
+     * What a cached entry is validated against.
+     */
+    struct FileStamp {
+        int64_t modTime = 0;    // Seconds since the epoch
+        int64_t size = -1;      // Bytes, -1 if unknown
+
+        bool isKnown() const { return modTime != 0 || size >= 0; }
+
+        bool operator==(const FileStamp& other) const {
+            return modTime == other.modTime && size == other.size;
+        }
+    };
+
+    explicit SymbolCache(std::string workspaceKey = "")
+        : m_workspaceKey(std::move(workspaceKey)) {}
+
+    const std::string& workspaceKey() const { return m_workspaceKey; }
+
+    /**
+     * Cached symbols for a file, or nullptr if the file is not cached, has
+     * changed since it was indexed, or its stamp is unknown.
+     */
+    const std::vector<LspDocumentSymbol>* find(const std::string& filePath, const FileStamp& stamp) const;
+
+    /**
+     * Record the symbols indexed for a file.
+     */
+    void store(const std::string& filePath, const FileStamp& stamp, std::vector<LspDocumentSymbol> symbols);
+
+    /**
+     * Drop entries for files that are no longer part of the workspace.
+     */
+    void retainOnly(const std::set<std::string>& filePaths);
+
+    void clear();
+    size_t fileCount() const { return m_files.size(); }
+    bool isDirty() const { return m_dirty; }
+
+    /**
+     * Load the cache from disk. Missing, corrupt, outdated or foreign cache
+     * files leave the cache empty.
+     * @return true if entries were loaded.
+     */
+    bool load(const std::string& cacheFile);
+
+    /**
+     * Write the cache to disk (via a temporary file and rename).
+     * @return true on success.
+     */
+    bool save(const std::string& cacheFile);
+
+    /**
+     * Cache file name for a workspace key, e.g. "symbols-1a2b3c4d5e6f7a8b.bin".
+     */
+    static std::string FileNameFor(const std::string& workspaceKey);
+
+private:
+    struct Entry {
+        FileStamp stamp;
+        std::vector<LspDocumentSymbol> symbols;
+    };
+
+    std::string m_workspaceKey;
+    std::unordered_map<std::string, Entry> m_files;
+    bool m_dirty = false;
+};
+
+#endif // SYMBOL_CACHE_H
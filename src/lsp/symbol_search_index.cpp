@@ -0,0 +1,194 @@
+#include "symbol_search_index.h"
+#include <algorithm>
+#include <tuple>
+
+// --- Building ---
+
+uint32_t SymbolSearchIndex::add(std::string_view name) {
+    uint32_t symbolId = static_cast<uint32_t>(m_symbolName.size());
+    uint32_t nameId = internName(toLower(name));
+
+    m_symbolName.push_back(nameId);
+    m_nextSymbol.push_back(kNone);
+    if (m_lastSymbol[nameId] == kNone) {
+        m_firstSymbol[nameId] = symbolId;
+    } else {
+        m_nextSymbol[m_lastSymbol[nameId]] = symbolId;
+    }
+    m_lastSymbol[nameId] = symbolId;
+    m_symbolCount[nameId]++;
+
+    return symbolId;
+}
+
+uint32_t SymbolSearchIndex::internName(std::string_view lowerName) {
+    auto it = m_nameIds.find(lowerName);
+    if (it != m_nameIds.end()) {
+        return it->second;
+    }
+
+    uint32_t nameId = static_cast<uint32_t>(m_names.size());
+    const std::string& stored = m_names.emplace_back(lowerName);
+    m_nameIds.emplace(std::string_view(stored), nameId);
+
+    m_firstSymbol.push_back(kNone);
+    m_lastSymbol.push_back(kNone);
+    m_symbolCount.push_back(0);
+
+    // Name ids only grow, so each posting list stays sorted by appending
+    for (size_t i = 0; i + 3 <= stored.size(); ++i) {
+        auto& postings = m_trigrams[trigramKey(stored.data() + i)];
+        if (postings.empty() || postings.back() != nameId) {
+            postings.push_back(nameId);
+        }
+    }
+
+    m_prefixTail.push_back(nameId);
+    if (m_prefixTail.size() >= kPrefixMergeThreshold) {
+        mergePrefixTail();
+    }
+
+    return nameId;
+}
+
+void SymbolSearchIndex::mergePrefixTail() {
+    auto byName = [this](uint32_t a, uint32_t b) { return m_names[a] < m_names[b]; };
+    std::sort(m_prefixTail.begin(), m_prefixTail.end(), byName);
+
+    size_t middle = m_prefixSorted.size();
+    m_prefixSorted.insert(m_prefixSorted.end(), m_prefixTail.begin(), m_prefixTail.end());
+    std::inplace_merge(m_prefixSorted.begin(), m_prefixSorted.begin() + middle, m_prefixSorted.end(), byName);
+    m_prefixTail.clear();
+}
+
+void SymbolSearchIndex::clear() {
+    m_nameIds.clear();
+    m_names.clear();
+    m_firstSymbol.clear();
+    m_lastSymbol.clear();
+    m_symbolCount.clear();
+    m_nextSymbol.clear();
+    m_symbolName.clear();
+    m_trigrams.clear();
+    m_prefixSorted.clear();
+    m_prefixTail.clear();
+}
+
+// --- Queries ---
+
+std::vector<uint32_t> SymbolSearchIndex::search(std::string_view query, size_t maxResults) const {
+    std::vector<uint32_t> results;
+    if (maxResults == 0 || m_symbolName.empty()) return results;
+
+    std::string lowerQuery = toLower(query);
+
+    // Prefix matches from the sorted table (binary search) plus the unmerged tail
+    std::vector<uint32_t> prefixNames;
+    auto lower = std::lower_bound(m_prefixSorted.begin(), m_prefixSorted.end(), lowerQuery,
+        [this](uint32_t id, const std::string& q) { return m_names[id] < q; });
+    for (auto it = lower; it != m_prefixSorted.end() && m_names[*it].starts_with(lowerQuery); ++it) {
+        prefixNames.push_back(*it);
+    }
+    for (uint32_t id : m_prefixTail) {
+        if (m_names[id].starts_with(lowerQuery)) {
+            prefixNames.push_back(id);
+        }
+    }
+
+    size_t prefixSymbols = 0;
+    for (uint32_t id : prefixNames) {
+        prefixSymbols += m_symbolCount[id];
+    }
+
+    // Matches elsewhere in the name are only needed if prefixes don't fill the page
+    std::vector<uint32_t> innerNames;
+    if (prefixSymbols < maxResults) {
+        auto isInnerMatch = [&](uint32_t id) {
+            const std::string& name = m_names[id];
+            return name.size() > lowerQuery.size() && !name.starts_with(lowerQuery) &&
+                   name.find(lowerQuery, 1) != std::string::npos;
+        };
+
+        if (lowerQuery.size() >= 3) {
+            for (uint32_t id : trigramCandidates(lowerQuery)) {
+                if (isInnerMatch(id)) innerNames.push_back(id);
+            }
+        } else {
+            for (uint32_t id = 0; id < m_names.size(); ++id) {
+                if (isInnerMatch(id)) innerNames.push_back(id);
+            }
+        }
+    }
+
+    // Rank names: shorter first, then by first appearance. Every name has at
+    // least one symbol, so only the best maxResults names can make the cut.
+    auto byRank = [this](uint32_t a, uint32_t b) {
+        return std::make_tuple(m_names[a].size(), m_firstSymbol[a]) <
+               std::make_tuple(m_names[b].size(), m_firstSymbol[b]);
+    };
+    for (auto* names : {&prefixNames, &innerNames}) {
+        if (names->size() > maxResults) {
+            std::partial_sort(names->begin(), names->begin() + maxResults, names->end(), byRank);
+            names->resize(maxResults);
+        } else {
+            std::sort(names->begin(), names->end(), byRank);
+        }
+    }
+
+    results.reserve(std::min(maxResults, prefixSymbols + innerNames.size()));
+    for (const auto* names : {&prefixNames, &innerNames}) {
+        for (uint32_t nameId : *names) {
+            for (uint32_t s = m_firstSymbol[nameId]; s != kNone; s = m_nextSymbol[s]) {
+                results.push_back(s);
+                if (results.size() >= maxResults) return results;
+            }
+        }
+    }
+    return results;
+}
+
+std::vector<uint32_t> SymbolSearchIndex::trigramCandidates(std::string_view lowerQuery) const {
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (size_t i = 0; i + 3 <= lowerQuery.size(); ++i) {
+        auto it = m_trigrams.find(trigramKey(lowerQuery.data() + i));
+        if (it == m_trigrams.end()) {
+            return {};  // Some trigram occurs in no name at all
+        }
+        if (std::find(lists.begin(), lists.end(), &it->second) == lists.end()) {
+            lists.push_back(&it->second);
+        }
+    }
+
+    // Intersect starting from the rarest trigram
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+
+    std::vector<uint32_t> candidates = *lists.front();
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+        const auto& postings = *lists[i];
+        auto cursor = postings.begin();
+        size_t kept = 0;
+        for (uint32_t id : candidates) {
+            cursor = std::lower_bound(cursor, postings.end(), id);
+            if (cursor == postings.end()) break;
+            if (*cursor == id) candidates[kept++] = id;
+        }
+        candidates.resize(kept);
+    }
+    return candidates;
+}
+
+// --- Helpers ---
+
+std::string SymbolSearchIndex::toLower(std::string_view text) {
+    std::string lower(text);
+    for (char& c : lower) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return lower;
+}
+
+uint32_t SymbolSearchIndex::trigramKey(const char* p) {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(p[0])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(p[1])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(p[2]));
+}
@@ -0,0 +1,86 @@
+#ifndef SYMBOL_SEARCH_INDEX_H
+#define SYMBOL_SEARCH_INDEX_H
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Case-insensitive substring search over symbol names.
+ *
+ * Symbols are identified by the order in which they were added (0, 1, 2, ...),
+ * so ids line up with the caller's own symbol storage. Names are lowercased
+ * once and interned: symbols sharing a name (overloads, common members like
+ * "size") share one entry, and every query works on unique names only.
+ *
+ * Two structures answer queries:
+ * - trigram postings (trigram -> sorted name ids) narrow queries of three or
+ *   more characters to a few candidates, which are then verified;
+ * - a sorted prefix table finds prefix matches by binary search. Prefix
+ *   matches rank first, so when they alone fill the requested result count
+ *   (typical for the first keystrokes) no other work is done.
+ *
+ * Adding is incremental and keeps the structures queryable at all times.
+ * Not thread safe: callers serialize access.
+ */
+class SymbolSearchIndex {
+public:
+    static constexpr size_t kUnlimited = std::numeric_limits<size_t>::max();
+
+    /**
+     * Add a symbol name.
+     * @return The symbol's id (equal to the number of symbols added before it).
+     */
+    uint32_t add(std::string_view name);
+
+    void clear();
+
+    size_t size() const { return m_symbolName.size(); }
+    size_t uniqueNameCount() const { return m_names.size(); }
+
+    /**
+     * Find symbols whose name contains the query, ignoring ASCII case.
+     * Results are ranked best first: prefix matches before other matches,
+     * then shorter names, then insertion order. An empty query matches all.
+     */
+    std::vector<uint32_t> search(std::string_view query, size_t maxResults = kUnlimited) const;
+
+private:
+    static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+    // Unsorted prefix-table tail size that triggers a merge
+    static constexpr size_t kPrefixMergeThreshold = 4096;
+
+    // Interned lowercase names; deque keeps the strings (and views of them) stable
+    std::deque<std::string> m_names;
+    std::unordered_map<std::string_view, uint32_t> m_nameIds;
+
+    // Symbols per name, as a singly linked list in insertion order
+    std::vector<uint32_t> m_firstSymbol;
+    std::vector<uint32_t> m_lastSymbol;
+    std::vector<uint32_t> m_symbolCount;
+    std::vector<uint32_t> m_nextSymbol;     // Indexed by symbol id
+    std::vector<uint32_t> m_symbolName;     // Symbol id -> name id
+
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_trigrams;
+
+    std::vector<uint32_t> m_prefixSorted;   // Name ids ordered by name
+    std::vector<uint32_t> m_prefixTail;     // Recent name ids, not yet merged
+
+    uint32_t internName(std::string_view lowerName);
+    void mergePrefixTail();
+
+    /**
+     * Name ids containing the query (lowercased, at least 3 characters).
+     */
+    std::vector<uint32_t> trigramCandidates(std::string_view lowerQuery) const;
+
+    static std::string toLower(std::string_view text);
+    static uint32_t trigramKey(const char* p);
+};
+
+#endif // SYMBOL_SEARCH_INDEX_H
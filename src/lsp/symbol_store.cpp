@@ -0,0 +1,245 @@
+#include "symbol_store.h"
+#include <bit>
+
+// --- Writing ---
+
+bool SymbolStore::addFile(const std::string& filePath, const std::vector<LspDocumentSymbol>& symbols) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    if (m_fileIds.count(filePath)) {
+        return false;
+    }
+
+    uint32_t fileId = static_cast<uint32_t>(m_files.size());
+    m_files.push_back(filePath);
+    m_fileIds.emplace(filePath, fileId);
+
+    SymbolId begin = static_cast<SymbolId>(m_names.size());
+    appendSymbols(fileId, symbols);
+    m_fileRanges.emplace_back(begin, static_cast<SymbolId>(m_names.size()));
+    return true;
+}
+
+void SymbolStore::appendSymbols(uint32_t fileId, const std::vector<LspDocumentSymbol>& symbols) {
+    for (const auto& symbol : symbols) {
+        SymbolId id = static_cast<SymbolId>(m_names.size());
+        m_names.push_back(symbol.name);
+        m_details.push_back(symbol.detail);
+        m_kinds.push_back(symbol.kind);
+        m_ranges.push_back(symbol.range);
+        m_selectionRanges.push_back(symbol.selectionRange);
+        m_fileOf.push_back(fileId);
+        m_searchIndex.add(symbol.name);
+        setKindBit(id, symbol.kind);
+
+        appendSymbols(fileId, symbol.children);
+    }
+}
+
+void SymbolStore::setKindBit(SymbolId id, LspSymbolKind kind) {
+    auto& bits = m_kindBits[kindSlot(kind)];
+    size_t word = id / 64;
+    if (bits.size() <= word) {
+        bits.resize(word + 1, 0);
+    }
+    bits[word] |= uint64_t(1) << (id % 64);
+}
+
+size_t SymbolStore::removeFiles(const std::unordered_set<std::string>& filePaths) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    size_t removedCount = 0;
+    for (const auto& path : filePaths) {
+        auto it = m_fileIds.find(path);
+        if (it == m_fileIds.end()) continue;
+
+        // Clearing the kind bits is what takes the symbols out of every query
+        auto [begin, end] = m_fileRanges[it->second];
+        for (SymbolId id = begin; id < end; ++id) {
+            m_kindBits[kindSlot(m_kinds[id])][id / 64] &= ~(uint64_t(1) << (id % 64));
+        }
+        m_deadCount += end - begin;
+        m_fileIds.erase(it);
+        ++removedCount;
+    }
+
+    if (m_deadCount >= kCompactMinimum && m_deadCount * 4 >= m_names.size()) {
+        compact();
+    }
+    return removedCount;
+}
+
+void SymbolStore::compact() {
+    // Files occupy ascending id ranges, so the live symbols slide down in
+    // place; the kind bitmaps and search index are rebuilt as they go
+    for (auto& bits : m_kindBits) {
+        bits.clear();
+    }
+    m_searchIndex.clear();
+
+    SymbolId next = 0;
+    uint32_t nextFile = 0;
+    for (size_t file = 0; file < m_files.size(); ++file) {
+        if (!isLiveFile(file)) continue;
+
+        auto [begin, end] = m_fileRanges[file];
+        SymbolId newBegin = next;
+        for (SymbolId id = begin; id < end; ++id, ++next) {
+            if (next != id) {
+                m_names[next] = std::move(m_names[id]);
+                m_details[next] = std::move(m_details[id]);
+                m_kinds[next] = m_kinds[id];
+                m_ranges[next] = m_ranges[id];
+                m_selectionRanges[next] = m_selectionRanges[id];
+            }
+            m_fileOf[next] = nextFile;
+            m_searchIndex.add(m_names[next]);
+            setKindBit(next, m_kinds[next]);
+        }
+
+        if (nextFile != file) {
+            m_files[nextFile] = std::move(m_files[file]);
+        }
+        m_fileRanges[nextFile] = {newBegin, next};
+        m_fileIds[m_files[nextFile]] = nextFile;
+        ++nextFile;
+    }
+
+    m_names.resize(next);
+    m_details.resize(next);
+    m_kinds.resize(next);
+    m_ranges.resize(next);
+    m_selectionRanges.resize(next);
+    m_fileOf.resize(next);
+    m_files.resize(nextFile);
+    m_fileRanges.resize(nextFile);
+    m_deadCount = 0;
+}
+
+bool SymbolStore::isLive(SymbolId id) const {
+    const auto& bits = m_kindBits[kindSlot(m_kinds[id])];
+    return id / 64 < bits.size() && (bits[id / 64] >> (id % 64)) & 1;
+}
+
+bool SymbolStore::isLiveFile(size_t file) const {
+    // A removed path may have been added again under a newer slot
+    auto it = m_fileIds.find(m_files[file]);
+    return it != m_fileIds.end() && it->second == file;
+}
+
+void SymbolStore::clear() {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    m_names.clear();
+    m_details.clear();
+    m_kinds.clear();
+    m_ranges.clear();
+    m_selectionRanges.clear();
+    m_fileOf.clear();
+    m_files.clear();
+    m_fileRanges.clear();
+    m_fileIds.clear();
+    for (auto& bits : m_kindBits) {
+        bits.clear();
+    }
+    m_searchIndex.clear();
+    m_deadCount = 0;
+}
+
+// --- Reading ---
+
+SymbolStore::SymbolRange SymbolStore::fileSymbols(const std::string& filePath) const {
+    auto it = m_fileIds.find(filePath);
+    if (it == m_fileIds.end()) {
+        return SymbolRange(this, 0, 0);
+    }
+    auto [begin, end] = m_fileRanges[it->second];
+    return SymbolRange(this, begin, end);
+}
+
+SymbolStore::KindView SymbolStore::symbolsOfKinds(std::initializer_list<LspSymbolKind> kinds) const {
+    uint32_t mask = 0;
+    for (LspSymbolKind kind : kinds) {
+        mask |= uint32_t(1) << kindSlot(kind);
+    }
+    return KindView(this, mask);
+}
+
+std::vector<SymbolStore::SymbolRef> SymbolStore::search(std::string_view query, size_t maxResults) const {
+    // Dead ids still rank in the index; ask for enough to fill maxResults anyway
+    size_t wanted = maxResults > SymbolSearchIndex::kUnlimited - m_deadCount
+        ? SymbolSearchIndex::kUnlimited : maxResults + m_deadCount;
+
+    std::vector<SymbolRef> results;
+    for (SymbolId id : m_searchIndex.search(query, wanted)) {
+        if (results.size() == maxResults) break;
+        if (isLive(id)) {
+            results.emplace_back(this, id);
+        }
+    }
+    return results;
+}
+
+std::vector<std::string> SymbolStore::files() const {
+    std::vector<std::string> files;
+    for (size_t file = 0; file < m_files.size(); ++file) {
+        if (isLiveFile(file)) {
+            files.push_back(m_files[file]);
+        }
+    }
+    return files;
+}
+
+size_t SymbolStore::kindSlot(LspSymbolKind kind) {
+    // Unknown kinds from newer servers share slot 0 (unused by the protocol)
+    auto value = static_cast<size_t>(kind);
+    return value < kKindSlots ? value : 0;
+}
+
+// --- KindView ---
+
+uint64_t SymbolStore::KindView::word(const SymbolStore* store, uint32_t kindMask, size_t index) {
+    uint64_t bits = 0;
+    for (uint32_t mask = kindMask; mask; mask &= mask - 1) {
+        const auto& kindBits = store->m_kindBits[std::countr_zero(mask)];
+        if (index < kindBits.size()) {
+            bits |= kindBits[index];
+        }
+    }
+    return bits;
+}
+
+size_t SymbolStore::KindView::count() const {
+    size_t total = 0;
+    for (size_t i = 0, n = wordCount(m_store); i < n; ++i) {
+        total += std::popcount(word(m_store, m_kindMask, i));
+    }
+    return total;
+}
+
+SymbolStore::KindView::Iterator::Iterator(const SymbolStore* store, uint32_t kindMask, size_t word)
+    : m_store(store), m_kindMask(kindMask), m_word(word) {
+    if (m_word < wordCount(m_store)) {
+        m_bits = KindView::word(m_store, m_kindMask, m_word);
+        settle();
+    }
+}
+
+SymbolStore::KindView::Iterator& SymbolStore::KindView::Iterator::operator++() {
+    m_bits &= m_bits - 1;
+    settle();
+    return *this;
+}
+
+void SymbolStore::KindView::Iterator::settle() {
+    // Advance to the next set bit, moving across empty words
+    size_t words = wordCount(m_store);
+    while (m_bits == 0) {
+        if (++m_word >= words) {
+            m_word = words;
+            return;
+        }
+        m_bits = word(m_store, m_kindMask, m_word);
+    }
+    m_id = static_cast<SymbolId>(m_word * 64 + std::countr_zero(m_bits));
+}
@@ -0,0 +1,229 @@
+#ifndef SYMBOL_STORE_H
+#define SYMBOL_STORE_H
+
+#include "lsp_client.h"
+#include "symbol_search_index.h"
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Workspace symbol table stored as a struct of arrays.
+ *
+ * Each symbol's fields live in parallel vectors indexed by a dense SymbolId,
+ * and document symbol hierarchies are flattened on insertion. Because a
+ * file's symbols are added in one go they occupy a contiguous id range, so
+ * per-file queries are a lookup. Per-kind queries walk one bitmap per kind.
+ * Queries return lightweight views (SymbolRef, SymbolRange, KindView) that
+ * read the columns in place instead of copying symbols out.
+ *
+ * Removing files only tombstones their symbols: the kind bitmaps double as
+ * the live set, and search results skip dead ids. Once enough symbols are
+ * dead the columns, bitmaps and search index are compacted in one pass, so
+ * re-indexing a few changed files stays proportional to their size.
+ *
+ * Threading: a single writer thread (the UI thread) adds, removes and
+ * clears symbols and may read without locking. Any other thread must hold
+ * readLock() while it queries or uses views.
+ */
+class SymbolStore {
+public:
+    using SymbolId = uint32_t;
+
+    /**
+     * View of one symbol. Valid until the store is cleared or files are removed.
+     */
+    class SymbolRef {
+    public:
+        SymbolRef(const SymbolStore* store, SymbolId id) : m_store(store), m_id(id) {}
+
+        SymbolId id() const { return m_id; }
+        const std::string& name() const { return m_store->m_names[m_id]; }
+        const std::string& detail() const { return m_store->m_details[m_id]; }
+        LspSymbolKind kind() const { return m_store->m_kinds[m_id]; }
+        const LspRange& range() const { return m_store->m_ranges[m_id]; }
+        const LspRange& selectionRange() const { return m_store->m_selectionRanges[m_id]; }
+        const std::string& filePath() const { return m_store->m_files[m_store->m_fileOf[m_id]]; }
+
+    private:
+        const SymbolStore* m_store;
+        SymbolId m_id;
+    };
+
+    /**
+     * Contiguous run of symbols, e.g. everything in one file.
+     */
+    class SymbolRange {
+    public:
+        class Iterator {
+        public:
+            Iterator(const SymbolStore* store, SymbolId id) : m_store(store), m_id(id) {}
+            SymbolRef operator*() const { return SymbolRef(m_store, m_id); }
+            Iterator& operator++() { ++m_id; return *this; }
+            bool operator==(const Iterator& other) const { return m_id == other.m_id; }
+
+        private:
+            const SymbolStore* m_store;
+            SymbolId m_id;
+        };
+
+        SymbolRange(const SymbolStore* store, SymbolId begin, SymbolId end)
+            : m_store(store), m_begin(begin), m_end(end) {}
+
+        Iterator begin() const { return Iterator(m_store, m_begin); }
+        Iterator end() const { return Iterator(m_store, m_end); }
+        size_t size() const { return m_end - m_begin; }
+        bool empty() const { return m_begin == m_end; }
+
+    private:
+        const SymbolStore* m_store;
+        SymbolId m_begin;
+        SymbolId m_end;
+    };
+
+    /**
+     * Symbols of one or more kinds, in workspace order, read straight from
+     * the kind bitmaps.
+     */
+    class KindView {
+    public:
+        class Iterator {
+        public:
+            Iterator(const SymbolStore* store, uint32_t kindMask, size_t word);
+            SymbolRef operator*() const { return SymbolRef(m_store, m_id); }
+            Iterator& operator++();
+            bool operator==(const Iterator& other) const { return m_word == other.m_word && m_bits == other.m_bits; }
+
+        private:
+            const SymbolStore* m_store;
+            uint32_t m_kindMask;
+            size_t m_word;          // Current bitmap word
+            uint64_t m_bits = 0;    // Remaining set bits in that word
+            SymbolId m_id = 0;
+
+            void settle();
+        };
+
+        KindView(const SymbolStore* store, uint32_t kindMask) : m_store(store), m_kindMask(kindMask) {}
+
+        Iterator begin() const { return Iterator(m_store, m_kindMask, 0); }
+        Iterator end() const { return Iterator(m_store, m_kindMask, wordCount(m_store)); }
+
+        /**
+         * Number of symbols in the view (popcount, no iteration of ids).
+         */
+        size_t count() const;
+
+    private:
+        const SymbolStore* m_store;
+        uint32_t m_kindMask;    // Bit k set = LspSymbolKind k included
+
+        static size_t wordCount(const SymbolStore* store) { return (store->m_names.size() + 63) / 64; }
+        static uint64_t word(const SymbolStore* store, uint32_t kindMask, size_t index);
+    };
+
+    // --- Writing (writer thread only) ---
+
+    /**
+     * Add a file's document symbols, flattening their children.
+     * @return false (and nothing is added) if the file is already present.
+     */
+    bool addFile(const std::string& filePath, const std::vector<LspDocumentSymbol>& symbols);
+
+    /**
+     * Drop the given files' symbols, e.g. before re-adding files that changed.
+     * Their ids are tombstoned; once at least kCompactMinimum symbols and a
+     * quarter of all ids are dead, the store is compacted, so ids change but
+     * stay in order.
+     * @return Number of files removed.
+     */
+    size_t removeFiles(const std::unordered_set<std::string>& filePaths);
+
+    void clear();
+
+    // --- Reading ---
+
+    /**
+     * Shared lock for readers on threads other than the writer.
+     */
+    std::shared_lock<std::shared_mutex> readLock() const {
+        return std::shared_lock<std::shared_mutex>(m_mutex);
+    }
+
+    /**
+     * Number of live symbols; ids may run higher until the store compacts.
+     */
+    size_t size() const { return m_names.size() - m_deadCount; }
+    bool empty() const { return size() == 0; }
+    size_t fileCount() const { return m_fileIds.size(); }
+
+    SymbolRef symbol(SymbolId id) const { return SymbolRef(this, id); }
+
+    /**
+     * All live symbols in workspace order.
+     */
+    KindView all() const { return KindView(this, ~uint32_t(0)); }
+
+    /**
+     * All symbols of a file (empty if the file is not indexed).
+     */
+    SymbolRange fileSymbols(const std::string& filePath) const;
+
+    /**
+     * All symbols whose kind is one of the given kinds.
+     */
+    KindView symbolsOfKinds(std::initializer_list<LspSymbolKind> kinds) const;
+
+    /**
+     * Ranked case-insensitive name search (see SymbolSearchIndex).
+     */
+    std::vector<SymbolRef> search(std::string_view query, size_t maxResults = SymbolSearchIndex::kUnlimited) const;
+
+    /**
+     * Indexed file paths in insertion order.
+     */
+    std::vector<std::string> files() const;
+
+    static constexpr size_t kCompactMinimum = 4096;
+
+private:
+    static constexpr size_t kKindSlots = 32;
+
+    // Symbol columns, indexed by SymbolId
+    std::vector<std::string> m_names;
+    std::vector<std::string> m_details;
+    std::vector<LspSymbolKind> m_kinds;
+    std::vector<LspRange> m_ranges;
+    std::vector<LspRange> m_selectionRanges;
+    std::vector<uint32_t> m_fileOf;
+
+    // Files and their [begin, end) symbol ranges; removed files keep their
+    // slot until the store compacts, but leave m_fileIds
+    std::vector<std::string> m_files;
+    std::vector<std::pair<SymbolId, SymbolId>> m_fileRanges;
+    std::unordered_map<std::string, uint32_t> m_fileIds;
+
+    // One bit per live symbol for each kind; shorter vectors mean trailing zeros
+    std::array<std::vector<uint64_t>, kKindSlots> m_kindBits;
+    size_t m_deadCount = 0;
+
+    SymbolSearchIndex m_searchIndex;
+
+    mutable std::shared_mutex m_mutex;
+
+    void appendSymbols(uint32_t fileId, const std::vector<LspDocumentSymbol>& symbols);
+    void setKindBit(SymbolId id, LspSymbolKind kind);
+    bool isLive(SymbolId id) const;
+    bool isLiveFile(size_t file) const;
+    void compact();
+    static size_t kindSlot(LspSymbolKind kind);
+};
+
+#endif // SYMBOL_STORE_H
@@ -3,10 +3,13 @@
 
 #include <string>
 #include <vector>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <functional>
+#include <mutex>
 #include <optional>
+#include <unordered_map>
 
 #include <wx/log.h>
 
@@ -286,20 +289,34 @@ public:
     /**
      * Check if this provider is currently enabled/available.
      */
-    virtual bool isEnabled() const { return true; }
+    virtual bool isEnabled() const { return m_enabled; }
     
     /**
      * Enable or disable this provider.
      */
     virtual void setEnabled(bool enabled) { m_enabled = enabled; }
+    
+    /**
+     * How many of this provider's tool calls may run at the same time when
+     * the model requests several in one turn. Providers whose tools are
+     * safe to run concurrently can raise this; the default keeps them
+     * one at a time.
+     */
+    virtual size_t maxConcurrentCalls() const { return 1; }
 
 protected:
-    bool m_enabled = true;
+    // Toggled on the UI thread, read by tool calls on worker threads
+    std::atomic<bool> m_enabled{true};
 };
 
 /**
  * Registry for MCP providers.
  * Manages all available providers and routes tool calls to the appropriate provider.
+ * 
+ * The tool name -> provider table and the serialized Gemini tools JSON are
+ * cached and only rebuilt when a provider is registered or unregistered or
+ * its isEnabled() state changes, so routing a call or building a request
+ * doesn't ask every provider for its tool definitions each AI turn.
  */
 class Registry {
 public:
@@ -312,20 +329,34 @@ public:
      * Register a provider.
      */
     void registerProvider(std::shared_ptr<Provider> provider) {
+        std::lock_guard<std::mutex> lock(m_mutex);
         m_providers[provider->getId()] = provider;
+        m_cacheValid = false;
     }
     
     /**
      * Unregister a provider.
      */
     void unregisterProvider(const std::string& id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
         m_providers.erase(id);
+        m_cacheValid = false;
+    }
+    
+    /**
+     * Drop the cached tool table, e.g. after a provider's tool list changed.
+     * Enabling or disabling a provider is picked up without this.
+     */
+    void invalidateTools() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cacheValid = false;
     }
     
     /**
      * Get a provider by ID.
      */
     std::shared_ptr<Provider> getProvider(const std::string& id) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
         auto it = m_providers.find(id);
         return it != m_providers.end() ? it->second : nullptr;
     }
@@ -334,6 +365,7 @@ public:
      * Get all registered providers.
      */
     std::vector<std::shared_ptr<Provider>> getProviders() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
         std::vector<std::shared_ptr<Provider>> result;
         for (const auto& [id, provider] : m_providers) {
             result.push_back(provider);
@@ -345,6 +377,7 @@ public:
      * Get all enabled providers.
      */
     std::vector<std::shared_ptr<Provider>> getEnabledProviders() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
         std::vector<std::shared_ptr<Provider>> result;
         for (const auto& [id, provider] : m_providers) {
             if (provider->isEnabled()) {
@@ -366,17 +399,23 @@ public:
         return tools;
     }
     
+    /**
+     * Find the enabled provider that offers a tool.
+     * @return The provider, or nullptr if no enabled provider has the tool.
+     */
+    std::shared_ptr<Provider> findToolProvider(const std::string& toolName) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        refreshToolCache();
+        auto it = m_toolRoutes.find(toolName);
+        return it != m_toolRoutes.end() ? it->second : nullptr;
+    }
+    
     /**
      * Execute a tool call, routing to the appropriate provider.
      */
     ToolResult executeTool(const std::string& toolName, const Value& arguments) {
-        // Find provider that has this tool
-        for (const auto& provider : getEnabledProviders()) {
-            for (const auto& tool : provider->getTools()) {
-                if (tool.name == toolName) {
-                    return provider->executeTool(toolName, arguments);
-                }
-            }
+        if (auto provider = findToolProvider(toolName)) {
+            return provider->executeTool(toolName, arguments);
         }
         return ToolResult::Error("Tool not found: " + toolName);
     }
@@ -385,29 +424,9 @@ public:
      * Build the tools JSON for Gemini API.
      */
     std::string buildGeminiToolsJson() const {
-        auto tools = getAllTools();
-        wxLogDebug("MCP: buildGeminiToolsJson() - %zu tools from %zu enabled providers",
-                   tools.size(), getEnabledProviders().size());
-        
-        // Log all registered providers and their status
-        for (const auto& [id, provider] : m_providers) {
-            wxLogDebug("MCP: Provider '%s' (%s) - enabled: %s, tools: %zu",
-                       id.c_str(), provider->getName().c_str(),
-                       provider->isEnabled() ? "yes" : "no",
-                       provider->getTools().size());
-        }
-        
-        if (tools.empty()) return "";
-        
-        std::string json = "\"tools\":[{\"functionDeclarations\":[";
-        bool first = true;
-        for (const auto& tool : tools) {
-            if (!first) json += ",";
-            first = false;
-            json += tool.toGeminiFunctionJson();
-        }
-        json += "]}]";
-        return json;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        refreshToolCache();
+        return m_geminiToolsJson;
     }
     
     /**
@@ -451,7 +470,7 @@ public:
         }
         
         // Mention disabled providers that could be enabled
-        for (const auto& [id, provider] : m_providers) {
+        for (const auto& provider : getProviders()) {
             if (!provider->isEnabled()) {
                 description += "Note: " + provider->getName() + " tools are available but not currently configured. ";
                 description += "The user can enable them by configuring the appropriate settings.\n";
@@ -508,7 +527,68 @@ public:
 
 private:
     Registry() = default;
+    
+    mutable std::mutex m_mutex;
     std::map<std::string, std::shared_ptr<Provider>> m_providers;
+    
+    // Tool cache, guarded by m_mutex
+    mutable bool m_cacheValid = false;
+    mutable std::vector<std::pair<const Provider*, bool>> m_cachedEnabled;  // Per provider, in map order
+    mutable std::unordered_map<std::string, std::shared_ptr<Provider>> m_toolRoutes;
+    mutable std::string m_geminiToolsJson;
+    
+    /**
+     * Rebuild the tool cache if the providers or their enabled states changed.
+     * Caller must hold m_mutex.
+     */
+    void refreshToolCache() const {
+        if (m_cacheValid && m_cachedEnabled.size() == m_providers.size()) {
+            bool unchanged = true;
+            size_t i = 0;
+            for (const auto& [id, provider] : m_providers) {
+                const auto& cached = m_cachedEnabled[i++];
+                if (cached.first != provider.get() || cached.second != provider->isEnabled()) {
+                    unchanged = false;
+                    break;
+                }
+            }
+            if (unchanged) return;
+        }
+        
+        m_cachedEnabled.clear();
+        m_toolRoutes.clear();
+        std::string declarations;
+        size_t toolCount = 0;
+        size_t enabledCount = 0;
+        
+        for (const auto& [id, provider] : m_providers) {
+            bool enabled = provider->isEnabled();
+            m_cachedEnabled.emplace_back(provider.get(), enabled);
+            
+            auto tools = provider->getTools();
+            wxLogDebug("MCP: Provider '%s' (%s) - enabled: %s, tools: %zu",
+                       id.c_str(), provider->getName().c_str(),
+                       enabled ? "yes" : "no", tools.size());
+            if (!enabled) continue;
+            ++enabledCount;
+            
+            for (const auto& tool : tools) {
+                // First provider (in ID order) wins, as with the old linear lookup
+                if (!m_toolRoutes.emplace(tool.name, provider).second) continue;
+                if (!declarations.empty()) declarations += ",";
+                declarations += tool.toGeminiFunctionJson();
+                ++toolCount;
+            }
+        }
+        
+        m_geminiToolsJson = declarations.empty()
+            ? std::string()
+            : "\"tools\":[{\"functionDeclarations\":[" + declarations + "]}]";
+        m_cacheValid = true;
+        
+        wxLogDebug("MCP: Rebuilt tool table - %zu tools from %zu enabled providers",
+                   toolCount, enabledCount);
+    }
 };
 
 } // namespace MCP
@@ -3,7 +3,9 @@
 
 #include "mcp.h"
 #include "../lsp/lsp_client.h"
+#include "../lsp/symbol_store.h"
 #include <wx/wx.h>
+#include <algorithm>
 #include <vector>
 #include <map>
 
@@ -43,12 +45,6 @@ struct CodeIndexSshConfig {
  */
 class CodeIndexProvider : public Provider {
 public:
-    using SymbolEntry = std::pair<std::string, LspDocumentSymbol>;
-    using SymbolList = std::vector<SymbolEntry>;
-    using SymbolSearchFn = std::function<SymbolList(const std::string&)>;
-    using FileSymbolsFn = std::function<std::vector<LspDocumentSymbol>(const std::string&)>;
-    using AllSymbolsFn = std::function<SymbolList()>;  // Returns copy, not reference
-    using SymbolsByKindFn = std::function<SymbolList(LspSymbolKind)>;
     using IndexStatusFn = std::function<std::tuple<bool, size_t, size_t>()>; // (complete, files, symbols)
 
     CodeIndexProvider() = default;
@@ -66,13 +62,11 @@ public:
     }
     
     /**
-     * Set the callbacks to access the code index.
-     * These callbacks connect to the SymbolsWidget.
+     * Connect the provider to the SymbolsWidget's symbol store.
+     * Tools query the store in place under its read lock; nothing is copied
+     * beyond the results they return.
      */
-    void setSearchCallback(SymbolSearchFn fn) { m_searchFn = fn; }
-    void setFileSymbolsCallback(FileSymbolsFn fn) { m_fileSymbolsFn = fn; }
-    void setAllSymbolsCallback(AllSymbolsFn fn) { m_allSymbolsFn = fn; }
-    void setSymbolsByKindCallback(SymbolsByKindFn fn) { m_symbolsByKindFn = fn; }
+    void setSymbolStore(std::shared_ptr<const SymbolStore> store) { m_store = std::move(store); }
     void setIndexStatusCallback(IndexStatusFn fn) { m_indexStatusFn = fn; }
     
     /**
@@ -180,10 +174,7 @@ public:
     }
 
 private:
-    SymbolSearchFn m_searchFn;
-    FileSymbolsFn m_fileSymbolsFn;
-    AllSymbolsFn m_allSymbolsFn;
-    SymbolsByKindFn m_symbolsByKindFn;
+    std::shared_ptr<const SymbolStore> m_store;
     IndexStatusFn m_indexStatusFn;
     CodeIndexSshConfig m_sshConfig;
     
@@ -223,23 +214,37 @@ private:
     /**
      * Convert a symbol to a Value object for JSON serialization.
      */
-    Value symbolToValue(const std::string& filePath, const LspDocumentSymbol& symbol) {
+    Value symbolToValue(const SymbolStore::SymbolRef& symbol) {
         std::map<std::string, Value> obj;
-        obj["name"] = symbol.name;
-        obj["kind"] = symbolKindToString(symbol.kind);
-        obj["file"] = filePath;
-        obj["line"] = symbol.selectionRange.start.line + 1; // 1-indexed for humans
-        obj["column"] = symbol.selectionRange.start.character + 1;
-        
-        if (!symbol.detail.empty()) {
-            obj["detail"] = symbol.detail;
+        obj["name"] = symbol.name();
+        obj["kind"] = symbolKindToString(symbol.kind());
+        obj["file"] = symbol.filePath();
+        obj["line"] = symbol.selectionRange().start.line + 1; // 1-indexed for humans
+        obj["column"] = symbol.selectionRange().start.character + 1;
+        
+        if (!symbol.detail().empty()) {
+            obj["detail"] = symbol.detail();
         }
         
         return Value(obj);
     }
     
+    /**
+     * Convert up to maxResults symbols from a store view.
+     */
+    template <typename View>
+    std::vector<Value> symbolsToValues(const View& view, int maxResults) {
+        std::vector<Value> symbols;
+        for (const auto& symbol : view) {
+            if (static_cast<int>(symbols.size()) >= maxResults) break;
+            symbols.push_back(symbolToValue(symbol));
+        }
+        return symbols;
+    }
+    
     ToolResult searchSymbols(const Value& arguments) {
-        if (!m_searchFn) {
+        auto store = m_store;
+        if (!store) {
             return ToolResult::Error("Code index not available");
         }
         
@@ -250,14 +255,9 @@ private:
         
         int maxResults = arguments.has("max_results") ? arguments["max_results"].asInt() : 20;
         
-        auto results = m_searchFn(query);
-        
-        std::vector<Value> symbols;
-        int count = 0;
-        for (const auto& [filePath, symbol] : results) {
-            if (count++ >= maxResults) break;
-            symbols.push_back(symbolToValue(filePath, symbol));
-        }
+        auto lock = store->readLock();
+        auto results = store->search(query, static_cast<size_t>(std::max(maxResults, 0)));
+        std::vector<Value> symbols = symbolsToValues(results, maxResults);
         
         std::map<std::string, Value> result;
         result["query"] = query;
@@ -268,7 +268,8 @@ private:
     }
     
     ToolResult listFileSymbols(const Value& arguments) {
-        if (!m_fileSymbolsFn) {
+        auto store = m_store;
+        if (!store) {
             return ToolResult::Error("Code index not available");
         }
         
@@ -277,12 +278,9 @@ private:
             return ToolResult::Error("Path parameter is required");
         }
         
-        auto fileSymbols = m_fileSymbolsFn(path);
-        
-        std::vector<Value> symbols;
-        for (const auto& symbol : fileSymbols) {
-            symbols.push_back(symbolToValue(path, symbol));
-        }
+        auto lock = store->readLock();
+        auto fileSymbols = store->fileSymbols(path);
+        std::vector<Value> symbols = symbolsToValues(fileSymbols, static_cast<int>(fileSymbols.size()));
         
         std::map<std::string, Value> result;
         result["file"] = path;
@@ -293,28 +291,17 @@ private:
     }
     
     ToolResult listFunctions(const Value& arguments) {
-        if (!m_symbolsByKindFn) {
+        auto store = m_store;
+        if (!store) {
             return ToolResult::Error("Code index not available");
         }
         
         int maxResults = arguments.has("max_results") ? arguments["max_results"].asInt() : 50;
         
-        // Get functions and methods
-        auto functions = m_symbolsByKindFn(LspSymbolKind::Function);
-        auto methods = m_symbolsByKindFn(LspSymbolKind::Method);
-        
-        std::vector<Value> symbols;
-        int count = 0;
-        
-        for (const auto& [filePath, symbol] : functions) {
-            if (count++ >= maxResults) break;
-            symbols.push_back(symbolToValue(filePath, symbol));
-        }
-        
-        for (const auto& [filePath, symbol] : methods) {
-            if (count++ >= maxResults) break;
-            symbols.push_back(symbolToValue(filePath, symbol));
-        }
+        // Functions and methods, in workspace order
+        auto lock = store->readLock();
+        std::vector<Value> symbols = symbolsToValues(
+            store->symbolsOfKinds({LspSymbolKind::Function, LspSymbolKind::Method}), maxResults);
         
         std::map<std::string, Value> result;
         result["count"] = static_cast<int>(symbols.size());
@@ -324,28 +311,17 @@ private:
     }
     
     ToolResult listClasses(const Value& arguments) {
-        if (!m_symbolsByKindFn) {
+        auto store = m_store;
+        if (!store) {
             return ToolResult::Error("Code index not available");
         }
         
         int maxResults = arguments.has("max_results") ? arguments["max_results"].asInt() : 50;
         
-        // Get classes and structs
-        auto classes = m_symbolsByKindFn(LspSymbolKind::Class);
-        auto structs = m_symbolsByKindFn(LspSymbolKind::Struct);
-        
-        std::vector<Value> symbols;
-        int count = 0;
-        
-        for (const auto& [filePath, symbol] : classes) {
-            if (count++ >= maxResults) break;
-            symbols.push_back(symbolToValue(filePath, symbol));
-        }
-        
-        for (const auto& [filePath, symbol] : structs) {
-            if (count++ >= maxResults) break;
-            symbols.push_back(symbolToValue(filePath, symbol));
-        }
+        // Classes and structs, in workspace order
+        auto lock = store->readLock();
+        std::vector<Value> symbols = symbolsToValues(
+            store->symbolsOfKinds({LspSymbolKind::Class, LspSymbolKind::Struct}), maxResults);
         
         std::map<std::string, Value> result;
         result["count"] = static_cast<int>(symbols.size());
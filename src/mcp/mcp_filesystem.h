@@ -2,12 +2,21 @@
 #define MCP_FILESYSTEM_H
 
 #include "mcp.h"
+#include "../fs/content_search.h"
+#include "../fs/line_reader.h"
+#include "../fs/remote_search.h"
+#include "../fs/remote_session.h"
+#include "../fs/watch_service.h"
+#include "../fs/workspace_index.h"
 #include <wx/dir.h>
 #include <wx/filename.h>
 #include <wx/file.h>
 #include <wx/textfile.h>
 #include <wx/wfstream.h>
+#include <algorithm>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 
 #ifdef _WIN32
@@ -150,6 +159,8 @@ public:
      */
     void setRootPath(const std::string& path) {
         m_rootPath = path;
+        std::lock_guard<std::mutex> lock(m_indexMutex);
+        m_workspaceIndex.reset();
     }
     
     /**
@@ -180,6 +191,42 @@ public:
         return m_sshConfig.isValid();
     }
     
+    /**
+     * Keep a background file and trigram index of a local workspace so
+     * repeated fs_grep / fs_search_files calls don't re-walk the tree.
+     * The index is built on first use, at the folder set by setWatchedRoot().
+     */
+    void setWorkspaceIndexEnabled(bool enabled) {
+        std::lock_guard<std::mutex> lock(m_indexMutex);
+        m_workspaceIndexEnabled = enabled;
+        if (!enabled) {
+            m_workspaceIndex.reset();
+        }
+    }
+    
+    /**
+     * Follow the folder whose changes are reported through notifyPathChanged()
+     * (empty for none). The index is dropped and rebuilt there on next use,
+     * as changes around the switch may not have been reported. Searches
+     * outside that folder scan the tree directly.
+     */
+    void setWatchedRoot(const std::string& root) {
+        std::lock_guard<std::mutex> lock(m_indexMutex);
+        m_watchedRoot = root;
+        m_workspaceIndex.reset();
+    }
+    
+    /**
+     * Report a created, modified, renamed or deleted path so the workspace
+     * index stays current. Safe to call from the UI thread.
+     */
+    void notifyPathChanged(const std::string& path) {
+        std::lock_guard<std::mutex> lock(m_indexMutex);
+        if (m_workspaceIndex) {
+            m_workspaceIndex->notifyChanged(path);
+        }
+    }
+    
     std::vector<ToolDefinition> getTools() const override {
         std::vector<ToolDefinition> tools;
         
@@ -266,6 +313,13 @@ public:
         return tools;
     }
     
+    /**
+     * The tools only read, so several can run side by side.
+     */
+    size_t maxConcurrentCalls() const override {
+        return 4;
+    }
+    
     ToolResult executeTool(const std::string& toolName, const Value& arguments) override {
         if (toolName == "fs_list_directory") {
             return listDirectory(arguments);
@@ -288,6 +342,62 @@ private:
     std::string m_rootPath;
     FilesystemSshConfig m_sshConfig;
     
+    std::mutex m_indexMutex;
+    bool m_workspaceIndexEnabled = false;
+    std::string m_watchedRoot;
+    std::shared_ptr<FS::WorkspaceIndex> m_workspaceIndex;
+    
+    /**
+     * Get the workspace index, creating and starting it on first use.
+     * Returns nullptr for remote workspaces, when disabled, or when no
+     * folder is watched (nothing would keep the index current).
+     */
+    std::shared_ptr<FS::WorkspaceIndex> getWorkspaceIndex() {
+        std::lock_guard<std::mutex> lock(m_indexMutex);
+        if (!m_workspaceIndexEnabled || m_sshConfig.isValid() || m_watchedRoot.empty()) {
+            return nullptr;
+        }
+        if (!m_workspaceIndex) {
+            FS::WorkspaceIndexOptions options;
+            options.skipName = &FilesystemProvider::shouldSkipEntry;
+            m_workspaceIndex = std::make_shared<FS::WorkspaceIndex>(m_watchedRoot, std::move(options));
+            m_workspaceIndex->start();
+        }
+        return m_workspaceIndex;
+    }
+    
+    /**
+     * The shared SSH session for this workspace, for streamed remote commands.
+     */
+    std::shared_ptr<FS::RemoteSession> remoteSession() const {
+        return FS::RemoteSession::Acquire(toFsSshConfig());
+    }
+    
+    FS::SshConfig toFsSshConfig() const {
+        FS::SshConfig config;
+        config.enabled = m_sshConfig.enabled;
+        config.host = m_sshConfig.host;
+        config.port = m_sshConfig.port;
+        config.user = m_sshConfig.user;
+        config.identityFile = m_sshConfig.identityFile;
+        config.extraOptions = m_sshConfig.extraOptions;
+        config.connectionTimeout = m_sshConfig.connectionTimeout;
+        return config;
+    }
+    
+    /**
+     * Strip the remote root from a remote path.
+     */
+    std::string toRemoteRelativePath(const std::string& remotePath) const {
+        std::string root = m_rootPath;
+        while (root.size() > 1 && root.back() == '/') root.pop_back();
+        if (remotePath.size() > root.size() && remotePath.compare(0, root.size(), root) == 0 &&
+            remotePath[root.size()] == '/') {
+            return remotePath.substr(root.size() + 1);
+        }
+        return remotePath;
+    }
+    
     /**
      * Execute a remote command via SSH and return output.
      * Used for remote filesystem operations.
@@ -401,7 +511,7 @@ private:
      * Check if a dotfile/directory should be skipped.
      * Allows .vscode but skips .git, .DS_Store, etc.
      */
-    bool shouldSkipDotfile(const wxString& filename) const {
+    static bool shouldSkipDotfile(const wxString& filename) {
         if (!filename.StartsWith(".")) {
             return false;  // Not a dotfile, don't skip
         }
@@ -417,6 +527,15 @@ private:
         return true;  // Skip other dotfiles like .git, .DS_Store
     }
     
+    /**
+     * Names left out of searches and the workspace index: exactly those the
+     * watch service never reports, so indexed and direct searches agree.
+     * Thread-safe; used by the search workers.
+     */
+    static bool shouldSkipEntry(const std::string& name) {
+        return FS::WatchService::IsSkippedName(name);
+    }
+    
     /**
      * Convert absolute path to relative path from root.
      */
@@ -759,37 +878,36 @@ private:
             return ToolResult::Error("Invalid path: access denied");
         }
         
-        if (!wxFileExists(fullPath)) {
-            return ToolResult::Error("File not found: " + relPath);
-        }
-        
-        std::ifstream file(fullPath);
-        if (!file) {
-            return ToolResult::Error("Could not open file: " + relPath);
-        }
-        
-        std::string content;
-        std::string line;
-        int lineNum = 0;
-        int linesRead = 0;
-        
-        while (std::getline(file, line)) {
-            lineNum++;
-            if (lineNum >= startLine && lineNum <= endLine) {
-                if (!content.empty()) content += "\n";
-                content += line;
-                linesRead++;
+        FS::LineRange range;
+        if (m_sshConfig.isValid()) {
+            // Only the requested lines cross the connection
+            auto output = remoteSession()->run(FS::LineReader::RemoteCommand(fullPath, startLine, endLine));
+            if (!output.ok()) {
+                return ToolResult::Error("Could not read file: " + relPath);
+            }
+            range = FS::LineReader::FromRemoteOutput(std::move(output.output), startLine);
+        } else {
+            if (!wxFileExists(fullPath)) {
+                return ToolResult::Error("File not found: " + relPath);
+            }
+            range = FS::LineReader::Instance().read(fullPath, startLine, endLine);
+            if (!range.ok) {
+                return ToolResult::Error("Could not open file: " + relPath);
             }
-            if (lineNum > endLine) break;
         }
         
         Value result;
         result["path"] = relPath;
         result["start_line"] = startLine;
-        result["end_line"] = std::min(endLine, lineNum);
-        result["total_lines"] = lineNum;
-        result["lines_read"] = linesRead;
-        result["content"] = content;
+        result["end_line"] = std::max(range.endLine, startLine - 1);
+        if (range.totalLines >= 0) {
+            result["total_lines"] = static_cast<double>(range.totalLines);
+        }
+        result["lines_read"] = range.endLine - range.startLine + 1;
+        result["content"] = range.content;
+        if (m_sshConfig.isValid()) {
+            result["remote"] = true;
+        }
         
         return ToolResult::Success(result);
     }
@@ -880,12 +998,66 @@ private:
             return ToolResult::Error("Invalid path: access denied");
         }
         
+        if (m_sshConfig.isValid()) {
+            return searchFilesRemote(fullPath, relPath, pattern, recursive);
+        }
+        
         if (!wxDirExists(fullPath)) {
             return ToolResult::Error("Directory not found: " + relPath);
         }
         
         Value results;
-        searchFilesRecursive(fullPath, pattern, recursive, results);
+        auto index = getWorkspaceIndex();
+        auto indexed = index ? index->findFiles(fullPath, pattern, recursive, 100) : std::nullopt;
+        if (indexed) {
+            for (const auto& file : *indexed) {
+                Value entry;
+                entry["name"] = file.path.substr(file.path.find_last_of("/\\") + 1);
+                entry["path"] = toRelativePath(file.path);
+                entry["type"] = "file";
+                entry["size"] = static_cast<double>(file.size);
+                results.push_back(entry);
+            }
+        } else {
+            searchFilesRecursive(fullPath, pattern, recursive, results);
+        }
+        
+        Value result;
+        result["pattern"] = pattern;
+        result["search_path"] = relPath;
+        result["matches"] = results;
+        result["count"] = static_cast<int>(results.size());
+        
+        return ToolResult::Success(result);
+    }
+    
+    /**
+     * Search file names on the remote host with a single streamed find.
+     */
+    ToolResult searchFilesRemote(const std::string& fullPath, const std::string& relPath,
+                                 const std::string& pattern, bool recursive, size_t maxResults = 100) {
+        FS::WalkOptions options;
+        options.maxDepth = recursive ? -1 : 1;
+        options.skipDirectories = {"node_modules"};
+        
+        Value results;
+        FS::Filesystem remote = FS::Filesystem::Remote(toFsSshConfig(), wxString::FromUTF8(m_rootPath.c_str()));
+        bool ok = remote.walk(wxString::FromUTF8(fullPath.c_str()), options, [&](const FS::FileEntry& file) {
+            std::string name = file.name.ToStdString();
+            if (!file.isDirectory && FS::ContentSearch::WildcardMatch(pattern, name)) {
+                Value entry;
+                entry["name"] = name;
+                entry["path"] = toRemoteRelativePath(file.fullPath.ToStdString());
+                entry["type"] = "file";
+                entry["size"] = static_cast<double>(file.size);
+                results.push_back(entry);
+            }
+            return results.size() < maxResults;
+        });
+        
+        if (!ok && results.size() == 0) {
+            return ToolResult::Error("Directory not found or not accessible: " + relPath);
+        }
         
         Value result;
         result["pattern"] = pattern;
@@ -908,7 +1080,7 @@ private:
         // Search files
         bool cont = dir.GetFirst(&filename, wxString(pattern), wxDIR_FILES);
         while (cont && results.size() < static_cast<size_t>(maxResults)) {
-            if (!shouldSkipDotfile(filename)) {
+            if (!shouldSkipEntry(filename.ToUTF8().data())) {
                 std::string fullPath = wxFileName(path, filename).GetFullPath().ToStdString();
                 Value entry;
                 entry["name"] = filename.ToStdString();
@@ -925,7 +1097,7 @@ private:
         if (recursive) {
             cont = dir.GetFirst(&filename, wxEmptyString, wxDIR_DIRS);
             while (cont && results.size() < static_cast<size_t>(maxResults)) {
-                if (!shouldSkipDotfile(filename) && filename != "node_modules") {
+                if (!shouldSkipEntry(filename.ToUTF8().data())) {
                     std::string subPath = wxFileName(path, filename).GetFullPath().ToStdString();
                     searchFilesRecursive(subPath, pattern, true, results, maxResults);
                 }
@@ -950,92 +1122,87 @@ private:
             return ToolResult::Error("Invalid path: access denied");
         }
         
+        FS::ContentSearchOptions options;
+        options.query = query;
+        options.caseSensitive = caseSensitive;
+        options.filePattern = filePattern;
+        options.maxResults = static_cast<size_t>(std::max(maxResults, 0));
+        options.skipName = &FilesystemProvider::shouldSkipEntry;
+        
+        if (m_sshConfig.isValid()) {
+            return grepFilesRemote(fullPath, relPath, options);
+        }
+        
         if (!wxDirExists(fullPath)) {
             return ToolResult::Error("Directory not found: " + relPath);
         }
         
-        Value matches;
-        std::string searchQuery = caseSensitive ? query : toLower(query);
+        // Only files the index can't rule out need reading; without a ready index, scan the tree
+        auto index = getWorkspaceIndex();
+        auto candidates = index ? index->candidateFiles(fullPath, query, filePattern) : std::nullopt;
+        FS::ContentSearchResult search = candidates
+            ? FS::ContentSearch::Search(*candidates, options)
+            : FS::ContentSearch::Run(fullPath, options);
         
-        grepFilesRecursive(fullPath, searchQuery, filePattern, caseSensitive, matches, maxResults);
+        Value matches;
+        for (const auto& found : search.matches) {
+            Value match;
+            match["file"] = toRelativePath(found.path);
+            match["line"] = found.line;
+            match["column"] = found.column;
+            match["content"] = found.content;
+            matches.push_back(match);
+        }
         
         Value result;
         result["query"] = query;
         result["search_path"] = relPath;
         result["matches"] = matches;
         result["count"] = static_cast<int>(matches.size());
-        result["truncated"] = (matches.size() >= static_cast<size_t>(maxResults));
+        result["truncated"] = search.truncated;
         
         return ToolResult::Success(result);
     }
     
-    void grepFilesRecursive(const std::string& path, const std::string& query,
-                           const std::string& filePattern, bool caseSensitive,
-                           Value& matches, int maxResults) {
-        if (matches.size() >= static_cast<size_t>(maxResults)) return;
-        
-        wxDir dir(path);
-        if (!dir.IsOpened()) return;
-        
-        wxString filename;
-        
-        // Search in files
-        bool cont = dir.GetFirst(&filename, wxString(filePattern), wxDIR_FILES);
-        while (cont && matches.size() < static_cast<size_t>(maxResults)) {
-            if (!shouldSkipDotfile(filename)) {
-                std::string filePath = wxFileName(path, filename).GetFullPath().ToStdString();
-                
-                // Only search text files
-                wxFileName fn(filePath);
-                if (isLikelyTextFile(fn.GetExt().ToStdString())) {
-                    grepFile(filePath, query, caseSensitive, matches, maxResults);
-                }
+    /**
+     * Run the search on the remote host as one streamed command and stop
+     * reading once max_results matches have arrived.
+     */
+    ToolResult grepFilesRemote(const std::string& fullPath, const std::string& relPath,
+                               const FS::ContentSearchOptions& options) {
+        Value matches;
+        bool truncated = false;
+        FS::RemoteGrepParser parser(options, [&](FS::ContentMatch&& found) {
+            if (matches.size() >= options.maxResults) {
+                truncated = true;
+                return false;
             }
-            cont = dir.GetNext(&filename);
-        }
+            Value match;
+            match["file"] = toRemoteRelativePath(found.path);
+            match["line"] = found.line;
+            match["column"] = found.column;
+            match["content"] = found.content;
+            matches.push_back(match);
+            return true;
+        });
         
-        // Recurse into directories
-        cont = dir.GetFirst(&filename, wxEmptyString, wxDIR_DIRS);
-        while (cont && matches.size() < static_cast<size_t>(maxResults)) {
-            if (!shouldSkipDotfile(filename) && filename != "node_modules") {
-                std::string subPath = wxFileName(path, filename).GetFullPath().ToStdString();
-                grepFilesRecursive(subPath, query, filePattern, caseSensitive, matches, maxResults);
-            }
-            cont = dir.GetNext(&filename);
+        int exitCode = remoteSession()->runStreaming(FS::RemoteGrep::BuildCommand(fullPath, options),
+            [&parser](const char* data, size_t size) { return parser.feed(data, size); });
+        parser.finish();
+        
+        // grep exits 1 for "no matches"; 255 is ssh failing to connect
+        if (exitCode == 255 && matches.size() == 0) {
+            return ToolResult::Error("Remote search failed: could not connect to " + m_sshConfig.host);
         }
-    }
-    
-    void grepFile(const std::string& filePath, const std::string& query,
-                  bool caseSensitive, Value& matches, int maxResults) {
-        std::ifstream file(filePath);
-        if (!file) return;
         
-        std::string line;
-        int lineNum = 0;
+        Value result;
+        result["query"] = options.query;
+        result["search_path"] = relPath;
+        result["matches"] = matches;
+        result["count"] = static_cast<int>(matches.size());
+        result["truncated"] = truncated;
         
-        while (std::getline(file, line) && matches.size() < static_cast<size_t>(maxResults)) {
-            lineNum++;
-            
-            std::string searchLine = caseSensitive ? line : toLower(line);
-            size_t pos = searchLine.find(query);
-            
-            if (pos != std::string::npos) {
-                Value match;
-                match["file"] = toRelativePath(filePath);
-                match["line"] = lineNum;
-                match["column"] = static_cast<int>(pos + 1);
-                
-                // Trim long lines
-                std::string content = line;
-                if (content.length() > 200) {
-                    size_t start = pos > 50 ? pos - 50 : 0;
-                    content = "..." + content.substr(start, 150) + "...";
-                }
-                match["content"] = content;
-                
-                matches.push_back(match);
-            }
-        }
+        return ToolResult::Success(result);
     }
     
     // ========== Utility Functions ==========
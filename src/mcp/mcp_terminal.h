@@ -2,11 +2,13 @@
 #define MCP_TERMINAL_H
 
 #include "mcp.h"
+#include "process_executor.h"
 #include <wx/filename.h>
 #include <wx/dir.h>
 #include <cstdlib>
 #include <cstdio>
 #include <array>
+#include <chrono>
 #include <memory>
 
 #ifdef _WIN32
@@ -176,8 +178,9 @@ public:
         {
             ToolDefinition tool;
             tool.name = "terminal_execute";
-            tool.description = "Execute a shell command and return its output. "
-                             "Commands are run in the configured working directory. "
+            tool.description = "Execute a shell command and return its stdout and stderr. "
+                             "Commands are run in the configured working directory and killed when the timeout expires. "
+                             "Long output keeps its beginning and end; the omitted middle is reported in bytes. "
                              "Use this for running build commands, scripts, or system utilities.";
             tool.parameters = {
                 {"command", "string", "The command to execute", true},
@@ -337,23 +340,23 @@ private:
     
     /**
      * Execute a shell command and capture its output.
-     * Uses popen() which is thread-safe, unlike wxExecute.
+     * Runs through ProcessExecutor, which is thread-safe (unlike wxExecute),
+     * keeps stdout and stderr apart, bounds each to m_maxOutputBytes and kills
+     * the command's process group when timeoutSecs expires.
      * Supports SSH for remote command execution.
      */
-    std::tuple<int, std::string, std::string> runCommand(
+    ProcessResult runCommand(
         const std::string& command,
         const std::string& workDir,
         const std::string& shell,
         int timeoutSecs
     ) const {
-        std::string stdout_output;
-        std::string stderr_output;
-        int exitCode = -1;
-        
         std::string shellToUse = shell.empty() ? m_defaultShell : shell;
         std::string effectiveWorkDir = workDir.empty() ? m_workingDirectory : workDir;
         
-        std::string fullCommand;
+        ProcessOptions options;
+        options.timeout = std::chrono::seconds(timeoutSecs > 0 ? timeoutSecs : m_timeoutSeconds);
+        options.maxOutputBytes = m_maxOutputBytes;
         
         // Check if we should execute via SSH
         if (m_sshConfig.isValid()) {
@@ -388,58 +391,44 @@ private:
                 remoteCmd = escapedCommand;
             }
             
-            // Combine SSH with remote command
-            fullCommand = sshPrefix + " \"" + remoteCmd + "\" 2>&1";
+            // The local shell parses the SSH prefix and the quoted remote command
+#ifdef _WIN32
+            options.argv = {"cmd.exe", "/C", sshPrefix + " \"" + remoteCmd + "\""};
+#else
+            options.argv = {"/bin/sh", "-c", sshPrefix + " \"" + remoteCmd + "\""};
+#endif
         } else {
-            // Local command execution (existing logic)
-            // Build the full command with cd and shell wrapper
-        
+            // Local command execution: cd to workdir (if specified) inside the shell
+            std::string script = command;
+            if (!effectiveWorkDir.empty()) {
 #ifdef _WIN32
-            // Windows: use cd /d for changing drive and directory
-            if (shellToUse == "powershell") {
-                // PowerShell command
-                fullCommand = "powershell.exe -NoProfile -NonInteractive -Command \"";
-                if (!effectiveWorkDir.empty()) {
-                    fullCommand += "Set-Location '" + effectiveWorkDir + "'; ";
-                }
-                fullCommand += command + "\" 2>&1";
-            } else {
-                // cmd.exe command
-                fullCommand = "cmd.exe /C \"";
-                if (!effectiveWorkDir.empty()) {
-                    fullCommand += "cd /d \"" + effectiveWorkDir + "\" && ";
+                // Windows: use cd /d for changing drive and directory
+                if (shellToUse == "powershell") {
+                    script = "Set-Location '" + effectiveWorkDir + "'; " + command;
+                } else {
+                    script = "cd /d \"" + effectiveWorkDir + "\" && " + command;
                 }
-                fullCommand += command + "\" 2>&1";
-            }
 #else
-            // Unix: build shell command with cd
-            std::string shellPath;
-            if (shellToUse == "zsh") {
-                shellPath = "/bin/zsh";
-            } else if (shellToUse == "bash") {
-                shellPath = "/bin/bash";
-            } else {
-                shellPath = "/bin/sh";
-            }
-            
-            // Escape single quotes in the command
-            std::string escapedCommand = command;
-            size_t pos = 0;
-            while ((pos = escapedCommand.find("'", pos)) != std::string::npos) {
-                escapedCommand.replace(pos, 1, "'\\''");
-                pos += 4;
+                // Quote the directory for the shell; ' becomes '\''
+                std::string quotedDir = "'";
+                for (char c : effectiveWorkDir) {
+                    if (c == '\'') {
+                        quotedDir += "'\\''";
+                    } else {
+                        quotedDir += c;
+                    }
+                }
+                quotedDir += "'";
+                script = "cd " + quotedDir + " && " + command;
+#endif
             }
             
-            // Build command: cd to workdir (if specified) and execute
-            if (!effectiveWorkDir.empty()) {
-                fullCommand = shellPath + " -c 'cd \"" + effectiveWorkDir + "\" && " + escapedCommand + "' 2>&1";
-            } else {
-                fullCommand = shellPath + " -c '" + escapedCommand + "' 2>&1";
-            }
-#endif
+            auto [shellPath, shellArgs] = getShellCommand(shellToUse, script);
+            options.argv.push_back(shellPath);
+            options.argv.insert(options.argv.end(), shellArgs.begin(), shellArgs.end());
         }
         
-        // Block SIGCHLD during popen/pclose to prevent signals from interfering with wxWidgets
+        // Block SIGCHLD while the child runs to prevent signals from interfering with wxWidgets
         // This is especially important on macOS where SIGCHLD can cause issues
 #ifndef _WIN32
         sigset_t newmask, oldmask;
@@ -448,50 +437,26 @@ private:
         pthread_sigmask(SIG_BLOCK, &newmask, &oldmask);
 #endif
         
-        // Execute using popen (thread-safe)
-        FILE* pipe = popen(fullCommand.c_str(), "r");
-        if (!pipe) {
-#ifndef _WIN32
-            pthread_sigmask(SIG_SETMASK, &oldmask, nullptr);
-#endif
-            return {-1, "", "Failed to execute command: popen() failed"};
-        }
-        
-        // Read output
-        std::array<char, 4096> buffer;
-        while (fgets(buffer.data(), buffer.size(), pipe) != nullptr) {
-            stdout_output += buffer.data();
-            if (stdout_output.size() > m_maxOutputBytes) {
-                stdout_output = stdout_output.substr(0, m_maxOutputBytes);
-                stdout_output += "\n... (output truncated)";
-                break;
-            }
-        }
-        
-        // Get exit code
-        int status = pclose(pipe);
+        ProcessResult result = ProcessExecutor::Run(options);
         
 #ifndef _WIN32
         // Restore signal mask
         pthread_sigmask(SIG_SETMASK, &oldmask, nullptr);
 #endif
         
-#ifdef _WIN32
-        exitCode = status;
-#else
-        if (WIFEXITED(status)) {
-            exitCode = WEXITSTATUS(status);
-        } else {
-            exitCode = -1;
+        if (!result.error.empty()) {
+            result.stderrText = "Failed to execute command: " + result.error;
         }
-#endif
         
         // Remove trailing newline if present
-        if (!stdout_output.empty() && stdout_output.back() == '\n') {
-            stdout_output.pop_back();
+        if (!result.stdoutText.empty() && result.stdoutText.back() == '\n') {
+            result.stdoutText.pop_back();
+        }
+        if (!result.stderrText.empty() && result.stderrText.back() == '\n') {
+            result.stderrText.pop_back();
         }
         
-        return {exitCode, stdout_output, stderr_output};
+        return result;
     }
     
     /**
@@ -532,13 +497,23 @@ private:
             return ToolResult::Error("Working directory does not exist: " + workDir);
         }
         
-        auto [exitCode, stdout_out, stderr_out] = runCommand(command, workDir, shell, timeout);
+        ProcessResult run = runCommand(command, workDir, shell, timeout);
         
         Value result;
-        result["exit_code"] = exitCode;
-        result["stdout"] = stdout_out;
-        result["stderr"] = stderr_out;
-        result["success"] = (exitCode == 0);
+        result["exit_code"] = run.exitCode;
+        result["stdout"] = run.stdoutText;
+        result["stderr"] = run.stderrText;
+        result["success"] = (run.exitCode == 0 && !run.timedOut);
+        if (run.timedOut) {
+            result["timed_out"] = true;
+            result["timeout_seconds"] = timeout;
+        }
+        if (run.stdoutDropped > 0) {
+            result["stdout_bytes_dropped"] = static_cast<double>(run.stdoutDropped);
+        }
+        if (run.stderrDropped > 0) {
+            result["stderr_bytes_dropped"] = static_cast<double>(run.stderrDropped);
+        }
         result["command"] = command;
         result["shell"] = shell.empty() ? m_defaultShell : shell;
         result["working_directory"] = workDir.empty() ? m_workingDirectory : workDir;
@@ -645,15 +620,15 @@ private:
         whichCmd = "which " + cmd;
 #endif
         
-        auto [exitCode, stdout_out, stderr_out] = runCommand(whichCmd, "", "", 10);
+        ProcessResult run = runCommand(whichCmd, "", "", 10);
         
         Value result;
         result["command"] = cmd;
-        result["found"] = (exitCode == 0);
+        result["found"] = (run.exitCode == 0);
         
-        if (exitCode == 0) {
+        if (run.exitCode == 0) {
             // Trim whitespace from path
-            std::string path = stdout_out;
+            std::string path = run.stdoutText;
             while (!path.empty() && (path.back() == '\n' || path.back() == '\r' || path.back() == ' ')) {
                 path.pop_back();
             }
@@ -686,12 +661,12 @@ private:
         }
 #endif
         
-        auto [exitCode, stdout_out, stderr_out] = runCommand(psCmd, "", "", 10);
+        ProcessResult run = runCommand(psCmd, "", "", 10);
         
         Value result;
-        result["output"] = stdout_out;
+        result["output"] = run.stdoutText;
         result["filter"] = filter;
-        result["success"] = (exitCode == 0);
+        result["success"] = (run.exitCode == 0);
         
         return ToolResult::Success(result);
     }
@@ -0,0 +1,290 @@
+#include "process_executor.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace MCP {
+
+// --- OutputCapture ---
+
+OutputCapture::OutputCapture(size_t headBytes, size_t tailBytes)
+    : m_headCapacity(headBytes), m_tailCapacity(tailBytes) {}
+
+void OutputCapture::append(const char* data, size_t size) {
+    m_total += size;
+
+    size_t toHead = std::min(size, m_headCapacity - m_head.size());
+    m_head.append(data, toHead);
+    data += toHead;
+    size -= toHead;
+    if (size == 0 || m_tailCapacity == 0) return;
+
+    // Only the last m_tailCapacity bytes of this chunk can survive
+    if (size > m_tailCapacity) {
+        data += size - m_tailCapacity;
+        size = m_tailCapacity;
+    }
+
+    size_t toFill = std::min(size, m_tailCapacity - m_tail.size());
+    m_tail.append(data, toFill);
+    data += toFill;
+    size -= toFill;
+
+    // Ring is full: overwrite the oldest bytes
+    while (size > 0) {
+        size_t chunk = std::min(size, m_tailCapacity - m_tailStart);
+        std::memcpy(&m_tail[m_tailStart], data, chunk);
+        m_tailStart = (m_tailStart + chunk) % m_tailCapacity;
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+size_t OutputCapture::droppedBytes() const {
+    return m_total - m_head.size() - m_tail.size();
+}
+
+std::string OutputCapture::str() const {
+    std::string out;
+    out.reserve(m_head.size() + m_tail.size() + 64);
+    out = m_head;
+    size_t dropped = droppedBytes();
+    if (dropped > 0) {
+        out += "\n... (" + std::to_string(dropped) + " bytes omitted) ...\n";
+    }
+    out.append(m_tail, m_tailStart, std::string::npos);
+    out.append(m_tail, 0, m_tailStart);
+    return out;
+}
+
+// --- ProcessExecutor ---
+
+#ifdef _WIN32
+
+ProcessResult ProcessExecutor::Run(const ProcessOptions& options) {
+    ProcessResult result;
+    if (options.argv.empty()) {
+        result.error = "No command given";
+        return result;
+    }
+
+    // Arguments with spaces are wrapped in quotes as they are, which is what
+    // cmd /C and powershell -Command expect for their script argument
+    std::string commandLine;
+    for (const auto& arg : options.argv) {
+        if (!commandLine.empty()) commandLine += ' ';
+        if (arg.find_first_of(" \t") == std::string::npos) {
+            commandLine += arg;
+        } else {
+            commandLine += '"' + arg + '"';
+        }
+    }
+    commandLine += " 2>&1";
+
+    FILE* pipe = _popen(commandLine.c_str(), "r");
+    if (!pipe) {
+        result.error = "Failed to execute command";
+        return result;
+    }
+
+    OutputCapture capture(options.maxOutputBytes / 2, options.maxOutputBytes - options.maxOutputBytes / 2);
+    char buffer[65536];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        capture.append(buffer, n);
+    }
+    result.exitCode = _pclose(pipe);
+    result.stdoutText = capture.str();
+    result.stdoutDropped = capture.droppedBytes();
+    return result;
+}
+
+#else
+
+namespace {
+
+int decodeStatus(int status) {
+    if (WIFEXITED(status)) return WEXITSTATUS(status);
+    if (WIFSIGNALED(status)) return 128 + WTERMSIG(status);
+    return -1;
+}
+
+} // namespace
+
+ProcessResult ProcessExecutor::Run(const ProcessOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    ProcessResult result;
+    if (options.argv.empty()) {
+        result.error = "No command given";
+        return result;
+    }
+
+    int outPipe[2];
+    int errPipe[2];
+    if (pipe(outPipe) != 0) {
+        result.error = std::string("pipe failed: ") + std::strerror(errno);
+        return result;
+    }
+    if (pipe(errPipe) != 0) {
+        result.error = std::string("pipe failed: ") + std::strerror(errno);
+        close(outPipe[0]);
+        close(outPipe[1]);
+        return result;
+    }
+    // Our ends must not leak into this or any concurrently spawned child
+    fcntl(outPipe[0], F_SETFD, FD_CLOEXEC);
+    fcntl(errPipe[0], F_SETFD, FD_CLOEXEC);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, outPipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, errPipe[1], STDERR_FILENO);
+    posix_spawn_file_actions_addclose(&actions, outPipe[1]);
+    posix_spawn_file_actions_addclose(&actions, errPipe[1]);
+
+    // Own process group so a timeout can kill everything the command started;
+    // default signal handling and an empty mask regardless of the caller's
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setpgroup(&attr, 0);
+    sigset_t emptyMask;
+    sigemptyset(&emptyMask);
+    posix_spawnattr_setsigmask(&attr, &emptyMask);
+    sigset_t defaultSignals;
+    sigemptyset(&defaultSignals);
+    sigaddset(&defaultSignals, SIGPIPE);
+    sigaddset(&defaultSignals, SIGINT);
+    sigaddset(&defaultSignals, SIGTERM);
+    sigaddset(&defaultSignals, SIGCHLD);
+    posix_spawnattr_setsigdefault(&attr, &defaultSignals);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+    std::vector<char*> argv;
+    argv.reserve(options.argv.size() + 1);
+    for (const auto& arg : options.argv) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    pid_t pid = 0;
+    int spawnError = posix_spawnp(&pid, argv[0], &actions, &attr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    close(outPipe[1]);
+    close(errPipe[1]);
+
+    if (spawnError != 0) {
+        close(outPipe[0]);
+        close(errPipe[0]);
+        result.error = "Failed to start " + options.argv[0] + ": " + std::strerror(spawnError);
+        return result;
+    }
+
+    size_t headBytes = options.maxOutputBytes / 2;
+    size_t tailBytes = options.maxOutputBytes - headBytes;
+    OutputCapture outCapture(headBytes, tailBytes);
+    OutputCapture errCapture(headBytes, tailBytes);
+
+    struct pollfd fds[2] = {
+        {outPipe[0], POLLIN, 0},
+        {errPipe[0], POLLIN, 0},
+    };
+    OutputCapture* captures[2] = {&outCapture, &errCapture};
+    int openPipes = 2;
+
+    const auto start = Clock::now();
+    auto deadline = start + options.timeout;
+    Clock::time_point drainDeadline = Clock::time_point::max();
+    bool exited = false;
+    bool terminated = false;
+    bool killed = false;
+    int status = 0;
+    char buffer[65536];
+
+    // Runs until the child is reaped, not just until the pipes close: a
+    // command that redirects its output away must still hit the deadline
+    while (!exited || openPipes > 0) {
+        auto now = Clock::now();
+
+        if (!exited) {
+            pid_t waited = waitpid(pid, &status, WNOHANG);
+            if (waited == pid) {
+                exited = true;
+                // Background children may hold the pipes open forever
+                drainDeadline = now + kOrphanDrain;
+            }
+        }
+        if (exited && now >= drainDeadline) break;
+
+        if (!exited && now >= deadline) {
+            if (!terminated) {
+                kill(-pid, SIGTERM);
+                terminated = true;
+                result.timedOut = true;
+                deadline = now + kKillGrace;
+            } else if (!killed) {
+                kill(-pid, SIGKILL);
+                killed = true;
+                deadline = Clock::time_point::max();
+            }
+        }
+
+        // Wake up at least every 50ms to notice an exit while pipes are held open
+        auto wakeAt = std::min({deadline, drainDeadline, now + std::chrono::milliseconds(50)});
+        int waitMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(wakeAt - now).count());
+        int ready = poll(fds, 2, std::max(waitMs, 0));
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        for (int i = 0; i < 2; ++i) {
+            if (fds[i].fd < 0 || fds[i].revents == 0) continue;
+            ssize_t n = read(fds[i].fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                captures[i]->append(buffer, static_cast<size_t>(n));
+            } else if (n == 0 || (errno != EINTR && errno != EAGAIN)) {
+                close(fds[i].fd);
+                fds[i].fd = -1;
+                --openPipes;
+            }
+        }
+    }
+
+    for (auto& fd : fds) {
+        if (fd.fd >= 0) close(fd.fd);
+    }
+
+    if (!exited) {
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+    }
+    // Leftovers of the group (e.g. a timed out command's grandchildren)
+    if (result.timedOut && !killed) {
+        kill(-pid, SIGKILL);
+    }
+
+    result.exitCode = decodeStatus(status);
+    result.stdoutText = outCapture.str();
+    result.stderrText = errCapture.str();
+    result.stdoutDropped = outCapture.droppedBytes();
+    result.stderrDropped = errCapture.droppedBytes();
+    return result;
+}
+
+#endif
+
+} // namespace MCP
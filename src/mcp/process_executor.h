@@ -0,0 +1,88 @@
+#ifndef PROCESS_EXECUTOR_H
+#define PROCESS_EXECUTOR_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace MCP {
+
+/**
+ * Bounded capture of a process output stream.
+ *
+ * Keeps the first headBytes verbatim and the most recent tailBytes in a ring
+ * buffer, counting everything in between as dropped. Memory stays at
+ * headBytes + tailBytes no matter how much the process writes, and both the
+ * start of the output (the command's banner, first error) and its end (the
+ * final errors and summary) survive.
+ */
+class OutputCapture {
+public:
+    OutputCapture(size_t headBytes, size_t tailBytes);
+
+    void append(const char* data, size_t size);
+
+    /**
+     * Head and tail joined by a marker line when bytes were dropped.
+     */
+    std::string str() const;
+
+    size_t totalBytes() const { return m_total; }
+    size_t droppedBytes() const;
+
+private:
+    std::string m_head;
+    size_t m_headCapacity;
+    std::string m_tail;         // Ring buffer once full
+    size_t m_tailCapacity;
+    size_t m_tailStart = 0;     // Oldest byte in m_tail when full
+    size_t m_total = 0;
+};
+
+/**
+ * What to run and the limits to apply.
+ */
+struct ProcessOptions {
+    std::vector<std::string> argv;              // argv[0] is looked up in PATH
+    std::chrono::milliseconds timeout{30000};
+    size_t maxOutputBytes = 100000;             // Per stream, split between head and tail
+};
+
+/**
+ * Outcome of a process run.
+ */
+struct ProcessResult {
+    int exitCode = -1;          // Exit status, 128 + signal if killed by one, -1 if never started
+    std::string stdoutText;
+    std::string stderrText;
+    size_t stdoutDropped = 0;   // Bytes cut from the middle of each stream
+    size_t stderrDropped = 0;
+    bool timedOut = false;      // Killed because the timeout expired
+    std::string error;          // Set when the process could not be started
+};
+
+/**
+ * Runs a command with separate stdout/stderr pipes and a hard timeout.
+ *
+ * On POSIX the child is started with posix_spawnp in its own process group
+ * with stdin on /dev/null. Both pipes are drained with poll() into
+ * OutputCaptures. When the timeout expires the whole group gets SIGTERM and,
+ * after a short grace period, SIGKILL, so build tools' children die too.
+ * Once the main process has exited, pipes still held open by background
+ * children are drained briefly and then abandoned instead of blocking.
+ *
+ * On Windows the command runs through _popen with stderr merged into stdout
+ * and no timeout, as before; output is still bounded.
+ */
+class ProcessExecutor {
+public:
+    static ProcessResult Run(const ProcessOptions& options);
+
+    static constexpr std::chrono::milliseconds kKillGrace{2000};
+    static constexpr std::chrono::milliseconds kOrphanDrain{200};
+};
+
+} // namespace MCP
+
+#endif // PROCESS_EXECUTOR_H
@@ -0,0 +1,105 @@
+#include "tool_dispatcher.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace MCP {
+
+namespace {
+
+ToolResult executeCall(Provider& provider, const ToolCall& call) {
+    try {
+        return provider.executeTool(call.name, call.arguments);
+    } catch (const std::exception& e) {
+        return ToolResult::Error(call.name + " failed: " + e.what());
+    } catch (...) {
+        return ToolResult::Error(call.name + " failed");
+    }
+}
+
+} // namespace
+
+std::vector<ToolResult> ToolDispatcher::Run(const std::vector<ToolCall>& calls, size_t maxParallel) {
+    std::vector<ToolResult> results(calls.size());
+    std::vector<std::shared_ptr<Provider>> providers(calls.size());
+    std::vector<size_t> pending;
+
+    auto& registry = Registry::Instance();
+    for (size_t i = 0; i < calls.size(); ++i) {
+        providers[i] = registry.findToolProvider(calls[i].name);
+        if (providers[i]) {
+            pending.push_back(i);
+        } else {
+            results[i] = ToolResult::Error("Tool not found: " + calls[i].name);
+        }
+    }
+
+    size_t workers = std::min(std::max<size_t>(maxParallel, 1), pending.size());
+    if (workers <= 1) {
+        for (size_t index : pending) {
+            results[index] = executeCall(*providers[index], calls[index]);
+        }
+        return results;
+    }
+
+    struct Slots {
+        size_t limit = 1;
+        size_t inFlight = 0;
+    };
+    std::unordered_map<const Provider*, Slots> slots;
+    for (size_t index : pending) {
+        slots[providers[index].get()].limit = std::max<size_t>(providers[index]->maxConcurrentCalls(), 1);
+    }
+
+    std::mutex mutex;
+    std::condition_variable slotFreed;
+
+    auto work = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!pending.empty()) {
+            // Oldest waiting call whose provider has a free slot
+            auto next = std::find_if(pending.begin(), pending.end(), [&](size_t index) {
+                const Slots& s = slots[providers[index].get()];
+                return s.inFlight < s.limit;
+            });
+            if (next == pending.end()) {
+                // Everything left is blocked on busy providers; one of them will finish
+                slotFreed.wait(lock);
+                continue;
+            }
+
+            size_t index = *next;
+            pending.erase(next);
+            Slots& slot = slots[providers[index].get()];
+            ++slot.inFlight;
+
+            lock.unlock();
+            ToolResult result = executeCall(*providers[index], calls[index]);
+            lock.lock();
+
+            results[index] = std::move(result);
+            --slot.inFlight;
+            slotFreed.notify_all();
+        }
+        // Wake workers still waiting so they see the queue is empty
+        slotFreed.notify_all();
+    };
+
+    std::vector<std::thread> helpers;
+    helpers.reserve(workers - 1);
+    for (size_t i = 1; i < workers; ++i) {
+        helpers.emplace_back(work);
+    }
+    work();
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+
+    return results;
+}
+
+} // namespace MCP
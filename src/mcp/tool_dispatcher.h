@@ -0,0 +1,28 @@
+#ifndef TOOL_DISPATCHER_H
+#define TOOL_DISPATCHER_H
+
+#include "mcp.h"
+#include <cstddef>
+#include <vector>
+
+namespace MCP {
+
+/**
+ * Runs the tool calls the model requested in one turn.
+ *
+ * Each call is routed to its provider up front. Up to maxParallel calls then
+ * run at the same time: the calling thread and maxParallel - 1 helper
+ * threads take the next waiting call whose provider is below its
+ * Provider::maxConcurrentCalls() limit, so e.g. several file reads overlap
+ * while terminal commands still run one after another. Results come back in
+ * call order, and a call whose tool is unknown or whose provider throws gets
+ * an error result instead of failing the batch.
+ */
+class ToolDispatcher {
+public:
+    static std::vector<ToolResult> Run(const std::vector<ToolCall>& calls, size_t maxParallel);
+};
+
+} // namespace MCP
+
+#endif // TOOL_DISPATCHER_H
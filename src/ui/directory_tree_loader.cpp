@@ -0,0 +1,348 @@
+#include "directory_tree_loader.h"
+#include <algorithm>
+
+// Row insertion runs once per frame; while only "more" rows are waiting to
+// scroll into view, the timer just polls their visibility
+static const int kInsertFrameMs = 16;
+static const int kVisibilityPollMs = 150;
+
+DirectoryTreeLoader::DirectoryTreeLoader(wxTreeCtrl* tree, ItemDataFactory makeItemData)
+    : m_tree(tree)
+    , m_makeItemData(std::move(makeItemData))
+    , m_timer(this)
+{
+    Bind(wxEVT_TIMER, &DirectoryTreeLoader::OnTimer, this, m_timer.GetId());
+    m_tree->Bind(wxEVT_TREE_DELETE_ITEM, &DirectoryTreeLoader::OnItemDeleted, this);
+    m_tree->Bind(wxEVT_DESTROY, &DirectoryTreeLoader::OnTreeDestroyed, this);
+}
+
+DirectoryTreeLoader::~DirectoryTreeLoader()
+{
+    m_timer.Stop();
+    if (m_tree) {
+        m_tree->Unbind(wxEVT_TREE_DELETE_ITEM, &DirectoryTreeLoader::OnItemDeleted, this);
+        m_tree->Unbind(wxEVT_DESTROY, &DirectoryTreeLoader::OnTreeDestroyed, this);
+    }
+}
+
+void DirectoryTreeLoader::Load(const wxTreeItemId& item, const wxString& path)
+{
+    if (!m_tree || !item.IsOk()) return;
+
+    auto existing = m_directories.find(item.GetID());
+    if (existing != m_directories.end() && existing->second.loading) {
+        return;
+    }
+
+    // Deleting the old rows also forgets any subdirectories loaded below them
+    m_tree->DeleteChildren(item);
+
+    Directory& dir = m_directories[item.GetID()];
+    dir = Directory();
+    dir.item = item;
+    dir.path = path.ToUTF8().data();
+    while (dir.path.size() > 1 && dir.path.back() == '/') {
+        dir.path.pop_back();
+    }
+    dir.limit = kPageSize;
+    dir.generation = ++m_nextGeneration;
+    SetStatusRow(dir, "Loading...");
+
+    void* key = item.GetID();
+    uint64_t generation = dir.generation;
+    dir.listing = m_transfers.list(m_fs, path,
+        [this, key, generation](size_t count) {
+            Directory* dir = Find(key, generation);
+            if (dir && dir->loading) {
+                SetStatusRow(*dir, wxString::Format("Loading... (%lu items)",
+                                                    static_cast<unsigned long>(count)));
+            }
+        },
+        [this, key, generation](const FS::ListResult& result) { OnListed(key, generation, result); });
+}
+
+DirectoryTreeLoader::Directory* DirectoryTreeLoader::Find(void* key, uint64_t generation)
+{
+    auto it = m_directories.find(key);
+    if (it == m_directories.end() || it->second.generation != generation) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void DirectoryTreeLoader::OnListed(void* key, uint64_t generation, const FS::ListResult& result)
+{
+    Directory* found = Find(key, generation);
+    if (!found) return;
+    Directory& dir = *found;
+
+    dir.loading = false;
+    if (!result.success) {
+        SetStatusRow(dir, result.cancelled ? wxString("Cancelled") : result.error);
+        return;
+    }
+    dir.entries = result.entries;
+    if (dir.entries.empty()) {
+        // Kept so files created in it later still show up
+        SetStatusRow(dir, wxEmptyString);
+        m_tree->SetItemHasChildren(dir.item, false);
+        return;
+    }
+    InsertRows();
+    UpdateTimer();
+}
+
+bool DirectoryTreeLoader::HandleActivated(const wxTreeItemId& item)
+{
+    for (auto& [key, dir] : m_directories) {
+        if (!dir.loading && dir.statusRow.IsOk() && dir.statusRow == item) {
+            ShowMore(dir);
+            return true;
+        }
+    }
+    return false;
+}
+
+void DirectoryTreeLoader::CancelAll()
+{
+    m_transfers.cancelAll();
+    m_directories.clear();
+    m_timer.Stop();
+}
+
+bool DirectoryTreeLoader::IsPendingRow(const wxTreeItemId& item) const
+{
+    return m_tree && item.IsOk() && m_tree->GetItemData(item) == nullptr;
+}
+
+void DirectoryTreeLoader::ApplyChanges(const std::vector<FS::FileChange>& changes)
+{
+    if (!m_tree || m_directories.empty()) return;
+
+    // Deleting a directory row drops the loaded directories below it
+    std::unordered_map<std::string, void*> byPath;
+    bool stale = true;
+    std::vector<void*> touched;
+    bool frozen = false;
+
+    for (const auto& change : changes) {
+        if (change.kind == FS::FileChange::Kind::Modified) continue;
+
+        size_t slash = change.path.rfind('/');
+        if (slash == std::string::npos || slash + 1 == change.path.size()) continue;
+        std::string parent = change.path.substr(0, slash == 0 ? 1 : slash);
+
+        if (stale) {
+            byPath.clear();
+            for (auto& [key, dir] : m_directories) {
+                if (!dir.loading) {
+                    byPath[dir.path] = key;
+                }
+            }
+            stale = false;
+        }
+        auto it = byPath.find(parent);
+        if (it == byPath.end()) continue;
+        Directory& dir = m_directories[it->second];
+
+        if (!frozen) {
+            m_tree->Freeze();
+            frozen = true;
+        }
+        wxString name = wxString::FromUTF8(change.path.substr(slash + 1));
+        if (change.kind == FS::FileChange::Kind::Created) {
+            AddEntry(dir, FS::FileEntry(name, wxString::FromUTF8(change.path), change.isDirectory));
+        } else if (RemoveEntry(dir, name)) {
+            stale = true;
+        }
+        if (std::find(touched.begin(), touched.end(), it->second) == touched.end()) {
+            touched.push_back(it->second);
+        }
+    }
+
+    for (void* key : touched) {
+        auto it = m_directories.find(key);
+        if (it == m_directories.end()) continue;
+        Directory& dir = it->second;
+        // Directories still creating rows update their status row as they go
+        if (dir.shown < dir.limit && dir.shown < dir.entries.size()) continue;
+        size_t remaining = dir.entries.size() - dir.shown;
+        SetStatusRow(dir, remaining > 0
+            ? wxString::Format("%lu more items", static_cast<unsigned long>(remaining))
+            : wxString());
+    }
+
+    if (frozen) {
+        m_tree->Thaw();
+    }
+    UpdateTimer();
+}
+
+// --- Rows ---
+
+void DirectoryTreeLoader::InsertRows()
+{
+    size_t budget = kBatchSize;
+    bool frozen = false;
+
+    for (auto& [key, dir] : m_directories) {
+        if (budget == 0) break;
+        if (dir.loading || dir.shown >= dir.limit || dir.shown >= dir.entries.size()) {
+            continue;
+        }
+        if (!frozen) {
+            m_tree->Freeze();
+            frozen = true;
+        }
+
+        // The status row stays last: take it out while appending
+        SetStatusRow(dir, wxEmptyString);
+        size_t end = std::min({dir.limit, dir.entries.size(), dir.shown + budget});
+        for (; dir.shown < end; ++dir.shown, --budget) {
+            const FS::FileEntry& entry = dir.entries[dir.shown];
+            wxTreeItemId row = m_tree->AppendItem(dir.item, entry.name, -1, -1, m_makeItemData(entry));
+            if (entry.isDirectory) {
+                m_tree->AppendItem(row, ""); // Dummy for expand arrow
+            }
+        }
+
+        size_t remaining = dir.entries.size() - dir.shown;
+        if (remaining > 0) {
+            SetStatusRow(dir, wxString::Format("%lu more items", static_cast<unsigned long>(remaining)));
+        }
+    }
+
+    if (frozen) {
+        m_tree->Thaw();
+    }
+}
+
+void DirectoryTreeLoader::SetStatusRow(Directory& dir, const wxString& label)
+{
+    if (dir.statusRow.IsOk()) {
+        if (!label.empty()) {
+            m_tree->SetItemText(dir.statusRow, label);
+            return;
+        }
+        wxTreeItemId row = dir.statusRow;
+        dir.statusRow = wxTreeItemId();
+        m_tree->Delete(row);
+    } else if (!label.empty()) {
+        dir.statusRow = m_tree->AppendItem(dir.item, label);
+    }
+}
+
+void DirectoryTreeLoader::ShowMore(Directory& dir)
+{
+    if (dir.limit > dir.shown) return;   // Still creating the last page
+    dir.limit = dir.shown + kPageSize;
+    SetStatusRow(dir, "Loading...");
+    UpdateTimer();
+}
+
+void DirectoryTreeLoader::AddEntry(Directory& dir, const FS::FileEntry& entry)
+{
+    auto byName = [](const FS::FileEntry& a, const FS::FileEntry& b) { return a.name.compare(b.name) < 0; };
+    auto pos = std::lower_bound(dir.entries.begin(), dir.entries.end(), entry, byName);
+    if (pos != dir.entries.end() && pos->name == entry.name) return;
+
+    size_t index = pos - dir.entries.begin();
+    bool allShown = dir.shown == dir.entries.size();
+    dir.entries.insert(pos, entry);
+
+    // Rows past the shown ones are created with their page
+    if (index >= dir.shown && !allShown) return;
+
+    wxTreeItemId row = m_tree->InsertItem(dir.item, index, entry.name, -1, -1, m_makeItemData(entry));
+    if (entry.isDirectory) {
+        m_tree->AppendItem(row, ""); // Dummy for expand arrow
+    }
+    ++dir.shown;
+    dir.limit = std::max(dir.limit, dir.shown);
+}
+
+bool DirectoryTreeLoader::RemoveEntry(Directory& dir, const wxString& name)
+{
+    auto pos = std::lower_bound(dir.entries.begin(), dir.entries.end(), name,
+        [](const FS::FileEntry& entry, const wxString& value) { return entry.name.compare(value) < 0; });
+    if (pos == dir.entries.end() || pos->name != name) return false;
+
+    size_t index = pos - dir.entries.begin();
+    dir.entries.erase(pos);
+    if (index >= dir.shown) return false;
+
+    --dir.shown;
+    wxTreeItemId row = EntryRow(dir, index);
+    if (!row.IsOk()) return false;
+    m_tree->Delete(row);
+    return true;
+}
+
+wxTreeItemId DirectoryTreeLoader::EntryRow(const Directory& dir, size_t index) const
+{
+    wxTreeItemIdValue cookie;
+    wxTreeItemId child = m_tree->GetFirstChild(dir.item, cookie);
+    for (size_t i = 0; i < index && child.IsOk(); ++i) {
+        child = m_tree->GetNextChild(dir.item, cookie);
+    }
+    return child;
+}
+
+void DirectoryTreeLoader::UpdateTimer()
+{
+    bool inserting = false;
+    bool waiting = false;
+    for (const auto& [key, dir] : m_directories) {
+        if (dir.loading) continue;
+        if (dir.shown < dir.limit && dir.shown < dir.entries.size()) {
+            inserting = true;
+        } else if (dir.shown < dir.entries.size()) {
+            waiting = true;
+        }
+    }
+
+    int interval = inserting ? kInsertFrameMs : (waiting ? kVisibilityPollMs : 0);
+    if (interval == 0) {
+        m_timer.Stop();
+    } else if (!m_timer.IsRunning() || m_timer.GetInterval() != interval) {
+        m_timer.Start(interval);
+    }
+}
+
+// --- Events ---
+
+void DirectoryTreeLoader::OnTimer(wxTimerEvent& event)
+{
+    if (!m_tree) return;
+
+    InsertRows();
+
+    // A page is due once its "more" row scrolls into view
+    for (auto& [key, dir] : m_directories) {
+        if (!dir.loading && dir.shown == dir.limit && dir.statusRow.IsOk() &&
+            m_tree->IsVisible(dir.statusRow)) {
+            dir.limit = dir.shown + kPageSize;
+        }
+    }
+    UpdateTimer();
+}
+
+void DirectoryTreeLoader::OnItemDeleted(wxTreeEvent& event)
+{
+    event.Skip();
+
+    auto it = m_directories.find(event.GetItem().GetID());
+    if (it != m_directories.end()) {
+        it->second.listing.cancel();
+        m_directories.erase(it);
+    }
+}
+
+void DirectoryTreeLoader::OnTreeDestroyed(wxWindowDestroyEvent& event)
+{
+    event.Skip();
+    if (event.GetEventObject() != m_tree) return;
+
+    CancelAll();
+    m_tree = nullptr;
+}
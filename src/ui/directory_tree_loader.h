@@ -0,0 +1,112 @@
+#ifndef DIRECTORY_TREE_LOADER_H
+#define DIRECTORY_TREE_LOADER_H
+
+#include <wx/wx.h>
+#include <wx/treectrl.h>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "../fs/fs.h"
+#include "../fs/transfer_scope.h"
+#include "../fs/change_watcher.h"
+#include <string>
+
+/**
+ * Fills the children of wxTreeCtrl directory items in the background.
+ *
+ * Load() puts a "Loading..." row under the item and lists the directory
+ * with FS::DirectoryLister, so expanding a directory never blocks the UI
+ * however large it is or however slow the host. The sorted entries are then
+ * inserted at most kBatchSize rows per frame.
+ *
+ * Large directories are virtualized: only the first kPageSize rows are
+ * created, followed by an "N more items" row. When that row scrolls into
+ * view, or is activated, the next page is created. Directory rows get an
+ * empty dummy child so they show an expand arrow; owners start a Load()
+ * when such an item expands (see IsPendingRow()).
+ *
+ * ApplyChanges() folds in changes made outside the editor (see
+ * FS::WatchService), adding and removing rows of loaded directories in
+ * place rather than listing them again.
+ *
+ * The loader binds to the tree's item-deletion and destroy events, so
+ * owners may delete items or the tree itself at any time.
+ */
+class DirectoryTreeLoader : public wxEvtHandler {
+public:
+    static constexpr size_t kBatchSize = 200;
+    static constexpr size_t kPageSize = 1000;
+
+    /** Creates the item data for an entry's row. */
+    using ItemDataFactory = std::function<wxTreeItemData*(const FS::FileEntry& entry)>;
+
+    DirectoryTreeLoader(wxTreeCtrl* tree, ItemDataFactory makeItemData);
+    ~DirectoryTreeLoader() override;
+
+    void SetFilesystem(const FS::Filesystem& fs) { m_fs = fs; }
+
+    /**
+     * Replace the item's children with the contents of path.
+     * Does nothing if the item is already loading.
+     */
+    void Load(const wxTreeItemId& item, const wxString& path);
+
+    /**
+     * Create the next page of rows if item is an "N more items" row.
+     * @return true if it was one.
+     */
+    bool HandleActivated(const wxTreeItemId& item);
+
+    /** Stop all loads in flight, e.g. before rebuilding the tree. */
+    void CancelAll();
+
+    /**
+     * True for rows this loader creates that are not entries: the dummy
+     * under an unexpanded directory and the loading and "more" rows.
+     */
+    bool IsPendingRow(const wxTreeItemId& item) const;
+
+    /**
+     * Add and remove rows of loaded directories for files created or
+     * deleted elsewhere. Directories that are still loading are skipped.
+     */
+    void ApplyChanges(const std::vector<FS::FileChange>& changes);
+
+private:
+    struct Directory {
+        wxTreeItemId item;
+        std::string path;           // UTF-8, without a trailing slash
+        std::vector<FS::FileEntry> entries;
+        size_t shown = 0;           // Entries created as rows
+        size_t limit = 0;           // Create rows up to here before pausing
+        wxTreeItemId statusRow;     // "Loading..." or "N more items", if any
+        bool loading = true;
+        uint64_t generation = 0;    // Tells this load's results from an earlier item's at the same address
+        FS::TransferToken listing;
+    };
+
+    wxTreeCtrl* m_tree;
+    ItemDataFactory m_makeItemData;
+    FS::Filesystem m_fs;
+    std::unordered_map<void*, Directory> m_directories;  // By wxTreeItemId::GetID()
+    uint64_t m_nextGeneration = 0;
+    wxTimer m_timer;
+    FS::TransferScope m_transfers;   // Last, so it is cancelled first
+
+    Directory* Find(void* key, uint64_t generation);
+    void OnListed(void* key, uint64_t generation, const FS::ListResult& result);
+    void InsertRows();
+    void SetStatusRow(Directory& dir, const wxString& label);
+    void ShowMore(Directory& dir);
+    void AddEntry(Directory& dir, const FS::FileEntry& entry);
+    bool RemoveEntry(Directory& dir, const wxString& name);
+    wxTreeItemId EntryRow(const Directory& dir, size_t index) const;
+    void UpdateTimer();
+
+    void OnTimer(wxTimerEvent& event);
+    void OnItemDeleted(wxTreeEvent& event);
+    void OnTreeDestroyed(wxWindowDestroyEvent& event);
+};
+
+#endif // DIRECTORY_TREE_LOADER_H
@@ -3,12 +3,18 @@
 #include <wx/filename.h>
 #include <wx/filedlg.h>
 #include <wx/msgdlg.h>
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <future>
 #include <string>
 
+// Change events for a file arrive shortly after we wrote it ourselves
+
 wxBEGIN_EVENT_TABLE(Editor, wxPanel)
     EVT_STC_SAVEPOINTREACHED(wxID_ANY, Editor::OnSavePointReached)
     EVT_STC_SAVEPOINTLEFT(wxID_ANY, Editor::OnSavePointLeft)
+    EVT_STC_MODIFIED(wxID_ANY, Editor::OnTextChanged)
 wxEND_EVENT_TABLE()
 
 Editor::Editor(wxWindow* parent, wxWindowID id)
@@ -16,6 +22,14 @@ Editor::Editor(wxWindow* parent, wxWindowID id)
     , m_textCtrl(nullptr)
     , m_isModified(false)
     , m_themeListenerId(0)
+    , m_loadGeneration(0)
+    , m_loadedBytes(0)
+    , m_loading(false)
+    , m_changeCount(0)
+    , m_savesInFlight(0)
+    , m_saveGeneration(0)
+    , m_changedWhileSaving(false)
+    , m_askingToReload(false)
 {
     SetupTextCtrl();
     ApplyCurrentTheme();
@@ -63,6 +77,8 @@ void Editor::SetupTextCtrl()
     // Default to no lexer
     m_textCtrl->SetLexer(wxSTC_LEX_NULL);
     
+    m_textCtrl->Bind(wxEVT_KEY_DOWN, &Editor::OnKeyDown, this);
+    
     sizer->Add(m_textCtrl, 1, wxEXPAND);
     SetSizer(sizer);
 }
@@ -304,62 +320,229 @@ bool Editor::OpenFile(const wxString& path)
         return false;
     }
     
-    // Create local filesystem and read file
-    m_filesystem = FS::Filesystem::Local(FS::Filesystem::getDirectory(path));
-    auto result = m_filesystem->readFile(path);
+    StartLoad(FS::Filesystem::Local(FS::Filesystem::getDirectory(path)), path);
+    return true;
+}
+
+bool Editor::OpenRemoteFile(const wxString& remotePath, const std::string& sshPrefix)
+{
+    wxLogMessage("Editor::OpenRemoteFile: remotePath='%s'", remotePath);
     
-    if (!result.success) {
-        wxMessageBox(result.error, "Error", wxOK | wxICON_ERROR, this);
+    // Check for unsaved changes
+    if (!PromptSaveIfModified()) {
         return false;
     }
     
-    m_textCtrl->SetText(result.content);
-    m_textCtrl->EmptyUndoBuffer();
-    m_textCtrl->SetSavePoint();
+    // Create remote filesystem from SSH config
+    auto sshConfig = FS::SshConfig::LoadFromConfig();
+    StartLoad(FS::Filesystem::Remote(sshConfig, FS::Filesystem::getDirectory(remotePath)), remotePath);
+    return true;
+}
+
+void Editor::StartLoad(const FS::Filesystem& fs, const wxString& path)
+{
+    CancelLoad();
     
+    m_filesystem = fs;
     m_currentFilePath = path;
+    m_remoteBase.reset();
+    m_savedChecksum.clear();
+    m_changedWhileSaving = false;
+    m_loading = true;
+    m_loadedBytes = 0;
+    uint64_t generation = ++m_loadGeneration;
+    
+    // Content arrives in chunks; keep it out of the undo history and
+    // read-only until all of it is there
+    m_textCtrl->SetReadOnly(false);
+    m_textCtrl->SetUndoCollection(false);
+    m_textCtrl->ClearAll();
+    m_textCtrl->SetReadOnly(true);
     SetModified(false);
     
     // Configure lexer based on file extension
     ConfigureLexer(FS::Filesystem::getExtension(path));
     
     NotifyFileChanged();
-    
-    return true;
+    ReportTransfer("Opening " + GetFileName() + "...");
+    
+    wxString name = GetFileName();
+    m_loadToken = m_transfers.read(fs, path,
+        [this, generation, name](std::string chunk, const FS::TransferProgress& progress) {
+            if (generation != m_loadGeneration) return;
+            AppendLoadedChunk(chunk);
+            ReportTransfer(FormatProgress("Opening", name, progress));
+        },
+        [this, generation](const FS::TransferResult& result) {
+            if (generation != m_loadGeneration) return;
+            FinishLoad(result);
+        });
 }
 
-bool Editor::OpenRemoteFile(const wxString& remotePath, const std::string& sshPrefix)
+void Editor::AppendLoadedChunk(const std::string& chunk)
 {
-    wxLogMessage("Editor::OpenRemoteFile: remotePath='%s'", remotePath);
+    const char* data = chunk.data();
+    size_t size = chunk.size();
     
-    // Check for unsaved changes
-    if (!PromptSaveIfModified()) {
-        return false;
+    // A UTF-8 byte order mark is not part of the text
+    if (m_loadedBytes == 0 && size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+        data += 3;
+        size -= 3;
     }
+    m_loadedBytes += chunk.size();
     
-    // Create remote filesystem from SSH config
-    auto sshConfig = FS::SshConfig::LoadFromConfig();
-    m_filesystem = FS::Filesystem::Remote(sshConfig, FS::Filesystem::getDirectory(remotePath));
+    m_textCtrl->SetReadOnly(false);
+    m_textCtrl->AppendTextRaw(data, static_cast<int>(size));
+    m_textCtrl->SetReadOnly(true);
+}
+
+void Editor::FinishLoad(const FS::TransferResult& result)
+{
+    m_loading = false;
+    ReportTransfer(wxEmptyString);
     
-    auto result = m_filesystem->readFile(remotePath);
     if (!result.success) {
-        wxLogError("Could not read remote file: %s - %s", remotePath, result.error);
-        return false;
+        if (!result.cancelled) {
+            wxMessageBox(result.error, "Error", wxOK | wxICON_ERROR, this);
+        }
+        // Never leave a partial file open where it could be saved over the original
+        ResetToUntitled();
+        return;
     }
     
-    m_textCtrl->SetText(result.content);
+    m_remoteBase = result.signature;
+    m_textCtrl->SetReadOnly(false);
+    m_textCtrl->SetUndoCollection(true);
     m_textCtrl->EmptyUndoBuffer();
     m_textCtrl->SetSavePoint();
+    SetModified(false);
     
-    m_currentFilePath = remotePath;
+    std::vector<std::function<void()>> pending;
+    pending.swap(m_whenLoaded);
+    for (auto& fn : pending) {
+        fn();
+    }
+}
+
+void Editor::CancelLoad()
+{
+    if (!m_loading) {
+        return;
+    }
+    m_loadToken.cancel();
+    ++m_loadGeneration;
+    FS::TransferResult result;
+    result.cancelled = true;
+    FinishLoad(result);
+}
+
+void Editor::WhenLoaded(std::function<void()> fn)
+{
+    if (m_loading) {
+        m_whenLoaded.push_back(std::move(fn));
+    } else {
+        fn();
+    }
+}
+
+void Editor::OnExternalChanges(const std::vector<FS::FileChange>& changes)
+{
+    if (!HasFile() || m_loading || m_askingToReload) {
+        return;
+    }
+    
+    std::string path = m_currentFilePath.ToUTF8().data();
+    auto change = std::find_if(changes.begin(), changes.end(),
+        [&path](const FS::FileChange& change) { return change.path == path; });
+    if (change == changes.end()) {
+        return;
+    }
+    
+    if (change->kind == FS::FileChange::Kind::Deleted) {
+        // The buffer is all that is left of the file
+        SetModified(true);
+        return;
+    }
+    
+    CheckDiskContent();
+}
+
+void Editor::CheckDiskContent()
+{
+    // Looked at once the save lands, as it may be what changed the file
+    if (m_savesInFlight > 0) {
+        m_changedWhileSaving = true;
+        return;
+    }
+    
+    // Our own saves are reported too, possibly much later (remote polling):
+    // only a file whose content differs from what we last wrote has changed
+    auto checksum = std::make_shared<FS::PosixChecksum>();
+    wxString path = m_currentFilePath;
+    uint64_t generation = m_loadGeneration;
+    m_transfers.read(m_filesystem.value_or(FS::Filesystem::Local(FS::Filesystem::getDirectory(path))), path,
+        [checksum](std::string chunk, const FS::TransferProgress&) {
+            checksum->update(chunk.data(), chunk.size());
+        },
+        [this, checksum, path, generation](const FS::TransferResult& result) {
+            if (!result.success || path != m_currentFilePath || generation != m_loadGeneration ||
+                m_loading || m_askingToReload) {
+                return;
+            }
+            if (m_savesInFlight > 0) {
+                m_changedWhileSaving = true;
+                return;
+            }
+            if (checksum->finish() != m_savedChecksum) {
+                ConfirmReload();
+            }
+        });
+}
+
+void Editor::ConfirmReload()
+{
+    if (m_isModified) {
+        m_askingToReload = true;
+        int answer = wxMessageBox(GetFileName() + " has changed on disk. Reload it and lose your changes?",
+                                  "File Changed", wxYES_NO | wxICON_QUESTION, this);
+        m_askingToReload = false;
+        if (answer != wxYES) {
+            return;
+        }
+    }
+    ReloadKeepingPosition();
+}
+
+void Editor::ReloadKeepingPosition()
+{
+    int firstLine = m_textCtrl->GetFirstVisibleLine();
+    int pos = m_textCtrl->GetCurrentPos();
+    
+    StartLoad(m_filesystem.value_or(FS::Filesystem::Local(FS::Filesystem::getDirectory(m_currentFilePath))),
+              m_currentFilePath);
+    WhenLoaded([this, firstLine, pos]() {
+        m_textCtrl->GotoPos(std::min(pos, m_textCtrl->GetLength()));
+        m_textCtrl->SetFirstVisibleLine(firstLine);
+    });
+}
+
+void Editor::ResetToUntitled()
+{
+    m_whenLoaded.clear();
+    m_textCtrl->SetReadOnly(false);
+    m_textCtrl->SetUndoCollection(true);
+    m_textCtrl->ClearAll();
+    m_textCtrl->EmptyUndoBuffer();
+    m_textCtrl->SetSavePoint();
+    
+    m_currentFilePath.Clear();
+    m_filesystem.reset();
+    m_remoteBase.reset();
     SetModified(false);
     
-    // Configure lexer based on file extension
-    ConfigureLexer(FS::Filesystem::getExtension(remotePath));
+    m_textCtrl->SetLexer(wxSTC_LEX_NULL);
     
     NotifyFileChanged();
-    
-    return true;
 }
 
 bool Editor::Save()
@@ -368,10 +551,68 @@ bool Editor::Save()
         return SaveAs();
     }
     
+    // Saving now would write back a partial file
+    if (m_loading) {
+        return false;
+    }
+    
+    if (!m_filesystem.has_value()) {
+        return SaveNow();
+    }
+    
+    wxCharBuffer raw = m_textCtrl->GetTextRaw();
+    std::string data(raw.data(), raw.length());
+    std::string checksum = FS::PosixChecksum::Of(data);
+    wxString path = m_currentFilePath;
+    wxString name = GetFileName();
+    uint64_t changeCount = m_changeCount;
+    uint64_t generation = ++m_saveGeneration;
+    
+    ReportTransfer("Saving " + name + "...");
+    ++m_savesInFlight;
+    m_transfers.write(*m_filesystem, path, std::move(data),
+        [this, name](const FS::TransferProgress& progress) {
+            ReportTransfer(FormatProgress("Saving", name, progress));
+        },
+        [this, path, changeCount, generation, checksum](const FS::TransferResult& result) {
+            --m_savesInFlight;
+            ReportTransfer(wxEmptyString);
+            if (result.success && path == m_currentFilePath) {
+                m_savedChecksum = checksum;
+            }
+            if (m_savesInFlight == 0 && m_changedWhileSaving) {
+                m_changedWhileSaving = false;
+                CheckDiskContent();
+            }
+            if (!result.success) {
+                wxMessageBox(result.error, "Error", wxOK | wxICON_ERROR, this);
+                return;
+            }
+            // A later save (possibly a synchronous one) knows the newer content
+            if (path == m_currentFilePath && generation == m_saveGeneration) {
+                m_remoteBase = result.signature;
+            }
+            // Edits made while the save was running are not on disk yet
+            if (path == m_currentFilePath && changeCount == m_changeCount && !m_loading) {
+                m_textCtrl->SetSavePoint();
+                SetModified(false);
+            }
+        },
+        m_remoteBase);
+    return true;
+}
+
+bool Editor::SaveNow()
+{
+    if (m_loading) {
+        return false;
+    }
+    
     // Use the stored filesystem (local or remote)
     if (m_filesystem.has_value()) {
-        wxString content = m_textCtrl->GetText();
-        auto result = m_filesystem->writeFile(m_currentFilePath, content);
+        ++m_saveGeneration;
+        auto result = WriteInOrder(*m_filesystem, m_currentFilePath, m_remoteBase);
+        m_remoteBase = result.signature;
         
         if (!result.success) {
             wxMessageBox(result.error, "Error", wxOK | wxICON_ERROR, this);
@@ -390,25 +631,73 @@ bool Editor::Save()
         return false;
     }
     
-    wxString content = m_textCtrl->GetText();
-    if (!file.Write(content)) {
+    wxCharBuffer raw = m_textCtrl->GetTextRaw();
+    bool written = file.Write(raw.data(), raw.length()) == raw.length();
+    if (!written) {
         wxMessageBox("Error writing to file: " + m_currentFilePath, "Error", wxOK | wxICON_ERROR, this);
         return false;
     }
     
+    m_savedChecksum = FS::PosixChecksum::Of(std::string_view(raw.data(), raw.length()));
     m_textCtrl->SetSavePoint();
     SetModified(false);
     
     return true;
 }
 
+FS::TransferResult Editor::WriteInOrder(const FS::Filesystem& fs, const wxString& path,
+                                        std::shared_ptr<const FS::DeltaSignature> base)
+{
+    wxCharBuffer raw = m_textCtrl->GetTextRaw();
+    std::string data(raw.data(), raw.length());
+    std::string checksum = FS::PosixChecksum::Of(data);
+    
+    // FileIO runs transfers in submission order, so this lands after any
+    // save still queued from Save() instead of being overwritten by it
+    std::promise<FS::TransferResult> done;
+    auto result = done.get_future();
+    FS::FileIO::Instance().write(fs, path, std::move(data), nullptr,
+        [&done](const FS::TransferResult& written) { done.set_value(written); },
+        FS::TransferToken(), std::move(base));
+    
+    wxBusyCursor busy;
+    FS::TransferResult written = result.get();
+    if (written.success) {
+        m_savedChecksum = checksum;
+    }
+    return written;
+}
+
+void Editor::ReportTransfer(const wxString& status)
+{
+    if (m_transferCallback) {
+        m_transferCallback(status);
+    }
+}
+
+wxString Editor::FormatProgress(const wxString& action, const wxString& name,
+                                const FS::TransferProgress& progress)
+{
+    wxString done = wxFileName::GetHumanReadableSize(wxULongLong(progress.bytesDone));
+    if (progress.bytesTotal <= 0) {
+        return wxString::Format("%s %s... %s", action, name, done);
+    }
+    int percent = static_cast<int>(progress.bytesDone * 100 / static_cast<uint64_t>(progress.bytesTotal));
+    return wxString::Format("%s %s... %d%% (%s of %s)", action, name, std::min(percent, 100), done,
+                            wxFileName::GetHumanReadableSize(wxULongLong(progress.bytesTotal)));
+}
+
 bool Editor::SaveAs(const wxString& path)
 {
+    if (m_loading) {
+        return false;
+    }
+    
     // Create local filesystem for save-as (always saves locally)
     auto fs = FS::Filesystem::Local(FS::Filesystem::getDirectory(path));
     
-    wxString content = m_textCtrl->GetText();
-    auto result = fs.writeFile(path, content);
+    ++m_saveGeneration;
+    auto result = WriteInOrder(fs, path, nullptr);
     
     if (!result.success) {
         wxMessageBox(result.error, "Error", wxOK | wxICON_ERROR, this);
@@ -417,6 +706,7 @@ bool Editor::SaveAs(const wxString& path)
     
     m_currentFilePath = path;
     m_filesystem = fs;  // Update to local filesystem
+    m_remoteBase.reset();
     m_textCtrl->SetSavePoint();
     SetModified(false);
     
@@ -449,6 +739,7 @@ void Editor::NewFile()
         return;
     }
     
+    CancelLoad();
     m_textCtrl->ClearAll();
     m_textCtrl->EmptyUndoBuffer();
     m_textCtrl->SetSavePoint();
@@ -494,7 +785,7 @@ bool Editor::PromptSaveIfModified()
     }
     
     if (result == wxYES) {
-        return Save();
+        return SaveNow();
     }
     
     // User chose No - discard changes
@@ -523,6 +814,23 @@ void Editor::NotifyFileChanged()
     }
 }
 
+void Editor::OnTextChanged(wxStyledTextEvent& event)
+{
+    if (event.GetModificationType() & (wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT)) {
+        ++m_changeCount;
+    }
+    event.Skip();
+}
+
+void Editor::OnKeyDown(wxKeyEvent& event)
+{
+    if (m_loading && event.GetKeyCode() == WXK_ESCAPE) {
+        CancelLoad();
+        return;
+    }
+    event.Skip();
+}
+
 void Editor::OnSavePointReached(wxStyledTextEvent& event)
 {
     SetModified(false);
@@ -531,6 +839,9 @@ void Editor::OnSavePointReached(wxStyledTextEvent& event)
 
 void Editor::OnSavePointLeft(wxStyledTextEvent& event)
 {
-    SetModified(true);
+    // Text streaming in while a file loads is not an edit
+    if (!m_loading) {
+        SetModified(true);
+    }
     event.Skip();
 }
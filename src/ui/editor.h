@@ -6,12 +6,25 @@
 #include <wx/file.h>
 #include <functional>
 #include <string>
+#include <vector>
 #include "../theme/theme.h"
 #include "../fs/fs.h"
+#include "../fs/transfer_scope.h"
+#include "../fs/change_watcher.h"
 
 /**
  * Editor component for ByteMuseHQ.
  * Wraps wxStyledTextCtrl with file management, dirty tracking, and save functionality.
+ *
+ * Files are opened and saved through FS::FileIO off the UI thread. While a
+ * file loads its content streams into the (read-only) control chunk by
+ * chunk; Escape cancels the load. Progress is reported through the
+ * transfer status callback.
+ *
+ * When the open file changes on disk (see FS::WatchService) it is reloaded
+ * in place, keeping the caret and scroll position, or, if it has unsaved
+ * edits, only after the user agrees. A change whose content matches what
+ * the editor last wrote is its own save and is ignored.
  */
 class Editor : public wxPanel {
 public:
@@ -19,11 +32,14 @@ public:
     using DirtyStateCallback = std::function<void(bool isDirty)>;
     // Callback when file changes (opened, saved, etc.)
     using FileChangeCallback = std::function<void(const wxString& filePath)>;
+    // Callback with the progress of a background open/save, empty when done
+    using TransferStatusCallback = std::function<void(const wxString& status)>;
 
     Editor(wxWindow* parent, wxWindowID id = wxID_ANY);
     virtual ~Editor() = default;
 
-    // File operations
+    // File operations. Opening and Save() return once the transfer has
+    // started; errors are reported when it completes.
     bool OpenFile(const wxString& path);
     bool OpenRemoteFile(const wxString& remotePath, const std::string& sshPrefix);
     bool Save();
@@ -31,8 +47,17 @@ public:
     bool SaveAs(); // Shows dialog
     void NewFile();
 
+    // Run fn once the current file has finished loading (now if it has).
+    // Dropped if the load fails or is cancelled.
+    void WhenLoaded(std::function<void()> fn);
+    void CancelLoad();
+
+    // Reload the open file if changes made elsewhere include it
+    void OnExternalChanges(const std::vector<FS::FileChange>& changes);
+
     // State queries
     bool IsModified() const { return m_isModified; }
+    bool IsLoading() const { return m_loading; }
     bool HasFile() const { return !m_currentFilePath.IsEmpty(); }
     const wxString& GetFilePath() const { return m_currentFilePath; }
     wxString GetFileName() const;
@@ -45,6 +70,7 @@ public:
     // Callbacks
     void SetDirtyStateCallback(DirtyStateCallback callback) { m_dirtyCallback = std::move(callback); }
     void SetFileChangeCallback(FileChangeCallback callback) { m_fileChangeCallback = std::move(callback); }
+    void SetTransferStatusCallback(TransferStatusCallback callback) { m_transferCallback = std::move(callback); }
 
     // Prompt to save if modified. Returns true if it's ok to proceed (saved or discarded)
     bool PromptSaveIfModified();
@@ -59,9 +85,25 @@ private:
     int m_themeListenerId;
     std::optional<FS::Filesystem> m_filesystem;  // Filesystem for current file (local or remote)
     
+    // Background transfers
+    FS::TransferScope m_transfers;
+    FS::TransferToken m_loadToken;
+    uint64_t m_loadGeneration;      // Tells callbacks of an abandoned load apart
+    uint64_t m_loadedBytes;
+    bool m_loading;
+    uint64_t m_changeCount;         // Text modifications, to spot edits made during a save
+    std::shared_ptr<const FS::DeltaSignature> m_remoteBase;  // What the remote file holds, for delta saves
+    std::vector<std::function<void()>> m_whenLoaded;
+    int m_savesInFlight;
+    uint64_t m_saveGeneration;      // Bumped per save, so older completions don't touch m_remoteBase
+    std::string m_savedChecksum;    // cksum of what we last wrote; our own saves show up as changes too
+    bool m_changedWhileSaving;
+    bool m_askingToReload;
+    
     // Callbacks
     DirtyStateCallback m_dirtyCallback;
     FileChangeCallback m_fileChangeCallback;
+    TransferStatusCallback m_transferCallback;
 
     // Setup methods
     void SetupTextCtrl();
@@ -69,6 +111,23 @@ private:
     void ApplyCurrentTheme();
     void ApplySyntaxColors(const ThemePtr& theme);
     
+    // Background open/save
+    void StartLoad(const FS::Filesystem& fs, const wxString& path);
+    void AppendLoadedChunk(const std::string& chunk);
+    void FinishLoad(const FS::TransferResult& result);
+    void ResetToUntitled();
+    void CheckDiskContent();
+    void ConfirmReload();
+    void ReloadKeepingPosition();
+    bool SaveNow();
+    
+    // Write the buffer through FS::FileIO's queue and wait for the result
+    FS::TransferResult WriteInOrder(const FS::Filesystem& fs, const wxString& path,
+                                    std::shared_ptr<const FS::DeltaSignature> base);
+    void ReportTransfer(const wxString& status);
+    static wxString FormatProgress(const wxString& action, const wxString& name,
+                                   const FS::TransferProgress& progress);
+    
     // Internal state management
     void SetModified(bool modified);
     void NotifyDirtyStateChanged();
@@ -76,6 +135,7 @@ private:
 
     // Event handlers
     void OnTextChanged(wxStyledTextEvent& event);
+    void OnKeyDown(wxKeyEvent& event);
     void OnSavePointReached(wxStyledTextEvent& event);
     void OnSavePointLeft(wxStyledTextEvent& event);
 
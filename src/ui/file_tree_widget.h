@@ -3,12 +3,15 @@
 
 #include "widget.h"
 #include "editor.h"
+#include "directory_tree_loader.h"
 #include "../theme/theme.h"
 #include "../config/config.h"
+#include "../fs/fs.h"
+#include "../fs/watch_service.h"
 #include <wx/treectrl.h>
 #include <wx/dir.h>
 #include <wx/filename.h>
-#include <sstream>
+#include <memory>
 
 #ifdef _WIN32
 #include <io.h>
@@ -147,7 +150,9 @@ private:
 /**
  * File tree sidebar widget.
  * Displays the workspace directory structure for file navigation.
- * Supports both local and remote (SSH) file browsing.
+ * Supports both local and remote (SSH) file browsing; directories are
+ * listed in the background as they are expanded (see DirectoryTreeLoader)
+ * and follow changes reported by FS::WatchService.
  */
 class FileTreeWidget : public Widget {
 public:
@@ -198,20 +203,35 @@ public:
         }
         
         wxLogMessage("FileTree: rootDir='%s'", rootDir);
-        wxTreeItemId rootId = m_treeCtrl->AddRoot(displayName);
-        m_treeCtrl->SetItemData(rootId, new PathData(rootDir, m_sshConfig.isValid()));
+        bool isRemote = m_sshConfig.isValid();
+        m_loader = std::make_unique<DirectoryTreeLoader>(m_treeCtrl, [isRemote](const FS::FileEntry& entry) {
+            return new PathData(entry.fullPath, isRemote);
+        });
+        m_loader->SetFilesystem(isRemote
+            ? FS::Filesystem::Remote(FS::SshConfig::LoadFromConfig(), rootDir)
+            : FS::Filesystem::Local(rootDir));
         
-        if (m_sshConfig.isValid()) {
-            PopulateTreeRemote(rootDir, rootId);
-        } else {
-            PopulateTree(rootDir, rootId);
-        }
+        wxTreeItemId rootId = m_treeCtrl->AddRoot(displayName);
+        m_treeCtrl->SetItemData(rootId, new PathData(rootDir, isRemote));
+        m_loader->Load(rootId, rootDir);
         m_treeCtrl->Expand(rootId);
         
         // Bind events
         m_treeCtrl->Bind(wxEVT_TREE_ITEM_ACTIVATED, &FileTreeWidget::OnItemActivated, this);
         m_treeCtrl->Bind(wxEVT_TREE_ITEM_EXPANDING, &FileTreeWidget::OnItemExpanding, this);
         
+        m_watchListenerId = FS::WatchService::Instance().AddListener(
+            [this](const std::vector<FS::FileChange>& changes) {
+                if (m_loader) m_loader->ApplyChanges(changes);
+            });
+        m_treeCtrl->Bind(wxEVT_DESTROY, [this](wxWindowDestroyEvent& event) {
+            if (event.GetEventObject() == m_treeCtrl && m_watchListenerId > 0) {
+                FS::WatchService::Instance().RemoveListener(m_watchListenerId);
+                m_watchListenerId = 0;
+            }
+            event.Skip();
+        });
+        
         return m_panel;
     }
 
@@ -239,96 +259,13 @@ private:
     wxTreeCtrl* m_treeCtrl = nullptr;
     WidgetContext* m_context = nullptr;
     FileTreeSshConfig m_sshConfig;
-
-    void PopulateTree(const wxString& path, wxTreeItemId parentItem) {
-        wxDir dir(path);
-        if (!dir.IsOpened()) return;
-        
-        wxString filename;
-        bool cont = dir.GetFirst(&filename);
-        
-        while (cont) {
-            if (!filename.StartsWith(".")) {
-                // Use path concatenation instead of wxFileName to avoid assert
-                wxString fullPath = path;
-                if (!fullPath.EndsWith('/') && !fullPath.EndsWith('\\')) {
-                    fullPath += wxFileName::GetPathSeparator();
-                }
-                fullPath += filename;
-                
-                if (wxDir::Exists(fullPath)) {
-                    wxTreeItemId itemId = m_treeCtrl->AppendItem(
-                        parentItem, filename, -1, -1, new PathData(fullPath, false));
-                    m_treeCtrl->AppendItem(itemId, ""); // Dummy for expand arrow
-                } else {
-                    m_treeCtrl->AppendItem(
-                        parentItem, filename, -1, -1, new PathData(fullPath, false));
-                }
-            }
-            cont = dir.GetNext(&filename);
-        }
-        m_treeCtrl->SortChildren(parentItem);
-    }
-    
-    /**
-     * Populate tree with remote directory contents via SSH.
-     */
-    void PopulateTreeRemote(const wxString& path, wxTreeItemId parentItem) {
-        std::string sshPrefix = m_sshConfig.buildSshPrefix();
-        std::string cmd = sshPrefix + " \"ls -la \\\"" + path.ToStdString() + "\\\" 2>/dev/null\" 2>&1";
-        
-        FILE* pipe = popen(cmd.c_str(), "r");
-        if (!pipe) return;
-        
-        std::string output;
-        char buffer[4096];
-        while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-            output += buffer;
-        }
-        pclose(pipe);
-        
-        std::istringstream stream(output);
-        std::string line;
-        
-        while (std::getline(stream, line)) {
-            // Skip total line and empty lines
-            if (line.empty() || line.find("total") == 0) continue;
-            
-            // Parse ls -la output
-            std::istringstream lineStream(line);
-            std::string permissions, links, owner, group, size, month, day, timeStr, name;
-            lineStream >> permissions >> links >> owner >> group >> size >> month >> day >> timeStr;
-            std::getline(lineStream, name);
-            
-            // Trim leading whitespace from name
-            size_t start = name.find_first_not_of(" \t");
-            if (start != std::string::npos) {
-                name = name.substr(start);
-            }
-            
-            // Skip . and .. and hidden files
-            if (name.empty() || name == "." || name == ".." || name[0] == '.') continue;
-            
-            wxString fullPath = path;
-            if (!fullPath.EndsWith("/")) fullPath += "/";
-            fullPath += wxString(name);
-            
-            bool isDirectory = !permissions.empty() && permissions[0] == 'd';
-            
-            if (isDirectory) {
-                wxTreeItemId itemId = m_treeCtrl->AppendItem(
-                    parentItem, wxString(name), -1, -1, new PathData(fullPath, true));
-                m_treeCtrl->AppendItem(itemId, ""); // Dummy for expand arrow
-            } else {
-                m_treeCtrl->AppendItem(
-                    parentItem, wxString(name), -1, -1, new PathData(fullPath, true));
-            }
-        }
-        m_treeCtrl->SortChildren(parentItem);
-    }
+    std::unique_ptr<DirectoryTreeLoader> m_loader;
+    int m_watchListenerId = 0;
 
     void OnItemActivated(wxTreeEvent& event) {
         wxTreeItemId itemId = event.GetItem();
+        if (m_loader && m_loader->HandleActivated(itemId)) return;
+        
         PathData* data = dynamic_cast<PathData*>(m_treeCtrl->GetItemData(itemId));
         if (!data) return;
         
@@ -376,19 +313,11 @@ private:
         wxTreeItemIdValue cookie;
         wxTreeItemId firstChild = m_treeCtrl->GetFirstChild(itemId, cookie);
         
-        if (firstChild.IsOk()) {
-            PathData* childData = dynamic_cast<PathData*>(m_treeCtrl->GetItemData(firstChild));
-            if (!childData) {
-                // Dummy child - delete and populate
-                m_treeCtrl->Delete(firstChild);
-                PathData* parentData = dynamic_cast<PathData*>(m_treeCtrl->GetItemData(itemId));
-                if (parentData) {
-                    if (parentData->IsRemote()) {
-                        PopulateTreeRemote(parentData->GetPath(), itemId);
-                    } else {
-                        PopulateTree(parentData->GetPath(), itemId);
-                    }
-                }
+        // Only the dummy or loading row means the directory still needs listing
+        if (firstChild.IsOk() && m_loader && m_loader->IsPendingRow(firstChild)) {
+            PathData* parentData = dynamic_cast<PathData*>(m_treeCtrl->GetItemData(itemId));
+            if (parentData) {
+                m_loader->Load(itemId, parentData->GetPath());
             }
         }
     }
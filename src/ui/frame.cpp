@@ -11,6 +11,7 @@
 #include "../mcp/mcp.h"
 #include "../mcp/mcp_code_index.h"
 #include "../fs/fs.h"
+#include "../fs/watch_service.h"
 #include "builtin_widgets.h"
 #include "gemini_chat_widget.h"
 #include "widget_bar.h"
@@ -43,6 +44,7 @@ MainFrame::MainFrame()
     : wxFrame(nullptr, wxID_ANY, "ByteMuseHQ", wxDefaultPosition, wxSize(1000, 600))
     , m_themeListenerId(0)
     , m_configListenerId(0)
+    , m_watchListenerId(0)
     , m_nextCommandId(wxID_HIGHEST + 1000)  // Start from a safe ID range
 {
     RegisterCommands();
@@ -70,6 +72,13 @@ MainFrame::MainFrame()
             UpdateStatusBar();
             UpdateTitle();
         });
+    
+    // Follow files created, deleted and changed outside the editor
+    m_watchListenerId = FS::WatchService::Instance().AddListener(
+        [this](const std::vector<FS::FileChange>& changes) {
+            m_treeLoader->ApplyChanges(changes);
+            m_editor->OnExternalChanges(changes);
+        });
 }
 
 MainFrame::~MainFrame()
@@ -80,6 +89,10 @@ MainFrame::~MainFrame()
     if (m_configListenerId > 0) {
         Config::Instance().RemoveListener(m_configListenerId);
     }
+    if (m_watchListenerId > 0) {
+        FS::WatchService::Instance().RemoveListener(m_watchListenerId);
+    }
+    FS::WatchService::Instance().Stop();
 }
 
 void MainFrame::SetupUI()
@@ -118,6 +131,9 @@ void MainFrame::SetupUI()
     
     m_treeCtrl = new wxTreeCtrl(m_leftContentPanel, wxID_ANY);
     leftContentSizer->Add(m_treeCtrl, 1, wxEXPAND | wxALL, 0);
+    m_treeLoader = std::make_unique<DirectoryTreeLoader>(m_treeCtrl, [this](const FS::FileEntry& entry) {
+        return new PathData(entry.fullPath, m_filesystem.isRemote());
+    });
     m_leftContentPanel->SetSizer(leftContentSizer);
     
     // Widget bar for sidebar widgets (Timer, Jira, etc.)
@@ -146,6 +162,15 @@ void MainFrame::SetupUI()
         UpdateTitle();
     });
     
+    // Show open/save progress in the status bar
+    m_editor->SetTransferStatusCallback([this](const wxString& status) {
+        if (status.IsEmpty()) {
+            UpdateStatusBar();
+        } else {
+            m_statusBar->SetStatusText(status);
+        }
+    });
+    
     // Terminal component
     m_terminal = new Terminal(m_rightSplitter);
     
@@ -355,33 +380,12 @@ void MainFrame::ReinitializeCodeIndex()
     }
 }
 
-void MainFrame::PopulateTree(const wxTreeItemId& parentItem)
-{
-    PathData* parentData = dynamic_cast<PathData*>(m_treeCtrl->GetItemData(parentItem));
-    if (!parentData) return;
-    
-    wxString path = parentData->GetPath();
-    auto entries = m_filesystem.listDirectory(path, false);  // Don't include hidden files
-    
-    for (const auto& entry : entries) {
-        wxTreeItemId itemId = m_treeCtrl->AppendItem(
-            parentItem, entry.name, -1, -1,
-            new PathData(entry.fullPath, m_filesystem.isRemote())
-        );
-        
-        // Add a dummy child for directories to show expand arrow
-        if (entry.isDirectory) {
-            m_treeCtrl->AppendItem(itemId, "");
-        }
-    }
-    
-    // Sort items
-    m_treeCtrl->SortChildren(parentItem);
-}
-
 void MainFrame::OnTreeItemActivated(wxTreeEvent& event)
 {
     wxTreeItemId itemId = event.GetItem();
+    if (m_treeLoader->HandleActivated(itemId))
+        return;
+    
     PathData* data = dynamic_cast<PathData*>(m_treeCtrl->GetItemData(itemId));
     
     if (!data)
@@ -409,18 +413,15 @@ void MainFrame::OnTreeItemExpanding(wxTreeEvent& event)
 {
     wxTreeItemId itemId = event.GetItem();
     
-    // Remove dummy child and populate on first expansion
+    // List the directory in the background on first expansion (or after a
+    // failed listing); the dummy child is replaced by a loading row
     wxTreeItemIdValue cookie;
     wxTreeItemId firstChild = m_treeCtrl->GetFirstChild(itemId, cookie);
     
-    if (firstChild.IsOk()) {
-        PathData* childData = dynamic_cast<PathData*>(m_treeCtrl->GetItemData(firstChild));
-        if (!childData) {
-            // This is the dummy child, remove it
-            m_treeCtrl->Delete(firstChild);
-            
-            // Now populate the actual children using the unified filesystem
-            PopulateTree(itemId);
+    if (firstChild.IsOk() && m_treeLoader->IsPendingRow(firstChild)) {
+        PathData* parentData = dynamic_cast<PathData*>(m_treeCtrl->GetItemData(itemId));
+        if (parentData) {
+            m_treeLoader->Load(itemId, parentData->GetPath());
         }
     }
 }
@@ -494,38 +495,8 @@ void MainFrame::ConnectCodeIndexToMCP(BuiltinWidgets::SymbolsWidget* symbolsWidg
         MCP::Registry::Instance().registerProvider(codeIndexProvider);
     }
     
-    // Set up callbacks to the symbols widget
-    codeIndexProvider->setSearchCallback([symbolsWidget](const std::string& query) {
-        auto results = symbolsWidget->SearchSymbols(query);
-        std::vector<std::pair<std::string, LspDocumentSymbol>> stdResults;
-        for (const auto& [path, sym] : results) {
-            stdResults.push_back({path, sym});
-        }
-        return stdResults;
-    });
-    
-    codeIndexProvider->setFileSymbolsCallback([symbolsWidget](const std::string& path) {
-        return symbolsWidget->GetFileSymbols(wxString(path));
-    });
-    
-    codeIndexProvider->setAllSymbolsCallback([symbolsWidget]() {
-        const auto& wxSymbols = symbolsWidget->GetAllSymbols();
-        std::vector<std::pair<std::string, LspDocumentSymbol>> stdResults;
-        stdResults.reserve(wxSymbols.size());
-        for (const auto& [path, sym] : wxSymbols) {
-            stdResults.push_back({path, sym});
-        }
-        return stdResults;
-    });
-    
-    codeIndexProvider->setSymbolsByKindCallback([symbolsWidget](LspSymbolKind kind) {
-        auto results = symbolsWidget->GetSymbolsByKind(kind);
-        std::vector<std::pair<std::string, LspDocumentSymbol>> stdResults;
-        for (const auto& [path, sym] : results) {
-            stdResults.push_back({path.ToStdString(), sym});
-        }
-        return stdResults;
-    });
+    // Share the symbol store; tools query it in place
+    codeIndexProvider->setSymbolStore(symbolsWidget->GetSymbolStore());
     
     codeIndexProvider->setIndexStatusCallback([symbolsWidget]() {
         return std::make_tuple(
@@ -855,7 +826,9 @@ void MainFrame::OpenFolder(const wxString& path, bool isRemote)
         m_filesystem = FS::Filesystem::Local(path);
     }
     
-    // Clear the existing tree
+    // Clear the existing tree, dropping listings of the old folder
+    m_treeLoader->CancelAll();
+    m_treeLoader->SetFilesystem(m_filesystem);
     m_treeCtrl->DeleteAllItems();
     
     // Create root node with display path
@@ -867,8 +840,9 @@ void MainFrame::OpenFolder(const wxString& path, bool isRemote)
     m_treeCtrl->SetItemData(rootId, new PathData(m_filesystem.rootPath(), m_filesystem.isRemote()));
     
     // Populate tree using unified filesystem
-    PopulateTree(rootId);
+    m_treeLoader->Load(rootId, m_filesystem.rootPath());
     m_treeCtrl->Expand(rootId);
+    FS::WatchService::Instance().Watch(m_filesystem);
     
     // Update the window title and status bar to reflect the change
     UpdateTitle();
@@ -9,10 +9,12 @@
 #include "widget.h"
 #include "widget_bar.h"
 #include "widget_activity_bar.h"
+#include "directory_tree_loader.h"
 #include "../commands/command.h"
 #include "../theme/theme.h"
 #include "../config/config.h"
 #include "../fs/fs.h"
+#include <memory>
 #include <sstream>
 
 // Forward declarations
@@ -90,6 +92,7 @@ private:
     wxString m_currentCategory;        // Currently selected category ID
     int m_themeListenerId;
     int m_configListenerId;            // Config change listener for SSH settings
+    int m_watchListenerId;             // External changes to the open folder
     WidgetContext m_widgetContext;
     
     // Dynamic command accelerator support
@@ -106,11 +109,11 @@ private:
     void SetupAccelerators();
     void RegisterCommands();
     void RegisterWidgets();
-    void PopulateTree(const wxTreeItemId& parentItem);
     void UpdateTitle();
     void UpdateStatusBar();            // Update status bar with connection info
     
     FS::Filesystem m_filesystem;       // Unified filesystem access (local or remote)
+    std::unique_ptr<DirectoryTreeLoader> m_treeLoader;  // Lists tree directories in the background
     
     // Theme support
     void ApplyTheme(const ThemePtr& theme);
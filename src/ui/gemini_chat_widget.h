@@ -13,8 +13,9 @@
 #include "../mcp/mcp_code_index.h"
 #include "../mcp/mcp_jira.h"
 #include "../mcp/mcp_github_projects.h"
+#include "../mcp/tool_dispatcher.h"
+#include "../fs/watch_service.h"
 #include <wx/dcbuffer.h>
-#include <wx/timer.h>
 #include <wx/textctrl.h>
 #include <wx/button.h>
 #include <wx/choice.h>
@@ -112,6 +113,13 @@ public:
         Refresh();
     }
     
+    /**
+     * Append streamed text to the message.
+     */
+    void AppendText(const wxString& text) {
+        SetText(m_text + text);
+    }
+    
     wxString GetText() const {
         return m_text;
     }
@@ -923,8 +931,20 @@ public:
         // Bind resize event to recalculate bubble heights when splitter changes
         m_chatPanel->Bind(wxEVT_SIZE, &GeminiChatWidget::OnChatPanelResize, this);
         
-        // Timer for checking async responses
-        m_responseTimer.Bind(wxEVT_TIMER, &GeminiChatWidget::OnResponseTimer, this);
+        // Stop the conversation's requests once the panel goes away
+        m_panel->Bind(wxEVT_DESTROY, [this](wxWindowDestroyEvent& event) {
+            if (event.GetEventObject() == m_panel) {
+                m_panelDestroyed = true;
+                AI::GeminiClient::Instance().CancelPendingRequests();
+                if (m_watchListenerId > 0) {
+                    FS::WatchService::Instance().RemoveListener(m_watchListenerId);
+                    FS::WatchService::Instance().RemoveListener(m_rootListenerId);
+                    m_watchListenerId = 0;
+                    m_rootListenerId = 0;
+                }
+            }
+            event.Skip();
+        });
         
         // Load config and check API key
         LoadConfig();
@@ -1058,6 +1078,7 @@ public:
         
         // Clear UI
         m_chatSizer->Clear(true);
+        m_streamBubble = nullptr;
         m_chatPanel->Layout();
         m_chatPanel->Refresh();
         
@@ -1101,8 +1122,10 @@ private:
     wxColour m_bgColor = wxColour(30, 30, 30);
     wxColour m_fgColor = wxColour(220, 220, 220);
     
-    wxTimer m_responseTimer;
     std::atomic<bool> m_isLoading{false};
+    std::atomic<bool> m_drainScheduled{false};
+    std::atomic<bool> m_panelDestroyed{false};
+    ChatMessageBubble* m_streamBubble = nullptr;    // Bubble receiving the streamed reply
     
     // MCP providers
     std::shared_ptr<MCP::FilesystemProvider> m_fsProvider;
@@ -1110,8 +1133,10 @@ private:
     std::shared_ptr<MCP::CodeIndexProvider> m_codeIndexProvider;
     std::shared_ptr<MCP::JiraProvider> m_jiraProvider;
     std::shared_ptr<MCP::GitHubProjectsProvider> m_githubProjectsProvider;
+    int m_watchListenerId = 0;
+    int m_rootListenerId = 0;
     
-    // Thread-safe response queue
+    // Thread-safe response queue, drained on the UI thread via CallAfter
     std::mutex m_responseMutex;
     struct PendingResponse {
         wxString text;
@@ -1119,6 +1144,7 @@ private:
         bool isToolCall;
         wxString toolName;
         wxString toolArgs;
+        bool isStreamChunk = false;     // Partial text of the reply being streamed
     };
     std::queue<PendingResponse> m_pendingResponses;
     
@@ -1180,6 +1206,12 @@ private:
         }
         MCP::Registry::Instance().registerProvider(m_fsProvider);
         
+        // Local workspaces get a search index, kept current by the watch service
+        if (!sshEnabled && config.GetBool("ai.workspaceIndex", true)) {
+            m_fsProvider->setWorkspaceIndexEnabled(true);
+            ListenForWorkspaceChanges();
+        }
+        
         // Create terminal provider
         m_terminalProvider = std::make_shared<MCP::TerminalProvider>(workDir);
         if (sshEnabled) {
@@ -1244,6 +1276,29 @@ private:
         UpdateMCPStatus();
     }
     
+    /**
+     * Forward external changes to the filesystem provider's index, which is
+     * kept at the folder the watch service follows.
+     */
+    void ListenForWorkspaceChanges() {
+        if (m_watchListenerId > 0) return;
+        
+        auto& watchService = FS::WatchService::Instance();
+        m_fsProvider->setWatchedRoot(watchService.RootPath());
+        m_rootListenerId = watchService.AddRootListener([this](const std::string& root) {
+            if (m_fsProvider) {
+                m_fsProvider->setWatchedRoot(root);
+            }
+        });
+        m_watchListenerId = watchService.AddListener(
+            [this](const std::vector<FS::FileChange>& changes) {
+                if (!m_fsProvider) return;
+                for (const auto& change : changes) {
+                    m_fsProvider->notifyPathChanged(change.path);
+                }
+            });
+    }
+    
     /**
      * Update MCP status label.
      */
@@ -1299,7 +1354,7 @@ private:
         }
     }
     
-    void AddMessageBubble(const wxString& text, bool isUser, bool isError = false) {
+    ChatMessageBubble* AddMessageBubble(const wxString& text, bool isUser, bool isError = false) {
         auto* bubble = new ChatMessageBubble(m_chatPanel, text, isUser, isError);
         bubble->SetThemeColors(m_bgColor, m_fgColor);
         m_chatSizer->Add(bubble, 0, wxEXPAND | wxALL, 5);
@@ -1308,6 +1363,20 @@ private:
         
         // Scroll to bottom
         m_chatPanel->Scroll(-1, m_chatPanel->GetVirtualSize().GetHeight());
+        return bubble;
+    }
+    
+    /**
+     * Append streamed reply text, starting a new bubble for a new reply.
+     */
+    void AppendStreamText(const wxString& text) {
+        if (!m_streamBubble) {
+            m_streamBubble = AddMessageBubble(text, false);
+            return;
+        }
+        m_streamBubble->AppendText(text);
+        m_chatPanel->FitInside();
+        m_chatPanel->Scroll(-1, m_chatPanel->GetVirtualSize().GetHeight());
     }
     
     void OnSendMessage(wxCommandEvent& event) {
@@ -1352,73 +1421,113 @@ private:
         
         // Send message in background thread
         std::string msgStr = message.ToStdString();
-        std::thread([this, msgStr]() {
-            ProcessMessageWithMCP(msgStr);
+        size_t toolConcurrency = static_cast<size_t>(
+            std::max(1, Config::Instance().GetInt("ai.toolConcurrency", 4)));
+        bool stream = Config::Instance().GetBool("ai.stream", true);
+        m_streamBubble = nullptr;
+        std::thread([this, msgStr, toolConcurrency, stream]() {
+            ProcessMessageWithMCP(msgStr, toolConcurrency, stream);
         }).detach();
-        
-        // Start timer to check for responses
-        m_responseTimer.Start(100);
     }
     
     /**
      * Process a message, handling MCP tool calls if needed.
-     * This runs in a background thread.
+     * This runs in a background thread. All calls the model requests in one
+     * turn run concurrently (up to toolConcurrency at a time) through
+     * MCP::ToolDispatcher and their results go back in a single round.
+     * With stream set, reply text is shown as it arrives.
      */
-    void ProcessMessageWithMCP(const std::string& message) {
-        AI::GeminiResponse response = AI::GeminiClient::Instance().SendMessage(message);
+    void ProcessMessageWithMCP(const std::string& message, size_t toolConcurrency, bool stream) {
+        AI::StreamCallback onText;
+        if (stream) {
+            onText = [this](const std::string& chunk) {
+                PendingResponse partial{wxString(chunk), false, false, "", ""};
+                partial.isStreamChunk = true;
+                QueueResponse(std::move(partial));
+                return true;
+            };
+        }
+        
+        AI::GeminiResponse response = AI::GeminiClient::Instance().SendMessage(message, onText);
         
-        // Handle tool calls in a loop (up to max iterations)
-        int toolCallCount = 0;
-        const int maxToolCalls = 5;
+        // Handle tool call rounds in a loop (up to max iterations)
+        int toolRoundCount = 0;
+        const int maxToolRounds = 5;
         
-        while (response.needsFunctionCall() && toolCallCount < maxToolCalls) {
-            toolCallCount++;
+        while (response.needsFunctionCall() && toolRoundCount < maxToolRounds) {
+            toolRoundCount++;
             
-            // Notify UI about tool call
-            {
-                std::lock_guard<std::mutex> lock(m_responseMutex);
+            std::vector<MCP::ToolCall> calls;
+            for (const auto& request : response.functionCalls) {
+                // Notify UI about tool call
                 PendingResponse toolNotify;
-                toolNotify.text = wxT("\U0001F527 Using tool: ") + wxString(response.functionName); // 🔧
+                toolNotify.text = wxT("\U0001F527 Using tool: ") + wxString(request.name); // 🔧
                 toolNotify.isError = false;
                 toolNotify.isToolCall = true;
-                toolNotify.toolName = wxString(response.functionName);
-                toolNotify.toolArgs = wxString(response.functionArgs);
-                m_pendingResponses.push(toolNotify);
+                toolNotify.toolName = wxString(request.name);
+                toolNotify.toolArgs = wxString(request.args);
+                QueueResponse(std::move(toolNotify));
+                
+                // Parse arguments
+                calls.push_back({std::to_string(calls.size()), request.name, ParseJsonArgs(request.args)});
             }
             
-            // Parse arguments and execute tool
-            MCP::Value args = ParseJsonArgs(response.functionArgs);
-            MCP::ToolResult toolResult = MCP::Registry::Instance().executeTool(
-                response.functionName, args);
+            std::vector<MCP::ToolResult> toolResults = MCP::ToolDispatcher::Run(calls, toolConcurrency);
             
-            // Format tool result
-            std::string resultStr;
-            if (toolResult.success) {
-                resultStr = toolResult.result.toJson();
-            } else {
-                resultStr = "{\"error\": \"" + toolResult.error + "\"}";
+            // Format tool results
+            std::vector<AI::FunctionCallResult> results;
+            for (size_t i = 0; i < calls.size(); ++i) {
+                const MCP::ToolResult& toolResult = toolResults[i];
+                std::string resultStr;
+                if (toolResult.success) {
+                    resultStr = toolResult.result.toJson();
+                } else {
+                    resultStr = "{\"error\": \"" + toolResult.error + "\"}";
+                }
+                results.push_back({calls[i].name, std::move(resultStr)});
             }
             
-            // Continue conversation with tool result
-            response = AI::GeminiClient::Instance().ContinueWithToolResult(
-                response.functionName, resultStr);
+            // Continue conversation with all tool results at once
+            response = AI::GeminiClient::Instance().ContinueWithToolResults(results, onText);
         }
         
         // Queue final response for UI thread
+        PendingResponse finalResponse;
+        if (response.isOk() && !response.hasFunctionCall) {
+            finalResponse = {wxString(response.text), false, false, "", ""};
+        } else if (response.hasFunctionCall) {
+            finalResponse = {wxString("Reached maximum tool calls. Last response may be incomplete."), 
+                     true, false, "", ""};
+        } else {
+            finalResponse = {wxString(response.error), true, false, "", ""};
+        }
+        
+        m_isLoading = false;
+        QueueResponse(std::move(finalResponse));
+    }
+    
+    /**
+     * Queue a response for the UI thread and schedule a drain unless one is
+     * already pending. Consecutive stream chunks are merged, so a fast
+     * stream costs one relayout per UI turn rather than one per chunk.
+     * Called from the worker thread.
+     */
+    void QueueResponse(PendingResponse response) {
+        if (m_panelDestroyed) {
+            return;
+        }
         {
             std::lock_guard<std::mutex> lock(m_responseMutex);
-            if (response.isOk() && !response.hasFunctionCall) {
-                m_pendingResponses.push({wxString(response.text), false, false, "", ""});
-            } else if (response.hasFunctionCall) {
-                m_pendingResponses.push({
-                    wxString("Reached maximum tool calls. Last response may be incomplete."), 
-                    true, false, "", ""});
+            if (response.isStreamChunk && !m_pendingResponses.empty() &&
+                m_pendingResponses.back().isStreamChunk) {
+                m_pendingResponses.back().text += response.text;
             } else {
-                m_pendingResponses.push({wxString(response.error), true, false, "", ""});
+                m_pendingResponses.push(std::move(response));
             }
         }
-        
-        m_isLoading = false;
+        if (!m_drainScheduled.exchange(true)) {
+            m_panel->CallAfter([this]() { DrainResponses(); });
+        }
     }
     
     /**
@@ -1512,22 +1621,24 @@ private:
         return result;
     }
     
-    void OnResponseTimer(wxTimerEvent& event) {
-        // Check for pending responses
-        PendingResponse response;
-        bool hasResponse = false;
-        
+    void DrainResponses() {
+        m_drainScheduled = false;
+        std::queue<PendingResponse> responses;
         {
             std::lock_guard<std::mutex> lock(m_responseMutex);
-            if (!m_pendingResponses.empty()) {
-                response = m_pendingResponses.front();
-                m_pendingResponses.pop();
-                hasResponse = true;
-            }
+            std::swap(responses, m_pendingResponses);
         }
         
-        if (hasResponse) {
-            if (response.isToolCall) {
+        while (!responses.empty()) {
+            PendingResponse response = std::move(responses.front());
+            responses.pop();
+            
+            if (response.isStreamChunk) {
+                AppendStreamText(response.text);
+            } else if (response.isToolCall) {
+                // Text after the tool results goes into a new bubble
+                m_streamBubble = nullptr;
+                
                 // Show tool call notification as a system message
                 AddToolCallBubble(response.toolName, response.toolArgs);
 #ifdef __WXMSW__
@@ -1536,18 +1647,16 @@ private:
                 UpdateStatus(wxT("\U0001F504 Executing tool...")); // 🔄
 #endif
             } else {
-                AddMessageBubble(response.text, false, response.isError);
+                if (m_streamBubble && !response.isError) {
+                    // Streamed already; settle on the complete text
+                    m_streamBubble->SetText(response.text);
+                } else {
+                    AddMessageBubble(response.text, false, response.isError);
+                }
+                m_streamBubble = nullptr;
                 UpdateStatus("");
                 m_sendBtn->Enable(AI::GeminiClient::Instance().HasApiKey());
             }
-            
-            if (m_pendingResponses.empty() && !m_isLoading) {
-                m_responseTimer.Stop();
-            }
-        } else if (!m_isLoading) {
-            m_responseTimer.Stop();
-            UpdateStatus("");
-            m_sendBtn->Enable(AI::GeminiClient::Instance().HasApiKey());
         }
     }
     
@@ -7,6 +7,7 @@
 #include "../commands/command.h"
 #include "../commands/command_registry.h"
 #include "../github/github_projects_client.h"
+#include "../http/request_scope.h"
 #include <wx/dcbuffer.h>
 #include <wx/timer.h>
 #include <wx/listctrl.h>
@@ -20,6 +21,8 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <memory>
+#include <optional>
 
 // Forward declaration
 class MainFrame;
@@ -332,6 +335,13 @@ public:
         m_allItemsBtn->Bind(wxEVT_BUTTON, &GitHubProjectsWidget::OnShowAllItems, this);
         m_createBtn->Bind(wxEVT_BUTTON, &GitHubProjectsWidget::OnShowCreate, this);
         m_submitBtn->Bind(wxEVT_BUTTON, &GitHubProjectsWidget::OnCreateDraft, this);
+        m_panel->Bind(wxEVT_DESTROY, [this](wxWindowDestroyEvent& event) {
+            if (event.GetEventObject() == m_panel) {
+                m_requests.cancelAll();
+                m_loading = false;
+            }
+            event.Skip();
+        });
 
         LoadConfig();
         FetchItemsFromApi(false); // fetch all items first
@@ -492,6 +502,7 @@ private:
     bool m_showMyItems = false;
 
     GitHub::ProjectsClient m_ghClient;
+    Http::RequestScope m_requests;
 
     GitHubIssueItem ConvertIssue(const GitHub::Issue& issue) {
         GitHubIssueItem item;
@@ -566,76 +577,97 @@ private:
             return;
         }
 
+        // A new fetch supersedes whatever is still in flight
+        m_requests.cancelAll();
         m_loading = true;
         m_showMyItems = myItemsOnly;
 
-        wxTheApp->CallAfter([this]() {
-            m_statusLabel->SetLabel(wxT("\u23F3 Loading..."));
-            m_statusLabel->SetForegroundColour(wxColour(52, 152, 219));
-        });
+        m_statusLabel->SetLabel(wxT("\u23F3 Loading..."));
+        m_statusLabel->SetForegroundColour(wxColour(52, 152, 219));
 
-        GitHub::ProjectsClient client = m_ghClient;
-        bool fetchMine = myItemsOnly;
+        if (!myItemsOnly) {
+            m_requests.submit(m_ghClient.BuildListItemsRequest(50), [this](Http::HttpResponse response) {
+                ShowItems(m_ghClient.ParseListItemsResponse(response));
+            }, Http::Priority::Interactive);
+            return;
+        }
 
-        std::thread([this, client, fetchMine]() mutable {
-            GitHub::Result<std::vector<GitHub::Issue>> result;
-            if (fetchMine) {
-                result = client.GetMyItems(50);
+        // "My items": the item list and the current login are fetched side by
+        // side; whichever lands second filters and shows the result.
+        struct MyItemsFetch {
+            std::optional<GitHub::Result<std::vector<GitHub::Issue>>> items;
+            std::optional<GitHub::Result<std::string>> login;
+        };
+        auto fetch = std::make_shared<MyItemsFetch>();
+        auto showWhenComplete = [this, fetch]() {
+            if (!fetch->items || !fetch->login) return;
+            if (!fetch->items->success) {
+                ShowItems(*fetch->items);
+            } else if (!fetch->login->success) {
+                ShowItems(GitHub::Result<std::vector<GitHub::Issue>>::Error(fetch->login->error));
             } else {
-                result = client.ListItems(50);
+                ShowItems(GitHub::Result<std::vector<GitHub::Issue>>::Success(
+                    GitHub::ProjectsClient::FilterAssignedTo(std::move(fetch->items->data), fetch->login->data, 50)));
             }
+        };
+        m_requests.submit(m_ghClient.BuildListItemsRequest(std::min(50 * 3, 100)),
+            [this, fetch, showWhenComplete](Http::HttpResponse response) {
+                fetch->items = m_ghClient.ParseListItemsResponse(response);
+                showWhenComplete();
+            }, Http::Priority::Interactive);
+        m_requests.submit(m_ghClient.BuildAuthenticatedUserRequest(),
+            [this, fetch, showWhenComplete](Http::HttpResponse response) {
+                fetch->login = m_ghClient.ParseAuthenticatedUserResponse(response);
+                showWhenComplete();
+            }, Http::Priority::Interactive);
+    }
 
-            std::vector<GitHubIssueItem> items;
-            wxString errorMsg;
-
-            if (!result.success) {
-                errorMsg = wxString::FromUTF8(result.error.c_str());
-            } else {
-                for (const auto& issue : result.data) {
-                    items.push_back(ConvertIssue(issue));
-                }
+    void ShowItems(const GitHub::Result<std::vector<GitHub::Issue>>& result) {
+        wxString errorMsg;
+        m_items.clear();
+        if (!result.success) {
+            errorMsg = wxString::FromUTF8(result.error.c_str());
+        } else {
+            for (const auto& issue : result.data) {
+                m_items.push_back(ConvertIssue(issue));
             }
+        }
+        m_loading = false;
+
+        m_itemsSizer->Clear(true);
+
+        if (!errorMsg.IsEmpty()) {
+            auto* errLabel = new wxStaticText(m_itemsPanel, wxID_ANY, errorMsg);
+            errLabel->SetForegroundColour(wxColour(231, 76, 60));
+            errLabel->Wrap(200);
+            m_itemsSizer->Add(errLabel, 0, wxALL, 10);
+            m_statusLabel->SetLabel(wxT("\u26A0 Error"));
+            m_statusLabel->SetForegroundColour(wxColour(231, 76, 60));
+        } else if (m_items.empty()) {
+            auto* emptyLabel = new wxStaticText(m_itemsPanel, wxID_ANY,
+                wxT("\U0001F389 No items found!\n\nThe project board is empty."));
+            emptyLabel->SetForegroundColour(wxColour(46, 204, 113));
+            emptyLabel->Wrap(200);
+            m_itemsSizer->Add(emptyLabel, 0, wxALL, 10);
+            auto& cfg = m_ghClient.GetConfig();
+            m_statusLabel->SetLabel(wxString::Format(wxT("\u2713 %s (project #%d)"),
+                wxString::FromUTF8(cfg.owner.c_str()), cfg.projectNumber));
+            m_statusLabel->SetForegroundColour(wxColour(46, 204, 113));
+        } else {
+            for (const auto& item : m_items) {
+                auto* card = new GitHubIssueCard(m_itemsPanel, item);
+                card->SetThemeColors(m_bgColor, m_fgColor);
+                m_itemsSizer->Add(card, 0, wxEXPAND | wxBOTTOM, 5);
+            }
+            auto& cfg = m_ghClient.GetConfig();
+            m_statusLabel->SetLabel(wxString::Format(wxT("\u2713 %s (project #%d)"),
+                wxString::FromUTF8(cfg.owner.c_str()), cfg.projectNumber));
+            m_statusLabel->SetForegroundColour(wxColour(46, 204, 113));
+        }
 
-            wxTheApp->CallAfter([this, items, errorMsg]() {
-                m_loading = false;
-                m_items = items;
-
-                m_itemsSizer->Clear(true);
-
-                if (!errorMsg.IsEmpty()) {
-                    auto* errLabel = new wxStaticText(m_itemsPanel, wxID_ANY, errorMsg);
-                    errLabel->SetForegroundColour(wxColour(231, 76, 60));
-                    errLabel->Wrap(200);
-                    m_itemsSizer->Add(errLabel, 0, wxALL, 10);
-                    m_statusLabel->SetLabel(wxT("\u26A0 Error"));
-                    m_statusLabel->SetForegroundColour(wxColour(231, 76, 60));
-                } else if (m_items.empty()) {
-                    auto* emptyLabel = new wxStaticText(m_itemsPanel, wxID_ANY,
-                        wxT("\U0001F389 No items found!\n\nThe project board is empty."));
-                    emptyLabel->SetForegroundColour(wxColour(46, 204, 113));
-                    emptyLabel->Wrap(200);
-                    m_itemsSizer->Add(emptyLabel, 0, wxALL, 10);
-                    auto& cfg = m_ghClient.GetConfig();
-                    m_statusLabel->SetLabel(wxString::Format(wxT("\u2713 %s (project #%d)"),
-                        wxString::FromUTF8(cfg.owner.c_str()), cfg.projectNumber));
-                    m_statusLabel->SetForegroundColour(wxColour(46, 204, 113));
-                } else {
-                    for (const auto& item : m_items) {
-                        auto* card = new GitHubIssueCard(m_itemsPanel, item);
-                        card->SetThemeColors(m_bgColor, m_fgColor);
-                        m_itemsSizer->Add(card, 0, wxEXPAND | wxBOTTOM, 5);
-                    }
-                    auto& cfg = m_ghClient.GetConfig();
-                    m_statusLabel->SetLabel(wxString::Format(wxT("\u2713 %s (project #%d)"),
-                        wxString::FromUTF8(cfg.owner.c_str()), cfg.projectNumber));
-                    m_statusLabel->SetForegroundColour(wxColour(46, 204, 113));
-                }
-
-                m_itemsPanel->FitInside();
-                m_itemsPanel->Layout();
-                m_headerLabel->SetLabel(wxString::Format(wxT("\U0001F4CA GitHub Projects (%zu)"), m_items.size()));
-            });
-        }).detach();
+        m_itemsPanel->FitInside();
+        m_itemsPanel->Layout();
+        m_headerLabel->SetLabel(wxString::Format(wxT("\U0001F4CA GitHub Projects (%zu)"), m_items.size()));
     }
 
     void OnRefresh(wxCommandEvent&) { RefreshItems(); }
@@ -7,6 +7,7 @@
 #include "../commands/command.h"
 #include "../commands/command_registry.h"
 #include "../jira/jira_client.h"
+#include "../http/request_scope.h"
 #include <wx/dcbuffer.h>
 #include <wx/timer.h>
 #include <wx/listctrl.h>
@@ -373,6 +374,13 @@ public:
         m_myIssuesBtn->Bind(wxEVT_BUTTON, &JiraWidget::OnShowMyIssues, this);
         m_createBtn->Bind(wxEVT_BUTTON, &JiraWidget::OnShowCreate, this);
         m_submitBtn->Bind(wxEVT_BUTTON, &JiraWidget::OnCreateIssue, this);
+        m_panel->Bind(wxEVT_DESTROY, [this](wxWindowDestroyEvent& event) {
+            if (event.GetEventObject() == m_panel) {
+                m_requests.cancelAll();
+                m_loading = false;
+            }
+            event.Skip();
+        });
         
         // Load configuration and fetch issues from JIRA API
         LoadConfig();
@@ -553,6 +561,7 @@ private:
     
     // Jira client
     Jira::Client m_jiraClient;
+    Http::RequestScope m_requests;
     
     /**
      * Convert Jira::Issue to JiraIssue (wxString-based for UI).
@@ -640,72 +649,61 @@ private:
             return;
         }
         
+        // A new fetch supersedes whatever is still in flight
+        m_requests.cancelAll();
         m_loading = true;
+        m_statusLabel->SetLabel(wxT("\u23F3 Loading..."));
+        m_statusLabel->SetForegroundColour(wxColour(52, 152, 219)); // Blue
         
-        // Update UI to show loading
-        wxTheApp->CallAfter([this]() {
-            m_statusLabel->SetLabel(wxT("\u23F3 Loading..."));
-            m_statusLabel->SetForegroundColour(wxColour(52, 152, 219)); // Blue
-        });
-        
-        // Copy client to capture for thread (it's safe to copy)
-        Jira::Client client = m_jiraClient;
-        
-        // Fetch in background thread
-        std::thread([this, client]() mutable {
-            auto result = client.GetMyIssues(50);
+        // The engine runs the request; the callback lands on the main thread
+        m_requests.submit(m_jiraClient.BuildMyIssuesRequest(50), [this](Http::HttpResponse response) {
+            auto result = m_jiraClient.ParseSearchResponse(response);
             
-            std::vector<JiraIssue> issues;
             wxString errorMsg;
-            
+            m_issues.clear();
             if (!result.success) {
                 errorMsg = wxString::FromUTF8(result.error.c_str());
             } else {
                 for (const auto& issue : result.data) {
-                    issues.push_back(ConvertIssue(issue));
+                    m_issues.push_back(ConvertIssue(issue));
                 }
             }
+            m_loading = false;
             
-            // Update UI on main thread
-            wxTheApp->CallAfter([this, issues, errorMsg]() {
-                m_loading = false;
-                m_issues = issues;
-                
-                // Clear and repopulate
-                m_issuesSizer->Clear(true);
-                
-                if (!errorMsg.IsEmpty()) {
-                    auto* errLabel = new wxStaticText(m_issuesPanel, wxID_ANY, errorMsg);
-                    errLabel->SetForegroundColour(wxColour(231, 76, 60)); // Red
-                    errLabel->Wrap(200);
-                    m_issuesSizer->Add(errLabel, 0, wxALL, 10);
-                    m_statusLabel->SetLabel(wxT("\u26A0 Error"));
-                    m_statusLabel->SetForegroundColour(wxColour(231, 76, 60));
-                } else if (m_issues.empty()) {
-                    auto* emptyLabel = new wxStaticText(m_issuesPanel, wxID_ANY,
-                        wxT("\U0001F389 No issues assigned to you!\n\nEnjoy your free time."));
-                    emptyLabel->SetForegroundColour(wxColour(46, 204, 113));
-                    emptyLabel->Wrap(200);
-                    m_issuesSizer->Add(emptyLabel, 0, wxALL, 10);
-                    auto& cfg = m_jiraClient.GetConfig();
-                    m_statusLabel->SetLabel(wxString::Format(wxT("\u2713 %s"), wxString::FromUTF8(cfg.user.c_str())));
-                    m_statusLabel->SetForegroundColour(wxColour(46, 204, 113));
-                } else {
-                    for (const auto& issue : m_issues) {
-                        auto* card = new JiraIssueCard(m_issuesPanel, issue);
-                        card->SetThemeColors(m_bgColor, m_fgColor);
-                        m_issuesSizer->Add(card, 0, wxEXPAND | wxBOTTOM, 5);
-                    }
-                    auto& cfg = m_jiraClient.GetConfig();
-                    m_statusLabel->SetLabel(wxString::Format(wxT("\u2713 %s"), wxString::FromUTF8(cfg.user.c_str())));
-                    m_statusLabel->SetForegroundColour(wxColour(46, 204, 113));
+            // Clear and repopulate
+            m_issuesSizer->Clear(true);
+            
+            if (!errorMsg.IsEmpty()) {
+                auto* errLabel = new wxStaticText(m_issuesPanel, wxID_ANY, errorMsg);
+                errLabel->SetForegroundColour(wxColour(231, 76, 60)); // Red
+                errLabel->Wrap(200);
+                m_issuesSizer->Add(errLabel, 0, wxALL, 10);
+                m_statusLabel->SetLabel(wxT("\u26A0 Error"));
+                m_statusLabel->SetForegroundColour(wxColour(231, 76, 60));
+            } else if (m_issues.empty()) {
+                auto* emptyLabel = new wxStaticText(m_issuesPanel, wxID_ANY,
+                    wxT("\U0001F389 No issues assigned to you!\n\nEnjoy your free time."));
+                emptyLabel->SetForegroundColour(wxColour(46, 204, 113));
+                emptyLabel->Wrap(200);
+                m_issuesSizer->Add(emptyLabel, 0, wxALL, 10);
+                auto& cfg = m_jiraClient.GetConfig();
+                m_statusLabel->SetLabel(wxString::Format(wxT("\u2713 %s"), wxString::FromUTF8(cfg.user.c_str())));
+                m_statusLabel->SetForegroundColour(wxColour(46, 204, 113));
+            } else {
+                for (const auto& issue : m_issues) {
+                    auto* card = new JiraIssueCard(m_issuesPanel, issue);
+                    card->SetThemeColors(m_bgColor, m_fgColor);
+                    m_issuesSizer->Add(card, 0, wxEXPAND | wxBOTTOM, 5);
                 }
-                
-                m_issuesPanel->FitInside();
-                m_issuesPanel->Layout();
-                m_headerLabel->SetLabel(wxString::Format(wxT("\U0001F3AF JIRA Issues (%zu)"), m_issues.size()));
-            });
-        }).detach();
+                auto& cfg = m_jiraClient.GetConfig();
+                m_statusLabel->SetLabel(wxString::Format(wxT("\u2713 %s"), wxString::FromUTF8(cfg.user.c_str())));
+                m_statusLabel->SetForegroundColour(wxColour(46, 204, 113));
+            }
+            
+            m_issuesPanel->FitInside();
+            m_issuesPanel->Layout();
+            m_headerLabel->SetLabel(wxString::Format(wxT("\U0001F3AF JIRA Issues (%zu)"), m_issues.size()));
+        }, Http::Priority::Interactive);
     }
     
     void OnRefresh(wxCommandEvent&) {
@@ -4,15 +4,24 @@
 #include "widget.h"
 #include "editor.h"
 #include "../lsp/lsp_client.h"
+#include "../lsp/symbol_cache.h"
+#include "../lsp/symbol_store.h"
 #include "../theme/theme.h"
 #include "../config/config.h"
 #include "../fs/fs.h"
+#include "../fs/watch_service.h"
+#include "../fs/transfer_scope.h"
 #include <wx/treectrl.h>
 #include <wx/textctrl.h>
 #include <wx/dir.h>
 #include <wx/filename.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
 #include <memory>
 #include <set>
+#include <unordered_set>
 
 namespace BuiltinWidgets {
 
@@ -21,19 +30,19 @@ namespace BuiltinWidgets {
  */
 class SymbolData : public wxTreeItemData {
 public:
-    SymbolData(const wxString& filePath, const LspDocumentSymbol& symbol) 
-        : m_filePath(filePath), m_symbol(symbol), m_isFile(false) {}
+    SymbolData(const wxString& filePath, const LspRange& selectionRange) 
+        : m_filePath(filePath), m_selectionRange(selectionRange), m_isFile(false) {}
     
     SymbolData(const wxString& filePath) 
         : m_filePath(filePath), m_isFile(true) {}
     
     const wxString& GetFilePath() const { return m_filePath; }
-    const LspDocumentSymbol& GetSymbol() const { return m_symbol; }
+    const LspRange& GetSelectionRange() const { return m_selectionRange; }
     bool IsFile() const { return m_isFile; }
     
 private:
     wxString m_filePath;
-    LspDocumentSymbol m_symbol;
+    LspRange m_selectionRange;
     bool m_isFile;
 };
 
@@ -48,7 +57,9 @@ private:
  * 
  * Features:
  * - Recursive directory scanning
- * - Background indexing
+ * - Background indexing with a bounded window of in-flight requests
+ * - On-disk symbol cache, so only changed files are re-indexed on startup
+ * - Files changed outside the editor are re-indexed individually
  * - Search/filter symbols
  * - Click to navigate
  */
@@ -65,6 +76,9 @@ public:
             m_indexTimeoutTimer = nullptr;
         }
         
+        // Keep whatever was indexed so far for the next launch
+        SaveSymbolCache();
+        
         // Clear log callback BEFORE destroying LspClient to prevent 
         // crashes during shutdown when wxTheApp may be null
         if (m_lspClient) {
@@ -151,6 +165,17 @@ public:
         // Initialize LSP and start indexing
         InitializeLspClient();
         
+        // Re-index files as they change on disk instead of rescanning
+        m_watchListenerId = FS::WatchService::Instance().AddListener(
+            [this](const std::vector<FS::FileChange>& changes) { OnFilesChanged(changes); });
+        m_panel->Bind(wxEVT_DESTROY, [this](wxWindowDestroyEvent& event) {
+            if (event.GetEventObject() == m_panel && m_watchListenerId > 0) {
+                FS::WatchService::Instance().RemoveListener(m_watchListenerId);
+                m_watchListenerId = 0;
+            }
+            event.Skip();
+        });
+        
         // Apply theme
         OnThemeChanged(m_panel, context);
         
@@ -180,8 +205,10 @@ public:
 
     void OnShow(wxWindow* window, WidgetContext& context) override {
         // Trigger indexing if not already done
-        if (m_allSymbols.empty() && m_lspClient && m_lspClient->isInitialized()) {
+        if (m_symbols->empty() && m_lspClient && m_lspClient->isInitialized()) {
             StartIndexing();
+        } else if (m_indexingComplete && !m_changesWhileIndexing.empty()) {
+            OnFilesChanged(m_changesWhileIndexing.take());
         }
     }
 
@@ -201,7 +228,7 @@ public:
         );
         reindexCmd->SetDescription("Rebuild the workspace symbol index");
         reindexCmd->SetExecuteHandler([this](CommandContext& ctx) {
-            StartIndexing();
+            StartIndexing(false);
         });
         registry.Register(reindexCmd);
         
@@ -224,69 +251,35 @@ public:
     // ========================================================================
     
     /**
-     * Get all indexed symbols.
-     * Returns a vector of all symbols across the workspace.
+     * Get the workspace symbol store.
+     * Shared so that consumers on other threads (MCP tools) can query it in
+     * place; they must hold its readLock() while doing so.
      */
-    const std::vector<std::pair<std::string, LspDocumentSymbol>>& GetAllSymbols() const {
-        return m_allSymbols;
+    std::shared_ptr<const SymbolStore> GetSymbolStore() const {
+        return m_symbols;
     }
     
     /**
-     * Search symbols by name (fuzzy match).
+     * Search symbols by name (case-insensitive substring).
+     * Prefix matches come first, then shorter names.
      */
-    std::vector<std::pair<std::string, LspDocumentSymbol>> SearchSymbols(const std::string& query) const {
-        std::vector<std::pair<std::string, LspDocumentSymbol>> results;
-        std::string lowerQuery = query;
-        std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
-        
-        for (const auto& [filePath, symbol] : m_allSymbols) {
-            std::string lowerName = symbol.name;
-            std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
-            if (lowerName.find(lowerQuery) != std::string::npos) {
-                results.push_back({filePath, symbol});
-            }
-        }
-        
-        // Sort by relevance (exact prefix match first, then contains)
-        std::sort(results.begin(), results.end(), 
-            [&lowerQuery](const auto& a, const auto& b) {
-                std::string aLower = a.second.name;
-                std::transform(aLower.begin(), aLower.end(), aLower.begin(), ::tolower);
-                std::string bLower = b.second.name;
-                std::transform(bLower.begin(), bLower.end(), bLower.begin(), ::tolower);
-                bool aPrefix = aLower.find(lowerQuery) == 0;
-                bool bPrefix = bLower.find(lowerQuery) == 0;
-                if (aPrefix != bPrefix) return aPrefix;
-                return a.second.name.length() < b.second.name.length();
-            });
-        
-        return results;
+    std::vector<SymbolStore::SymbolRef> SearchSymbols(const std::string& query,
+            size_t maxResults = SymbolSearchIndex::kUnlimited) const {
+        return m_symbols->search(query, maxResults);
     }
     
     /**
      * Get symbols in a specific file.
      */
-    std::vector<LspDocumentSymbol> GetFileSymbols(const wxString& filePath) const {
-        std::vector<LspDocumentSymbol> results;
-        for (const auto& [path, symbol] : m_allSymbols) {
-            if (path == filePath) {
-                results.push_back(symbol);
-            }
-        }
-        return results;
+    SymbolStore::SymbolRange GetFileSymbols(const wxString& filePath) const {
+        return m_symbols->fileSymbols(std::string(filePath.ToUTF8().data()));
     }
     
     /**
      * Get symbols by kind (e.g., all functions, all classes).
      */
-    std::vector<std::pair<wxString, LspDocumentSymbol>> GetSymbolsByKind(LspSymbolKind kind) const {
-        std::vector<std::pair<wxString, LspDocumentSymbol>> results;
-        for (const auto& [filePath, symbol] : m_allSymbols) {
-            if (symbol.kind == kind) {
-                results.push_back({filePath, symbol});
-            }
-        }
-        return results;
+    SymbolStore::KindView GetSymbolsByKind(LspSymbolKind kind) const {
+        return m_symbols->symbolsOfKinds({kind});
     }
     
     /**
@@ -307,7 +300,7 @@ public:
      * Get the number of indexed symbols.
      */
     size_t GetIndexedSymbolCount() const {
-        return m_allSymbols.size();
+        return m_symbols->size();
     }
     
     /**
@@ -367,10 +360,12 @@ public:
         }
         
         // Clear previous data
-        m_allSymbols.clear();
+        m_symbols->clear();
         m_indexedFiles.clear();
         m_filesToIndex.clear();
+        m_fileStamps.clear();
         m_currentIndexFile = 0;
+        m_finishedIndexFiles = 0;
         m_indexingComplete = false;
         
         // Update UI
@@ -407,13 +402,51 @@ private:
     bool m_destroyed = false;       // Flag to detect use-after-destroy in callbacks
     
     // Index data
-    std::vector<std::pair<std::string, LspDocumentSymbol>> m_allSymbols;
+    std::shared_ptr<SymbolStore> m_symbols = std::make_shared<SymbolStore>();
     std::set<std::string> m_indexedFiles;
     std::vector<std::string> m_filesToIndex;
-    size_t m_currentIndexFile = 0;
+    std::vector<SymbolCache::FileStamp> m_fileStamps;  // Parallel to m_filesToIndex
+    size_t m_currentIndexFile = 0;      // Next file to send to the server
+    size_t m_finishedIndexFiles = 0;    // Files answered, skipped or timed out
     bool m_indexingComplete = false;
     wxTimer* m_indexTimeoutTimer = nullptr;
-    std::shared_ptr<std::atomic<bool>> m_currentRequestCompleted;
+    int m_watchListenerId = 0;
+    FS::ChangeCoalescer m_changesWhileIndexing;  // Applied once the current run completes
+    
+    /**
+     * A documentSymbol request that has been sent but not retired yet.
+     */
+    struct PendingIndexRequest {
+        std::string uri;
+        std::chrono::steady_clock::time_point sentAt;
+        std::shared_ptr<std::atomic<bool>> completed;  // Set by whoever handles it first
+    };
+    
+    // In-flight requests keyed by index into m_filesToIndex
+    std::map<size_t, PendingIndexRequest> m_pendingIndexRequests;
+    std::map<size_t, std::string> m_indexReads;     // Files being read, with what has arrived
+    FS::Filesystem m_indexFs;                       // Reads the files to index
+    FS::TransferScope m_transfers;
+    size_t m_indexConcurrency = 32;     // From lsp.indexConcurrency
+    long m_indexTimeoutMs = 10000;      // From lsp.indexTimeout
+    
+    static constexpr int kIndexSweepIntervalMs = 500;
+    
+    // Reads run one at a time on FS::FileIO's worker; queueing only a few
+    // ahead keeps the editor's own opens and saves from waiting behind them
+    static constexpr size_t kMaxIndexReads = 4;
+    
+    // Search-as-you-type shows at most this many symbols, keeping tree rebuilds cheap
+    static constexpr size_t kMaxFilteredTreeSymbols = 2000;
+    
+    // Persistent symbol cache for the current workspace (null when disabled)
+    std::unique_ptr<SymbolCache> m_symbolCache;
+    std::string m_symbolCachePath;
+    
+    // Non-source directories that are never scanned (hidden ones are skipped too)
+    const std::vector<std::string> m_skippedDirectories = {
+        "node_modules", "build", "target", "__pycache__", "venv", "dist"
+    };
     
     // File extensions to index
     const std::set<wxString> m_sourceExtensions = {
@@ -636,15 +669,8 @@ private:
      * Stop any ongoing indexing operation.
      */
     void StopIndexing() {
-        // Cancel current request if pending
-        if (m_currentRequestCompleted) {
-            m_currentRequestCompleted->store(true);
-        }
-        
-        // Stop timeout timer
-        if (m_indexTimeoutTimer && m_indexTimeoutTimer->IsRunning()) {
-            m_indexTimeoutTimer->Stop();
-        }
+        // Cancel pending requests and stop the timeout sweep
+        CancelPendingIndexRequests();
         
         m_indexingComplete = true;  // Prevent further indexing
         ShowStatus("Indexing stopped");
@@ -652,14 +678,31 @@ private:
     
     /**
      * Start indexing the workspace.
+     * @param useCache Serve unchanged files from the on-disk symbol cache.
+     *                 When false the whole workspace is re-queried.
      */
-    void StartIndexing() {
-        m_allSymbols.clear();
+    void StartIndexing(bool useCache = true) {
+        // Abandon a run that is still in progress
+        CancelPendingIndexRequests();
+        
+        // The scan sees every change made so far
+        m_changesWhileIndexing.take();
+        
+        m_symbols->clear();
         m_indexedFiles.clear();
         m_filesToIndex.clear();
+        m_fileStamps.clear();
         m_currentIndexFile = 0;
+        m_finishedIndexFiles = 0;
         m_indexingComplete = false;
         
+        auto& config = Config::Instance();
+        m_indexConcurrency = static_cast<size_t>(std::clamp(config.GetInt("lsp.indexConcurrency", 32), 1, 64));
+        m_indexTimeoutMs = std::max(config.GetInt("lsp.indexTimeout", 10), 1) * 1000L;
+        
+        m_indexFs = m_isRemoteMode ? FS::Filesystem::Remote(FS::SshConfig::LoadFromConfig(), m_workspaceRoot)
+                                   : FS::Filesystem::Local(m_workspaceRoot);
+        
         // Scan for source files (supports both local and remote)
         ShowStatus(m_isRemoteMode ? "Scanning remote files..." : "Scanning files...");
         
@@ -675,9 +718,17 @@ private:
             return;
         }
         
-        ShowStatus(wxString::Format("Found %zu files, indexing...", m_filesToIndex.size()));
+        size_t cachedFiles = LoadCachedSymbols(useCache);
+        if (cachedFiles > 0) {
+            // Make the cached index browsable while changed files are re-indexed
+            RebuildTree();
+            ShowStatus(wxString::Format("Loaded %zu files from cache, %zu to index...", 
+                cachedFiles, m_filesToIndex.size()));
+        } else {
+            ShowStatus(wxString::Format("Found %zu files, indexing...", m_filesToIndex.size()));
+        }
         
-        // Start indexing files one by one
+        // Fill the request window; each answer refills it
         IndexNextFile();
     }
     
@@ -709,6 +760,12 @@ private:
                 }
                 fullPath += filename;
                 m_filesToIndex.push_back(std::string(fullPath.ToUTF8().data()));
+                
+                SymbolCache::FileStamp stamp;
+                stamp.modTime = wxFileModificationTime(fullPath);
+                wxULongLong size = wxFileName::GetSize(fullPath);
+                stamp.size = size == wxInvalidSize ? -1 : static_cast<int64_t>(size.GetValue());
+                m_fileStamps.push_back(stamp);
             }
             cont = dir.GetNext(&filename);
         }
@@ -737,92 +794,34 @@ private:
     }
     
     /**
-     * Recursively scan remote directory for source files via SSH.
+     * Scan remote directory for source files via SSH.
+     * The whole subtree is listed by a single streamed remote command.
      */
-    void ScanDirectoryRemote(const wxString& dirPath, int depth = 0) {
-        // Limit recursion depth to avoid very deep scans
-        if (depth > 10) {
-            wxLogMessage("SymbolsWidget: Max scan depth reached at %s", dirPath);
-            return;
-        }
-        
+    void ScanDirectoryRemote(const wxString& dirPath) {
         auto sshConfig = FS::SshConfig::LoadFromConfig();
         if (!sshConfig.isValid()) {
             wxLogMessage("SymbolsWidget: Invalid SSH config for remote scanning");
             return;
         }
         
-        // Use find command for efficient remote scanning
-        // This is much faster than recursive ls for large directories
-        std::string sshPrefix = sshConfig.buildSshPrefix();
-        std::string escapedPath = dirPath.ToStdString();
-        
-        // Build find command to get files and directories
-        // Exclude common non-source directories and hidden files
-        std::string cmd = sshPrefix + " \"find '" + escapedPath + "' -maxdepth 1 \\( -type f -o -type d \\) 2>/dev/null\" 2>&1";
-        
-        FILE* pipe = popen(cmd.c_str(), "r");
-        if (!pipe) {
-            wxLogMessage("SymbolsWidget: Failed to execute SSH find command");
-            return;
-        }
-        
-        std::vector<std::string> files;
-        std::vector<std::string> directories;
-        
-        char buffer[4096];
-        while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-            std::string line(buffer);
-            // Remove trailing newline
-            while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
-                line.pop_back();
-            }
-            
-            if (line.empty() || line == dirPath.ToStdString()) continue;
-            
-            // Get just the filename
-            std::string filename = line;
-            size_t lastSlash = line.rfind('/');
-            if (lastSlash != std::string::npos) {
-                filename = line.substr(lastSlash + 1);
-            }
-            
-            // Skip hidden files/directories
-            if (!filename.empty() && filename[0] == '.') continue;
-            
-            // Check if it's a file or directory by testing extension
-            wxString ext = wxString(filename).AfterLast('.').Lower();
-            if (m_sourceExtensions.count(ext)) {
-                files.push_back(line);
-            } else if (filename.find('.') == std::string::npos || ext.length() > 10) {
-                // Likely a directory (no extension or very long "extension")
-                // We'll verify with stat below
-                directories.push_back(line);
-            }
-        }
-        pclose(pipe);
-        
-        // Add source files
-        for (const auto& file : files) {
-            m_filesToIndex.push_back(file);
-        }
-        
-        // Recursively scan subdirectories
-        for (const auto& dir : directories) {
-            wxString dirName = wxString(dir).AfterLast('/');
-            if (ShouldScanDirectory(dirName)) {
-                // Verify it's actually a directory via SSH
-                std::string testCmd = sshPrefix + " \"test -d '" + dir + "' && echo yes\" 2>/dev/null";
-                FILE* testPipe = popen(testCmd.c_str(), "r");
-                if (testPipe) {
-                    char testBuf[16];
-                    bool isDir = (fgets(testBuf, sizeof(testBuf), testPipe) != nullptr);
-                    pclose(testPipe);
-                    if (isDir) {
-                        ScanDirectoryRemote(wxString(dir), depth + 1);
-                    }
+        FS::WalkOptions options;
+        options.maxDepth = 11;  // Avoid very deep scans
+        options.skipDirectories = m_skippedDirectories;
+        
+        auto fs = FS::Filesystem::Remote(sshConfig, dirPath);
+        bool ok = fs.walk(fs.rootPath(), options, [this](const FS::FileEntry& entry) {
+            if (!entry.isDirectory) {
+                wxString ext = entry.name.AfterLast('.').Lower();
+                if (m_sourceExtensions.count(ext)) {
+                    m_filesToIndex.push_back(std::string(entry.fullPath.ToUTF8().data()));
+                    m_fileStamps.push_back({static_cast<int64_t>(entry.modTime), entry.size});
                 }
             }
+            return true;
+        });
+        
+        if (!ok) {
+            wxLogMessage("SymbolsWidget: Remote scan of %s failed", dirPath);
         }
     }
     
@@ -830,15 +829,11 @@ private:
      * Check if a directory should be scanned (not excluded).
      */
     bool ShouldScanDirectory(const wxString& dirname) const {
-        return !dirname.StartsWith(".") && 
-               dirname != "node_modules" && 
-               dirname != "build" && 
-               dirname != "target" &&
-               dirname != "__pycache__" &&
-               dirname != "venv" &&
-               dirname != ".git" &&
-               dirname != "dist" &&
-               dirname != ".cache";
+        if (dirname.StartsWith(".")) return false;
+        for (const auto& skipped : m_skippedDirectories) {
+            if (dirname == wxString(skipped)) return false;
+        }
+        return true;
     }
     
     /**
@@ -855,148 +850,360 @@ private:
     }
     
     /**
-     * Index the next file in the queue.
+     * Keep the in-flight window full.
+     * Reads files in the background and sends documentSymbol requests until
+     * m_indexConcurrency are outstanding so clangd's worker pool always has
+     * files to parse, and finishes the index once every file has been
+     * answered, skipped or timed out.
      */
     void IndexNextFile() {
         // Safety check - ensure panel is still valid
         if (!m_panel || !m_panel->IsShown()) {
             wxLogMessage("SymbolsWidget: Panel invalid or hidden, stopping indexing");
+            CancelPendingIndexRequests();
             m_indexingComplete = true;
             return;
         }
         
-        if (m_currentIndexFile >= m_filesToIndex.size()) {
+        // Check if we've been told to stop
+        if (m_indexingComplete) {
+            return;
+        }
+        
+        while (m_pendingIndexRequests.size() + m_indexReads.size() < m_indexConcurrency &&
+               m_indexReads.size() < kMaxIndexReads &&
+               m_currentIndexFile < m_filesToIndex.size()) {
+            ReadIndexFile(m_currentIndexFile++);
+        }
+        
+        if (m_pendingIndexRequests.empty() && m_indexReads.empty() &&
+            m_currentIndexFile >= m_filesToIndex.size()) {
             // Indexing complete
             m_indexingComplete = true;
+            if (m_indexTimeoutTimer) {
+                m_indexTimeoutTimer->Stop();
+            }
             ShowStatus(wxString::Format("Indexed %zu symbols in %zu files", 
-                m_allSymbols.size(), m_indexedFiles.size()));
-            RebuildTree();
+                m_symbols->size(), m_indexedFiles.size()));
+            RebuildTree(m_searchCtrl ? std::string(m_searchCtrl->GetValue().ToUTF8().data()) : "");
+            SaveSymbolCache();
+            
+            // Files that changed during the run may have been read before they did
+            if (!m_changesWhileIndexing.empty()) {
+                OnFilesChanged(m_changesWhileIndexing.take());
+            }
             return;
         }
         
-        // Check if we've been told to stop
-        if (m_indexingComplete) {
-            return;
+        ShowStatus(wxString::Format("Indexing %zu/%zu (%zu in flight)", 
+            m_finishedIndexFiles, m_filesToIndex.size(), m_pendingIndexRequests.size() + m_indexReads.size()));
+        
+        // A single periodic sweep handles timeouts for the whole window
+        if (!m_indexTimeoutTimer) {
+            m_indexTimeoutTimer = new wxTimer(m_panel);
+            m_panel->Bind(wxEVT_TIMER, [this](wxTimerEvent&) {
+                if (m_destroyed) return;
+                ExpireIndexRequests();
+            });
         }
+        if (!m_indexTimeoutTimer->IsRunning()) {
+            m_indexTimeoutTimer->Start(kIndexSweepIntervalMs);
+        }
+    }
+    
+    /**
+     * Re-index source files created or modified outside the editor and
+     * drop the symbols of deleted ones, as a small indexing run over just
+     * those files. Changes arriving while a run is in progress, or while
+     * the panel is hidden, wait for it to complete or show.
+     */
+    void OnFilesChanged(const std::vector<FS::FileChange>& changes) {
+        if (m_destroyed || !m_lspClient) return;
         
-        wxString filePath = m_filesToIndex[m_currentIndexFile];
-        wxString uri = pathToUri(std::string(filePath.mb_str()));
+        if (!m_indexingComplete || !m_pendingIndexRequests.empty() || !m_panel->IsShown() ||
+            !m_lspClient->isInitialized()) {
+            for (const auto& change : changes) {
+                m_changesWhileIndexing.add(change);
+            }
+            return;
+        }
         
-        // Update status
-        wxString fileName = filePath.AfterLast('/');
-        if (fileName.IsEmpty()) fileName = filePath.AfterLast('\\');
-        if (fileName.IsEmpty()) fileName = filePath;
+        std::string root(m_workspaceRoot.ToUTF8().data());
+        while (root.size() > 1 && root.back() == '/') {
+            root.pop_back();
+        }
         
-        ShowStatus(wxString::Format("Indexing %zu/%zu: %s", 
-            m_currentIndexFile + 1, m_filesToIndex.size(), fileName));
+        std::unordered_set<std::string> removed;
+        std::vector<std::string> changed;
+        for (const auto& change : changes) {
+            if (FS::RemoteWatcher::IsIgnored(root, change.path, m_skippedDirectories)) continue;
+            
+            wxString ext = wxString::FromUTF8(change.path).AfterLast('/').AfterLast('.').Lower();
+            bool isSource = !change.isDirectory && m_sourceExtensions.count(ext);
+            if (change.kind == FS::FileChange::Kind::Deleted && !isSource) {
+                // Possibly a directory: everything indexed below it goes
+                std::string prefix = change.path + "/";
+                for (auto it = m_indexedFiles.lower_bound(prefix);
+                     it != m_indexedFiles.end() && it->compare(0, prefix.size(), prefix) == 0; ++it) {
+                    removed.insert(*it);
+                }
+            }
+            if (!isSource) continue;
+            
+            removed.insert(change.path);
+            if (change.kind != FS::FileChange::Kind::Deleted) {
+                changed.push_back(change.path);
+            }
+        }
+        if (removed.empty()) return;
         
-        // Read file content (local or remote)
-        wxString content;
-        bool readSuccess = false;
+        for (const auto& path : removed) {
+            m_indexedFiles.erase(path);
+        }
+        m_symbols->removeFiles(removed);
         
-        if (m_isRemoteMode) {
-            readSuccess = ReadRemoteFile(filePath, content);
-        } else {
-            readSuccess = ReadLocalFile(filePath, content);
+        m_filesToIndex.clear();
+        m_fileStamps.clear();
+        for (auto& path : changed) {
+            SymbolCache::FileStamp stamp;   // Unknown for remote files, so never served from the cache
+            if (!m_isRemoteMode) {
+                wxString localPath = wxString::FromUTF8(path);
+                if (!wxFileExists(localPath)) continue;
+                stamp.modTime = wxFileModificationTime(localPath);
+                wxULongLong size = wxFileName::GetSize(localPath);
+                stamp.size = size == wxInvalidSize ? -1 : static_cast<int64_t>(size.GetValue());
+            }
+            m_filesToIndex.push_back(std::move(path));
+            m_fileStamps.push_back(stamp);
         }
+        m_currentIndexFile = 0;
+        m_finishedIndexFiles = 0;
+        m_indexingComplete = false;
         
-        if (!readSuccess || content.IsEmpty()) {
-            wxLogMessage("SymbolsWidget: Failed to read file %s, skipping", filePath);
-            m_currentIndexFile++;
-            // Use CallAfter to prevent stack overflow on many failures
-            wxTheApp->CallAfter([this]() {
-                if (m_destroyed) return;
+        // Completes straight away (updating the tree) if only deletions remain
+        IndexNextFile();
+    }
+    
+    /**
+     * Read one file in the background, then send it to the server.
+     * Files that cannot be read are counted as finished.
+     */
+    void ReadIndexFile(size_t index) {
+        m_indexReads[index];
+        m_transfers.read(m_indexFs, wxString::FromUTF8(m_filesToIndex[index]),
+            [this, index](std::string chunk, const FS::TransferProgress&) {
+                m_indexReads[index] += chunk;
+            },
+            [this, index](const FS::TransferResult& result) {
+                auto it = m_indexReads.find(index);
+                if (it == m_indexReads.end()) return;
+                std::string content = std::move(it->second);
+                m_indexReads.erase(it);
+                
+                if (!result.success || content.empty()) {
+                    wxLogMessage("SymbolsWidget: Failed to read file %s, skipping",
+                        wxString::FromUTF8(m_filesToIndex[index]));
+                    m_finishedIndexFiles++;
+                } else {
+                    SendIndexRequest(index, content);
+                }
                 IndexNextFile();
             });
-            return;
-        }
+    }
+    
+    /**
+     * Open one file on the server and request its symbols.
+     */
+    void SendIndexRequest(size_t index, const std::string& content) {
+        wxString filePath = wxString::FromUTF8(m_filesToIndex[index]);
+        std::string uri = pathToUri(m_filesToIndex[index]);
         
         // Notify LSP about the file
         wxString langId = DetectLanguage(filePath);
-        m_lspClient->didOpen(
-            std::string(uri.mb_str()),
-            std::string(langId.mb_str()),
-            std::string(content.mb_str())
-        );
+        m_lspClient->didOpen(uri, std::string(langId.mb_str()), content);
         
-        wxLogMessage("LSP: Requesting symbols from %s", wxString::FromUTF8(filePath.c_str()));
+        wxLogMessage("LSP: Requesting symbols from %s", filePath);
         
-        // Request symbols with timeout protection
-        m_currentRequestCompleted = std::make_shared<std::atomic<bool>>(false);
-        auto requestCompleted = m_currentRequestCompleted;
+        PendingIndexRequest request;
+        request.uri = uri;
+        request.sentAt = std::chrono::steady_clock::now();
+        request.completed = std::make_shared<std::atomic<bool>>(false);
+        auto completed = request.completed;
+        m_pendingIndexRequests[index] = std::move(request);
         
-        m_lspClient->getDocumentSymbols(std::string(uri.mb_str()), [this, filePath, uri, requestCompleted](const std::vector<LspDocumentSymbol>& symbols) {
-            if (requestCompleted->exchange(true)) {
-                wxLogMessage("LSP: Callback fired but request already completed for %s", wxString::FromUTF8(filePath.c_str()));
-                return; // Already handled by timeout
+        m_lspClient->getDocumentSymbols(uri, [this, index, completed](const std::vector<LspDocumentSymbol>& symbols) {
+            if (completed->exchange(true)) {
+                return; // Already timed out or cancelled
             }
             
-            wxTheApp->CallAfter([this, filePath, uri, symbols]() {
+            wxTheApp->CallAfter([this, index, completed, symbols]() {
                 if (m_destroyed) return;
                 
-                // Stop timeout timer
-                if (m_indexTimeoutTimer && m_indexTimeoutTimer->IsRunning()) {
-                    m_indexTimeoutTimer->Stop();
+                // Ignore answers that belong to a cancelled or restarted run
+                auto it = m_pendingIndexRequests.find(index);
+                if (it == m_pendingIndexRequests.end() || it->second.completed != completed) {
+                    return;
                 }
                 
-                wxLogMessage("LSP: Received %zu symbols from %s", symbols.size(), wxString::FromUTF8(filePath.c_str()));
-                
-                // Store symbols
-                CollectSymbols(filePath, symbols);
-                m_indexedFiles.insert(std::string(filePath.ToUTF8().data()));
-                
-                // Close the document to free LSP memory
-                m_lspClient->didClose(std::string(uri.mb_str()));
-                
-                // Continue to next file
-                m_currentIndexFile++;
+                wxLogMessage("LSP: Received %zu symbols from %s", symbols.size(), 
+                    wxString::FromUTF8(m_filesToIndex[index]));
+                FinishIndexRequest(index, &symbols);
                 IndexNextFile();
             });
         });
+    }
+    
+    /**
+     * Retire an in-flight request: store its symbols (if any) and close the
+     * document so the server can drop its AST.
+     */
+    void FinishIndexRequest(size_t index, const std::vector<LspDocumentSymbol>* symbols) {
+        auto it = m_pendingIndexRequests.find(index);
+        if (it == m_pendingIndexRequests.end()) return;
+        
+        if (symbols) {
+            CollectSymbols(wxString::FromUTF8(m_filesToIndex[index]), *symbols);
+            m_indexedFiles.insert(m_filesToIndex[index]);
+            if (m_symbolCache) {
+                m_symbolCache->store(m_filesToIndex[index], m_fileStamps[index], *symbols);
+            }
+        }
         
-        // Set a timeout in case clangd doesn't respond
-        if (!m_indexTimeoutTimer) {
-            m_indexTimeoutTimer = new wxTimer(m_panel);
-            m_panel->Bind(wxEVT_TIMER, [this](wxTimerEvent&) {
-                if (m_destroyed) return;
-                
-                // Use member variable that was captured before timeout
-                auto requestCompleted = m_currentRequestCompleted;
-                if (!requestCompleted || requestCompleted->exchange(true)) {
-                    wxLogMessage("LSP: Timeout fired but request already completed");
-                    return;
-                }
-                
-                wxLogMessage("LSP: Timeout (5s) waiting for symbols, skipping file %zu/%zu", 
-                    m_currentIndexFile + 1, m_filesToIndex.size());
-                
-                // Close the current document
-                if (m_currentIndexFile < m_filesToIndex.size()) {
-                    wxString currentFilePath = m_filesToIndex[m_currentIndexFile];
-                    wxString currentUri = pathToUri(std::string(currentFilePath.mb_str()));
-                    m_lspClient->didClose(std::string(currentUri.mb_str()));
-                }
-                
-                // Continue to next file
-                m_currentIndexFile++;
-                IndexNextFile();
-            });
+        if (m_lspClient) {
+            m_lspClient->didClose(it->second.uri);
         }
-        m_indexTimeoutTimer->StartOnce(5000); // 5 second timeout
+        m_pendingIndexRequests.erase(it);
+        m_finishedIndexFiles++;
     }
     
     /**
-     * Recursively collect symbols from hierarchical structure.
+     * Skip files whose symbols have not arrived within the timeout.
      */
-    void CollectSymbols(const wxString& filePath, const std::vector<LspDocumentSymbol>& symbols) {
-        for (const auto& symbol : symbols) {
-            m_allSymbols.push_back({std::string(filePath.ToUTF8().data()), symbol});
+    void ExpireIndexRequests() {
+        auto now = std::chrono::steady_clock::now();
+        auto timeout = std::chrono::milliseconds(m_indexTimeoutMs);
+        
+        std::vector<size_t> expired;
+        for (const auto& [index, request] : m_pendingIndexRequests) {
+            // A request whose answer is already queued via CallAfter is left alone
+            if (now - request.sentAt >= timeout && !request.completed->exchange(true)) {
+                expired.push_back(index);
+            }
+        }
+        
+        if (expired.empty()) return;
+        
+        for (size_t index : expired) {
+            wxLogMessage("LSP: Timeout (%ldms) waiting for symbols, skipping %s", 
+                m_indexTimeoutMs, wxString::FromUTF8(m_filesToIndex[index]));
+            FinishIndexRequest(index, nullptr);
+        }
+        IndexNextFile();
+    }
+    
+    /**
+     * Drop every in-flight request, closing their documents on the server.
+     */
+    void CancelPendingIndexRequests() {
+        for (auto& [index, request] : m_pendingIndexRequests) {
+            request.completed->store(true);
+            if (m_lspClient) {
+                m_lspClient->didClose(request.uri);
+            }
+        }
+        m_pendingIndexRequests.clear();
+        m_transfers.cancelAll();
+        m_indexReads.clear();
+        
+        if (m_indexTimeoutTimer && m_indexTimeoutTimer->IsRunning()) {
+            m_indexTimeoutTimer->Stop();
+        }
+    }
+    
+    /**
+     * Key identifying the workspace in the symbol cache.
+     * Remote roots include the endpoint, so the same path on two hosts
+     * (or locally) never shares a cache.
+     */
+    std::string GetWorkspaceCacheKey() const {
+        std::string root(m_workspaceRoot.ToUTF8().data());
+        if (m_isRemoteMode) {
+            auto sshConfig = FS::SshConfig::LoadFromConfig();
+            return "ssh:" + sshConfig.getHostSpec() + ":" + std::to_string(sshConfig.port) + ":" + root;
+        }
+        return "local:" + root;
+    }
+    
+    /**
+     * Serve unchanged files from the symbol cache.
+     * Cache hits are added to the index directly and removed from
+     * m_filesToIndex, leaving only new or modified files to query.
+     * @return Number of files loaded from the cache.
+     */
+    size_t LoadCachedSymbols(bool useCache) {
+        if (!Config::Instance().GetBool("lsp.symbolCache", true)) {
+            m_symbolCache.reset();
+            return 0;
+        }
+        
+        std::string key = GetWorkspaceCacheKey();
+        if (!m_symbolCache || m_symbolCache->workspaceKey() != key) {
+            SaveSymbolCache();
+            
+            wxString cacheDir = wxFileName(Config::Instance().GetConfigDir(), "cache").GetFullPath();
+            if (!wxDir::Exists(cacheDir)) {
+                wxFileName::Mkdir(cacheDir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+            }
+            m_symbolCachePath = std::string(wxFileName(cacheDir, 
+                wxString::FromUTF8(SymbolCache::FileNameFor(key))).GetFullPath().ToUTF8().data());
             
-            // Collect children
-            if (!symbol.children.empty()) {
-                CollectSymbols(filePath, symbol.children);
+            m_symbolCache = std::make_unique<SymbolCache>(key);
+            if (m_symbolCache->load(m_symbolCachePath)) {
+                wxLogMessage("SymbolsWidget: Loaded symbol cache with %zu files", m_symbolCache->fileCount());
+            }
+        }
+        
+        if (!useCache) {
+            m_symbolCache->clear();
+            return 0;
+        }
+        
+        m_symbolCache->retainOnly(std::set<std::string>(m_filesToIndex.begin(), m_filesToIndex.end()));
+        
+        std::vector<std::string> staleFiles;
+        std::vector<SymbolCache::FileStamp> staleStamps;
+        size_t hits = 0;
+        for (size_t i = 0; i < m_filesToIndex.size(); ++i) {
+            if (const auto* symbols = m_symbolCache->find(m_filesToIndex[i], m_fileStamps[i])) {
+                CollectSymbols(wxString::FromUTF8(m_filesToIndex[i]), *symbols);
+                m_indexedFiles.insert(m_filesToIndex[i]);
+                ++hits;
+            } else {
+                staleFiles.push_back(std::move(m_filesToIndex[i]));
+                staleStamps.push_back(m_fileStamps[i]);
             }
         }
+        m_filesToIndex = std::move(staleFiles);
+        m_fileStamps = std::move(staleStamps);
+        return hits;
+    }
+    
+    /**
+     * Persist the symbol cache if anything changed since it was loaded.
+     */
+    void SaveSymbolCache() {
+        if (!m_symbolCache || !m_symbolCache->isDirty() || m_symbolCachePath.empty()) return;
+        
+        if (!m_symbolCache->save(m_symbolCachePath)) {
+            wxLogMessage("SymbolsWidget: Failed to write symbol cache %s", wxString::FromUTF8(m_symbolCachePath));
+        }
+    }
+    
+    /**
+     * Add a file's symbols (children included) to the store.
+     */
+    void CollectSymbols(const wxString& filePath, const std::vector<LspDocumentSymbol>& symbols) {
+        m_symbols->addFile(std::string(filePath.ToUTF8().data()), symbols);
     }
     
     /**
@@ -1007,24 +1214,28 @@ private:
         m_treeCtrl->DeleteAllItems();
         wxTreeItemId root = m_treeCtrl->AddRoot("Workspace");
         
-        std::string lowerFilter = filter;
-        std::transform(lowerFilter.begin(), lowerFilter.end(), lowerFilter.begin(), ::tolower);
+        const bool filtering = !filter.empty();
         
-        // Group symbols by file
-        std::map<std::string, std::vector<const LspDocumentSymbol*>> fileSymbols;
+        // Group symbols by file (sorted by path)
+        std::map<std::string_view, std::vector<SymbolStore::SymbolRef>> fileSymbols;
         
-        for (const auto& [filePath, symbol] : m_allSymbols) {
-            // Apply filter
-            std::string lowerName = symbol.name;
-            std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
-            if (!lowerFilter.empty() && lowerName.find(lowerFilter) == std::string::npos) {
-                continue;
+        if (filtering) {
+            // Best matches only, shown in workspace order
+            auto matches = m_symbols->search(filter, kMaxFilteredTreeSymbols);
+            std::sort(matches.begin(), matches.end(), 
+                [](const auto& a, const auto& b) { return a.id() < b.id(); });
+            for (const auto& symbol : matches) {
+                fileSymbols[symbol.filePath()].push_back(symbol);
+            }
+        } else {
+            for (auto symbol : m_symbols->all()) {
+                fileSymbols[symbol.filePath()].push_back(symbol);
             }
-            fileSymbols[filePath].push_back(&symbol);
         }
         
         // Build tree
-        for (const auto& [filePath, symbols] : fileSymbols) {
+        for (const auto& [path, symbols] : fileSymbols) {
+            wxString filePath = wxString::FromUTF8(path.data(), path.size());
             wxString relativePath = filePath;
             if (relativePath.StartsWith(m_workspaceRoot)) {
                 relativePath = relativePath.Mid(m_workspaceRoot.length());
@@ -1037,18 +1248,18 @@ private:
                 wxString::FromUTF8("📄 ") + relativePath, 
                 -1, -1, new SymbolData(filePath));
             
-            for (const auto* symbol : symbols) {
-                wxString icon = getSymbolKindIcon(symbol->kind);
-                wxString label = icon + " " + symbol->name;
-                if (!symbol->detail.empty()) {
-                    label += " : " + symbol->detail;
+            for (const auto& symbol : symbols) {
+                wxString icon = getSymbolKindIcon(symbol.kind());
+                wxString label = icon + " " + symbol.name();
+                if (!symbol.detail().empty()) {
+                    label += " : " + symbol.detail();
                 }
                 m_treeCtrl->AppendItem(fileItem, label, -1, -1, 
-                    new SymbolData(filePath, *symbol));
+                    new SymbolData(filePath, symbol.selectionRange()));
             }
             
             // Expand file node if filtering
-            if (!lowerFilter.empty()) {
+            if (filtering) {
                 m_treeCtrl->Expand(fileItem);
             }
         }
@@ -1056,63 +1267,11 @@ private:
         m_treeCtrl->Thaw();
         
         // Expand all if filtering
-        if (!lowerFilter.empty()) {
+        if (filtering) {
             m_treeCtrl->ExpandAll();
         }
     }
     
-    /**
-     * Read a local file's content.
-     */
-    bool ReadLocalFile(const wxString& filePath, wxString& content) {
-        wxFile file(filePath);
-        if (!file.IsOpened()) {
-            return false;
-        }
-        
-        bool success = file.ReadAll(&content);
-        file.Close();
-        return success && !content.IsEmpty();
-    }
-    
-    /**
-     * Read a remote file's content via SSH.
-     */
-    bool ReadRemoteFile(const wxString& filePath, wxString& content) {
-        auto sshConfig = FS::SshConfig::LoadFromConfig();
-        if (!sshConfig.isValid()) {
-            wxLogMessage("SymbolsWidget: Invalid SSH config for reading remote file");
-            return false;
-        }
-        
-        std::string sshPrefix = sshConfig.buildSshPrefix();
-        std::string escapedPath = filePath.ToStdString();
-        
-        // Use cat to read file content
-        std::string cmd = sshPrefix + " \"cat '" + escapedPath + "'\" 2>/dev/null";
-        
-        FILE* pipe = popen(cmd.c_str(), "r");
-        if (!pipe) {
-            wxLogMessage("SymbolsWidget: Failed to execute SSH cat command for %s", filePath);
-            return false;
-        }
-        
-        std::string result;
-        char buffer[4096];
-        while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-            result += buffer;
-        }
-        
-        int status = pclose(pipe);
-        if (status != 0) {
-            wxLogMessage("SymbolsWidget: SSH cat command failed with status %d for %s", status, filePath);
-            return false;
-        }
-        
-        content = wxString::FromUTF8(result.c_str());
-        return !content.IsEmpty();
-    }
-    
     /**
      * Show status message.
      */
@@ -1170,30 +1329,33 @@ private:
             }
         }
         
-        // Navigate to symbol position if it's a symbol (not just a file)
+        // Navigate to symbol position if it's a symbol (not just a file),
+        // once the file has finished loading
         if (!data->IsFile()) {
-            const LspDocumentSymbol& symbol = data->GetSymbol();
-            wxStyledTextCtrl* textCtrl = editor->GetTextCtrl();
-            if (textCtrl) {
-                int line = symbol.selectionRange.start.line;
-                int col = symbol.selectionRange.start.character;
-                int pos = textCtrl->PositionFromLine(line) + col;
+            LspRange selection = data->GetSelectionRange();
+            editor->WhenLoaded([editor, selection]() {
+                wxStyledTextCtrl* textCtrl = editor->GetTextCtrl();
+                if (textCtrl) {
+                    int line = selection.start.line;
+                    int col = selection.start.character;
+                    int pos = textCtrl->PositionFromLine(line) + col;
                 
-                textCtrl->GotoPos(pos);
-                textCtrl->EnsureCaretVisible();
-                textCtrl->SetFocus();
+                    textCtrl->GotoPos(pos);
+                    textCtrl->EnsureCaretVisible();
+                    textCtrl->SetFocus();
                 
-                // Select the symbol name
-                int endLine = symbol.selectionRange.end.line;
-                int endCol = symbol.selectionRange.end.character;
-                int endPos = textCtrl->PositionFromLine(endLine) + endCol;
-                textCtrl->SetSelection(pos, endPos);
-            }
+                    // Select the symbol name
+                    int endLine = selection.end.line;
+                    int endCol = selection.end.character;
+                    int endPos = textCtrl->PositionFromLine(endLine) + endCol;
+                    textCtrl->SetSelection(pos, endPos);
+                }
+            });
         }
     }
     
     void OnRefreshClicked(wxCommandEvent& event) {
-        StartIndexing();
+        StartIndexing(false);
     }
     
     void OnSearchTextChanged(wxCommandEvent& event) {
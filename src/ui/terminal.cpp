@@ -1,12 +1,19 @@
 #include "terminal.h"
 #include "../config/config.h"
 #include <wx/filename.h>
+#include <algorithm>
+#include <string_view>
 
 wxBEGIN_EVENT_TABLE(Terminal, wxPanel)
     EVT_END_PROCESS(wxID_ANY, Terminal::OnProcessTerminated)
-    EVT_IDLE(Terminal::OnIdle)
 wxEND_EVENT_TABLE()
 
+// Shell output is collected this often, so a flood costs one repaint per frame
+static const int kOutputFrameMs = 16;
+
+// Bytes taken from the shell per frame; the rest waits in the pipe
+static const size_t kOutputBytesPerFrame = 2 * 1024 * 1024;
+
 /**
  * Load SSH configuration from the global config.
  */
@@ -38,6 +45,8 @@ Terminal::Terminal(wxWindow* parent, wxWindowID id)
     , m_processInput(nullptr)
     , m_processOutput(nullptr)
     , m_processError(nullptr)
+    , m_outputTimer(this)
+    , m_readBuffer(64 * 1024)
     , m_historyIndex(-1)
     , m_themeListenerId(0)
 {
@@ -48,6 +57,7 @@ Terminal::Terminal(wxWindow* parent, wxWindowID id)
     
     SetupUI();
     ApplyCurrentTheme();
+    Bind(wxEVT_TIMER, &Terminal::OnOutputTimer, this, m_outputTimer.GetId());
     StartShell();
     
     // Listen for theme changes
@@ -86,9 +96,9 @@ void Terminal::SetupUI()
     sizer->Add(headerSizer, 0, wxEXPAND | wxTOP | wxBOTTOM, 3);
     
     // Output area
-    m_output = new wxTextCtrl(this, wxID_ANY, wxEmptyString,
-        wxDefaultPosition, wxDefaultSize,
-        wxTE_MULTILINE | wxTE_READONLY | wxTE_RICH2 | wxHSCROLL);
+    m_output = new TerminalView(this);
+    m_output->Buffer().setMaxLines(static_cast<size_t>(
+        std::max(1, Config::Instance().GetInt("terminal.scrollback", 10000))));
     
     // Use monospace font
     wxFont monoFont(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
@@ -136,7 +146,11 @@ void Terminal::ApplyTheme(const ThemePtr& theme)
     // Output area
     if (m_output) {
         m_output->SetBackgroundColour(colors.background);
-        m_output->SetForegroundColour(colors.foreground);
+        m_output->SetStyleColour(TerminalStyle::Output, colors.foreground);
+        m_output->SetStyleColour(TerminalStyle::Info, colors.foreground);
+        m_output->SetStyleColour(TerminalStyle::Error, colors.error);
+        m_output->SetStyleColour(TerminalStyle::Command, colors.prompt);
+        m_output->SetSelectionColour(theme->editor.selection);
     }
     
     // Input area
@@ -216,7 +230,7 @@ void Terminal::StartShell()
     m_pid = wxExecute(shell, wxEXEC_ASYNC, m_process, &env);
     
     if (m_pid == 0) {
-        m_output->AppendText("Failed to start: " + shell + "\n");
+        AppendText("Failed to start: " + shell + "\n", TerminalStyle::Error);
         delete m_process;
         m_process = nullptr;
         return;
@@ -226,21 +240,24 @@ void Terminal::StartShell()
     m_processOutput = m_process->GetInputStream();
     m_processError = m_process->GetErrorStream();
     
-    m_output->AppendText(displayMessage);
+    m_outputTimer.Start(kOutputFrameMs);
+    AppendText(displayMessage, TerminalStyle::Info);
     
     // For SSH, change to the remote working directory
     if (m_sshConfig.IsValid() && !m_sshConfig.remotePath.IsEmpty()) {
-        m_output->AppendText("Remote directory: " + m_sshConfig.remotePath + "\n\n");
+        AppendText("Remote directory: " + m_sshConfig.remotePath + "\n\n", TerminalStyle::Info);
         // Send cd command after a brief delay for connection establishment
         wxString cdCmd = "cd " + m_sshConfig.remotePath + "\n";
         m_processInput->Write(cdCmd.c_str(), cdCmd.length());
     } else {
-        m_output->AppendText("Working directory: " + m_workingDir + "\n\n");
+        AppendText("Working directory: " + m_workingDir + "\n\n", TerminalStyle::Info);
     }
 }
 
 void Terminal::StopShell()
 {
+    m_outputTimer.Stop();
+    
     if (m_process && m_pid > 0) {
         // Send exit command gracefully
         if (m_processInput && m_processInput->IsOk()) {
@@ -267,7 +284,7 @@ void Terminal::StopShell()
 void Terminal::ExecuteCommand(const wxString& command)
 {
     if (!m_process || !m_processInput || !m_processInput->IsOk()) {
-        m_output->AppendText("Shell not running. Restarting...\n");
+        AppendText("Shell not running. Restarting...\n", TerminalStyle::Info);
         StartShell();
         if (!m_process) return;
     }
@@ -281,62 +298,50 @@ void Terminal::ExecuteCommand(const wxString& command)
     }
     
     // Echo the command
-    m_output->SetDefaultStyle(wxTextAttr(wxColour(100, 200, 100)));
-    m_output->AppendText("> " + command + "\n");
-    m_output->SetDefaultStyle(wxTextAttr(wxColour(204, 204, 204)));
+    AppendText("> " + command + "\n", TerminalStyle::Command);
     
     // Send to shell
     wxString cmdLine = command + "\n";
     m_processInput->Write(cmdLine.c_str(), cmdLine.length());
     
     // Scroll to end
-    m_output->ShowPosition(m_output->GetLastPosition());
+    m_output->ScrollToEnd();
 }
 
-void Terminal::ReadProcessOutput()
+bool Terminal::ReadProcessOutput()
 {
-    if (!m_process) return;
-    
-    bool hasOutput = false;
-    
-    // Read stdout
-    if (m_processOutput && m_processOutput->CanRead()) {
-        char buffer[4096];
-        while (m_processOutput->CanRead()) {
-            m_processOutput->Read(buffer, sizeof(buffer) - 1);
-            size_t count = m_processOutput->LastRead();
-            if (count > 0) {
-                buffer[count] = '\0';
-                m_output->AppendText(wxString::FromUTF8(buffer, count));
-                hasOutput = true;
-            } else {
-                break;
-            }
-        }
-    }
+    if (!m_process) return true;
     
-    // Read stderr
-    if (m_processError && m_processError->CanRead()) {
-        char buffer[4096];
-        while (m_processError->CanRead()) {
-            m_processError->Read(buffer, sizeof(buffer) - 1);
-            size_t count = m_processError->LastRead();
-            if (count > 0) {
-                buffer[count] = '\0';
-                // Show errors in red
-                m_output->SetDefaultStyle(wxTextAttr(wxColour(255, 100, 100)));
-                m_output->AppendText(wxString::FromUTF8(buffer, count));
-                m_output->SetDefaultStyle(wxTextAttr(wxColour(204, 204, 204)));
-                hasOutput = true;
-            } else {
-                break;
-            }
-        }
-    }
+    // stderr first: it is usually short and should not wait behind a flood on stdout
+    size_t count = ReadStream(m_processError, TerminalStyle::Error, kOutputBytesPerFrame);
+    count += ReadStream(m_processOutput, TerminalStyle::Output, kOutputBytesPerFrame - count);
     
-    if (hasOutput) {
-        m_output->ShowPosition(m_output->GetLastPosition());
+    if (count > 0) {
+        m_output->BufferChanged();
     }
+    return count < kOutputBytesPerFrame;
+}
+
+size_t Terminal::ReadStream(wxInputStream* stream, TerminalStyle style, size_t budget)
+{
+    size_t total = 0;
+    while (stream && total < budget && stream->CanRead()) {
+        stream->Read(m_readBuffer.data(), std::min(m_readBuffer.size(), budget - total));
+        size_t count = stream->LastRead();
+        if (count == 0) {
+            break;
+        }
+        m_output->Buffer().append(std::string_view(m_readBuffer.data(), count), style);
+        total += count;
+    }
+    return total;
+}
+
+void Terminal::AppendText(const wxString& text, TerminalStyle style)
+{
+    wxScopedCharBuffer utf8 = text.utf8_str();
+    m_output->Buffer().append(std::string_view(utf8.data(), utf8.length()), style);
+    m_output->BufferChanged();
 }
 
 void Terminal::Clear()
@@ -395,22 +400,20 @@ void Terminal::OnInputKeyDown(wxKeyEvent& event)
     }
 }
 
-void Terminal::OnIdle(wxIdleEvent& event)
+void Terminal::OnOutputTimer(wxTimerEvent& event)
 {
     ReadProcessOutput();
-    
-    // Request more idle events if shell is running
-    if (m_process) {
-        event.RequestMore();
-    }
 }
 
 void Terminal::OnProcessTerminated(wxProcessEvent& event)
 {
-    ReadProcessOutput(); // Get any remaining output
+    // Get any remaining output
+    while (!ReadProcessOutput()) {
+    }
+    m_outputTimer.Stop();
     
-    m_output->AppendText("\n[Shell process terminated with exit code: " + 
-                         wxString::Format("%d", event.GetExitCode()) + "]\n");
+    AppendText("\n[Shell process terminated with exit code: " + 
+               wxString::Format("%d", event.GetExitCode()) + "]\n", TerminalStyle::Info);
     
     delete m_process;
     m_process = nullptr;
@@ -4,8 +4,11 @@
 #include <wx/wx.h>
 #include <wx/process.h>
 #include <wx/txtstrm.h>
+#include <wx/timer.h>
 #include <memory>
+#include <vector>
 #include "../theme/theme.h"
+#include "terminal_view.h"
 
 /**
  * SSH connection configuration.
@@ -65,6 +68,10 @@ struct SshConfig {
  * Terminal component for ByteMuseHQ.
  * Provides a simple command-line interface with a persistent shell session.
  * Supports both local and remote (SSH) shell sessions.
+ *
+ * Shell output is collected once per frame into a TerminalView, whose
+ * scrollback is capped at terminal.scrollback lines, so a command that
+ * prints without pause cannot stall the UI or grow memory without bound.
  */
 class Terminal : public wxPanel {
 public:
@@ -95,7 +102,7 @@ public:
     void Reconnect();
 
 private:
-    wxTextCtrl* m_output;       // Output display
+    TerminalView* m_output;     // Output display
     wxTextCtrl* m_input;        // Command input
     wxStaticText* m_label;      // Header label
     wxStaticText* m_prompt;     // Input prompt
@@ -111,6 +118,8 @@ private:
     wxOutputStream* m_processInput;
     wxInputStream* m_processOutput;
     wxInputStream* m_processError;
+    wxTimer m_outputTimer;          // Collects output once per frame
+    std::vector<char> m_readBuffer;
     
     // Command history
     wxArrayString m_history;
@@ -122,8 +131,10 @@ private:
     void StopShell();
     void ApplyCurrentTheme();
     
-    // Read output from shell
-    void ReadProcessOutput();
+    // Read output from shell; false if the per-frame budget ran out first
+    bool ReadProcessOutput();
+    size_t ReadStream(wxInputStream* stream, TerminalStyle style, size_t budget);
+    void AppendText(const wxString& text, TerminalStyle style);
     
     // Get the shell command for the current platform
     static wxString GetShellCommand();
@@ -131,7 +142,7 @@ private:
     // Event handlers
     void OnInputEnter(wxCommandEvent& event);
     void OnInputKeyDown(wxKeyEvent& event);
-    void OnIdle(wxIdleEvent& event);
+    void OnOutputTimer(wxTimerEvent& event);
     void OnProcessTerminated(wxProcessEvent& event);
 
     wxDECLARE_EVENT_TABLE();
@@ -0,0 +1,115 @@
+#include "terminal_buffer.h"
+#include <algorithm>
+
+TerminalBuffer::TerminalBuffer(size_t maxLines) : m_maxLines(std::max<size_t>(maxLines, 1)) {}
+
+void TerminalBuffer::append(std::string_view text, TerminalStyle style) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        if (m_pendingCr) {
+            m_pendingCr = false;
+            if (text[pos] == '\n') {
+                endLine();
+                ++pos;
+                continue;
+            }
+            // Lone \r: what follows overwrites the line
+            if (m_lineOpen) {
+                m_lines.back().text.clear();
+                m_lines.back().runs.clear();
+            }
+        }
+
+        size_t eol = pos;
+        while (eol < text.size() && text[eol] != '\n' && text[eol] != '\r') {
+            ++eol;
+        }
+        if (eol == text.size()) {
+            appendToLine(text.substr(pos), style);
+            break;
+        }
+        appendToLine(text.substr(pos, eol - pos), style);
+        if (text[eol] == '\n') {
+            endLine();
+        } else {
+            m_pendingCr = true;
+        }
+        pos = eol + 1;
+    }
+}
+
+void TerminalBuffer::clear() {
+    m_lines.clear();
+    m_firstLineNumber = 0;
+    m_lineOpen = false;
+    m_pendingCr = false;
+}
+
+void TerminalBuffer::setMaxLines(size_t maxLines) {
+    m_maxLines = std::max<size_t>(maxLines, 1);
+    trim();
+}
+
+// ---------------------------------------------------------------------------
+
+TerminalBuffer::Line& TerminalBuffer::openLine() {
+    if (!m_lineOpen) {
+        if (m_lines.size() >= m_maxLines) {
+            // Full: recycle the oldest line and its allocations
+            Line recycled = std::move(m_lines.front());
+            m_lines.pop_front();
+            ++m_firstLineNumber;
+            recycled.text.clear();
+            recycled.runs.clear();
+            m_lines.push_back(std::move(recycled));
+        } else {
+            m_lines.emplace_back();
+        }
+        m_lineOpen = true;
+        trim();
+    }
+    return m_lines.back();
+}
+
+void TerminalBuffer::appendToLine(std::string_view text, TerminalStyle style) {
+    while (!text.empty()) {
+        Line& line = openLine();
+        size_t take = std::min(kMaxLineLength - line.text.size(), text.size());
+        if (take < text.size()) {
+            // Wrap on a character boundary, not inside a UTF-8 sequence
+            while (take > 0 && (static_cast<unsigned char>(text[take]) & 0xC0) == 0x80) {
+                --take;
+            }
+            if (take == 0) {
+                if (line.text.empty()) {
+                    take = std::min(kMaxLineLength, text.size());
+                } else {
+                    endLine();
+                    continue;
+                }
+            }
+        }
+
+        if (line.runs.empty() || line.runs.back().style != style) {
+            if (!line.runs.empty() && line.runs.back().start == line.text.size()) {
+                line.runs.back().style = style;
+            } else {
+                line.runs.push_back({line.text.size(), style});
+            }
+        }
+        line.text.append(text.data(), take);
+        text.remove_prefix(take);
+    }
+}
+
+void TerminalBuffer::endLine() {
+    openLine();
+    m_lineOpen = false;
+}
+
+void TerminalBuffer::trim() {
+    while (m_lines.size() > m_maxLines) {
+        m_lines.pop_front();
+        ++m_firstLineNumber;
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef TERMINAL_BUFFER_H
+#define TERMINAL_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * What a span of terminal text is; the view picks its colour.
+ */
+enum class TerminalStyle : uint8_t {
+    Output,     // Shell stdout
+    Error,      // Shell stderr
+    Command,    // Echo of a command the user ran
+    Info        // Messages from the terminal itself
+};
+
+/**
+ * Scrollback of the terminal panel.
+ *
+ * Output is appended as raw UTF-8 chunks, split at any byte, and kept as
+ * lines with style runs. At most maxLines lines are kept; the oldest are
+ * dropped as new ones arrive, and firstLineNumber() keeps counting so a
+ * view can hold its position while the buffer scrolls underneath.
+ *
+ * \r\n ends a line like \n. A lone \r returns to the start of the line, so
+ * the next text replaces it (progress bars redraw in place). Lines longer
+ * than kMaxLineLength bytes are wrapped, keeping a line without newlines
+ * from growing without bound.
+ */
+class TerminalBuffer {
+public:
+    static constexpr size_t kDefaultMaxLines = 10000;
+    static constexpr size_t kMaxLineLength = 4096;
+
+    /** Text from start (a byte offset) up to the next run has this style. */
+    struct Run {
+        size_t start;
+        TerminalStyle style;
+    };
+
+    struct Line {
+        std::string text;
+        std::vector<Run> runs;
+    };
+
+    explicit TerminalBuffer(size_t maxLines = kDefaultMaxLines);
+
+    void append(std::string_view text, TerminalStyle style);
+    void clear();
+
+    /** Change the scrollback cap (at least one line), dropping lines over it. */
+    void setMaxLines(size_t maxLines);
+    size_t maxLines() const { return m_maxLines; }
+
+    /** Lines held, including an unterminated last line. */
+    size_t lineCount() const { return m_lines.size(); }
+    const Line& line(size_t index) const { return m_lines[index]; }
+
+    /** Number of line(0) since the buffer was created or cleared. */
+    uint64_t firstLineNumber() const { return m_firstLineNumber; }
+
+private:
+    std::deque<Line> m_lines;
+    size_t m_maxLines;
+    uint64_t m_firstLineNumber = 0;
+    bool m_lineOpen = false;        // Last line is still receiving text
+    bool m_pendingCr = false;       // Previous chunk ended in \r
+
+    Line& openLine();
+    void appendToLine(std::string_view text, TerminalStyle style);
+    void endLine();
+    void trim();
+};
+
+#endif // TERMINAL_BUFFER_H
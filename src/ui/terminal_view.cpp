@@ -0,0 +1,379 @@
+#include "terminal_view.h"
+#include <wx/dcbuffer.h>
+#include <wx/clipbrd.h>
+#include <algorithm>
+
+TerminalView::TerminalView(wxWindow* parent, wxWindowID id)
+    : wxWindow(parent, id, wxDefaultPosition, wxDefaultSize,
+               wxVSCROLL | wxHSCROLL | wxWANTS_CHARS | wxBORDER_THEME)
+{
+    SetBackgroundStyle(wxBG_STYLE_PAINT);
+    SetCursor(wxCursor(wxCURSOR_IBEAM));
+
+    m_styleColours[static_cast<int>(TerminalStyle::Output)] = wxColour(204, 204, 204);
+    m_styleColours[static_cast<int>(TerminalStyle::Error)] = wxColour(255, 100, 100);
+    m_styleColours[static_cast<int>(TerminalStyle::Command)] = wxColour(100, 200, 100);
+    m_styleColours[static_cast<int>(TerminalStyle::Info)] = wxColour(204, 204, 204);
+
+    Bind(wxEVT_PAINT, &TerminalView::OnPaint, this);
+    Bind(wxEVT_SIZE, &TerminalView::OnSize, this);
+    Bind(wxEVT_MOUSEWHEEL, &TerminalView::OnMouseWheel, this);
+    Bind(wxEVT_LEFT_DOWN, &TerminalView::OnLeftDown, this);
+    Bind(wxEVT_MOTION, &TerminalView::OnMotion, this);
+    Bind(wxEVT_LEFT_UP, &TerminalView::OnLeftUp, this);
+    Bind(wxEVT_MOUSE_CAPTURE_LOST, &TerminalView::OnCaptureLost, this);
+    Bind(wxEVT_KEY_DOWN, &TerminalView::OnKeyDown, this);
+    Bind(wxEVT_RIGHT_DOWN, [this](wxMouseEvent& event) {
+        wxMenu menu;
+        menu.Append(wxID_COPY, "Copy");
+        menu.Append(wxID_SELECTALL, "Select All");
+        menu.Enable(wxID_COPY, m_hasSelection);
+        menu.Bind(wxEVT_MENU, [this](wxCommandEvent&) { CopySelection(); }, wxID_COPY);
+        menu.Bind(wxEVT_MENU, [this](wxCommandEvent&) { SelectAll(); }, wxID_SELECTALL);
+        PopupMenu(&menu, event.GetPosition());
+    });
+    Bind(wxEVT_SCROLLWIN_TOP, &TerminalView::OnScroll, this);
+    Bind(wxEVT_SCROLLWIN_BOTTOM, &TerminalView::OnScroll, this);
+    Bind(wxEVT_SCROLLWIN_LINEUP, &TerminalView::OnScroll, this);
+    Bind(wxEVT_SCROLLWIN_LINEDOWN, &TerminalView::OnScroll, this);
+    Bind(wxEVT_SCROLLWIN_PAGEUP, &TerminalView::OnScroll, this);
+    Bind(wxEVT_SCROLLWIN_PAGEDOWN, &TerminalView::OnScroll, this);
+    Bind(wxEVT_SCROLLWIN_THUMBTRACK, &TerminalView::OnScroll, this);
+    Bind(wxEVT_SCROLLWIN_THUMBRELEASE, &TerminalView::OnScroll, this);
+
+    SetFont(wxFont(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+}
+
+void TerminalView::BufferChanged()
+{
+    uint64_t first = m_buffer.firstLineNumber();
+    uint64_t lastTop = std::max<uint64_t>(first, EndLine() - std::min<uint64_t>(EndLine(), VisibleLines()));
+    if (m_followTail) {
+        m_topLine = lastTop;
+    } else {
+        m_topLine = std::clamp(m_topLine, first, lastTop);
+    }
+    UpdateScrollbars();
+    Refresh(false);
+}
+
+void TerminalView::Clear()
+{
+    m_buffer.clear();
+    m_topLine = 0;
+    m_leftColumn = 0;
+    m_followTail = true;
+    m_hasSelection = false;
+    UpdateScrollbars();
+    Refresh(false);
+}
+
+void TerminalView::ScrollToEnd()
+{
+    m_followTail = true;
+    BufferChanged();
+}
+
+void TerminalView::SetStyleColour(TerminalStyle style, const wxColour& colour)
+{
+    m_styleColours[static_cast<int>(style)] = colour;
+    Refresh(false);
+}
+
+bool TerminalView::SetFont(const wxFont& font)
+{
+    bool changed = wxWindow::SetFont(font);
+    MeasureFont();
+    BufferChanged();
+    return changed;
+}
+
+// ---------------------------------------------------------------------------
+
+int TerminalView::VisibleLines() const
+{
+    return std::max(1, GetClientSize().GetHeight() / m_lineHeight);
+}
+
+int TerminalView::VisibleColumns() const
+{
+    return std::max(1, GetClientSize().GetWidth() / m_charWidth);
+}
+
+uint64_t TerminalView::EndLine() const
+{
+    return m_buffer.firstLineNumber() + m_buffer.lineCount();
+}
+
+void TerminalView::ScrollToLine(int64_t line)
+{
+    int64_t first = static_cast<int64_t>(m_buffer.firstLineNumber());
+    int64_t lastTop = std::max(first, static_cast<int64_t>(EndLine()) - VisibleLines());
+    m_topLine = static_cast<uint64_t>(std::clamp(line, first, lastTop));
+    m_followTail = (m_topLine == static_cast<uint64_t>(lastTop));
+    UpdateScrollbars();
+    Refresh(false);
+}
+
+void TerminalView::UpdateScrollbars()
+{
+    int visibleLines = VisibleLines();
+    SetScrollbar(wxVERTICAL, static_cast<int>(m_topLine - m_buffer.firstLineNumber()),
+                 visibleLines, static_cast<int>(m_buffer.lineCount()));
+
+    // Only the lines on screen count towards the horizontal range
+    size_t widest = 0;
+    for (uint64_t line = m_topLine; line < std::min<uint64_t>(EndLine(), m_topLine + visibleLines); ++line) {
+        widest = std::max(widest, LineText(line).length());
+    }
+    int visibleColumns = VisibleColumns();
+    if (widest <= static_cast<size_t>(visibleColumns)) {
+        m_leftColumn = 0;
+    } else {
+        m_leftColumn = std::min(m_leftColumn, widest - visibleColumns);
+    }
+    SetScrollbar(wxHORIZONTAL, static_cast<int>(m_leftColumn), visibleColumns, static_cast<int>(widest));
+}
+
+void TerminalView::MeasureFont()
+{
+    wxClientDC dc(this);
+    dc.SetFont(GetFont());
+    wxSize extent = dc.GetTextExtent("M");
+    m_charWidth = std::max(1, extent.GetWidth());
+    m_lineHeight = std::max(1, extent.GetHeight());
+}
+
+TerminalView::Position TerminalView::HitTest(const wxPoint& point) const
+{
+    Position position;
+    if (m_buffer.lineCount() == 0) {
+        return position;
+    }
+    int row = std::max(0, point.y) / m_lineHeight;
+    position.line = std::min<uint64_t>(m_topLine + row, EndLine() - 1);
+    size_t column = m_leftColumn + (std::max(0, point.x) + m_charWidth / 2) / m_charWidth;
+    position.column = std::min(column, LineText(position.line).length());
+    return position;
+}
+
+wxString TerminalView::LineText(uint64_t line) const
+{
+    uint64_t first = m_buffer.firstLineNumber();
+    if (line < first || line >= EndLine()) {
+        return wxString();
+    }
+    const std::string& text = m_buffer.line(line - first).text;
+    return wxString::FromUTF8(text.data(), text.size());
+}
+
+wxString TerminalView::SelectedText() const
+{
+    if (!m_hasSelection) {
+        return wxString();
+    }
+    Position start = std::min(m_anchor, m_caret);
+    Position end = std::max(m_anchor, m_caret);
+    if (start.line < m_buffer.firstLineNumber()) {
+        start = {m_buffer.firstLineNumber(), 0};    // Scrolled out of the buffer
+    }
+
+    wxString result;
+    for (uint64_t line = start.line; line <= end.line && line < EndLine(); ++line) {
+        wxString text = LineText(line);
+        size_t from = (line == start.line) ? start.column : 0;
+        size_t to = (line == end.line) ? end.column : text.length();
+        if (from < to) {
+            result += text.Mid(from, to - from);
+        }
+        if (line != end.line) {
+            result += "\n";
+        }
+    }
+    return result;
+}
+
+void TerminalView::SelectAll()
+{
+    if (m_buffer.lineCount() == 0) {
+        return;
+    }
+    m_anchor = {m_buffer.firstLineNumber(), 0};
+    m_caret = {EndLine() - 1, LineText(EndLine() - 1).length()};
+    m_hasSelection = true;
+    Refresh(false);
+}
+
+void TerminalView::CopySelection()
+{
+    wxString text = SelectedText();
+    if (text.IsEmpty()) {
+        return;
+    }
+    if (wxTheClipboard->Open()) {
+        wxTheClipboard->SetData(new wxTextDataObject(text));
+        wxTheClipboard->Close();
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void TerminalView::OnPaint(wxPaintEvent& event)
+{
+    wxAutoBufferedPaintDC dc(this);
+    dc.SetBackground(wxBrush(GetBackgroundColour()));
+    dc.Clear();
+    dc.SetFont(GetFont());
+
+    Position selStart = std::min(m_anchor, m_caret);
+    Position selEnd = std::max(m_anchor, m_caret);
+    size_t visibleColumns = static_cast<size_t>(VisibleColumns()) + 1;
+    uint64_t first = m_buffer.firstLineNumber();
+    int visibleLines = VisibleLines() + 1;      // Include a partly visible last row
+
+    for (int row = 0; row < visibleLines; ++row) {
+        uint64_t lineNumber = m_topLine + row;
+        if (lineNumber >= EndLine()) {
+            break;
+        }
+        const TerminalBuffer::Line& line = m_buffer.line(lineNumber - first);
+        int y = row * m_lineHeight;
+
+        if (m_hasSelection && lineNumber >= selStart.line && lineNumber <= selEnd.line) {
+            size_t from = (lineNumber == selStart.line) ? selStart.column : 0;
+            // Past the end of the line marks the selected line break
+            size_t to = (lineNumber == selEnd.line) ? selEnd.column : LineText(lineNumber).length() + 1;
+            if (to > m_leftColumn && from < to) {
+                size_t left = std::max(from, m_leftColumn);
+                dc.SetPen(*wxTRANSPARENT_PEN);
+                dc.SetBrush(wxBrush(m_selectionColour));
+                dc.DrawRectangle(static_cast<int>(left - m_leftColumn) * m_charWidth, y,
+                                 static_cast<int>(to - left) * m_charWidth, m_lineHeight);
+            }
+        }
+
+        size_t column = 0;
+        for (size_t i = 0; i < line.runs.size() && column < m_leftColumn + visibleColumns; ++i) {
+            size_t start = line.runs[i].start;
+            size_t end = (i + 1 < line.runs.size()) ? line.runs[i + 1].start : line.text.size();
+            wxString segment = wxString::FromUTF8(line.text.data() + start, end - start);
+            size_t length = segment.length();
+
+            size_t from = std::max(column, m_leftColumn);
+            size_t to = std::min(column + length, m_leftColumn + visibleColumns);
+            if (from < to) {
+                dc.SetTextForeground(m_styleColours[static_cast<int>(line.runs[i].style)]);
+                dc.DrawText(segment.Mid(from - column, to - from),
+                            static_cast<int>(from - m_leftColumn) * m_charWidth, y);
+            }
+            column += length;
+        }
+    }
+}
+
+void TerminalView::OnSize(wxSizeEvent& event)
+{
+    BufferChanged();
+    event.Skip();
+}
+
+void TerminalView::OnScroll(wxScrollWinEvent& event)
+{
+    bool vertical = (event.GetOrientation() == wxVERTICAL);
+    int position = GetScrollPos(event.GetOrientation());
+    int page = vertical ? VisibleLines() : VisibleColumns();
+    int range = GetScrollRange(event.GetOrientation());
+
+    wxEventType type = event.GetEventType();
+    if (type == wxEVT_SCROLLWIN_TOP) position = 0;
+    else if (type == wxEVT_SCROLLWIN_BOTTOM) position = range;
+    else if (type == wxEVT_SCROLLWIN_LINEUP) position -= 1;
+    else if (type == wxEVT_SCROLLWIN_LINEDOWN) position += 1;
+    else if (type == wxEVT_SCROLLWIN_PAGEUP) position -= page;
+    else if (type == wxEVT_SCROLLWIN_PAGEDOWN) position += page;
+    else position = event.GetPosition();
+
+    if (vertical) {
+        ScrollToLine(static_cast<int64_t>(m_buffer.firstLineNumber()) + position);
+    } else {
+        m_leftColumn = static_cast<size_t>(std::clamp(position, 0, std::max(0, range - page)));
+        UpdateScrollbars();
+        Refresh(false);
+    }
+}
+
+void TerminalView::OnMouseWheel(wxMouseEvent& event)
+{
+    int steps = event.GetWheelRotation() / std::max(1, event.GetWheelDelta());
+    if (event.GetWheelAxis() == wxMOUSE_WHEEL_HORIZONTAL) {
+        int64_t column = static_cast<int64_t>(m_leftColumn) + steps * event.GetLinesPerAction();
+        m_leftColumn = static_cast<size_t>(std::max<int64_t>(0, column));
+        UpdateScrollbars();
+        Refresh(false);
+    } else {
+        ScrollToLine(static_cast<int64_t>(m_topLine) - steps * event.GetLinesPerAction());
+    }
+}
+
+void TerminalView::OnLeftDown(wxMouseEvent& event)
+{
+    SetFocus();
+    m_anchor = HitTest(event.GetPosition());
+    m_caret = m_anchor;
+    m_hasSelection = false;
+    m_selecting = true;
+    CaptureMouse();
+    Refresh(false);
+}
+
+void TerminalView::OnMotion(wxMouseEvent& event)
+{
+    if (!m_selecting || !event.LeftIsDown()) {
+        return;
+    }
+    // Dragging past the edge scrolls
+    wxPoint point = event.GetPosition();
+    if (point.y < 0) {
+        ScrollToLine(static_cast<int64_t>(m_topLine) - 1);
+    } else if (point.y > GetClientSize().GetHeight()) {
+        ScrollToLine(static_cast<int64_t>(m_topLine) + 1);
+    }
+    m_caret = HitTest(point);
+    m_hasSelection = (m_anchor < m_caret || m_caret < m_anchor);
+    Refresh(false);
+}
+
+void TerminalView::OnLeftUp(wxMouseEvent& event)
+{
+    if (m_selecting) {
+        m_selecting = false;
+        if (HasCapture()) {
+            ReleaseMouse();
+        }
+    }
+}
+
+void TerminalView::OnCaptureLost(wxMouseCaptureLostEvent& event)
+{
+    m_selecting = false;
+}
+
+void TerminalView::OnKeyDown(wxKeyEvent& event)
+{
+    int key = event.GetKeyCode();
+    if (event.ControlDown() && key == 'C') {
+        CopySelection();
+    } else if (event.ControlDown() && key == 'A') {
+        SelectAll();
+    } else if (key == WXK_PAGEUP) {
+        ScrollToLine(static_cast<int64_t>(m_topLine) - VisibleLines());
+    } else if (key == WXK_PAGEDOWN) {
+        ScrollToLine(static_cast<int64_t>(m_topLine) + VisibleLines());
+    } else if (event.ControlDown() && key == WXK_HOME) {
+        ScrollToLine(static_cast<int64_t>(m_buffer.firstLineNumber()));
+    } else if (event.ControlDown() && key == WXK_END) {
+        ScrollToEnd();
+    } else {
+        event.Skip();
+    }
+}
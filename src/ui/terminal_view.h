@@ -0,0 +1,87 @@
+#ifndef TERMINAL_VIEW_H
+#define TERMINAL_VIEW_H
+
+#include <wx/wx.h>
+#include <cstdint>
+#include "terminal_buffer.h"
+
+/**
+ * Output area of the terminal panel.
+ *
+ * Draws the lines of a TerminalBuffer that fall in the viewport and
+ * nothing else, so painting costs the same with ten lines of scrollback
+ * or a hundred thousand. Owners append to Buffer() as output arrives and
+ * call BufferChanged() once per batch. While scrolled to the bottom the
+ * view follows new output; scrolled up, it stays on the lines shown even
+ * as old ones are dropped.
+ *
+ * Text is selected with the mouse and copied with Ctrl+C (Cmd+C on macOS);
+ * Ctrl+A selects everything.
+ */
+class TerminalView : public wxWindow {
+public:
+    TerminalView(wxWindow* parent, wxWindowID id = wxID_ANY);
+
+    TerminalBuffer& Buffer() { return m_buffer; }
+
+    /** Update scrollbars and repaint after appending to Buffer(). */
+    void BufferChanged();
+
+    /** Empty the buffer. */
+    void Clear();
+
+    void ScrollToEnd();
+
+    void SetStyleColour(TerminalStyle style, const wxColour& colour);
+    void SetSelectionColour(const wxColour& colour) { m_selectionColour = colour; }
+
+    bool SetFont(const wxFont& font) override;
+
+private:
+    /** A character position; line is absolute (see TerminalBuffer::firstLineNumber). */
+    struct Position {
+        uint64_t line = 0;
+        size_t column = 0;
+        bool operator<(const Position& other) const {
+            return line < other.line || (line == other.line && column < other.column);
+        }
+    };
+
+    TerminalBuffer m_buffer;
+    uint64_t m_topLine = 0;         // Absolute number of the first visible line
+    size_t m_leftColumn = 0;
+    bool m_followTail = true;
+    wxColour m_styleColours[4];
+    wxColour m_selectionColour = wxColour(38, 79, 120);
+    int m_charWidth = 8;
+    int m_lineHeight = 16;
+
+    bool m_hasSelection = false;
+    bool m_selecting = false;
+    Position m_anchor;
+    Position m_caret;
+
+    int VisibleLines() const;
+    int VisibleColumns() const;
+    uint64_t EndLine() const;       // One past the last absolute line
+    void ScrollToLine(int64_t line);
+    void UpdateScrollbars();
+    void MeasureFont();
+    Position HitTest(const wxPoint& point) const;
+    wxString LineText(uint64_t line) const;
+    wxString SelectedText() const;
+    void SelectAll();
+    void CopySelection();
+
+    void OnPaint(wxPaintEvent& event);
+    void OnSize(wxSizeEvent& event);
+    void OnScroll(wxScrollWinEvent& event);
+    void OnMouseWheel(wxMouseEvent& event);
+    void OnLeftDown(wxMouseEvent& event);
+    void OnMotion(wxMouseEvent& event);
+    void OnLeftUp(wxMouseEvent& event);
+    void OnCaptureLost(wxMouseCaptureLostEvent& event);
+    void OnKeyDown(wxKeyEvent& event);
+};
+
+#endif // TERMINAL_VIEW_H
@@ -0,0 +1,204 @@
+/**
+ * Unit tests for the asynchronous HTTP engine, against a small local server.
+ */
+
+#include <gtest/gtest.h>
+#include "http/async_http.h"
+
+#ifndef _WIN32
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Http;
+using namespace std::chrono_literals;
+
+namespace {
+
+/**
+ * Keep-alive HTTP/1.1 server answering GET /<delay ms>/<tag> with the tag
+ * after the delay.
+ */
+class TestServer {
+public:
+    TestServer() {
+        m_listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(m_listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        socklen_t len = sizeof(addr);
+        getsockname(m_listener, reinterpret_cast<sockaddr*>(&addr), &len);
+        m_port = ntohs(addr.sin_port);
+        listen(m_listener, 16);
+        m_acceptThread = std::thread([this] { acceptLoop(); });
+    }
+
+    ~TestServer() {
+        shutdown(m_listener, SHUT_RDWR);
+        close(m_listener);
+        m_acceptThread.join();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int fd : m_connections) {
+            shutdown(fd, SHUT_RDWR);
+        }
+        for (auto& thread : m_connectionThreads) {
+            thread.join();
+        }
+    }
+
+    std::string url(int delayMs, const std::string& tag) const {
+        return "http://127.0.0.1:" + std::to_string(m_port) + "/" + std::to_string(delayMs) + "/" + tag;
+    }
+
+private:
+    int m_listener = -1;
+    int m_port = 0;
+    std::thread m_acceptThread;
+    std::mutex m_mutex;
+    std::vector<int> m_connections;
+    std::vector<std::thread> m_connectionThreads;
+
+    void acceptLoop() {
+        while (true) {
+            int fd = accept(m_listener, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_connections.push_back(fd);
+            m_connectionThreads.emplace_back([fd] { serve(fd); });
+        }
+    }
+
+    static void serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        while (true) {
+            size_t headerEnd;
+            while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = read(fd, chunk, sizeof(chunk));
+                if (n <= 0) {
+                    close(fd);
+                    return;
+                }
+                buffer.append(chunk, n);
+            }
+            std::string requestLine = buffer.substr(0, buffer.find("\r\n"));
+            buffer.erase(0, headerEnd + 4);
+
+            // "GET /<delay>/<tag> HTTP/1.1"
+            size_t pathStart = requestLine.find('/') + 1;
+            size_t slash = requestLine.find('/', pathStart);
+            int delayMs = std::stoi(requestLine.substr(pathStart, slash - pathStart));
+            std::string tag = requestLine.substr(slash + 1, requestLine.find(' ', slash) - slash - 1);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+            std::string response = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(tag.size()) +
+                                   "\r\n\r\n" + tag;
+            if (send(fd, response.data(), response.size(), MSG_NOSIGNAL) < 0) {
+                close(fd);
+                return;
+            }
+        }
+    }
+};
+
+HttpRequest get(const std::string& url) {
+    HttpRequest request;
+    request.url = url;
+    return request;
+}
+
+} // namespace
+
+// Test that concurrent requests overlap on the engine thread
+TEST(AsyncClientTest, RunsRequestsConcurrently) {
+    TestServer server;
+    AsyncClient client(8);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<HttpResponse>> futures;
+    for (int i = 0; i < 5; ++i) {
+        futures.push_back(client.submit(get(server.url(200, "r" + std::to_string(i)))));
+    }
+    for (int i = 0; i < 5; ++i) {
+        HttpResponse response = futures[i].get();
+        ASSERT_TRUE(response.isOk()) << response.error;
+        EXPECT_EQ(response.body, "r" + std::to_string(i));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 800ms);
+}
+
+// Test that waiting requests start by priority, then in submission order
+TEST(AsyncClientTest, StartsHigherPriorityFirst) {
+    TestServer server;
+    AsyncClient client(1);
+
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto record = [&](HttpResponse response) {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(response.body);
+    };
+
+    auto blocker = client.submit(get(server.url(200, "block")));
+    std::this_thread::sleep_for(50ms);
+    client.submit(get(server.url(0, "bg")), record, Priority::Background);
+    client.submit(get(server.url(0, "normal1")), record, Priority::Normal);
+    client.submit(get(server.url(0, "hi")), record, Priority::Interactive);
+    client.submit(get(server.url(0, "normal2")), record, Priority::Normal);
+    blocker.get();
+
+    auto last = client.submit(get(server.url(0, "last")), Priority::Background);
+    last.get();
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(order, (std::vector<std::string>{"hi", "normal1", "normal2", "bg"}));
+}
+
+// Test that queued and running requests stop once their token trips
+TEST(AsyncClientTest, CancelsQueuedAndRunningRequests) {
+    TestServer server;
+    AsyncClient client(1);
+
+    HttpRequest running = get(server.url(2000, "slow"));
+    HttpRequest queued = get(server.url(0, "queued"));
+    CancellationToken runningToken = running.cancel;
+    CancellationToken queuedToken = queued.cancel;
+
+    auto start = std::chrono::steady_clock::now();
+    auto runningFuture = client.submit(running);
+    auto queuedFuture = client.submit(queued);
+    std::this_thread::sleep_for(50ms);
+
+    queuedToken.cancel();
+    HttpResponse queuedResponse = queuedFuture.get();
+    EXPECT_TRUE(queuedResponse.cancelled);
+
+    runningToken.cancel();
+    HttpResponse runningResponse = runningFuture.get();
+    EXPECT_TRUE(runningResponse.cancelled);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
+
+// Test that requests still queued at destruction complete as cancelled
+TEST(AsyncClientTest, CompletesPendingRequestsOnShutdown) {
+    TestServer server;
+    std::future<HttpResponse> pending;
+    {
+        AsyncClient client(1);
+        client.submit(get(server.url(300, "busy")), nullptr);
+        std::this_thread::sleep_for(50ms);
+        pending = client.submit(get(server.url(0, "never")));
+    }
+    EXPECT_TRUE(pending.get().cancelled);
+}
+
+#endif // _WIN32
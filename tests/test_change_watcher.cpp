@@ -0,0 +1,129 @@
+/**
+ * Unit tests for change coalescing and the remote watcher's parsing.
+ */
+
+#include <gtest/gtest.h>
+#include "fs/change_watcher.h"
+#include <string>
+#include <vector>
+
+using namespace FS;
+using Kind = FileChange::Kind;
+
+namespace {
+
+std::vector<std::string> describe(const std::vector<FileChange>& changes) {
+    std::vector<std::string> result;
+    for (const auto& change : changes) {
+        const char* kind = change.kind == Kind::Created ? "+" : change.kind == Kind::Deleted ? "-" : "~";
+        result.push_back(kind + change.path + (change.isDirectory ? "/" : ""));
+    }
+    return result;
+}
+
+} // namespace
+
+// Test that a burst folds into one change per path, in first-seen order
+TEST(ChangeCoalescerTest, FoldsBursts) {
+    ChangeCoalescer coalescer;
+    EXPECT_TRUE(coalescer.empty());
+
+    coalescer.add({Kind::Modified, "/w/a.cpp"});
+    coalescer.add({Kind::Created, "/w/new.cpp"});
+    coalescer.add({Kind::Modified, "/w/new.cpp"});      // Created wins
+    coalescer.add({Kind::Created, "/w/tmp.swp"});
+    coalescer.add({Kind::Deleted, "/w/tmp.swp"});       // Never existed as far as anyone knows
+    coalescer.add({Kind::Deleted, "/w/b.cpp"});
+    coalescer.add({Kind::Created, "/w/b.cpp"});         // Atomic save
+    coalescer.add({Kind::Modified, "/w/a.cpp"});
+    coalescer.add({Kind::Deleted, "/w/a.cpp"});
+    coalescer.add({Kind::Created, "/w/dir", true});
+
+    EXPECT_EQ(coalescer.size(), 4u);
+    EXPECT_EQ(describe(coalescer.take()),
+              (std::vector<std::string>{"-/w/a.cpp", "+/w/new.cpp", "~/w/b.cpp", "+/w/dir/"}));
+    EXPECT_TRUE(coalescer.empty());
+    EXPECT_TRUE(coalescer.take().empty());
+}
+
+// Test that a path dropped within a burst can come back in it
+TEST(ChangeCoalescerTest, DroppedPathsReturn) {
+    ChangeCoalescer coalescer;
+    coalescer.add({Kind::Created, "/w/x"});
+    coalescer.add({Kind::Deleted, "/w/x"});
+    EXPECT_TRUE(coalescer.empty());
+
+    coalescer.add({Kind::Created, "/w/x"});
+    EXPECT_EQ(describe(coalescer.take()), (std::vector<std::string>{"+/w/x"}));
+}
+
+// Test parsing of inotifywait output lines
+TEST(RemoteWatcherTest, ParsesEvents) {
+    FileChange change;
+    ASSERT_TRUE(RemoteWatcher::ParseEvent("CLOSE_WRITE,CLOSE|/w/src/a.cpp", change));
+    EXPECT_EQ(change.kind, Kind::Modified);
+    EXPECT_EQ(change.path, "/w/src/a.cpp");
+    EXPECT_FALSE(change.isDirectory);
+
+    ASSERT_TRUE(RemoteWatcher::ParseEvent("CREATE,ISDIR|/w/new dir", change));
+    EXPECT_EQ(change.kind, Kind::Created);
+    EXPECT_EQ(change.path, "/w/new dir");
+    EXPECT_TRUE(change.isDirectory);
+
+    ASSERT_TRUE(RemoteWatcher::ParseEvent("MOVED_FROM|/w/a|b.txt", change));
+    EXPECT_EQ(change.kind, Kind::Deleted);
+    EXPECT_EQ(change.path, "/w/a|b.txt");
+    EXPECT_FALSE(change.isDirectory);
+
+    ASSERT_TRUE(RemoteWatcher::ParseEvent("MOVED_TO|/w/b.txt", change));
+    EXPECT_EQ(change.kind, Kind::Created);
+
+    EXPECT_FALSE(RemoteWatcher::ParseEvent("", change));               // Heartbeat
+    EXPECT_FALSE(RemoteWatcher::ParseEvent("OPEN|/w/a.cpp", change));
+    EXPECT_FALSE(RemoteWatcher::ParseEvent("garbage", change));
+    EXPECT_FALSE(RemoteWatcher::ParseEvent("DELETE|", change));
+}
+
+// Test that only visible paths below the root are reported
+TEST(RemoteWatcherTest, IgnoresHiddenAndSkippedPaths) {
+    std::vector<std::string> skip = {"node_modules", "build"};
+    EXPECT_FALSE(RemoteWatcher::IsIgnored("/w", "/w/src/a.cpp", skip));
+    EXPECT_FALSE(RemoteWatcher::IsIgnored("/w", "/w/builder/a.cpp", skip));
+    EXPECT_TRUE(RemoteWatcher::IsIgnored("/w", "/w/.git/index", skip));
+    EXPECT_TRUE(RemoteWatcher::IsIgnored("/w", "/w/src/.a.cpp.swp", skip));
+    EXPECT_TRUE(RemoteWatcher::IsIgnored("/w", "/w/build", skip));
+    EXPECT_TRUE(RemoteWatcher::IsIgnored("/w", "/w/web/node_modules/x.js", skip));
+    EXPECT_TRUE(RemoteWatcher::IsIgnored("/w", "/w", skip));
+    EXPECT_TRUE(RemoteWatcher::IsIgnored("/w", "/wx/a.cpp", skip));
+    EXPECT_TRUE(RemoteWatcher::IsIgnored("/w", "/other/a.cpp", skip));
+    EXPECT_FALSE(RemoteWatcher::IsIgnored("/", "/etc/hosts", skip));
+}
+
+// Test that comparing two walks finds what the polling fallback reports
+TEST(RemoteWatcherTest, DiffsSnapshots) {
+    RemoteWatcher::Snapshot before = {
+        {"/w/a.cpp", {100, 10, false}},
+        {"/w/b.cpp", {100, 10, false}},
+        {"/w/gone", {100, 0, true}},
+        {"/w/src", {100, 0, true}},
+    };
+    RemoteWatcher::Snapshot after = {
+        {"/w/a.cpp", {100, 10, false}},
+        {"/w/b.cpp", {200, 12, false}},
+        {"/w/src", {200, 0, true}},         // Only its mtime moved
+        {"/w/src/c.cpp", {200, 5, false}},
+    };
+
+    EXPECT_EQ(describe(RemoteWatcher::Diff(before, after)),
+              (std::vector<std::string>{"~/w/b.cpp", "-/w/gone/", "+/w/src/c.cpp"}));
+    EXPECT_TRUE(RemoteWatcher::Diff(after, after).empty());
+}
+
+// Test that the watch command checks for inotifywait and excludes skipped directories
+TEST(RemoteWatcherTest, BuildsWatchCommand) {
+    std::string command = RemoteWatcher::WatchCommand("/home/me/work", {"node_modules", "a.b"});
+    EXPECT_EQ(command.rfind("sh -c '", 0), 0u);
+    EXPECT_NE(command.find("inotifywait -m -r"), std::string::npos);
+    EXPECT_NE(command.find("exit 127"), std::string::npos);
+    EXPECT_NE(command.find("node_modules|a\\.b"), std::string::npos);
+}
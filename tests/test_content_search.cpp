@@ -0,0 +1,171 @@
+/**
+ * Unit tests for the parallel content search engine.
+ */
+
+#include <gtest/gtest.h>
+#include "fs/content_search.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace FS;
+
+namespace {
+
+class ContentSearchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_root = std::filesystem::temp_directory_path() /
+                 ("bytemuse-content-search-test-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()));
+        std::filesystem::remove_all(m_root);
+        std::filesystem::create_directories(m_root);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_root);
+    }
+
+    void writeFile(const std::string& relPath, const std::string& content) {
+        auto path = m_root / relPath;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    std::string path(const std::string& relPath) const {
+        return (m_root / relPath).string();
+    }
+
+    std::filesystem::path m_root;
+};
+
+std::vector<ContentMatch> searchBuffer(const std::string& text, const std::string& query,
+                                       bool caseSensitive = false, size_t max = 100) {
+    std::vector<ContentMatch> matches;
+    LiteralMatcher matcher(query, caseSensitive);
+    ContentSearch::SearchBuffer(text.data(), text.size(), matcher, "f", max, matches);
+    return matches;
+}
+
+} // namespace
+
+// Test that the matcher folds case without touching the haystack
+TEST(LiteralMatcherTest, FindsWithAndWithoutCase) {
+    std::string text = "alpha Beta gamma BETA beta";
+    LiteralMatcher folded("beta", false);
+    const char* hit = folded.find(text.data(), text.data() + text.size());
+    ASSERT_NE(hit, nullptr);
+    EXPECT_EQ(hit - text.data(), 6);
+
+    LiteralMatcher exact("beta", true);
+    hit = exact.find(text.data(), text.data() + text.size());
+    ASSERT_NE(hit, nullptr);
+    EXPECT_EQ(hit - text.data(), 22);
+
+    LiteralMatcher missing("delta", false);
+    EXPECT_EQ(missing.find(text.data(), text.data() + text.size()), nullptr);
+}
+
+// Test that a match at the very end of the buffer is found and none past it
+TEST(LiteralMatcherTest, HandlesBufferEdges) {
+    std::string text = "xxab";
+    LiteralMatcher matcher("AB", false);
+    EXPECT_EQ(matcher.find(text.data(), text.data() + text.size()), text.data() + 2);
+    EXPECT_EQ(matcher.find(text.data(), text.data() + 3), nullptr);
+}
+
+// Test line and column reporting, one match per line, and CRLF trimming
+TEST(ContentSearchBufferTest, ReportsLinesAndColumns) {
+    auto matches = searchBuffer("first line\r\nfoo and foo\n\nlast Foo", "foo");
+    ASSERT_EQ(matches.size(), 2u);
+    EXPECT_EQ(matches[0].line, 2);
+    EXPECT_EQ(matches[0].column, 1);
+    EXPECT_EQ(matches[0].content, "foo and foo");
+    EXPECT_EQ(matches[1].line, 4);
+    EXPECT_EQ(matches[1].column, 6);
+    EXPECT_EQ(matches[1].content, "last Foo");
+}
+
+// Test that long lines are trimmed around the match
+TEST(ContentSearchBufferTest, TrimsLongLines) {
+    std::string line(300, 'x');
+    line.replace(200, 6, "needle");
+    auto matches = searchBuffer(line, "needle");
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].column, 201);
+    EXPECT_EQ(matches[0].content, "..." + line.substr(150, 150) + "...");
+}
+
+// Test wildcard file name patterns
+TEST(ContentSearchWildcardTest, MatchesStarsAndQuestionMarks) {
+    EXPECT_TRUE(ContentSearch::WildcardMatch("*", "anything"));
+    EXPECT_TRUE(ContentSearch::WildcardMatch("*.cpp", "main.cpp"));
+    EXPECT_FALSE(ContentSearch::WildcardMatch("*.cpp", "main.h"));
+    EXPECT_TRUE(ContentSearch::WildcardMatch("test_?.py", "test_a.py"));
+    EXPECT_FALSE(ContentSearch::WildcardMatch("test_?.py", "test_ab.py"));
+    EXPECT_TRUE(ContentSearch::WildcardMatch("*a*b*", "xxaxxbxx"));
+}
+
+// Test a tree search: ordered results, pattern filter, skipped names and binary files
+TEST_F(ContentSearchTest, SearchesTreeInPathOrder) {
+    writeFile("b.cpp", "int token = 1;\n");
+    writeFile("a/z.cpp", "// TOKEN here\n");
+    writeFile("a/y.h", "token in a header\n");
+    writeFile("skip/x.cpp", "token\n");
+    writeFile("bin.cpp", std::string("token\0\x01\x02", 8));
+
+    ContentSearchOptions options;
+    options.query = "token";
+    options.filePattern = "*.cpp";
+    options.threads = 4;
+    options.skipName = [](const std::string& name) { return name == "skip"; };
+
+    auto result = ContentSearch::Run(m_root.string(), options);
+    ASSERT_EQ(result.matches.size(), 2u);
+    EXPECT_EQ(result.matches[0].path, path("a/z.cpp"));
+    EXPECT_EQ(result.matches[0].column, 4);
+    EXPECT_EQ(result.matches[1].path, path("b.cpp"));
+    EXPECT_FALSE(result.truncated);
+}
+
+// Test that maxResults keeps the first matches in path order regardless of threads
+TEST_F(ContentSearchTest, StopsAtMaxResultsDeterministically) {
+    for (int i = 0; i < 40; ++i) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "f%02d.txt", i);
+        writeFile(name, "match one\nno\nmatch two\n");
+    }
+
+    ContentSearchOptions options;
+    options.query = "match";
+    options.maxResults = 7;
+    options.threads = 8;
+
+    auto result = ContentSearch::Run(m_root.string(), options);
+    ASSERT_EQ(result.matches.size(), 7u);
+    EXPECT_TRUE(result.truncated);
+    EXPECT_EQ(result.matches[0].path, path("f00.txt"));
+    EXPECT_EQ(result.matches[1].line, 3);
+    EXPECT_EQ(result.matches[6].path, path("f03.txt"));
+}
+
+// Test that exactly maxResults matches is not reported as truncated
+TEST_F(ContentSearchTest, ExactlyMaxResultsIsNotTruncated) {
+    writeFile("a.txt", "match\nmatch\n");
+    writeFile("b.txt", "match\n");
+
+    ContentSearchOptions options;
+    options.query = "match";
+    options.maxResults = 3;
+    options.threads = 2;
+
+    auto result = ContentSearch::Run(m_root.string(), options);
+    EXPECT_EQ(result.matches.size(), 3u);
+    EXPECT_FALSE(result.truncated);
+
+    options.maxResults = 2;
+    result = ContentSearch::Run(m_root.string(), options);
+    EXPECT_EQ(result.matches.size(), 2u);
+    EXPECT_TRUE(result.truncated);
+}
@@ -0,0 +1,98 @@
+/**
+ * Unit tests for background directory listing.
+ */
+
+#include <gtest/gtest.h>
+#include "fs/directory_lister.h"
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+
+using namespace FS;
+using namespace std::chrono_literals;
+
+namespace {
+
+class DirectoryListerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_root = std::filesystem::temp_directory_path() /
+                 ("bytemuse-directory-lister-test-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()));
+        std::filesystem::remove_all(m_root);
+        std::filesystem::create_directories(m_root);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_root);
+    }
+
+    void touch(const std::string& name) const {
+        std::ofstream(m_root / name) << name;
+    }
+
+    ListResult list(const std::string& dir, DirectoryLister::ProgressCallback onProgress = nullptr,
+                    TransferToken cancel = TransferToken()) {
+        std::promise<ListResult> done;
+        m_lister.list(Filesystem::Local(m_root.string()), dir, std::move(onProgress),
+            [&](const ListResult& result) { done.set_value(result); }, cancel);
+        auto future = done.get_future();
+        EXPECT_EQ(future.wait_for(10s), std::future_status::ready);
+        return future.get();
+    }
+
+    std::filesystem::path m_root;
+    DirectoryLister m_lister;
+};
+
+} // namespace
+
+// Test that one level is listed, sorted, without hidden entries
+TEST_F(DirectoryListerTest, ListsOneLevelSorted) {
+    touch("b.txt");
+    touch("Z.txt");
+    touch("a.txt");
+    touch(".hidden");
+    std::filesystem::create_directories(m_root / "dir" / "nested");
+    touch("dir/inner.txt");
+
+    ListResult result = list(m_root.string());
+    EXPECT_TRUE(result.success);
+    ASSERT_EQ(result.entries.size(), 4u);
+    EXPECT_EQ(result.entries[0].name, "Z.txt");
+    EXPECT_EQ(result.entries[1].name, "a.txt");
+    EXPECT_EQ(result.entries[2].name, "b.txt");
+    EXPECT_EQ(result.entries[3].name, "dir");
+    EXPECT_TRUE(result.entries[3].isDirectory);
+    EXPECT_FALSE(result.entries[0].isDirectory);
+}
+
+// Test that large directories report progress while listing
+TEST_F(DirectoryListerTest, ReportsProgress) {
+    size_t count = DirectoryLister::kProgressInterval * 2 + 5;
+    for (size_t i = 0; i < count; ++i) {
+        touch("f" + std::to_string(i));
+    }
+
+    std::vector<size_t> progress;
+    ListResult result = list(m_root.string(), [&](size_t soFar) { progress.push_back(soFar); });
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.entries.size(), count);
+    EXPECT_EQ(progress, (std::vector<size_t>{DirectoryLister::kProgressInterval,
+                                             DirectoryLister::kProgressInterval * 2}));
+}
+
+// Test that a missing directory is an error and a cancelled listing returns nothing
+TEST_F(DirectoryListerTest, ReportsErrorsAndCancellation) {
+    ListResult missing = list((m_root / "missing").string());
+    EXPECT_FALSE(missing.success);
+    EXPECT_FALSE(missing.error.empty());
+
+    touch("a.txt");
+    TransferToken token;
+    token.cancel();
+    ListResult cancelled = list(m_root.string(), nullptr, token);
+    EXPECT_FALSE(cancelled.success);
+    EXPECT_TRUE(cancelled.cancelled);
+    EXPECT_TRUE(cancelled.entries.empty());
+}
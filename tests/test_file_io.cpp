@@ -0,0 +1,118 @@
+/**
+ * Unit tests for the background file transfer service.
+ */
+
+#include <gtest/gtest.h>
+#include "fs/file_io.h"
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <string>
+
+using namespace FS;
+using namespace std::chrono_literals;
+
+namespace {
+
+class FileIOTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_root = std::filesystem::temp_directory_path() /
+                 ("bytemuse-file-io-test-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()));
+        std::filesystem::remove_all(m_root);
+        std::filesystem::create_directories(m_root);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_root);
+    }
+
+    std::string path(const std::string& name) const {
+        return (m_root / name).string();
+    }
+
+    static std::string readBack(const std::string& file) {
+        std::ifstream in(file, std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    std::filesystem::path m_root;
+    FileIO m_io;
+};
+
+} // namespace
+
+// Test that a read delivers every byte, NULs included, in chunks with progress
+TEST_F(FileIOTest, ReadsWholeFileInChunks) {
+    std::string content;
+    for (size_t i = 0; i < FileIO::kChunkSize * 2 + 123; ++i) {
+        content.push_back(static_cast<char>(i % 251));
+    }
+    std::ofstream(path("data.bin"), std::ios::binary) << content;
+
+    std::string received;
+    size_t chunks = 0;
+    TransferProgress last;
+    std::promise<TransferResult> done;
+    m_io.read(Filesystem::Local(m_root.string()), path("data.bin"),
+        [&](std::string chunk, const TransferProgress& progress) {
+            received += chunk;
+            ++chunks;
+            last = progress;
+        },
+        [&](const TransferResult& result) { done.set_value(result); });
+
+    auto future = done.get_future();
+    ASSERT_EQ(future.wait_for(10s), std::future_status::ready);
+    TransferResult result = future.get();
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.bytes, content.size());
+    EXPECT_EQ(received, content);
+    EXPECT_EQ(chunks, 3u);
+    EXPECT_EQ(last.bytesDone, content.size());
+    EXPECT_EQ(last.bytesTotal, static_cast<int64_t>(content.size()));
+}
+
+// Test that a missing file fails with an error instead of empty content
+TEST_F(FileIOTest, ReportsMissingFile) {
+    std::promise<TransferResult> done;
+    m_io.read(Filesystem::Local(m_root.string()), path("missing.txt"), nullptr,
+        [&](const TransferResult& result) { done.set_value(result); });
+
+    TransferResult result = done.get_future().get();
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(result.cancelled);
+    EXPECT_FALSE(result.error.IsEmpty());
+}
+
+// Test that writes run in order and replace the file's content
+TEST_F(FileIOTest, WritesInSubmissionOrder) {
+    Filesystem fs = Filesystem::Local(m_root.string());
+    std::string large(FileIO::kChunkSize + 10, 'x');
+    m_io.write(fs, path("out.txt"), large, nullptr, nullptr);
+
+    std::promise<TransferResult> done;
+    m_io.write(fs, path("out.txt"), "final", nullptr,
+        [&](const TransferResult& result) { done.set_value(result); });
+
+    EXPECT_TRUE(done.get_future().get().success);
+    EXPECT_EQ(readBack(path("out.txt")), "final");
+}
+
+// Test that a transfer cancelled while queued never touches the file
+TEST_F(FileIOTest, CancelledBeforeStartIsSkipped) {
+    TransferToken token;
+    token.cancel();
+
+    std::promise<TransferResult> done;
+    m_io.write(Filesystem::Local(m_root.string()), path("never.txt"), "data", nullptr,
+        [&](const TransferResult& result) { done.set_value(result); }, token);
+
+    TransferResult result = done.get_future().get();
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.cancelled);
+    EXPECT_FALSE(std::filesystem::exists(path("never.txt")));
+}
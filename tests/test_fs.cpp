@@ -0,0 +1,89 @@
+/**
+ * Unit tests for the FS module helpers.
+ */
+
+#include <gtest/gtest.h>
+#include "fs/fs.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string record(const std::string& type, const std::string& size,
+                   const std::string& mtime, const std::string& path) {
+    std::string r = type + "\t" + size + "\t" + mtime + "\t" + path;
+    r.push_back('\0');
+    return r;
+}
+
+} // namespace
+
+// Test that complete records are parsed into file entries
+TEST(WalkStreamParserTest, ParsesRecords) {
+    std::vector<FS::FileEntry> entries;
+    FS::WalkStreamParser parser([&entries](const FS::FileEntry& e) {
+        entries.push_back(e);
+        return true;
+    });
+
+    std::string data = record("d", "4096", "1700000000.5", "/src/lib")
+                     + record("f", "123", "1700000001.25", "/src/lib/main.cpp");
+    EXPECT_TRUE(parser.feed(data.data(), data.size()));
+
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_TRUE(entries[0].isDirectory);
+    EXPECT_EQ(entries[0].name, "lib");
+    EXPECT_EQ(entries[0].size, -1);
+    EXPECT_FALSE(entries[1].isDirectory);
+    EXPECT_EQ(entries[1].name, "main.cpp");
+    EXPECT_EQ(entries[1].fullPath, "/src/lib/main.cpp");
+    EXPECT_EQ(entries[1].size, 123);
+    EXPECT_EQ(entries[1].modTime, 1700000001);
+}
+
+// Test that records split across chunk boundaries are reassembled
+TEST(WalkStreamParserTest, HandlesRecordsSplitAcrossChunks) {
+    std::vector<FS::FileEntry> entries;
+    FS::WalkStreamParser parser([&entries](const FS::FileEntry& e) {
+        entries.push_back(e);
+        return true;
+    });
+
+    std::string data = record("f", "7", "0", "/a/with\ttab.h") + record("f", "8", "0", "/a/b.h");
+    for (char c : data) {
+        parser.feed(&c, 1);
+    }
+
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].name, "with\ttab.h");
+    EXPECT_EQ(entries[1].size, 8);
+}
+
+// Test that returning false from the callback stops parsing
+TEST(WalkStreamParserTest, StopsWhenCallbackReturnsFalse) {
+    int seen = 0;
+    FS::WalkStreamParser parser([&seen](const FS::FileEntry&) {
+        ++seen;
+        return false;
+    });
+
+    std::string data = record("f", "1", "0", "/x") + record("f", "2", "0", "/y");
+    EXPECT_FALSE(parser.feed(data.data(), data.size()));
+    EXPECT_TRUE(parser.stopped());
+    EXPECT_EQ(seen, 1);
+}
+
+// Test that malformed records are skipped
+TEST(WalkStreamParserTest, SkipsMalformedRecords) {
+    std::vector<FS::FileEntry> entries;
+    FS::WalkStreamParser parser([&entries](const FS::FileEntry& e) {
+        entries.push_back(e);
+        return true;
+    });
+
+    std::string data = std::string("garbage") + '\0' + record("f", "1", "0", "/ok");
+    parser.feed(data.data(), data.size());
+
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].name, "ok");
+}
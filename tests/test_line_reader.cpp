@@ -0,0 +1,108 @@
+/**
+ * Unit tests for the line range reader.
+ */
+
+#include <gtest/gtest.h>
+#include "fs/line_reader.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace FS;
+
+namespace {
+
+std::string numberedLines(int count) {
+    std::string text;
+    for (int i = 1; i <= count; ++i) {
+        text += "line " + std::to_string(i) + "\n";
+    }
+    return text;
+}
+
+} // namespace
+
+// Test that a range is cut out with the same line rules as getline
+TEST(LineReaderTest, ExtractsRange) {
+    std::string text = "a\nb\r\n\nd";
+    auto range = LineReader::Extract(text.data(), text.size(), 2, 3, nullptr);
+    EXPECT_TRUE(range.ok);
+    EXPECT_EQ(range.content, "b\r\n");
+    EXPECT_EQ(range.startLine, 2);
+    EXPECT_EQ(range.endLine, 3);
+    EXPECT_EQ(range.totalLines, 4);
+
+    range = LineReader::Extract(text.data(), text.size(), 3, -1, nullptr);
+    EXPECT_EQ(range.content, "\nd");
+    EXPECT_EQ(range.endLine, 4);
+}
+
+// Test ranges that run past the end of the file
+TEST(LineReaderTest, ClampsToEndOfFile) {
+    std::string text = "one\ntwo\n";
+    auto range = LineReader::Extract(text.data(), text.size(), 2, 10, nullptr);
+    EXPECT_EQ(range.content, "two");
+    EXPECT_EQ(range.endLine, 2);
+    EXPECT_EQ(range.totalLines, 2);
+
+    range = LineReader::Extract(text.data(), text.size(), 5, 10, nullptr);
+    EXPECT_TRUE(range.ok);
+    EXPECT_EQ(range.content, "");
+    EXPECT_EQ(range.endLine, 4);
+
+    range = LineReader::Extract("", 0, 1, -1, nullptr);
+    EXPECT_EQ(range.totalLines, 0);
+    EXPECT_EQ(range.endLine, 0);
+}
+
+// Test that starting from the sparse index gives the same lines as a full scan
+TEST(LineReaderTest, IndexMatchesFullScan) {
+    std::string text = numberedLines(LineIndex::kStride * 3 + 17);
+    LineIndex index = LineIndex::Build(text.data(), text.size());
+    EXPECT_EQ(index.totalLines, LineIndex::kStride * 3 + 17);
+    EXPECT_EQ(index.checkpoints.size(), 4u);
+
+    for (int start : {1, LineIndex::kStride, LineIndex::kStride + 1, LineIndex::kStride * 3 + 17}) {
+        auto indexed = LineReader::Extract(text.data(), text.size(), start, start + 2, &index);
+        auto scanned = LineReader::Extract(text.data(), text.size(), start, start + 2, nullptr);
+        EXPECT_EQ(indexed.content, scanned.content) << "start " << start;
+        EXPECT_EQ(indexed.endLine, scanned.endLine) << "start " << start;
+        EXPECT_EQ(indexed.totalLines, scanned.totalLines) << "start " << start;
+    }
+    auto range = LineReader::Extract(text.data(), text.size(), 2050, 2050, &index);
+    EXPECT_EQ(range.content, "line 2050");
+}
+
+// Test that a file re-read after being rewritten is not served a stale index
+TEST(LineReaderTest, ReadsFilesAndNoticesChanges) {
+    auto path = (std::filesystem::temp_directory_path() / "bytemuse-line-reader-test.txt").string();
+    std::string large = numberedLines(200000);
+    ASSERT_GE(large.size(), LineReader::kIndexThreshold);
+    std::ofstream(path, std::ios::binary) << large;
+
+    LineReader reader;
+    auto range = reader.read(path, 150000, 150001);
+    EXPECT_TRUE(range.ok);
+    EXPECT_EQ(range.content, "line 150000\nline 150001");
+    EXPECT_EQ(range.totalLines, 200000);
+
+    std::ofstream(path, std::ios::binary) << "short\n" << large;
+    range = reader.read(path, 150000, 150000);
+    EXPECT_EQ(range.content, "line 149999");
+    EXPECT_EQ(range.totalLines, 200001);
+
+    std::filesystem::remove(path);
+    EXPECT_FALSE(reader.read(path, 1, 1).ok);
+}
+
+// Test the remote sed command and the parsing of its output
+TEST(LineReaderTest, RemoteRange) {
+    EXPECT_EQ(LineReader::RemoteCommand("/a b/f.txt", 10, 20), "sed -n '10,20p;20q' '/a b/f.txt'");
+    EXPECT_EQ(LineReader::RemoteCommand("f", 0, -1), "sed -n '1,$p' 'f'");
+
+    auto range = LineReader::FromRemoteOutput("x\ny\n", 10);
+    EXPECT_EQ(range.content, "x\ny");
+    EXPECT_EQ(range.startLine, 10);
+    EXPECT_EQ(range.endLine, 11);
+    EXPECT_EQ(range.totalLines, -1);
+}
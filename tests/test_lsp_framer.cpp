@@ -0,0 +1,116 @@
+/**
+ * Unit tests for the LSP Content-Length framer.
+ */
+
+#include <gtest/gtest.h>
+#include "lsp/lsp_framer.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string frame(const std::string& body) {
+    return "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+} // namespace
+
+// Test that several messages in one chunk are all dispatched
+TEST(LspMessageFramerTest, DispatchesMultipleMessagesFromOneChunk) {
+    LspMessageFramer framer;
+    std::string data = frame(R"({"id":1})") + frame(R"({"id":2})");
+    framer.append(data.data(), data.size());
+
+    std::vector<std::string> messages;
+    size_t count = framer.drain([&](std::string_view body) { messages.emplace_back(body); });
+
+    EXPECT_EQ(count, 2u);
+    ASSERT_EQ(messages.size(), 2u);
+    EXPECT_EQ(messages[0], R"({"id":1})");
+    EXPECT_EQ(messages[1], R"({"id":2})");
+    EXPECT_EQ(framer.bufferedBytes(), 0u);
+}
+
+// Test that headers and bodies split across reads are reassembled
+TEST(LspMessageFramerTest, HandlesByteByByteInput) {
+    LspMessageFramer framer;
+    std::string data = frame(R"({"method":"a"})") + frame(R"({"method":"b"})");
+
+    std::vector<std::string> messages;
+    for (char c : data) {
+        framer.append(&c, 1);
+        framer.drain([&](std::string_view body) { messages.emplace_back(body); });
+    }
+
+    ASSERT_EQ(messages.size(), 2u);
+    EXPECT_EQ(messages[1], R"({"method":"b"})");
+}
+
+// Test that the body view is NUL-terminated while the handler runs
+TEST(LspMessageFramerTest, BodyIsNulTerminatedDuringCallback) {
+    LspMessageFramer framer;
+    std::string data = frame("{}") + frame("[]");
+    framer.append(data.data(), data.size());
+
+    framer.drain([](std::string_view body) {
+        EXPECT_EQ(body.data()[body.size()], '\0');
+    });
+}
+
+// Test that extra headers and header-name case are handled
+TEST(LspMessageFramerTest, ParsesExtraHeadersCaseInsensitively) {
+    LspMessageFramer framer;
+    std::string data = "content-type: application/vscode-jsonrpc; charset=utf-8\r\n"
+                       "content-length: 2\r\n\r\n{}";
+    framer.append(data.data(), data.size());
+
+    std::vector<std::string> messages;
+    framer.drain([&](std::string_view body) { messages.emplace_back(body); });
+
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_EQ(messages[0], "{}");
+}
+
+// Test that a header block without Content-Length is skipped
+TEST(LspMessageFramerTest, SkipsHeaderWithoutContentLength) {
+    LspMessageFramer framer;
+    std::string data = std::string("garbage line\r\n\r\n") + frame(R"({"ok":true})");
+    framer.append(data.data(), data.size());
+
+    std::vector<std::string> messages;
+    framer.drain([&](std::string_view body) { messages.emplace_back(body); });
+
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_EQ(messages[0], R"({"ok":true})");
+}
+
+// Test that an absurd Content-Length is skipped instead of reserved
+TEST(LspMessageFramerTest, SkipsOversizedContentLength) {
+    LspMessageFramer framer;
+    std::string data = std::string("Content-Length: 4611686018427387904\r\n\r\n") + frame("{}");
+    framer.append(data.data(), data.size());
+
+    std::vector<std::string> messages;
+    EXPECT_NO_THROW(framer.drain([&](std::string_view body) { messages.emplace_back(body); }));
+
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_EQ(messages[0], "{}");
+}
+
+// Test that partial messages survive buffer compaction
+TEST(LspMessageFramerTest, KeepsPartialMessageAcrossCompaction) {
+    LspMessageFramer framer;
+    std::string big(100 * 1024, 'x');
+    std::string tail = frame("\"" + big + "\"");
+    std::string data = frame("\"" + big + "\"") + tail.substr(0, 50);
+    framer.append(data.data(), data.size());
+
+    std::vector<size_t> sizes;
+    framer.drain([&](std::string_view body) { sizes.push_back(body.size()); });
+    ASSERT_EQ(sizes.size(), 1u);
+
+    framer.append(tail.data() + 50, tail.size() - 50);
+    framer.drain([&](std::string_view body) { sizes.push_back(body.size()); });
+    ASSERT_EQ(sizes.size(), 2u);
+    EXPECT_EQ(sizes[1], big.size() + 2);
+}
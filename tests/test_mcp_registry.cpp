@@ -0,0 +1,105 @@
+/**
+ * Unit tests for MCP::Registry tool routing and its cached tool table.
+ */
+
+#include <gtest/gtest.h>
+#include "mcp/mcp.h"
+#include <atomic>
+
+using namespace MCP;
+
+namespace {
+
+/**
+ * Provider with one tool that counts how often its definitions are built.
+ */
+class CountingProvider : public Provider {
+public:
+    CountingProvider(std::string id, std::string tool) : m_id(std::move(id)), m_tool(std::move(tool)) {}
+
+    std::string getId() const override { return m_id; }
+    std::string getName() const override { return m_id; }
+    std::string getDescription() const override { return ""; }
+
+    std::vector<ToolDefinition> getTools() const override {
+        ++m_getToolsCalls;
+        ToolDefinition tool;
+        tool.name = m_tool;
+        tool.description = "Test tool";
+        return {tool};
+    }
+
+    ToolResult executeTool(const std::string& toolName, const Value& /*arguments*/) override {
+        return ToolResult::Success(Value(m_id + ":" + toolName));
+    }
+
+    int getToolsCalls() const { return m_getToolsCalls.load(); }
+
+private:
+    std::string m_id;
+    std::string m_tool;
+    mutable std::atomic<int> m_getToolsCalls{0};
+};
+
+class RegistryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_alpha = std::make_shared<CountingProvider>("test.alpha", "alpha_tool");
+        m_beta = std::make_shared<CountingProvider>("test.beta", "beta_tool");
+        Registry::Instance().registerProvider(m_alpha);
+        Registry::Instance().registerProvider(m_beta);
+    }
+
+    void TearDown() override {
+        Registry::Instance().unregisterProvider("test.alpha");
+        Registry::Instance().unregisterProvider("test.beta");
+        Registry::Instance().unregisterProvider("test.gamma");
+    }
+
+    std::shared_ptr<CountingProvider> m_alpha;
+    std::shared_ptr<CountingProvider> m_beta;
+};
+
+} // namespace
+
+// Test that calls are routed to the provider owning the tool
+TEST_F(RegistryTest, RoutesToolToProvider) {
+    auto result = Registry::Instance().executeTool("beta_tool", Value());
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.result.asString(), "test.beta:beta_tool");
+    EXPECT_FALSE(Registry::Instance().executeTool("missing_tool", Value()).success);
+}
+
+// Test that repeated lookups and JSON builds reuse the cached table
+TEST_F(RegistryTest, CachesToolTable) {
+    auto& registry = Registry::Instance();
+    std::string json = registry.buildGeminiToolsJson();
+    EXPECT_NE(json.find("\"alpha_tool\""), std::string::npos);
+    EXPECT_NE(json.find("\"beta_tool\""), std::string::npos);
+
+    int before = m_alpha->getToolsCalls();
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(registry.findToolProvider("alpha_tool"), m_alpha);
+        EXPECT_EQ(registry.buildGeminiToolsJson(), json);
+    }
+    EXPECT_EQ(m_alpha->getToolsCalls(), before);
+}
+
+// Test that enabling, disabling and registering providers refresh the table
+TEST_F(RegistryTest, RebuildsOnProviderChanges) {
+    auto& registry = Registry::Instance();
+    ASSERT_EQ(registry.findToolProvider("alpha_tool"), m_alpha);
+
+    m_alpha->setEnabled(false);
+    EXPECT_EQ(registry.findToolProvider("alpha_tool"), nullptr);
+    EXPECT_EQ(registry.buildGeminiToolsJson().find("alpha_tool"), std::string::npos);
+
+    m_alpha->setEnabled(true);
+    EXPECT_EQ(registry.findToolProvider("alpha_tool"), m_alpha);
+
+    auto gamma = std::make_shared<CountingProvider>("test.gamma", "gamma_tool");
+    registry.registerProvider(gamma);
+    EXPECT_EQ(registry.findToolProvider("gamma_tool"), gamma);
+    registry.unregisterProvider("test.gamma");
+    EXPECT_EQ(registry.findToolProvider("gamma_tool"), nullptr);
+}
@@ -0,0 +1,115 @@
+/**
+ * Unit tests for the bounded output capture and the process executor.
+ */
+
+#include <gtest/gtest.h>
+#include "mcp/process_executor.h"
+#include <chrono>
+#include <string>
+
+using namespace MCP;
+using namespace std::chrono_literals;
+
+// Test that output under the limit is kept verbatim
+TEST(OutputCaptureTest, KeepsSmallOutput) {
+    OutputCapture capture(8, 8);
+    capture.append("hello ", 6);
+    capture.append("world", 5);
+    EXPECT_EQ(capture.str(), "hello world");
+    EXPECT_EQ(capture.droppedBytes(), 0u);
+    EXPECT_EQ(capture.totalBytes(), 11u);
+}
+
+// Test that the head and the latest tail survive, with the middle dropped
+TEST(OutputCaptureTest, KeepsHeadAndTail) {
+    OutputCapture capture(4, 6);
+    std::string input;
+    for (int i = 0; i < 1000; ++i) {
+        input += static_cast<char>('a' + i % 26);
+    }
+    // Uneven chunk sizes exercise the ring wrap-around
+    for (size_t i = 0, chunk = 1; i < input.size(); i += chunk, chunk = chunk % 7 + 1) {
+        capture.append(input.data() + i, std::min(chunk, input.size() - i));
+    }
+    EXPECT_EQ(capture.droppedBytes(), 990u);
+    EXPECT_EQ(capture.str(), input.substr(0, 4) + "\n... (990 bytes omitted) ...\n" + input.substr(994));
+}
+
+#ifndef _WIN32
+// Test that stdout and stderr are captured separately along with the exit code
+TEST(ProcessExecutorTest, SeparatesStreams) {
+    ProcessOptions options;
+    options.argv = {"/bin/sh", "-c", "echo out; echo err >&2; exit 3"};
+    auto result = ProcessExecutor::Run(options);
+    EXPECT_TRUE(result.error.empty());
+    EXPECT_EQ(result.exitCode, 3);
+    EXPECT_EQ(result.stdoutText, "out\n");
+    EXPECT_EQ(result.stderrText, "err\n");
+    EXPECT_FALSE(result.timedOut);
+}
+
+// Test that a timeout kills the whole process group, grandchildren included
+TEST(ProcessExecutorTest, TimeoutKillsProcessGroup) {
+    ProcessOptions options;
+    options.argv = {"/bin/sh", "-c", "sleep 30 & sleep 30; echo never"};
+    options.timeout = 200ms;
+    auto start = std::chrono::steady_clock::now();
+    auto result = ProcessExecutor::Run(options);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_TRUE(result.timedOut);
+    EXPECT_LT(elapsed, 5s);
+    EXPECT_EQ(result.stdoutText, "");
+    EXPECT_GE(result.exitCode, 128);
+}
+
+// Test that the timeout holds for a command that closes its output early
+TEST(ProcessExecutorTest, TimeoutAfterOutputClosed) {
+    ProcessOptions options;
+    options.argv = {"/bin/sh", "-c", "exec >/dev/null 2>&1; sleep 6"};
+    options.timeout = 1000ms;
+    auto start = std::chrono::steady_clock::now();
+    auto result = ProcessExecutor::Run(options);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_TRUE(result.timedOut);
+    EXPECT_LT(elapsed, 4s);
+    EXPECT_GE(result.exitCode, 128);
+}
+
+// Test that a background child holding the pipes open doesn't block the result
+TEST(ProcessExecutorTest, DoesNotWaitForBackgroundChildren) {
+    ProcessOptions options;
+    options.argv = {"/bin/sh", "-c", "sleep 2 & echo done"};
+    auto start = std::chrono::steady_clock::now();
+    auto result = ProcessExecutor::Run(options);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_FALSE(result.timedOut);
+    EXPECT_EQ(result.exitCode, 0);
+    EXPECT_EQ(result.stdoutText, "done\n");
+    EXPECT_LT(elapsed, 1500ms);
+}
+
+// Test that large output is bounded and the dropped byte count is reported
+TEST(ProcessExecutorTest, BoundsLargeOutput) {
+    ProcessOptions options;
+    options.argv = {"/bin/sh", "-c", "i=0; while [ $i -lt 20000 ]; do echo line$i; i=$((i+1)); done"};
+    options.maxOutputBytes = 1000;
+    auto result = ProcessExecutor::Run(options);
+    EXPECT_EQ(result.exitCode, 0);
+    EXPECT_GT(result.stdoutDropped, 100000u);
+    EXPECT_EQ(result.stdoutText.rfind("line0\n", 0), 0u);
+    EXPECT_NE(result.stdoutText.find("line19999\n"), std::string::npos);
+    EXPECT_LT(result.stdoutText.size(), 1100u);
+}
+
+// Test that a missing program is reported as an error
+TEST(ProcessExecutorTest, ReportsSpawnFailure) {
+    ProcessOptions options;
+    options.argv = {"/nonexistent/bytemuse-no-such-program"};
+    auto result = ProcessExecutor::Run(options);
+    EXPECT_FALSE(result.error.empty());
+    EXPECT_EQ(result.exitCode, -1);
+}
+#endif
@@ -0,0 +1,175 @@
+/**
+ * Unit tests for delta-based remote saves.
+ */
+
+#include <gtest/gtest.h>
+#include "fs/remote_delta.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <sys/wait.h>
+#endif
+
+using namespace FS;
+
+namespace {
+
+std::string randomText(size_t size, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::string text(size, '\0');
+    for (auto& c : text) {
+        c = static_cast<char>('a' + rng() % 26);
+    }
+    return text;
+}
+
+std::string rebuild(std::string_view base, const Delta& delta) {
+    std::string out;
+    for (const auto& op : delta.ops) {
+        std::string_view source = op.copy ? base : std::string_view(delta.literals);
+        out += source.substr(op.offset, op.length);
+    }
+    return out;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+#ifndef _WIN32
+int runWithInput(const std::string& command, const std::string& input) {
+    FILE* pipe = popen(command.c_str(), "w");
+    if (!pipe) return -1;
+    fwrite(input.data(), 1, input.size(), pipe);
+    int status = pclose(pipe);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+#endif
+
+} // namespace
+
+// Test the checksum against values printed by cksum(1)
+TEST(RemoteDeltaTest, ChecksumMatchesCksum) {
+    EXPECT_EQ(PosixChecksum::Of(""), "4294967295 0");
+    EXPECT_EQ(PosixChecksum::Of("hello\n"), "3015617425 6");
+}
+
+// Test that an insertion, a deletion and an edit are sent as small literals
+TEST(RemoteDeltaTest, SendsOnlyChanges) {
+    std::string base = randomText(300000, 1);
+    auto signature = DeltaSignature::Of(base);
+
+    std::string target = base;
+    target.insert(1000, "inserted text");
+    target.erase(150000, 500);
+    target[250000] = '#';
+
+    Delta delta = Delta::Compute(signature, target);
+    EXPECT_EQ(rebuild(base, delta), target);
+    EXPECT_LT(delta.literals.size(), 4 * signature.blockSize());
+}
+
+// Test that the signature does not depend on how the content was chunked
+TEST(RemoteDeltaTest, SignatureIsChunkingIndependent) {
+    std::string base = randomText(10000, 2);
+    auto whole = DeltaSignature::Of(base);
+
+    DeltaSignature chunked(static_cast<int64_t>(base.size()));
+    for (size_t pos = 0; pos < base.size(); pos += 777) {
+        chunked.update(base.data() + pos, std::min<size_t>(777, base.size() - pos));
+    }
+    chunked.finish();
+
+    EXPECT_EQ(chunked.checksum(), whole.checksum());
+    ASSERT_EQ(chunked.blocks().size(), whole.blocks().size());
+    for (size_t i = 0; i < whole.blocks().size(); ++i) {
+        EXPECT_EQ(chunked.blocks()[i].strong, whole.blocks()[i].strong);
+    }
+}
+
+// Test edge cases: empty sides and a changed short last block
+TEST(RemoteDeltaTest, HandlesEdgeCases) {
+    std::string base = randomText(5000, 3);
+    for (const std::string& target : {std::string(), base + "tail", base.substr(0, 4999), std::string("x") + base}) {
+        Delta delta = Delta::Compute(DeltaSignature::Of(base), target);
+        EXPECT_EQ(rebuild(base, delta), target);
+    }
+    Delta fromEmpty = Delta::Compute(DeltaSignature::Of(""), "new");
+    EXPECT_EQ(rebuild("", fromEmpty), "new");
+}
+
+#ifndef _WIN32
+// Test that the scripts rebuild the file in place and keep its permissions
+TEST(RemoteDeltaTest, ScriptsReplaceFile) {
+    auto dir = std::filesystem::temp_directory_path() / "bytemuse-remote-delta-test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::string path = (dir / "file's name.txt").string();
+
+    std::string base = randomText(200000, 4);
+    ASSERT_EQ(runWithInput(RemoteWrite::FullCommand(path, base), base), 0);
+    EXPECT_EQ(readFile(path), base);
+    chmod(path.c_str(), 0751);
+
+    std::string target = base;
+    target.replace(100000, 10, "changed");
+    auto signature = DeltaSignature::Of(base);
+    Delta delta = Delta::Compute(signature, target);
+    ASSERT_EQ(runWithInput(RemoteWrite::PatchCommand(path, signature, delta, target), delta.literals), 0);
+    EXPECT_EQ(readFile(path), target);
+
+    struct stat st;
+    ASSERT_EQ(stat(path.c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 0777, 0751u);
+
+    // The remote file is no longer the base: refuse and leave it alone
+    EXPECT_EQ(runWithInput(RemoteWrite::PatchCommand(path, signature, delta, target), delta.literals),
+              RemoteWrite::kBaseMismatch);
+    EXPECT_EQ(readFile(path), target);
+
+    // No temp files left behind
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir), {}), 1);
+    std::filesystem::remove_all(dir);
+}
+
+// Test that saving through a symlink updates its target and keeps the link
+TEST(RemoteDeltaTest, ScriptsFollowSymlinks) {
+    auto dir = std::filesystem::temp_directory_path() / "bytemuse-remote-delta-link-test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "real");
+    std::string real = (dir / "real" / "file.txt").string();
+    std::string link = (dir / "link.txt").string();
+    std::filesystem::create_symlink("real/file.txt", link);
+
+    std::string base = randomText(50000, 5);
+    ASSERT_EQ(runWithInput(RemoteWrite::FullCommand(link, base), base), 0);
+    EXPECT_TRUE(std::filesystem::is_symlink(link));
+    EXPECT_EQ(readFile(real), base);
+    chmod(real.c_str(), 0640);
+
+    std::string target = base;
+    target.replace(20000, 10, "changed");
+    auto signature = DeltaSignature::Of(base);
+    Delta delta = Delta::Compute(signature, target);
+    ASSERT_EQ(runWithInput(RemoteWrite::PatchCommand(link, signature, delta, target), delta.literals), 0);
+    EXPECT_TRUE(std::filesystem::is_symlink(link));
+    EXPECT_EQ(readFile(real), target);
+
+    // The target's mode, not the link's 0777
+    struct stat st;
+    ASSERT_EQ(stat(real.c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 0777, 0640u);
+
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir / "real"), {}), 1);
+    std::filesystem::remove_all(dir);
+}
+#endif
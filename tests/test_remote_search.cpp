@@ -0,0 +1,122 @@
+/**
+ * Unit tests for remote search command building and output parsing.
+ */
+
+#include <gtest/gtest.h>
+#include "fs/remote_search.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace FS;
+using namespace std::string_literals;
+
+namespace {
+
+std::vector<ContentMatch> parseAll(const std::string& output, const std::string& query, size_t chunkSize) {
+    ContentSearchOptions options;
+    options.query = query;
+    std::vector<ContentMatch> matches;
+    RemoteGrepParser parser(options, [&](ContentMatch&& match) {
+        matches.push_back(std::move(match));
+        return true;
+    });
+    for (size_t i = 0; i < output.size(); i += chunkSize) {
+        parser.feed(output.data() + i, std::min(chunkSize, output.size() - i));
+    }
+    parser.finish();
+    return matches;
+}
+
+} // namespace
+
+// Test NUL-separated (rg / GNU grep) output split across arbitrary chunks
+TEST(RemoteGrepParserTest, ParsesNulSeparatedRecords) {
+    std::string output = "/w/a:b.cpp\0" "12:int Foo = 1;\n"
+                         "/w/c.h\0" "3:  return foo;\r\n"s;
+    for (size_t chunk : {1u, 5u, 1000u}) {
+        auto matches = parseAll(output, "foo", chunk);
+        ASSERT_EQ(matches.size(), 2u);
+        EXPECT_EQ(matches[0].path, "/w/a:b.cpp");
+        EXPECT_EQ(matches[0].line, 12);
+        EXPECT_EQ(matches[0].column, 5);
+        EXPECT_EQ(matches[0].content, "int Foo = 1;");
+        EXPECT_EQ(matches[1].path, "/w/c.h");
+        EXPECT_EQ(matches[1].column, 10);
+        EXPECT_EQ(matches[1].content, "  return foo;");
+    }
+}
+
+// Test the portable "path:line:text" form, including colons in the text
+TEST(RemoteGrepParserTest, ParsesColonSeparatedRecords) {
+    auto matches = parseAll("/w/x.py:7:key: foo\nBinary file /w/y.bin matches\n/w/z:9:foo", "foo", 64);
+    ASSERT_EQ(matches.size(), 2u);
+    EXPECT_EQ(matches[0].path, "/w/x.py");
+    EXPECT_EQ(matches[0].line, 7);
+    EXPECT_EQ(matches[0].content, "key: foo");
+    EXPECT_EQ(matches[1].path, "/w/z");
+    EXPECT_EQ(matches[1].line, 9);
+}
+
+// Test that returning false from the callback stops parsing
+TEST(RemoteGrepParserTest, StopsWhenCallbackDeclines) {
+    ContentSearchOptions options;
+    options.query = "x";
+    int seen = 0;
+    RemoteGrepParser parser(options, [&](ContentMatch&&) { return ++seen < 2; });
+
+    std::string output = "/a:1:x\n/a:2:x\n/a:3:x\n";
+    EXPECT_FALSE(parser.feed(output.data(), output.size()));
+    EXPECT_TRUE(parser.stopped());
+    EXPECT_EQ(seen, 2);
+}
+
+#ifndef _WIN32
+// Test the generated command end to end with the local shell
+TEST(RemoteGrepCommandTest, FindsMatchesWithLocalShell) {
+    auto root = std::filesystem::temp_directory_path() /
+                ("bytemuse-remote-search-test-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()));
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "src");
+    std::filesystem::create_directories(root / "node_modules");
+    std::filesystem::create_directories(root / ".git");
+    std::ofstream(root / "src" / "it's.cpp") << "// Needle here\nnothing\n";
+    std::ofstream(root / "src" / "b.h") << "needle\n";
+    std::ofstream(root / "node_modules" / "dep.cpp") << "needle\n";
+    std::ofstream(root / ".git" / "config.cpp") << "needle\n";
+
+    ContentSearchOptions options;
+    options.query = "needle";
+    options.filePattern = "*.cpp";
+
+    std::string command = RemoteGrep::BuildCommand(root.string(), options);
+    std::vector<ContentMatch> matches;
+    RemoteGrepParser parser(options, [&](ContentMatch&& match) {
+        matches.push_back(std::move(match));
+        return true;
+    });
+
+    std::string shellCommand = "sh -c '";
+    for (char c : command) {
+        shellCommand += (c == '\'') ? std::string("'\\''") : std::string(1, c);
+    }
+    shellCommand += "'";
+    FILE* pipe = popen(shellCommand.c_str(), "r");
+    ASSERT_NE(pipe, nullptr);
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        parser.feed(buffer, n);
+    }
+    pclose(pipe);
+    parser.finish();
+    std::filesystem::remove_all(root);
+
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].path, (root / "src" / "it's.cpp").string());
+    EXPECT_EQ(matches[0].line, 1);
+    EXPECT_EQ(matches[0].column, 4);
+}
+#endif
@@ -0,0 +1,81 @@
+/**
+ * Unit tests for the incremental server-sent events parser.
+ */
+
+#include <gtest/gtest.h>
+#include "http/sse_parser.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace Http;
+
+namespace {
+
+std::vector<SseEvent> parseAll(const std::string& body, size_t chunkSize) {
+    std::vector<SseEvent> events;
+    SseParser parser([&](const SseEvent& event) {
+        events.push_back(event);
+        return true;
+    });
+    for (size_t pos = 0; pos < body.size(); pos += chunkSize) {
+        parser.feed(body.data() + pos, std::min(chunkSize, body.size() - pos));
+    }
+    parser.finish();
+    return events;
+}
+
+} // namespace
+
+// Test that events split at every byte come out the same as in one chunk
+TEST(SseParserTest, ParsesEventsSplitAtAnyByte) {
+    std::string body = "data: {\"a\":1}\r\n\r\n"
+                       "event: update\n"
+                       "id: 7\n"
+                       "data: first\n"
+                       "data: second\n\n"
+                       ": keep-alive\n\n"
+                       "data:no-space\r\r";
+
+    for (size_t chunkSize : {body.size(), size_t(1), size_t(3)}) {
+        auto events = parseAll(body, chunkSize);
+        ASSERT_EQ(events.size(), 3u) << "chunk size " << chunkSize;
+        EXPECT_EQ(events[0].event, "message");
+        EXPECT_EQ(events[0].data, "{\"a\":1}");
+        EXPECT_EQ(events[1].event, "update");
+        EXPECT_EQ(events[1].data, "first\nsecond");
+        EXPECT_EQ(events[1].id, "7");
+        EXPECT_EQ(events[2].data, "no-space");
+        EXPECT_EQ(events[2].id, "7");
+    }
+}
+
+// Test that an event without its trailing blank line is flushed by finish()
+TEST(SseParserTest, FinishFlushesLastEvent) {
+    auto events = parseAll("data: tail", 4);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].data, "tail");
+}
+
+// Test that returning false from the callback stops parsing
+TEST(SseParserTest, StopsWhenCallbackDeclines) {
+    int calls = 0;
+    SseParser parser([&](const SseEvent&) {
+        ++calls;
+        return false;
+    });
+    std::string body = "data: 1\n\ndata: 2\n\n";
+    EXPECT_FALSE(parser.feed(body.data(), body.size()));
+    EXPECT_TRUE(parser.stopped());
+    EXPECT_EQ(calls, 1);
+}
+
+// Test that a plain error body is kept for the caller
+TEST(SseParserTest, KeepsNonEventBody) {
+    std::string body = "{\n  \"error\": {\"code\": 400}\n}\n";
+    SseParser parser([](const SseEvent&) { return true; });
+    parser.feed(body.data(), body.size());
+    parser.finish();
+    EXPECT_FALSE(parser.sawEvent());
+    EXPECT_EQ(parser.nonEventText(), body);
+}
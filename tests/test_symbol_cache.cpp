@@ -0,0 +1,124 @@
+/**
+ * Unit tests for the persistent symbol cache.
+ */
+
+#include <gtest/gtest.h>
+#include "lsp/symbol_cache.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+LspDocumentSymbol makeSymbol(const std::string& name, LspSymbolKind kind, int line) {
+    LspDocumentSymbol symbol;
+    symbol.name = name;
+    symbol.kind = kind;
+    symbol.range.start.line = line;
+    symbol.range.end.line = line + 3;
+    symbol.selectionRange.start = {line, 6};
+    symbol.selectionRange.end = {line, 6 + static_cast<int>(name.size())};
+    return symbol;
+}
+
+class SymbolCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_path = (std::filesystem::temp_directory_path() /
+                  ("bytemuse-symbol-cache-test-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + ".bin"))
+                     .string();
+        std::remove(m_path.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(m_path.c_str());
+    }
+
+    std::string m_path;
+};
+
+} // namespace
+
+// Test that symbols survive a save/load round trip, including children
+TEST_F(SymbolCacheTest, RoundTripsSymbols) {
+    SymbolCache cache("local:/work");
+    auto cls = makeSymbol("Widget", LspSymbolKind::Class, 10);
+    cls.detail = "class Widget";
+    cls.children.push_back(makeSymbol("draw", LspSymbolKind::Method, 12));
+    cache.store("/work/widget.h", {1700000000, 512}, {cls});
+    ASSERT_TRUE(cache.save(m_path));
+
+    SymbolCache loaded("local:/work");
+    ASSERT_TRUE(loaded.load(m_path));
+    EXPECT_FALSE(loaded.isDirty());
+
+    const auto* symbols = loaded.find("/work/widget.h", {1700000000, 512});
+    ASSERT_NE(symbols, nullptr);
+    ASSERT_EQ(symbols->size(), 1u);
+    EXPECT_EQ((*symbols)[0].name, "Widget");
+    EXPECT_EQ((*symbols)[0].detail, "class Widget");
+    EXPECT_EQ((*symbols)[0].kind, LspSymbolKind::Class);
+    EXPECT_EQ((*symbols)[0].range.end.line, 13);
+    ASSERT_EQ((*symbols)[0].children.size(), 1u);
+    EXPECT_EQ((*symbols)[0].children[0].name, "draw");
+    EXPECT_EQ((*symbols)[0].children[0].selectionRange.end.character, 10);
+}
+
+// Test that an entry is only served while the file's stamp is unchanged
+TEST_F(SymbolCacheTest, RejectsChangedFiles) {
+    SymbolCache cache("local:/work");
+    cache.store("/work/a.cpp", {100, 20}, {makeSymbol("main", LspSymbolKind::Function, 0)});
+
+    EXPECT_NE(cache.find("/work/a.cpp", {100, 20}), nullptr);
+    EXPECT_EQ(cache.find("/work/a.cpp", {101, 20}), nullptr);
+    EXPECT_EQ(cache.find("/work/a.cpp", {100, 21}), nullptr);
+    EXPECT_EQ(cache.find("/work/b.cpp", {100, 20}), nullptr);
+}
+
+// Test that a cache written for another workspace is ignored
+TEST_F(SymbolCacheTest, IgnoresOtherWorkspaces) {
+    SymbolCache cache("ssh:dev@host:22:/srv/app");
+    cache.store("/srv/app/a.cpp", {1, 1}, {makeSymbol("f", LspSymbolKind::Function, 0)});
+    ASSERT_TRUE(cache.save(m_path));
+
+    SymbolCache other("local:/srv/app");
+    EXPECT_FALSE(other.load(m_path));
+    EXPECT_EQ(other.fileCount(), 0u);
+}
+
+// Test that truncated cache files are discarded instead of half-loaded
+TEST_F(SymbolCacheTest, DiscardsTruncatedFiles) {
+    SymbolCache cache("local:/work");
+    cache.store("/work/a.cpp", {1, 1}, {makeSymbol("alpha", LspSymbolKind::Function, 0)});
+    cache.store("/work/b.cpp", {2, 2}, {makeSymbol("beta", LspSymbolKind::Function, 0)});
+    ASSERT_TRUE(cache.save(m_path));
+
+    auto size = std::filesystem::file_size(m_path);
+    std::filesystem::resize_file(m_path, size - 5);
+
+    SymbolCache loaded("local:/work");
+    EXPECT_FALSE(loaded.load(m_path));
+    EXPECT_EQ(loaded.fileCount(), 0u);
+}
+
+// Test that files missing from the workspace are pruned
+TEST_F(SymbolCacheTest, RetainOnlyDropsRemovedFiles) {
+    SymbolCache cache("local:/work");
+    cache.store("/work/keep.cpp", {1, 1}, {});
+    cache.store("/work/gone.cpp", {1, 1}, {});
+    ASSERT_TRUE(cache.save(m_path));
+    EXPECT_FALSE(cache.isDirty());
+
+    cache.retainOnly({"/work/keep.cpp"});
+    EXPECT_TRUE(cache.isDirty());
+    EXPECT_EQ(cache.fileCount(), 1u);
+    EXPECT_NE(cache.find("/work/keep.cpp", {1, 1}), nullptr);
+}
+
+// Test that cache file names are stable and distinct per workspace
+TEST(SymbolCacheNameTest, FileNameIsStablePerWorkspace) {
+    EXPECT_EQ(SymbolCache::FileNameFor("local:/a"), SymbolCache::FileNameFor("local:/a"));
+    EXPECT_NE(SymbolCache::FileNameFor("local:/a"), SymbolCache::FileNameFor("local:/b"));
+    EXPECT_EQ(SymbolCache::FileNameFor("local:/a").rfind("symbols-", 0), 0u);
+}
@@ -0,0 +1,95 @@
+/**
+ * Unit tests for the symbol name search index.
+ */
+
+#include <gtest/gtest.h>
+#include "lsp/symbol_search_index.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+SymbolSearchIndex makeIndex(const std::vector<std::string>& names) {
+    SymbolSearchIndex index;
+    for (const auto& name : names) {
+        index.add(name);
+    }
+    return index;
+}
+
+} // namespace
+
+// Test that matching ignores case and finds substrings anywhere in the name
+TEST(SymbolSearchIndexTest, MatchesSubstringsCaseInsensitively) {
+    auto index = makeIndex({"LoadConfig", "saveConfig", "Editor", "CONFIG_PATH"});
+
+    auto results = index.search("config");
+    std::sort(results.begin(), results.end());
+    EXPECT_EQ(results, (std::vector<uint32_t>{0, 1, 3}));
+
+    EXPECT_TRUE(index.search("xyz").empty());
+}
+
+// Test that prefix matches rank first, then shorter names
+TEST(SymbolSearchIndexTest, RanksPrefixMatchesFirst) {
+    auto index = makeIndex({"getWidgetName", "widgetCount", "Widget", "subwidget"});
+
+    auto results = index.search("widget");
+    EXPECT_EQ(results, (std::vector<uint32_t>{2, 1, 3, 0}));
+}
+
+// Test that short queries (below trigram length) still find inner matches
+TEST(SymbolSearchIndexTest, HandlesShortQueries) {
+    auto index = makeIndex({"ab", "xaby", "b"});
+
+    EXPECT_EQ(index.search("ab"), (std::vector<uint32_t>{0, 1}));
+    EXPECT_EQ(index.search("b"), (std::vector<uint32_t>{2, 0, 1}));
+}
+
+// Test that symbols sharing a name are interned and all returned in order
+TEST(SymbolSearchIndexTest, InternsDuplicateNames) {
+    auto index = makeIndex({"size", "Size", "resize", "size"});
+
+    EXPECT_EQ(index.size(), 4u);
+    EXPECT_EQ(index.uniqueNameCount(), 2u);
+    EXPECT_EQ(index.search("size"), (std::vector<uint32_t>{0, 1, 3, 2}));
+}
+
+// Test that maxResults truncates the ranked list
+TEST(SymbolSearchIndexTest, RespectsMaxResults) {
+    auto index = makeIndex({"parse", "parser", "parseHeader", "reparse"});
+
+    EXPECT_EQ(index.search("parse", 2), (std::vector<uint32_t>{0, 1}));
+    EXPECT_TRUE(index.search("parse", 0).empty());
+}
+
+// Test that trigram candidates are verified (trigrams present but not contiguous)
+TEST(SymbolSearchIndexTest, VerifiesTrigramCandidates) {
+    auto index = makeIndex({"abcXbcd", "abcd"});
+
+    EXPECT_EQ(index.search("abcd"), (std::vector<uint32_t>{1}));
+}
+
+// Test that results stay correct across prefix table merges
+TEST(SymbolSearchIndexTest, StaysCorrectAcrossManyAdditions) {
+    SymbolSearchIndex index;
+    for (int i = 0; i < 10000; ++i) {
+        index.add("symbol_" + std::to_string(i));
+    }
+    index.add("needle");
+
+    EXPECT_EQ(index.search("needle"), (std::vector<uint32_t>{10000}));
+    EXPECT_EQ(index.search("symbol_9999").front(), 9999u);
+    EXPECT_EQ(index.search("symbol_1", 3), (std::vector<uint32_t>{1, 10, 11}));
+}
+
+// Test that an empty query returns everything and clear() resets ids
+TEST(SymbolSearchIndexTest, EmptyQueryAndClear) {
+    auto index = makeIndex({"bb", "a"});
+    EXPECT_EQ(index.search(""), (std::vector<uint32_t>{1, 0}));
+
+    index.clear();
+    EXPECT_TRUE(index.search("").empty());
+    EXPECT_EQ(index.add("c"), 0u);
+}
@@ -0,0 +1,185 @@
+/**
+ * Unit tests for the struct-of-arrays symbol store.
+ */
+
+#include <gtest/gtest.h>
+#include "lsp/symbol_store.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+LspDocumentSymbol makeSymbol(const std::string& name, LspSymbolKind kind, int line,
+                             std::vector<LspDocumentSymbol> children = {}) {
+    LspDocumentSymbol symbol;
+    symbol.name = name;
+    symbol.kind = kind;
+    symbol.selectionRange.start.line = line;
+    symbol.children = std::move(children);
+    return symbol;
+}
+
+std::vector<std::string> names(const auto& view) {
+    std::vector<std::string> result;
+    for (auto symbol : view) {
+        result.push_back(symbol.name());
+    }
+    return result;
+}
+
+} // namespace
+
+// Test that hierarchies are flattened and each file maps to its own range
+TEST(SymbolStoreTest, FlattensFilesIntoRanges) {
+    SymbolStore store;
+    store.addFile("/src/a.h", {
+        makeSymbol("Widget", LspSymbolKind::Class, 1, {makeSymbol("draw", LspSymbolKind::Method, 2)}),
+        makeSymbol("helper", LspSymbolKind::Function, 9)
+    });
+    store.addFile("/src/b.cpp", {makeSymbol("main", LspSymbolKind::Function, 0)});
+
+    EXPECT_EQ(store.size(), 4u);
+    EXPECT_EQ(store.fileCount(), 2u);
+    EXPECT_EQ(names(store.fileSymbols("/src/a.h")), (std::vector<std::string>{"Widget", "draw", "helper"}));
+    EXPECT_EQ(names(store.fileSymbols("/src/b.cpp")), (std::vector<std::string>{"main"}));
+    EXPECT_TRUE(store.fileSymbols("/src/missing.cpp").empty());
+
+    auto draw = store.symbol(1);
+    EXPECT_EQ(draw.kind(), LspSymbolKind::Method);
+    EXPECT_EQ(draw.selectionRange().start.line, 2);
+    EXPECT_EQ(draw.filePath(), "/src/a.h");
+}
+
+// Test that kind views combine bitmaps and keep workspace order
+TEST(SymbolStoreTest, KindViewsFollowBitmaps) {
+    SymbolStore store;
+    store.addFile("/x.cpp", {
+        makeSymbol("f1", LspSymbolKind::Function, 0),
+        makeSymbol("C", LspSymbolKind::Class, 1, {makeSymbol("m1", LspSymbolKind::Method, 2)}),
+        makeSymbol("S", LspSymbolKind::Struct, 3),
+        makeSymbol("f2", LspSymbolKind::Function, 4)
+    });
+
+    auto functions = store.symbolsOfKinds({LspSymbolKind::Function, LspSymbolKind::Method});
+    EXPECT_EQ(names(functions), (std::vector<std::string>{"f1", "m1", "f2"}));
+    EXPECT_EQ(functions.count(), 3u);
+
+    auto types = store.symbolsOfKinds({LspSymbolKind::Class, LspSymbolKind::Struct});
+    EXPECT_EQ(names(types), (std::vector<std::string>{"C", "S"}));
+
+    EXPECT_EQ(store.symbolsOfKinds({LspSymbolKind::Enum}).count(), 0u);
+    EXPECT_TRUE(names(store.symbolsOfKinds({LspSymbolKind::Enum})).empty());
+}
+
+// Test that kind views work across many bitmap words
+TEST(SymbolStoreTest, KindViewsSpanManyWords) {
+    std::vector<LspDocumentSymbol> symbols;
+    for (int i = 0; i < 1000; ++i) {
+        symbols.push_back(makeSymbol("s" + std::to_string(i),
+            i % 100 == 0 ? LspSymbolKind::Class : LspSymbolKind::Variable, i));
+    }
+    SymbolStore store;
+    store.addFile("/big.cpp", symbols);
+
+    std::vector<SymbolStore::SymbolId> ids;
+    for (auto symbol : store.symbolsOfKinds({LspSymbolKind::Class})) {
+        ids.push_back(symbol.id());
+    }
+    ASSERT_EQ(ids.size(), 10u);
+    EXPECT_EQ(ids.front(), 0u);
+    EXPECT_EQ(ids.back(), 900u);
+}
+
+// Test that search results refer back into the store
+TEST(SymbolStoreTest, SearchReturnsRefs) {
+    SymbolStore store;
+    store.addFile("/a.cpp", {makeSymbol("parseHeader", LspSymbolKind::Function, 0)});
+    store.addFile("/b.cpp", {makeSymbol("Parser", LspSymbolKind::Class, 0)});
+
+    auto results = store.search("parse");
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].name(), "Parser");
+    EXPECT_EQ(results[0].filePath(), "/b.cpp");
+    EXPECT_EQ(results[1].name(), "parseHeader");
+}
+
+// Test that adding a file twice is rejected and clear() empties everything
+TEST(SymbolStoreTest, DuplicateFilesAndClear) {
+    SymbolStore store;
+    EXPECT_TRUE(store.addFile("/a.cpp", {makeSymbol("a", LspSymbolKind::Function, 0)}));
+    EXPECT_FALSE(store.addFile("/a.cpp", {makeSymbol("b", LspSymbolKind::Function, 0)}));
+    EXPECT_EQ(store.size(), 1u);
+
+    store.clear();
+    EXPECT_TRUE(store.empty());
+    EXPECT_EQ(store.fileCount(), 0u);
+    EXPECT_TRUE(store.search("a").empty());
+    EXPECT_EQ(store.symbolsOfKinds({LspSymbolKind::Function}).count(), 0u);
+}
+
+// Test that removing files tombstones their symbols out of every query
+TEST(SymbolStoreTest, RemoveFilesTombstones) {
+    SymbolStore store;
+    store.addFile("/a.cpp", {makeSymbol("alpha", LspSymbolKind::Function, 0)});
+    store.addFile("/b.cpp", {
+        makeSymbol("Beta", LspSymbolKind::Class, 0, {makeSymbol("run", LspSymbolKind::Method, 1)})
+    });
+    store.addFile("/c.cpp", {makeSymbol("gamma", LspSymbolKind::Function, 0)});
+
+    EXPECT_EQ(store.removeFiles({"/b.cpp", "/missing.cpp"}), 1u);
+    EXPECT_EQ(store.removeFiles({"/b.cpp"}), 0u);
+    EXPECT_EQ(store.size(), 2u);
+    EXPECT_EQ(store.fileCount(), 2u);
+    EXPECT_EQ(store.files(), (std::vector<std::string>{"/a.cpp", "/c.cpp"}));
+    EXPECT_TRUE(store.fileSymbols("/b.cpp").empty());
+    EXPECT_EQ(names(store.fileSymbols("/c.cpp")), (std::vector<std::string>{"gamma"}));
+    EXPECT_EQ(names(store.all()), (std::vector<std::string>{"alpha", "gamma"}));
+    EXPECT_EQ(names(store.symbolsOfKinds({LspSymbolKind::Function})), (std::vector<std::string>{"alpha", "gamma"}));
+    EXPECT_EQ(store.symbolsOfKinds({LspSymbolKind::Class, LspSymbolKind::Method}).count(), 0u);
+    EXPECT_TRUE(store.search("run").empty());
+    ASSERT_EQ(store.search("gamma").size(), 1u);
+    EXPECT_EQ(store.search("gamma")[0].id(), 3u);
+    EXPECT_EQ(store.search("gamma")[0].filePath(), "/c.cpp");
+
+    // A removed file can be indexed again
+    EXPECT_TRUE(store.addFile("/b.cpp", {makeSymbol("Beta", LspSymbolKind::Class, 0)}));
+    EXPECT_EQ(names(store.fileSymbols("/b.cpp")), (std::vector<std::string>{"Beta"}));
+    ASSERT_EQ(store.search("beta").size(), 1u);
+    EXPECT_EQ(store.search("beta")[0].filePath(), "/b.cpp");
+    EXPECT_EQ(store.files(), (std::vector<std::string>{"/a.cpp", "/c.cpp", "/b.cpp"}));
+}
+
+// Test that dead symbols don't take result slots from live matches
+TEST(SymbolStoreTest, SearchSkipsDeadSymbols) {
+    SymbolStore store;
+    store.addFile("/old.cpp", {makeSymbol("parse", LspSymbolKind::Function, 0),
+                               makeSymbol("parseAll", LspSymbolKind::Function, 1)});
+    store.addFile("/new.cpp", {makeSymbol("parseOne", LspSymbolKind::Function, 0)});
+    store.removeFiles({"/old.cpp"});
+
+    auto results = store.search("parse", 1);
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].name(), "parseOne");
+}
+
+// Test that enough dead symbols compact the store back to dense ids
+TEST(SymbolStoreTest, RemoveFilesCompactsPastThreshold) {
+    SymbolStore store;
+    std::vector<LspDocumentSymbol> many;
+    for (size_t i = 0; i < SymbolStore::kCompactMinimum; ++i) {
+        many.push_back(makeSymbol("sym" + std::to_string(i), LspSymbolKind::Variable, static_cast<int>(i)));
+    }
+    store.addFile("/a.cpp", {makeSymbol("alpha", LspSymbolKind::Function, 0)});
+    store.addFile("/big.cpp", many);
+    store.addFile("/c.cpp", {makeSymbol("gamma", LspSymbolKind::Function, 0)});
+
+    EXPECT_EQ(store.removeFiles({"/big.cpp"}), 1u);
+    EXPECT_EQ(store.size(), 2u);
+    EXPECT_EQ(store.all().count(), 2u);
+    EXPECT_EQ(store.symbol(1).name(), "gamma");
+    EXPECT_EQ(store.symbol(1).filePath(), "/c.cpp");
+    EXPECT_EQ(store.files(), (std::vector<std::string>{"/a.cpp", "/c.cpp"}));
+    EXPECT_EQ(store.search("gamma")[0].id(), 1u);
+    EXPECT_TRUE(store.search("sym1").empty());
+    EXPECT_EQ(names(store.symbolsOfKinds({LspSymbolKind::Function})), (std::vector<std::string>{"alpha", "gamma"}));
+}
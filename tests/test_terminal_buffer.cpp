@@ -0,0 +1,90 @@
+/**
+ * Unit tests for the terminal scrollback buffer.
+ */
+
+#include <gtest/gtest.h>
+#include "ui/terminal_buffer.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> lines(const TerminalBuffer& buffer) {
+    std::vector<std::string> result;
+    for (size_t i = 0; i < buffer.lineCount(); ++i) {
+        result.push_back(buffer.line(i).text);
+    }
+    return result;
+}
+
+} // namespace
+
+// Test that chunks split anywhere, including inside \r\n, give the same lines
+TEST(TerminalBufferTest, SplitsLinesAcrossChunks) {
+    std::string text = "first\r\nsecond\n\nthird";
+    for (size_t chunkSize : {text.size(), size_t(1), size_t(6)}) {
+        TerminalBuffer buffer;
+        for (size_t pos = 0; pos < text.size(); pos += chunkSize) {
+            buffer.append(std::string_view(text).substr(pos, chunkSize), TerminalStyle::Output);
+        }
+        EXPECT_EQ(lines(buffer), (std::vector<std::string>{"first", "second", "", "third"}))
+            << "chunk size " << chunkSize;
+    }
+}
+
+// Test that a lone \r makes the next text replace the line
+TEST(TerminalBufferTest, CarriageReturnOverwritesLine) {
+    TerminalBuffer buffer;
+    buffer.append("progress 10%\r", TerminalStyle::Output);
+    buffer.append("progress 99%\rdone\n", TerminalStyle::Output);
+    buffer.append("next", TerminalStyle::Output);
+    EXPECT_EQ(lines(buffer), (std::vector<std::string>{"done", "next"}));
+}
+
+// Test that style changes within a line become runs and adjacent ones merge
+TEST(TerminalBufferTest, RecordsStyleRuns) {
+    TerminalBuffer buffer;
+    buffer.append("$ ", TerminalStyle::Output);
+    buffer.append("make", TerminalStyle::Output);
+    buffer.append("error!", TerminalStyle::Error);
+    buffer.append("\n", TerminalStyle::Output);
+
+    ASSERT_EQ(buffer.lineCount(), 1u);
+    const auto& runs = buffer.line(0).runs;
+    ASSERT_EQ(runs.size(), 2u);
+    EXPECT_EQ(runs[0].start, 0u);
+    EXPECT_EQ(runs[0].style, TerminalStyle::Output);
+    EXPECT_EQ(runs[1].start, 6u);
+    EXPECT_EQ(runs[1].style, TerminalStyle::Error);
+}
+
+// Test that the oldest lines are dropped at the cap and numbering continues
+TEST(TerminalBufferTest, DropsOldestLinesAtCap) {
+    TerminalBuffer buffer(3);
+    for (int i = 0; i < 10; ++i) {
+        buffer.append("line " + std::to_string(i) + "\n", TerminalStyle::Output);
+    }
+    EXPECT_EQ(lines(buffer), (std::vector<std::string>{"line 7", "line 8", "line 9"}));
+    EXPECT_EQ(buffer.firstLineNumber(), 7u);
+
+    buffer.setMaxLines(1);
+    EXPECT_EQ(lines(buffer), (std::vector<std::string>{"line 9"}));
+    EXPECT_EQ(buffer.firstLineNumber(), 9u);
+
+    buffer.clear();
+    EXPECT_EQ(buffer.lineCount(), 0u);
+    EXPECT_EQ(buffer.firstLineNumber(), 0u);
+}
+
+// Test that overlong lines wrap without splitting a UTF-8 sequence
+TEST(TerminalBufferTest, WrapsLongLinesOnCharacterBoundaries) {
+    TerminalBuffer buffer;
+    std::string text(TerminalBuffer::kMaxLineLength - 1, 'a');
+    text += "\xC3\xA9";     // é straddles the limit
+    text += "tail";
+    buffer.append(text, TerminalStyle::Output);
+
+    ASSERT_EQ(buffer.lineCount(), 2u);
+    EXPECT_EQ(buffer.line(0).text, std::string(TerminalBuffer::kMaxLineLength - 1, 'a'));
+    EXPECT_EQ(buffer.line(1).text, "\xC3\xA9tail");
+}
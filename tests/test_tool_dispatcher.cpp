@@ -0,0 +1,129 @@
+/**
+ * Unit tests for concurrent dispatch of MCP tool calls.
+ */
+
+#include <gtest/gtest.h>
+#include "mcp/tool_dispatcher.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+using namespace MCP;
+using namespace std::chrono_literals;
+
+namespace {
+
+/**
+ * Provider whose single tool sleeps and records how many calls overlapped.
+ */
+class SleepyProvider : public Provider {
+public:
+    SleepyProvider(std::string id, std::string tool, size_t limit)
+        : m_id(std::move(id)), m_tool(std::move(tool)), m_limit(limit) {}
+
+    std::string getId() const override { return m_id; }
+    std::string getName() const override { return m_id; }
+    std::string getDescription() const override { return ""; }
+    size_t maxConcurrentCalls() const override { return m_limit; }
+
+    std::vector<ToolDefinition> getTools() const override {
+        ToolDefinition tool;
+        tool.name = m_tool;
+        return {tool};
+    }
+
+    ToolResult executeTool(const std::string& /*toolName*/, const Value& arguments) override {
+        if (arguments.has("throw")) {
+            throw std::runtime_error("boom");
+        }
+        int running = ++m_running;
+        int peak = m_peak.load();
+        while (running > peak && !m_peak.compare_exchange_weak(peak, running)) {}
+        std::this_thread::sleep_for(50ms);
+        --m_running;
+        return ToolResult::Success(arguments["n"]);
+    }
+
+    int peak() const { return m_peak.load(); }
+
+private:
+    std::string m_id;
+    std::string m_tool;
+    size_t m_limit;
+    std::atomic<int> m_running{0};
+    std::atomic<int> m_peak{0};
+};
+
+class ToolDispatcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_reader = std::make_shared<SleepyProvider>("test.reader", "test_read", 3);
+        m_shell = std::make_shared<SleepyProvider>("test.shell", "test_exec", 1);
+        Registry::Instance().registerProvider(m_reader);
+        Registry::Instance().registerProvider(m_shell);
+    }
+
+    void TearDown() override {
+        Registry::Instance().unregisterProvider("test.reader");
+        Registry::Instance().unregisterProvider("test.shell");
+    }
+
+    static ToolCall call(const std::string& name, int n) {
+        Value args;
+        args["n"] = n;
+        return {std::to_string(n), name, args};
+    }
+
+    std::shared_ptr<SleepyProvider> m_reader;
+    std::shared_ptr<SleepyProvider> m_shell;
+};
+
+} // namespace
+
+// Test that calls overlap up to each provider's limit and results keep call order
+TEST_F(ToolDispatcherTest, RunsCallsConcurrentlyWithinProviderLimits) {
+    std::vector<ToolCall> calls;
+    for (int i = 0; i < 6; ++i) {
+        calls.push_back(call(i % 2 ? "test_exec" : "test_read", i));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto results = ToolDispatcher::Run(calls, 8);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(results.size(), calls.size());
+    for (int i = 0; i < 6; ++i) {
+        ASSERT_TRUE(results[i].success);
+        EXPECT_EQ(results[i].result.asInt(), i);
+    }
+    EXPECT_EQ(m_reader->peak(), 3);
+    EXPECT_EQ(m_shell->peak(), 1);
+    // The three shell calls run back to back; everything else overlaps them
+    EXPECT_LT(elapsed, 300ms);
+}
+
+// Test that a parallelism of one runs the calls one at a time
+TEST_F(ToolDispatcherTest, RunsSeriallyWithOneWorker) {
+    std::vector<ToolCall> calls = {call("test_read", 1), call("test_read", 2)};
+    auto results = ToolDispatcher::Run(calls, 1);
+    EXPECT_TRUE(results[0].success);
+    EXPECT_TRUE(results[1].success);
+    EXPECT_EQ(m_reader->peak(), 1);
+}
+
+// Test that unknown tools and throwing providers yield error results
+TEST_F(ToolDispatcherTest, ReportsUnknownToolsAndExceptions) {
+    ToolCall throwing = call("test_read", 2);
+    throwing.arguments["throw"] = true;
+    std::vector<ToolCall> calls = {call("no_such_tool", 0), call("test_read", 1), throwing};
+
+    auto results = ToolDispatcher::Run(calls, 4);
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_FALSE(results[0].success);
+    EXPECT_NE(results[0].error.find("no_such_tool"), std::string::npos);
+    EXPECT_TRUE(results[1].success);
+    EXPECT_FALSE(results[2].success);
+    EXPECT_NE(results[2].error.find("boom"), std::string::npos);
+}
@@ -0,0 +1,207 @@
+/**
+ * Unit tests for the workspace file/trigram index.
+ */
+
+#include <gtest/gtest.h>
+#include "fs/workspace_index.h"
+#include "fs/change_watcher.h"
+#include "fs/content_search.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace FS;
+using namespace std::chrono_literals;
+
+namespace {
+
+class WorkspaceIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_root = std::filesystem::temp_directory_path() /
+                 ("bytemuse-workspace-index-test-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()));
+        std::filesystem::remove_all(m_root);
+        std::filesystem::create_directories(m_root);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_root);
+    }
+
+    void writeFile(const std::string& relPath, const std::string& content) {
+        auto path = m_root / relPath;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    std::string path(const std::string& relPath) const {
+        return (m_root / relPath).string();
+    }
+
+    std::unique_ptr<WorkspaceIndex> makeIndex(WorkspaceIndexOptions options = {}) {
+        options.changeDelay = 10ms;
+        auto index = std::make_unique<WorkspaceIndex>(m_root.string(), std::move(options));
+        index->start();
+        EXPECT_TRUE(index->waitUntilReady(10s));
+        return index;
+    }
+
+    std::filesystem::path m_root;
+};
+
+} // namespace
+
+// Test that posting lists round-trip ids across varint byte boundaries
+TEST(PostingListTest, RoundTripsIds) {
+    std::vector<uint32_t> ids = {0, 1, 2, 129, 130, 20000, 20001, 3000000, 0xFFFFFFFFu};
+    PostingList list;
+    for (uint32_t id : ids) {
+        list.add(id);
+    }
+    EXPECT_EQ(list.size(), ids.size());
+    EXPECT_LT(list.byteSize(), ids.size() * sizeof(uint32_t));
+
+    std::vector<uint32_t> decoded;
+    list.forEach([&](uint32_t id) {
+        decoded.push_back(id);
+        return true;
+    });
+    EXPECT_EQ(decoded, ids);
+
+    decoded.clear();
+    list.forEach([&](uint32_t id) {
+        decoded.push_back(id);
+        return decoded.size() < 3;
+    });
+    EXPECT_EQ(decoded, (std::vector<uint32_t>{0, 1, 2}));
+}
+
+// Test that content candidates are pruned by trigrams, case-insensitively
+TEST_F(WorkspaceIndexTest, PrunesCandidatesByTrigrams) {
+    writeFile("a.cpp", "void LoadConfig();\n");
+    writeFile("b.cpp", "int main() {}\n");
+    writeFile("sub/c.h", "// loadconfig helper\n");
+    writeFile("data.bin", std::string("loadconfig\0\0", 12));
+
+    auto index = makeIndex();
+    EXPECT_EQ(index->fileCount(), 4u);
+
+    auto candidates = index->candidateFiles(m_root.string(), "loadConfig", "*");
+    ASSERT_TRUE(candidates.has_value());
+    EXPECT_EQ(*candidates, (std::vector<std::string>{path("a.cpp"), path("sub/c.h")}));
+
+    EXPECT_TRUE(index->candidateFiles(m_root.string(), "nowhere", "*")->empty());
+    EXPECT_EQ(*index->candidateFiles(path("sub"), "config", "*"), (std::vector<std::string>{path("sub/c.h")}));
+    EXPECT_EQ(*index->candidateFiles(m_root.string(), "config", "*.cpp"), (std::vector<std::string>{path("a.cpp")}));
+
+    // Short queries can't be pruned
+    EXPECT_EQ(index->candidateFiles(m_root.string(), "in", "*")->size(), 3u);
+}
+
+// Test file name lookups, recursion and skipped names
+TEST_F(WorkspaceIndexTest, FindsFilesByPattern) {
+    writeFile("main.cpp", "x");
+    writeFile("src/util.cpp", "yy");
+    writeFile("src/util.h", "z");
+    writeFile("node_modules/dep.cpp", "w");
+
+    WorkspaceIndexOptions options;
+    options.skipName = [](const std::string& name) { return name == "node_modules"; };
+    auto index = makeIndex(std::move(options));
+
+    auto all = index->findFiles(m_root.string(), "*.cpp", true, 100);
+    ASSERT_TRUE(all.has_value());
+    ASSERT_EQ(all->size(), 2u);
+    EXPECT_EQ((*all)[0].path, path("main.cpp"));
+    EXPECT_EQ((*all)[1].path, path("src/util.cpp"));
+    EXPECT_EQ((*all)[1].size, 2);
+
+    auto top = index->findFiles(m_root.string(), "*", false, 100);
+    ASSERT_EQ(top->size(), 1u);
+    EXPECT_EQ((*top)[0].path, path("main.cpp"));
+
+    EXPECT_EQ(index->findFiles(m_root.string(), "*", true, 2)->size(), 2u);
+}
+
+// Test that change notifications update, add and remove files
+TEST_F(WorkspaceIndexTest, AppliesChangeNotifications) {
+    writeFile("a.txt", "alpha\n");
+    writeFile("dir/b.txt", "beta\n");
+    auto index = makeIndex();
+
+    // Modified file (different size so the stamp changes)
+    writeFile("a.txt", "gamma gamma\n");
+    index->notifyChanged(path("a.txt"));
+    // New file in a new directory, reported as the directory
+    writeFile("new/c.txt", "gamma\n");
+    index->notifyChanged(path("new"));
+    // Removed directory
+    std::filesystem::remove_all(m_root / "dir");
+    index->notifyChanged(path("dir"));
+    ASSERT_TRUE(index->waitUntilIdle(10s));
+
+    EXPECT_TRUE(index->candidateFiles(m_root.string(), "alpha", "*")->empty());
+    EXPECT_TRUE(index->candidateFiles(m_root.string(), "beta", "*")->empty());
+    EXPECT_EQ(*index->candidateFiles(m_root.string(), "gamma", "*"),
+              (std::vector<std::string>{path("a.txt"), path("new/c.txt")}));
+    EXPECT_EQ(index->fileCount(), 2u);
+}
+
+// Test that edits the watcher never reports can't make an indexed search miss a match
+TEST_F(WorkspaceIndexTest, UnreportedEditsCannotHideMatches) {
+    writeFile("src/main.cpp", "int main();\n");
+    writeFile("build/gen.cpp", "int old();\n");
+    writeFile(".github/ci.yml", "run: old\n");
+
+    WorkspaceIndexOptions options;
+    options.skipName = [](const std::string& name) {
+        return RemoteWatcher::IsIgnoredName(name, {"build"});
+    };
+    auto index = makeIndex(options);
+
+    // Reported, so notified
+    writeFile("src/main.cpp", "int main(); // needle\n");
+    index->notifyChanged(path("src/main.cpp"));
+    ASSERT_TRUE(index->waitUntilIdle(10s));
+    // Ignored by the watcher, so the index never hears of these
+    writeFile("build/gen.cpp", "int needle();\n");
+    writeFile("build/new.cpp", "int needle();\n");
+    writeFile(".github/ci.yml", "run: needle\n");
+
+    // With the same skipped names, the index finds what a scan of the root finds
+    ContentSearchOptions search;
+    search.query = "needle";
+    search.skipName = options.skipName;
+    auto candidates = index->candidateFiles(m_root.string(), "needle", "*");
+    ASSERT_TRUE(candidates.has_value());
+    EXPECT_EQ(ContentSearch::Search(*candidates, search).matches.size(), 1u);
+    EXPECT_EQ(ContentSearch::Run(m_root.string(), search).matches.size(), 1u);
+
+    // Below a skipped directory it defers to a direct scan
+    EXPECT_FALSE(index->candidateFiles(path("build"), "needle", "*").has_value());
+    EXPECT_FALSE(index->findFiles(path("build"), "*", true, 100).has_value());
+    EXPECT_FALSE(index->candidateFiles(path(".github"), "needle", "*").has_value());
+    EXPECT_EQ(ContentSearch::Run(path("build"), search).matches.size(), 2u);
+}
+
+// Test that files above the indexing limit are always candidates
+TEST_F(WorkspaceIndexTest, LargeFilesAreAlwaysCandidates) {
+    writeFile("big.txt", std::string(2048, 'x'));
+    writeFile("small.txt", "needle\n");
+
+    WorkspaceIndexOptions options;
+    options.maxIndexedFileSize = 1024;
+    auto index = makeIndex(std::move(options));
+
+    EXPECT_EQ(*index->candidateFiles(m_root.string(), "needle", "*"),
+              (std::vector<std::string>{path("big.txt"), path("small.txt")}));
+}
+
+// Test that queries report not-ready before the first build
+TEST_F(WorkspaceIndexTest, NotReadyBeforeStart) {
+    WorkspaceIndex index(m_root.string());
+    EXPECT_FALSE(index.isReady());
+    EXPECT_FALSE(index.candidateFiles(m_root.string(), "x", "*").has_value());
+    EXPECT_FALSE(index.findFiles(m_root.string(), "*", true, 10).has_value());
+}